@@ -59,6 +59,7 @@ Tests for ADMC
 %doc CHANGELOG.txt
 %doc CHANGELOG_ru.txt
 %_bindir/admc
+%_bindir/admc-cli
 %_libdir/libadldap.so
 %_man1dir/admc*
 %_datadir/applications/admc.desktop
@@ -0,0 +1,145 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "admc_bench.h"
+
+#include "adldap.h"
+
+#include <QTest>
+#include <QUuid>
+
+const QString bench_base_dn = "OU=Bench,DC=domain,DC=alt";
+
+QList<int> bench_dataset_sizes() {
+    const QString sizes_string = QString::fromLocal8Bit(qgetenv("ADMC_BENCH_SIZES"));
+
+    if (sizes_string.isEmpty()) {
+        return {10000, 100000};
+    }
+
+    QList<int> out;
+
+    for (const QString &size_string : sizes_string.split(",")) {
+        bool ok;
+        const int size = size_string.trimmed().toInt(&ok);
+
+        if (ok && size > 0) {
+            out.append(size);
+        }
+    }
+
+    return out;
+}
+
+void bench_add_size_rows() {
+    QTest::addColumn<int>("size");
+
+    for (const int size : bench_dataset_sizes()) {
+        const QByteArray row_name = QByteArray::number(size);
+
+        QTest::newRow(row_name.constData()) << size;
+    }
+}
+
+QString bench_object_dn(const int i) {
+    return QString("CN=bench-%1,%2").arg(i).arg(bench_base_dn);
+}
+
+QHash<QString, QList<QByteArray>> bench_object_attributes(const int i) {
+    const QByteArray name = QString("bench-%1").arg(i).toUtf8();
+    const QByteArray sid = sid_string_to_bytes(QString("S-1-5-21-1000-2000-3000-%1").arg(10000 + i));
+    const QByteArray guid = QUuid::createUuid().toRfc4122();
+    const QByteArray usn = QByteArray::number(10000 + i);
+    const QByteArray timestamp = "20220101120000.0Z";
+
+    QHash<QString, QList<QByteArray>> out = {
+        {ATTRIBUTE_CN, {name}},
+        {ATTRIBUTE_NAME, {name}},
+        {ATTRIBUTE_DN, {bench_object_dn(i).toUtf8()}},
+        {ATTRIBUTE_SAM_ACCOUNT_NAME, {name}},
+        {ATTRIBUTE_DESCRIPTION, {"Synthetic object for benchmarks"}},
+        {ATTRIBUTE_OBJECT_SID, {sid}},
+        {ATTRIBUTE_OBJECT_GUID, {guid}},
+        {ATTRIBUTE_WHEN_CREATED, {timestamp}},
+        {ATTRIBUTE_WHEN_CHANGED, {timestamp}},
+        {ATTRIBUTE_USN_CREATED, {usn}},
+        {ATTRIBUTE_USN_CHANGED, {usn}},
+    };
+
+    const bool is_group = (i % 10 == 0);
+
+    if (is_group) {
+        out[ATTRIBUTE_OBJECT_CLASS] = {"top", CLASS_GROUP};
+        out[ATTRIBUTE_OBJECT_CATEGORY] = {"CN=Group,CN=Schema,CN=Configuration,DC=domain,DC=alt"};
+        out[ATTRIBUTE_GROUP_TYPE] = {"-2147483646"};
+    } else {
+        out[ATTRIBUTE_OBJECT_CLASS] = {"top", "person", "organizationalPerson", CLASS_USER};
+        out[ATTRIBUTE_OBJECT_CATEGORY] = {"CN=Person,CN=Schema,CN=Configuration,DC=domain,DC=alt"};
+        out[ATTRIBUTE_USER_PRINCIPAL_NAME] = {name + "@domain.alt"};
+        out[ATTRIBUTE_DISPLAY_NAME] = {name};
+        out[ATTRIBUTE_USER_ACCOUNT_CONTROL] = {(i % 7 == 0) ? "514" : "512"};
+        out[ATTRIBUTE_PWD_LAST_SET] = {"132854688000000000"};
+        out[ATTRIBUTE_ACCOUNT_EXPIRES] = {"9223372036854775807"};
+    }
+
+    return out;
+}
+
+QList<AdObject> bench_make_object_list(const int size) {
+    QList<AdObject> out;
+    out.reserve(size);
+
+    for (int i = 0; i < size; i++) {
+        AdObject object;
+        object.load(bench_object_dn(i), bench_object_attributes(i));
+
+        out.append(object);
+    }
+
+    return out;
+}
+
+AdMemoryBackend *bench_install_backend() {
+    AdMemoryBackend *out = new AdMemoryBackend("DOMAIN.ALT", "dc0.domain.alt", "administrator@domain.alt");
+
+    QString error;
+    const bool load_success = out->load_ldif(ADMC_BENCH_DATASET, &error);
+    if (!load_success) {
+        qFatal("Failed to load benchmark dataset: %s", qPrintable(error));
+    }
+
+    AdInterface::set_backend(out);
+
+    return out;
+}
+
+void bench_populate(AdMemoryBackend *backend, const int size) {
+    backend->remove(bench_base_dn, true);
+
+    backend->add_entry(bench_base_dn, {
+        {ATTRIBUTE_OBJECT_CLASS, {"top", CLASS_OU}},
+        {ATTRIBUTE_NAME, {"Bench"}},
+        {ATTRIBUTE_OBJECT_CATEGORY, {"CN=Organizational-Unit,CN=Schema,CN=Configuration,DC=domain,DC=alt"}},
+    });
+
+    for (int i = 0; i < size; i++) {
+        backend->add_entry(bench_object_dn(i), bench_object_attributes(i));
+    }
+}
@@ -0,0 +1,64 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ADMC_BENCH_H
+#define ADMC_BENCH_H
+
+/**
+ * Helpers shared by benchmarks. Benchmarks are data-driven
+ * by the size of a synthetic dataset. By default they run
+ * for 10k and 100k objects. Set ADMC_BENCH_SIZES to a
+ * comma-separated list of sizes to change that, for example
+ * "10000,100000,1000000".
+ */
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+class AdMemoryBackend;
+class AdObject;
+
+// Parent of all synthetic objects
+extern const QString bench_base_dn;
+
+QList<int> bench_dataset_sizes();
+
+// Adds "size" column and a row for each dataset size to
+// current benchmark's data
+void bench_add_size_rows();
+
+// Synthetic objects are mostly users, with every tenth
+// object being a group
+QString bench_object_dn(const int i);
+QHash<QString, QList<QByteArray>> bench_object_attributes(const int i);
+QList<AdObject> bench_make_object_list(const int size);
+
+// Creates a backend seeded with the offline test dataset
+// and installs it for AdInterface. Must be called before
+// any AdInterface is created.
+AdMemoryBackend *bench_install_backend();
+
+// Replaces contents of bench base with given amount of
+// synthetic objects
+void bench_populate(AdMemoryBackend *backend, const int size);
+
+#endif /* ADMC_BENCH_H */
@@ -0,0 +1,342 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "admc_bench_adldap.h"
+
+#include "admc_bench.h"
+
+#include "adldap.h"
+#include "samba/ndr_security.h"
+#include "samba/security_descriptor.h"
+
+#include <QUuid>
+
+// NOTE: set ADMC_BENCH_LIVE_BASE to a DN to run the search
+// benchmark against a live domain instead of the in-memory
+// directory. That measures the libldap path, including BER
+// decoding in search_paged_internal(). All other
+// benchmarks don't depend on the directory.
+const QString live_base = QString::fromLocal8Bit(qgetenv("ADMC_BENCH_LIVE_BASE"));
+
+const QList<QString> search_attributes = {
+    ATTRIBUTE_NAME,
+    ATTRIBUTE_OBJECT_CLASS,
+    ATTRIBUTE_OBJECT_CATEGORY,
+    ATTRIBUTE_SAM_ACCOUNT_NAME,
+    ATTRIBUTE_USER_ACCOUNT_CONTROL,
+    ATTRIBUTE_GROUP_TYPE,
+    ATTRIBUTE_DESCRIPTION,
+    ATTRIBUTE_WHEN_CHANGED,
+};
+
+const QString gpo_dn_template = "CN=%1,CN=Policies,CN=System,DC=domain,DC=alt";
+
+void ADMCBenchAdldap::initTestCase() {
+    if (live_base.isEmpty()) {
+        backend = bench_install_backend();
+    } else {
+        backend = nullptr;
+    }
+
+    ad = new AdInterface();
+    QVERIFY2(ad->is_connected(), "Failed to connect to AD server");
+
+    adconfig = new AdConfig();
+    adconfig->load(*ad, QLocale(QLocale::English));
+    AdInterface::set_config(adconfig);
+}
+
+void ADMCBenchAdldap::cleanupTestCase() {
+    delete ad;
+    delete adconfig;
+    delete backend;
+}
+
+void ADMCBenchAdldap::search_paged_data() {
+    if (live_base.isEmpty()) {
+        bench_add_size_rows();
+    } else {
+        QTest::addColumn<int>("size");
+
+        QTest::newRow("live") << 0;
+    }
+}
+
+// Pages through all objects under the base, like console
+// does when fetching a large container
+void ADMCBenchAdldap::search_paged() {
+    QFETCH(int, size);
+
+    if (backend != nullptr) {
+        bench_populate(backend, size);
+    }
+
+    const QString base = [&]() {
+        if (backend != nullptr) {
+            return bench_base_dn;
+        } else {
+            return live_base;
+        }
+    }();
+
+    int count = 0;
+
+    QBENCHMARK {
+        AdCookie cookie;
+        count = 0;
+
+        while (true) {
+            QHash<QString, AdObject> results;
+            const bool success = ad->search_paged(base, SearchScope_Children, "(objectClass=*)", search_attributes, &results, &cookie);
+            QVERIFY(success);
+
+            count += results.size();
+
+            if (!cookie.more_pages()) {
+                break;
+            }
+        }
+    }
+
+    if (backend != nullptr) {
+        QCOMPARE(count, size);
+    }
+}
+
+void ADMCBenchAdldap::object_load_data() {
+    bench_add_size_rows();
+}
+
+void ADMCBenchAdldap::object_load() {
+    QFETCH(int, size);
+
+    QList<QString> dn_list;
+    QList<QHash<QString, QList<QByteArray>>> attributes_list;
+    for (int i = 0; i < size; i++) {
+        dn_list.append(bench_object_dn(i));
+        attributes_list.append(bench_object_attributes(i));
+    }
+
+    QBENCHMARK {
+        for (int i = 0; i < size; i++) {
+            AdObject object;
+            object.load(dn_list[i], attributes_list[i]);
+        }
+    }
+}
+
+void ADMCBenchAdldap::object_getters_data() {
+    bench_add_size_rows();
+}
+
+// Calls getters that are used when loading console rows and
+// properties
+void ADMCBenchAdldap::object_getters() {
+    QFETCH(int, size);
+
+    const QList<AdObject> object_list = bench_make_object_list(size);
+
+    QBENCHMARK {
+        for (const AdObject &object : object_list) {
+            object.get_string(ATTRIBUTE_NAME);
+            object.get_string(ATTRIBUTE_OBJECT_CLASS);
+            object.get_value(ATTRIBUTE_OBJECT_SID);
+            object.get_int(ATTRIBUTE_USER_ACCOUNT_CONTROL);
+            object.get_system_flag(SystemFlagsBit_CannotDelete);
+            object.get_datetime(ATTRIBUTE_WHEN_CHANGED, adconfig);
+            object.is_class(CLASS_USER);
+
+            if (object.is_class(CLASS_GROUP)) {
+                object.get_group_scope();
+                object.get_group_type();
+            } else {
+                object.get_account_option(AccountOption_Disabled, adconfig);
+            }
+        }
+    }
+}
+
+void ADMCBenchAdldap::attribute_display_value_data() {
+    QTest::addColumn<QString>("attribute");
+    QTest::addColumn<int>("size");
+
+    // NOTE: one attribute for each kind of display
+    // formatting
+    const QList<QString> attribute_list = {
+        ATTRIBUTE_CN,
+        ATTRIBUTE_OBJECT_CATEGORY,
+        ATTRIBUTE_OBJECT_SID,
+        ATTRIBUTE_OBJECT_GUID,
+        ATTRIBUTE_WHEN_CHANGED,
+        ATTRIBUTE_PWD_LAST_SET,
+        ATTRIBUTE_ACCOUNT_EXPIRES,
+        ATTRIBUTE_USER_ACCOUNT_CONTROL,
+        ATTRIBUTE_USN_CHANGED,
+    };
+
+    for (const QString &attribute : attribute_list) {
+        for (const int size : bench_dataset_sizes()) {
+            const QByteArray row_name = QString("%1-%2").arg(attribute).arg(size).toUtf8();
+
+            QTest::newRow(row_name.constData()) << attribute << size;
+        }
+    }
+}
+
+void ADMCBenchAdldap::attribute_display_value() {
+    QFETCH(QString, attribute);
+    QFETCH(int, size);
+
+    // NOTE: only users have all of the attributes, so
+    // skip groups
+    QList<QByteArray> value_list;
+    for (int i = 0; value_list.size() < size; i++) {
+        const QHash<QString, QList<QByteArray>> attributes = bench_object_attributes(i);
+
+        if (attributes.contains(attribute)) {
+            value_list.append(attributes[attribute]);
+        }
+    }
+
+    QBENCHMARK {
+        for (const QByteArray &value : value_list) {
+            attribute_display_value(attribute, value, adconfig);
+        }
+    }
+}
+
+void ADMCBenchAdldap::gplink_parse_data() {
+    QTest::addColumn<int>("link_count");
+    QTest::addColumn<int>("size");
+
+    // NOTE: real gplinks are short, but there are many of
+    // them, so besides dataset size also vary the length
+    for (const int link_count : {1, 10, 100}) {
+        for (const int size : bench_dataset_sizes()) {
+            const QByteArray row_name = QString("%1-%2").arg(link_count).arg(size).toUtf8();
+
+            QTest::newRow(row_name.constData()) << link_count << size;
+        }
+    }
+}
+
+void ADMCBenchAdldap::gplink_parse() {
+    QFETCH(int, link_count);
+    QFETCH(int, size);
+
+    const QString gplink_string = [&]() {
+        Gplink gplink;
+
+        for (int i = 0; i < link_count; i++) {
+            const QString gpo = gpo_dn_template.arg(QUuid::createUuid().toString().toUpper());
+            gplink.add(gpo);
+            gplink.set_option(gpo, GplinkOption_Enforced, (i % 2 == 0));
+        }
+
+        return gplink.to_string();
+    }();
+
+    QBENCHMARK {
+        for (int i = 0; i < size; i++) {
+            const Gplink gplink = Gplink(gplink_string);
+            gplink.get_gpo_list();
+        }
+    }
+}
+
+void ADMCBenchAdldap::gplink_to_string_data() {
+    gplink_parse_data();
+}
+
+void ADMCBenchAdldap::gplink_to_string() {
+    QFETCH(int, link_count);
+    QFETCH(int, size);
+
+    Gplink gplink;
+    for (int i = 0; i < link_count; i++) {
+        const QString gpo = gpo_dn_template.arg(QUuid::createUuid().toString().toUpper());
+        gplink.add(gpo);
+        gplink.set_option(gpo, GplinkOption_Disabled, (i % 3 == 0));
+    }
+
+    QBENCHMARK {
+        for (int i = 0; i < size; i++) {
+            gplink.to_string();
+        }
+    }
+}
+
+void ADMCBenchAdldap::security_descriptor_get_right_data() {
+    QTest::addColumn<int>("ace_count");
+
+    // NOTE: DACL's of real objects rarely have more than a
+    // few hundred ACE's, so sizes here are smaller than
+    // dataset sizes
+    for (const int ace_count : {10, 100, 1000, 10000}) {
+        const QByteArray row_name = QByteArray::number(ace_count);
+
+        QTest::newRow(row_name.constData()) << ace_count;
+    }
+}
+
+// Gets right of a trustee whose ACE is at the end of a
+// large DACL, which is the worst case for the linear scan
+// in security_descriptor_get_right()
+void ADMCBenchAdldap::security_descriptor_get_right() {
+    QFETCH(int, ace_count);
+
+    // NOTE: "User-Change-Password" extended right
+    const QByteArray object_type = guid_string_to_bytes("ab721a53-1e2f-11d0-9819-00aa0040529b");
+
+    security_descriptor *sd = security_descriptor_initialise(NULL);
+
+    QByteArray last_trustee;
+    for (int i = 0; i < ace_count; i++) {
+        const QByteArray trustee = sid_string_to_bytes(QString("S-1-5-21-1000-2000-3000-%1").arg(10000 + i));
+        const bool object_present = (i % 2 == 0);
+
+        security_ace ace;
+        memset(&ace, '\0', sizeof(security_ace));
+
+        if (object_present) {
+            ace.type = SEC_ACE_TYPE_ACCESS_ALLOWED_OBJECT;
+            ace.access_mask = SEC_ADS_CONTROL_ACCESS;
+            ace.object.object.flags = SEC_ACE_OBJECT_TYPE_PRESENT;
+            memcpy(&ace.object.object.type.type, object_type.constData(), sizeof(GUID));
+        } else {
+            ace.type = SEC_ACE_TYPE_ACCESS_ALLOWED;
+            ace.access_mask = SEC_ADS_GENERIC_READ;
+        }
+        memcpy(&ace.trustee, trustee.constData(), qMin((size_t) trustee.size(), sizeof(dom_sid)));
+
+        security_descriptor_dacl_add(sd, &ace);
+
+        last_trustee = trustee;
+    }
+
+    QBENCHMARK {
+        security_descriptor_get_right(sd, last_trustee, SEC_ADS_GENERIC_READ, QByteArray());
+        security_descriptor_get_right(sd, last_trustee, SEC_ADS_CONTROL_ACCESS, object_type);
+    }
+
+    security_descriptor_free(sd);
+}
+
+QTEST_MAIN(ADMCBenchAdldap)
@@ -0,0 +1,60 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ADMC_BENCH_ADLDAP_H
+#define ADMC_BENCH_ADLDAP_H
+
+#include <QObject>
+#include <QTest>
+
+class AdInterface;
+class AdConfig;
+class AdMemoryBackend;
+
+class ADMCBenchAdldap : public QObject {
+    Q_OBJECT
+
+public slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+private slots:
+    void search_paged_data();
+    void search_paged();
+    void object_load_data();
+    void object_load();
+    void object_getters_data();
+    void object_getters();
+    void attribute_display_value_data();
+    void attribute_display_value();
+    void gplink_parse_data();
+    void gplink_parse();
+    void gplink_to_string_data();
+    void gplink_to_string();
+    void security_descriptor_get_right_data();
+    void security_descriptor_get_right();
+
+private:
+    AdMemoryBackend *backend;
+    AdInterface *ad;
+    AdConfig *adconfig;
+};
+
+#endif /* ADMC_BENCH_ADLDAP_H */
@@ -0,0 +1,92 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "admc_bench_console.h"
+
+#include "admc_bench.h"
+
+#include "adldap.h"
+#include "console_impls/object_impl.h"
+#include "globals.h"
+#include "utils.h"
+
+#include <QStandardItem>
+
+void ADMCBenchConsole::initTestCase() {
+    backend = bench_install_backend();
+
+    ad = new AdInterface();
+    QVERIFY2(ad->is_connected(), "Failed to connect to AD server");
+
+    g_adconfig->load(*ad, QLocale(QLocale::English));
+    AdInterface::set_config(g_adconfig);
+}
+
+void ADMCBenchConsole::cleanupTestCase() {
+    delete ad;
+    delete backend;
+}
+
+void ADMCBenchConsole::console_object_load_data() {
+    bench_add_size_rows();
+}
+
+// Constructs rows the old way, resolving columns from
+// AdConfig for every object
+void ADMCBenchConsole::console_object_load() {
+    QFETCH(int, size);
+
+    const QList<AdObject> object_list = bench_make_object_list(size);
+    const int column_count = g_adconfig->get_columns().size();
+
+    QBENCHMARK {
+        for (const AdObject &object : object_list) {
+            const QList<QStandardItem *> row = make_item_row(column_count);
+            ::console_object_load(row, object);
+            qDeleteAll(row);
+        }
+    }
+}
+
+void ADMCBenchConsole::object_row_loader_data() {
+    bench_add_size_rows();
+}
+
+// Constructs rows through one loader for the whole fetch,
+// like console does when fetching children of an object
+void ADMCBenchConsole::object_row_loader() {
+    QFETCH(int, size);
+
+    const QList<AdObject> object_list = bench_make_object_list(size);
+    const int column_count = g_adconfig->get_columns().size();
+
+    QBENCHMARK {
+        const ObjectRowLoader loader;
+
+        for (const AdObject &object : object_list) {
+            const QList<QStandardItem *> row = make_item_row(column_count);
+            loader.load(row, object);
+            loader.is_container(object);
+            qDeleteAll(row);
+        }
+    }
+}
+
+QTEST_MAIN(ADMCBenchConsole)
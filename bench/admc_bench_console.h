@@ -0,0 +1,48 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ADMC_BENCH_CONSOLE_H
+#define ADMC_BENCH_CONSOLE_H
+
+#include <QObject>
+#include <QTest>
+
+class AdInterface;
+class AdMemoryBackend;
+
+class ADMCBenchConsole : public QObject {
+    Q_OBJECT
+
+public slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+private slots:
+    void console_object_load_data();
+    void console_object_load();
+    void object_row_loader_data();
+    void object_row_loader();
+
+private:
+    AdMemoryBackend *backend;
+    AdInterface *ad;
+};
+
+#endif /* ADMC_BENCH_CONSOLE_H */
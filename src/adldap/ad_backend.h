@@ -0,0 +1,88 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AD_BACKEND_H
+#define AD_BACKEND_H
+
+/**
+ * Transport used by AdInterface to access the directory.
+ * By default AdInterface talks to a domain controller
+ * through libldap and libsmbclient. Installing a backend
+ * via AdInterface::set_backend() redirects all LDAP
+ * operations of every AdInterface instance to it. This is
+ * used to run against an in-process directory, for example
+ * in tests that can't rely on a live domain.
+ *
+ * All operations return an LDAP result code, same as the
+ * ones returned by libldap, so that AdInterface can report
+ * errors in the same way for all backends.
+ */
+
+#include "ad_defines.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+class AdObject;
+
+enum AdBackendModOp {
+    AdBackendModOp_Add,
+    AdBackendModOp_Delete,
+    AdBackendModOp_Replace,
+};
+
+class AdBackendMod {
+public:
+    AdBackendModOp op;
+    QString attribute;
+    QList<QByteArray> values;
+};
+
+class AdBackend {
+public:
+    virtual ~AdBackend() = default;
+
+    virtual QString domain() const = 0;
+    virtual QString dc() const = 0;
+    virtual QString client_user() const = 0;
+
+    // Returns one page of results. "cookie" should be 0
+    // for the first page. It is set to a value that
+    // continues the search or to 0 if there are no more
+    // pages.
+    // Empty attributes list returns all attributes.
+    virtual int search(const QString &base, const SearchScope scope, const QString &filter, const QList<QString> &attributes, QHash<QString, AdObject> *results, int *cookie) = 0;
+
+    virtual int add(const QString &dn, const QHash<QString, QList<QByteArray>> &attributes) = 0;
+    virtual int modify(const QString &dn, const QList<AdBackendMod> &mod_list) = 0;
+
+    // If "tree_delete" is true, children are deleted
+    // together with the object, otherwise deleting an
+    // object with children fails
+    virtual int remove(const QString &dn, const bool tree_delete) = 0;
+
+    // "new_superior" may be empty, in which case object
+    // stays in the same parent
+    virtual int rename(const QString &dn, const QString &new_rdn, const QString &new_superior) = 0;
+};
+
+#endif /* AD_BACKEND_H */
@@ -33,6 +33,7 @@
 #include <QCoreApplication>
 #include <QDebug>
 #include <QLocale>
+#include <QSet>
 #include <algorithm>
 
 #define ATTRIBUTE_ATTRIBUTE_DISPLAY_NAMES "attributeDisplayNames"
@@ -56,6 +57,7 @@
 #define ATTRIBUTE_LINK_ID "linkID"
 #define ATTRIBUTE_SYSTEM_AUXILIARY_CLASS "systemAuxiliaryClass"
 #define ATTRIBUTE_SUB_CLASS_OF "subClassOf"
+#define ATTRIBUTE_OBJECT_CLASS_CATEGORY "objectClassCategory"
 
 #define CLASS_ATTRIBUTE_SCHEMA "attributeSchema"
 #define CLASS_CLASS_SCHEMA "classSchema"
@@ -63,6 +65,10 @@
 
 #define FLAG_ATTR_IS_CONSTRUCTED 0x00000004
 
+// Value of objectClassCategory. Other values are for
+// abstract and auxiliary classes.
+#define CLASS_CATEGORY_STRUCTURAL 1
+
 AdConfigPrivate::AdConfigPrivate() {
 }
 
@@ -85,6 +91,8 @@ void AdConfig::load(AdInterface &ad, const QLocale &locale) {
     d->attribute_display_names.clear();
     d->attribute_schemas.clear();
     d->class_schemas.clear();
+    d->unique_object_category_map.clear();
+    d->anr_attributes.clear();
 
     const AdObject rootDSE_object = ad.search_object(ROOT_DSE);
     d->domain_dn = rootDSE_object.get_string(ATTRIBUTE_ROOT_DOMAIN_NAMING_CONTEXT);
@@ -122,6 +130,7 @@ void AdConfig::load(AdInterface &ad, const QLocale &locale) {
             ATTRIBUTE_LINK_ID,
             ATTRIBUTE_SYSTEM_FLAGS,
             ATTRIBUTE_SCHEMA_ID_GUID,
+            ATTRIBUTE_SEARCH_FLAGS,
         };
 
         const QHash<QString, AdObject> results = ad.search(schema_dn(), SearchScope_Children, filter, attributes);
@@ -132,6 +141,11 @@ void AdConfig::load(AdInterface &ad, const QLocale &locale) {
 
             const QByteArray guid = object.get_value(ATTRIBUTE_SCHEMA_ID_GUID);
             d->guid_to_attribute_map[guid] = attribute;
+
+            const int search_flags = object.get_int(ATTRIBUTE_SEARCH_FLAGS);
+            if (bitmask_is_set(search_flags, SearchFlagsBit_ANR)) {
+                d->anr_attributes.append(attribute);
+            }
         }
     }
 
@@ -151,6 +165,8 @@ void AdConfig::load(AdInterface &ad, const QLocale &locale) {
             ATTRIBUTE_SYSTEM_AUXILIARY_CLASS,
             ATTRIBUTE_SCHEMA_ID_GUID,
             ATTRIBUTE_SUB_CLASS_OF,
+            ATTRIBUTE_DEFAULT_OBJECT_CATEGORY,
+            ATTRIBUTE_OBJECT_CLASS_CATEGORY,
         };
 
         const QHash<QString, AdObject> results = ad.search(schema_dn(), SearchScope_Children, filter, attributes);
@@ -165,6 +181,38 @@ void AdConfig::load(AdInterface &ad, const QLocale &locale) {
             const QString sub_class_of = object.get_string(ATTRIBUTE_SUB_CLASS_OF);
             d->sub_class_of_map[object_class] = sub_class_of;
         }
+
+        // Find classes whose objects can be found by
+        // object category instead of object class. This
+        // is possible if class is structural, has no
+        // subclasses and no other class uses same
+        // category.
+        // NOTE: objectCategory of an object is set from
+        // it's structural class only, so objects with an
+        // auxiliary class have a different category.
+        QHash<QString, int> category_use_count;
+        QSet<ObjectClass> classes_with_subclasses;
+        for (const AdObject &object : results.values()) {
+            const QString object_class = object.get_string(ATTRIBUTE_LDAP_DISPLAY_NAME);
+            const QString category = object.get_string(ATTRIBUTE_DEFAULT_OBJECT_CATEGORY);
+            category_use_count[category.toLower()]++;
+
+            const QString parent_class = d->sub_class_of_map[object_class];
+            if (parent_class != object_class) {
+                classes_with_subclasses.insert(parent_class);
+            }
+        }
+
+        for (const AdObject &object : results.values()) {
+            const QString object_class = object.get_string(ATTRIBUTE_LDAP_DISPLAY_NAME);
+            const QString category = object.get_string(ATTRIBUTE_DEFAULT_OBJECT_CATEGORY);
+            const bool is_structural = (object.get_int(ATTRIBUTE_OBJECT_CLASS_CATEGORY) == CLASS_CATEGORY_STRUCTURAL);
+
+            const bool category_is_unique = (is_structural && !category.isEmpty() && category_use_count[category.toLower()] == 1 && !classes_with_subclasses.contains(object_class));
+            if (category_is_unique) {
+                d->unique_object_category_map[object_class] = category;
+            }
+        }
     }
 
     // Class display specifiers
@@ -390,8 +438,8 @@ QString AdConfig::domain_sid() const
 }
 
 QString AdConfig::get_attribute_display_name(const Attribute &attribute, const ObjectClass &objectClass) const {
-    if (d->attribute_display_names.contains(objectClass) && d->attribute_display_names[objectClass].contains(attribute)) {
-        const QString display_name = d->attribute_display_names[objectClass][attribute];
+    if (d->attribute_display_names.contains(objectClass) && d->attribute_display_names.value(objectClass).contains(attribute)) {
+        const QString display_name = d->attribute_display_names.value(objectClass).value(attribute);
 
         return display_name;
     }
@@ -446,7 +494,7 @@ QList<QString> AdConfig::get_possible_superiors(const QList<ObjectClass> &object
     QList<QString> out;
 
     for (const QString &object_class : object_classes) {
-        const AdObject schema = d->class_schemas[object_class];
+        const AdObject schema = d->class_schemas.value(object_class);
         out += schema.get_strings(ATTRIBUTE_POSSIBLE_SUPERIORS);
         out += schema.get_strings(ATTRIBUTE_SYSTEM_POSSIBLE_SUPERIORS);
     }
@@ -490,7 +538,7 @@ QList<QString> AdConfig::get_optional_attributes(const QList<QString> &object_cl
     QList<QString> attributes;
 
     for (const auto &object_class : all_classes) {
-        const AdObject schema = d->class_schemas[object_class];
+        const AdObject schema = d->class_schemas.value(object_class);
         attributes += schema.get_strings(ATTRIBUTE_MAY_CONTAIN);
         attributes += schema.get_strings(ATTRIBUTE_SYSTEM_MAY_CONTAIN);
     }
@@ -506,7 +554,7 @@ QList<QString> AdConfig::get_mandatory_attributes(const QList<QString> &object_c
     QList<QString> attributes;
 
     for (const auto &object_class : all_classes) {
-        const AdObject schema = d->class_schemas[object_class];
+        const AdObject schema = d->class_schemas.value(object_class);
         attributes += schema.get_strings(ATTRIBUTE_MUST_CONTAIN);
         attributes += schema.get_strings(ATTRIBUTE_SYSTEM_MUST_CONTAIN);
     }
@@ -520,10 +568,14 @@ QList<QString> AdConfig::get_find_attributes(const QString &object_class) const
     return d->find_attributes.value(object_class, QList<QString>());
 }
 
+bool AdConfig::get_attribute_is_known(const QString &attribute) const {
+    return d->attribute_schemas.contains(attribute);
+}
+
 AttributeType AdConfig::get_attribute_type(const QString &attribute) const {
     // NOTE: replica of: https://docs.microsoft.com/en-us/openspecs/windows_protocols/ms-adts/7cda533e-d7a4-4aec-a517-91d02ff4a1aa
     // syntax -> om syntax list -> type
-    static QHash<QString, QHash<QString, AttributeType>> type_map = {
+    static const QHash<QString, QHash<QString, AttributeType>> type_map = {
         {"2.5.5.8", {{"1", AttributeType_Boolean}}},
         {"2.5.5.9",
             {
@@ -555,7 +607,7 @@ AttributeType AdConfig::get_attribute_type(const QString &attribute) const {
         {"2.5.5.1", {{"127", AttributeType_DSDN}}},
     };
 
-    const AdObject schema = d->attribute_schemas[attribute];
+    const AdObject schema = d->attribute_schemas.value(attribute);
 
     const QString attribute_syntax = schema.get_string(ATTRIBUTE_ATTRIBUTE_SYNTAX);
     const QString om_syntax = schema.get_string(ATTRIBUTE_OM_SYNTAX);
@@ -612,20 +664,20 @@ bool AdConfig::get_attribute_is_number(const QString &attribute) const {
 }
 
 bool AdConfig::get_attribute_is_single_valued(const QString &attribute) const {
-    return d->attribute_schemas[attribute].get_bool(ATTRIBUTE_IS_SINGLE_VALUED);
+    return d->attribute_schemas.value(attribute).get_bool(ATTRIBUTE_IS_SINGLE_VALUED);
 }
 
 bool AdConfig::get_attribute_is_system_only(const QString &attribute) const {
-    return d->attribute_schemas[attribute].get_bool(ATTRIBUTE_SYSTEM_ONLY);
+    return d->attribute_schemas.value(attribute).get_bool(ATTRIBUTE_SYSTEM_ONLY);
 }
 
 int AdConfig::get_attribute_range_upper(const QString &attribute) const {
-    return d->attribute_schemas[attribute].get_int(ATTRIBUTE_RANGE_UPPER);
+    return d->attribute_schemas.value(attribute).get_int(ATTRIBUTE_RANGE_UPPER);
 }
 
 bool AdConfig::get_attribute_is_backlink(const QString &attribute) const {
-    if (d->attribute_schemas[attribute].contains(ATTRIBUTE_LINK_ID)) {
-        const int link_id = d->attribute_schemas[attribute].get_int(ATTRIBUTE_LINK_ID);
+    if (d->attribute_schemas.value(attribute).contains(ATTRIBUTE_LINK_ID)) {
+        const int link_id = d->attribute_schemas.value(attribute).get_int(ATTRIBUTE_LINK_ID);
         const bool link_id_is_odd = (link_id % 2 != 0);
 
         return link_id_is_odd;
@@ -634,8 +686,20 @@ bool AdConfig::get_attribute_is_backlink(const QString &attribute) const {
     }
 }
 
+int AdConfig::get_attribute_search_flags(const Attribute &attribute) const {
+    return d->attribute_schemas.value(attribute).get_int(ATTRIBUTE_SEARCH_FLAGS);
+}
+
+QList<Attribute> AdConfig::get_anr_attributes() const {
+    return d->anr_attributes;
+}
+
+QString AdConfig::get_class_unique_object_category(const ObjectClass &object_class) const {
+    return d->unique_object_category_map.value(object_class);
+}
+
 bool AdConfig::get_attribute_is_constructed(const QString &attribute) const {
-    const int system_flags = d->attribute_schemas[attribute].get_int(ATTRIBUTE_SYSTEM_FLAGS);
+    const int system_flags = d->attribute_schemas.value(attribute).get_int(ATTRIBUTE_SYSTEM_FLAGS);
     return bitmask_is_set(system_flags, FLAG_ATTR_IS_CONSTRUCTED);
 }
 
@@ -735,7 +799,7 @@ QString AdConfig::get_right_name(const QByteArray &right_guid, const QLocale::La
         {"DNS-Host-Name-Attributes", QCoreApplication::translate("AdConfig", "DNS Host Name Attributes")},
     };
 
-    const QString right_cn = d->right_guid_to_cn_map[right_guid];
+    const QString right_cn = d->right_guid_to_cn_map.value(right_guid);
     if (language == QLocale::Russian && cn_to_map_russian.contains(right_cn)) {
         const QString out = cn_to_map_russian[right_cn];
 
@@ -796,9 +860,9 @@ QList<QString> AdConfig::get_noncontainer_classes() {
 }
 
 bool AdConfig::rights_applies_to_class(const QString &rights_cn, const QList<QString> &class_list) const {
-    const QByteArray rights_guid = d->rights_name_to_guid_map[rights_cn];
+    const QByteArray rights_guid = d->rights_name_to_guid_map.value(rights_cn);
 
-    const QList<QString> applies_to_list = d->rights_applies_to_map[rights_guid];
+    const QList<QString> applies_to_list = d->rights_applies_to_map.value(rights_guid);
     const QSet<QString> applies_to_set = QSet<QString>(applies_to_list.begin(), applies_to_list.end());
 
     const QSet<QString> class_set = QSet<QString>(class_list.begin(), class_list.end());
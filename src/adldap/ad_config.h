@@ -82,6 +82,9 @@ public:
     QList<Attribute> get_mandatory_attributes(const QList<ObjectClass> &object_classes) const;
     QList<Attribute> get_find_attributes(const ObjectClass &object_class) const;
 
+    // Returns false if attribute is not in the schema. For
+    // such attributes the getters below return defaults.
+    bool get_attribute_is_known(const Attribute &attribute) const;
     AttributeType get_attribute_type(const Attribute &attribute) const;
     LargeIntegerSubtype get_attribute_large_integer_subtype(const Attribute &attribute) const;
     bool get_attribute_is_number(const Attribute &attribute) const;
@@ -90,6 +93,19 @@ public:
     int get_attribute_range_upper(const Attribute &attribute) const;
     bool get_attribute_is_backlink(const Attribute &attribute) const;
     bool get_attribute_is_constructed(const Attribute &attribute) const;
+    int get_attribute_search_flags(const Attribute &attribute) const;
+
+    // Returns attributes that have ANR search flag, which
+    // are the ones that server checks for "anr=" filters
+    QList<Attribute> get_anr_attributes() const;
+
+    // Returns object category that is used only by given
+    // class, if class is structural and has no
+    // subclasses. Searching by this category finds same
+    // objects as searching by class but is faster.
+    // Otherwise, for example for auxiliary classes,
+    // returns empty string.
+    QString get_class_unique_object_category(const ObjectClass &object_class) const;
 
     // Limit's edit's max valid input length based on
     // the upper range defined for attribute in schema
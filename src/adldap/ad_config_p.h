@@ -71,6 +71,8 @@ public:
     QList<QString> supported_control_list;
 
     QHash<QString, QString> sub_class_of_map;
+    QHash<ObjectClass, QString> unique_object_category_map;
+    QList<Attribute> anr_attributes;
 };
 
 #endif /* AD_CONFIG_P_H */
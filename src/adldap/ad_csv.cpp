@@ -0,0 +1,139 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ad_csv.h"
+
+#include <QByteArray>
+#include <QCoreApplication>
+
+bool csv_parse(const QByteArray &data, QList<QList<QString>> *row_list, QString *error) {
+    QList<QString> current_row;
+    QByteArray current_field;
+    bool in_quotes = false;
+    bool field_was_quoted = false;
+    int line = 1;
+
+    auto finish_field = [&]() {
+        current_row.append(QString::fromUtf8(current_field));
+        current_field.clear();
+        field_was_quoted = false;
+    };
+
+    auto finish_row = [&]() {
+        finish_field();
+        row_list->append(current_row);
+        current_row.clear();
+    };
+
+    for (int i = 0; i < data.size(); i++) {
+        const char c = data[i];
+
+        if (in_quotes) {
+            if (c == '"') {
+                const bool is_escaped_quote = (i + 1 < data.size() && data[i + 1] == '"');
+
+                if (is_escaped_quote) {
+                    current_field.append('"');
+                    i++;
+                } else {
+                    in_quotes = false;
+                }
+            } else {
+                if (c == '\n') {
+                    line++;
+                }
+
+                current_field.append(c);
+            }
+
+            continue;
+        }
+
+        switch (c) {
+            case '"': {
+                if (!current_field.isEmpty() || field_was_quoted) {
+                    *error = QCoreApplication::translate("csv", "Line %1: unexpected quote.").arg(line);
+
+                    return false;
+                }
+
+                in_quotes = true;
+                field_was_quoted = true;
+
+                break;
+            }
+            case ',': {
+                finish_field();
+
+                break;
+            }
+            case '\r': {
+                // NOTE: part of CRLF, row is finished on LF
+                break;
+            }
+            case '\n': {
+                finish_row();
+                line++;
+
+                break;
+            }
+            default: {
+                if (field_was_quoted) {
+                    *error = QCoreApplication::translate("csv", "Line %1: unexpected characters after closing quote.").arg(line);
+
+                    return false;
+                }
+
+                current_field.append(c);
+
+                break;
+            }
+        }
+    }
+
+    if (in_quotes) {
+        *error = QCoreApplication::translate("csv", "Line %1: quoted field is not closed.").arg(line);
+
+        return false;
+    }
+
+    // NOTE: last line may or may not end with a line
+    // break
+    const bool have_last_row = (!current_row.isEmpty() || !current_field.isEmpty() || field_was_quoted);
+    if (have_last_row) {
+        finish_row();
+    }
+
+    return true;
+}
+
+QByteArray csv_escape_field(const QString &field) {
+    QByteArray out = field.toUtf8();
+
+    const bool need_quotes = (out.contains(',') || out.contains('"') || out.contains('\n') || out.contains('\r'));
+
+    if (need_quotes) {
+        out.replace("\"", "\"\"");
+        out.prepend('"');
+        out.append('"');
+    }
+
+    return out;
+}
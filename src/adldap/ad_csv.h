@@ -0,0 +1,42 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AD_CSV_H
+#define AD_CSV_H
+
+/**
+ * Reading and writing CSV as described in RFC 4180. Fields
+ * are separated by commas, fields that contain commas,
+ * quotes or line breaks are quoted and quotes inside them
+ * are doubled. Both CRLF and LF line endings are accepted.
+ */
+
+#include <QList>
+#include <QString>
+
+class QByteArray;
+
+// Returns false and sets error if data is malformed
+bool csv_parse(const QByteArray &data, QList<QList<QString>> *row_list, QString *error);
+
+// Returns field quoted if needed, without separators
+QByteArray csv_escape_field(const QString &field);
+
+#endif /* AD_CSV_H */
@@ -90,6 +90,15 @@ enum SystemFlagsBit {
     SystemFlagsBit_CannotDelete = 0x80000000
 };
 
+// Bits of attribute schema's searchFlags
+enum SearchFlagsBit {
+    SearchFlagsBit_Indexed = 0x00000001,
+    SearchFlagsBit_ContainerIndexed = 0x00000002,
+    SearchFlagsBit_ANR = 0x00000004,
+    SearchFlagsBit_TupleIndexed = 0x00000020,
+    SearchFlagsBit_SubtreeIndexed = 0x00000040,
+};
+
 #define ROOT_DSE ""
 
 #define ATTRIBUTE_CN "cn"
@@ -126,6 +135,11 @@ enum SystemFlagsBit {
 #define ATTRIBUTE_USN_CHANGED "uSNChanged"
 #define ATTRIBUTE_USN_CREATED "uSNCreated"
 #define ATTRIBUTE_OBJECT_CATEGORY "objectCategory"
+#define ATTRIBUTE_DEFAULT_OBJECT_CATEGORY "defaultObjectCategory"
+#define ATTRIBUTE_SEARCH_FLAGS "searchFlags"
+// NOTE: not a real attribute, used in filters for
+// ambiguous name resolution
+#define ATTRIBUTE_ANR "anr"
 #define ATTRIBUTE_MEMBER "member"
 #define ATTRIBUTE_MEMBER_OF "memberOf"
 #define ATTRIBUTE_SHOW_IN_ADVANCED_VIEW_ONLY "showInAdvancedViewOnly"
@@ -189,6 +203,7 @@ enum SystemFlagsBit {
 #define ATTRIBUTE_SCHEMA_NAMING_CONTEXT "schemaNamingContext"
 #define ATTRIBUTE_CONFIGURATION_NAMING_CONTEXT "configurationNamingContext"
 #define ATTRIBUTE_ROOT_DOMAIN_NAMING_CONTEXT "rootDomainNamingContext"
+#define ATTRIBUTE_HIGHEST_COMMITTED_USN "highestCommittedUSN"
 #define ATTRIBUTE_FSMO_ROLE_OWNER "fSMORoleOwner"
 #define ATTRIBUTE_SERVER_NAME "serverName"
 #define ATTRIBUTE_SCHEMA_ID_GUID "schemaIDGUID"
@@ -244,6 +259,7 @@ enum SystemFlagsBit {
 #define CLASS_SITE "site"
 #define CLASS_SERVER "server"
 #define CLASS_SERVERS_CONTAINER "serversContainer"
+#define CLASS_NTDS_DSA "nTDSDSA"
 #define CLASS_PSO_CONTAINER "msDS-PasswordSettingsContainer"
 #define CLASS_PSO "msDS-PasswordSettings"
 // NOTE: for schema object
@@ -298,6 +314,8 @@ enum SystemFlagsBit {
 const long long MILLIS_TO_100_NANOS = 10000LL;
 
 #define MATCHING_RULE_IN_CHAIN_OID "1.2.840.113556.1.4.1941"
+#define MATCHING_RULE_BIT_AND_OID "1.2.840.113556.1.4.803"
+#define MATCHING_RULE_BIT_OR_OID "1.2.840.113556.1.4.804"
 
 #define LDAP_SERVER_SD_FLAGS_OID "1.2.840.113556.1.4.801"
 #define OWNER_SECURITY_INFORMATION 0x01
@@ -0,0 +1,219 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ad_export.h"
+
+#include "ad_csv.h"
+#include "ad_display.h"
+#include "ad_interface.h"
+#include "ad_ldif.h"
+#include "ad_object.h"
+
+#include <QIODevice>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+
+#include <algorithm>
+
+AdExportWriter::AdExportWriter(QIODevice *device_arg, const AdExportFormat format_arg, const AdExportValues values_arg, const QList<QString> &attributes_arg, const AdConfig *adconfig_arg) {
+    device = device_arg;
+    format = format_arg;
+    values = values_arg;
+    attributes = attributes_arg;
+    adconfig = adconfig_arg;
+    object_count = 0;
+}
+
+bool AdExportWriter::write_header() {
+    if (format != AdExportFormat_Csv) {
+        return true;
+    }
+
+    QByteArray line = csv_escape_field("dn");
+    for (const QString &attribute : attributes) {
+        line.append(',');
+        line.append(csv_escape_field(attribute));
+    }
+    line.append("\r\n");
+
+    return write(line);
+}
+
+bool AdExportWriter::write_object(const AdObject &object) {
+    const QString dn = object.get_dn();
+
+    const QList<QString> object_attributes = [&]() {
+        if (attributes.isEmpty()) {
+            QList<QString> out = object.attributes();
+            std::sort(out.begin(), out.end());
+
+            return out;
+        } else {
+            return attributes;
+        }
+    }();
+
+    const QByteArray data = [&]() {
+        switch (format) {
+            case AdExportFormat_Csv: {
+                QByteArray out = csv_escape_field(dn);
+
+                for (const QString &attribute : attributes) {
+                    const QList<QString> value_strings = get_value_strings(attribute, object.get_values(attribute));
+                    const QString field = QStringList(value_strings).join(";");
+
+                    out.append(',');
+                    out.append(csv_escape_field(field));
+                }
+
+                // NOTE: RFC 4180 uses CRLF line endings
+                out.append("\r\n");
+
+                return out;
+            }
+            case AdExportFormat_JsonLines: {
+                QJsonObject json_object;
+                json_object["dn"] = dn;
+
+                for (const QString &attribute : object_attributes) {
+                    if (!object.contains(attribute)) {
+                        continue;
+                    }
+
+                    const QList<QString> value_strings = get_value_strings(attribute, object.get_values(attribute));
+                    json_object[attribute] = QJsonArray::fromStringList(value_strings);
+                }
+
+                QByteArray out = QJsonDocument(json_object).toJson(QJsonDocument::Compact);
+                out.append('\n');
+
+                return out;
+            }
+            case AdExportFormat_Ldif: {
+                LdifEntry entry;
+                entry.dn = dn;
+
+                for (const QString &attribute : object_attributes) {
+                    if (!object.contains(attribute)) {
+                        continue;
+                    }
+
+                    const QList<QByteArray> value_list = object.get_values(attribute);
+
+                    if (values == AdExportValues_Raw) {
+                        entry.attributes[attribute] = value_list;
+                    } else {
+                        for (const QString &value_string : get_value_strings(attribute, value_list)) {
+                            entry.attributes[attribute].append(value_string.toUtf8());
+                        }
+                    }
+                }
+
+                return ldif_write_entry(entry, object_attributes);
+            }
+            case AdExportFormat_COUNT: break;
+        }
+
+        return QByteArray();
+    }();
+
+    const bool success = write(data);
+
+    if (success) {
+        object_count++;
+    }
+
+    return success;
+}
+
+int AdExportWriter::get_object_count() const {
+    return object_count;
+}
+
+QList<QString> AdExportWriter::get_attributes() const {
+    return attributes;
+}
+
+QList<QString> AdExportWriter::get_value_strings(const QString &attribute, const QList<QByteArray> &value_list) const {
+    QList<QString> out;
+
+    for (const QByteArray &value : value_list) {
+        if (values == AdExportValues_Raw) {
+            out.append(QString::fromLatin1(value.toBase64()));
+        } else {
+            out.append(attribute_display_value(attribute, value, adconfig));
+        }
+    }
+
+    return out;
+}
+
+bool AdExportWriter::write(const QByteArray &data) {
+    const qint64 written = device->write(data);
+
+    return (written == data.size());
+}
+
+AdExportResult ad_export_search(AdInterface &ad, const QString &base, const SearchScope scope, const QString &filter, AdExportWriter *writer, const AdExportProgressCallback &progress, const bool *stop_flag) {
+    AdCookie cookie;
+
+    const QList<QString> attributes = writer->get_attributes();
+
+    while (true) {
+        QHash<QString, AdObject> results;
+
+        const bool search_success = ad.search_paged(base, scope, filter, attributes, &results, &cookie);
+
+        for (const AdObject &object : results) {
+            const bool write_success = writer->write_object(object);
+
+            if (!write_success) {
+                return AdExportResult_WriteFailed;
+            }
+        }
+
+        progress(writer->get_object_count());
+
+        if (!search_success) {
+            return AdExportResult_SearchFailed;
+        }
+
+        if (!cookie.more_pages()) {
+            return AdExportResult_Complete;
+        }
+
+        if (*stop_flag) {
+            return AdExportResult_Stopped;
+        }
+    }
+}
+
+QString ad_export_format_extension(const AdExportFormat format) {
+    switch (format) {
+        case AdExportFormat_Csv: return "csv";
+        case AdExportFormat_JsonLines: return "jsonl";
+        case AdExportFormat_Ldif: return "ldif";
+        case AdExportFormat_COUNT: break;
+    }
+
+    return QString();
+}
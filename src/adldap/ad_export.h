@@ -0,0 +1,108 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AD_EXPORT_H
+#define AD_EXPORT_H
+
+/**
+ * Writes objects to a device in CSV, JSON Lines or LDIF
+ * format. Objects are written one at a time, so that large
+ * result sets can be exported page by page without keeping
+ * all of them in memory. Only the given attributes are
+ * written, DN is always written first. If attributes list
+ * is empty, all attributes of each object are written,
+ * which is not supported for CSV because it needs a fixed
+ * set of columns.
+ */
+
+#include "ad_defines.h"
+
+#include <QList>
+#include <QString>
+
+#include <functional>
+
+class AdConfig;
+class AdInterface;
+class AdObject;
+class QIODevice;
+
+enum AdExportFormat {
+    AdExportFormat_Csv,
+    AdExportFormat_JsonLines,
+    AdExportFormat_Ldif,
+
+    AdExportFormat_COUNT,
+};
+
+enum AdExportValues {
+    // Values are formatted same as in attributes tab
+    AdExportValues_Display,
+
+    // Values are written as is. In CSV and JSON they are
+    // base64 encoded, LDIF encodes them itself when
+    // needed.
+    AdExportValues_Raw,
+};
+
+class AdExportWriter {
+public:
+    AdExportWriter(QIODevice *device, const AdExportFormat format, const AdExportValues values, const QList<QString> &attributes, const AdConfig *adconfig);
+
+    // Writes CSV header, nothing for other formats. Should
+    // be called once before writing objects.
+    bool write_header();
+    bool write_object(const AdObject &object);
+
+    int get_object_count() const;
+    QList<QString> get_attributes() const;
+
+private:
+    QIODevice *device;
+    AdExportFormat format;
+    AdExportValues values;
+    QList<QString> attributes;
+    const AdConfig *adconfig;
+    int object_count;
+
+    QList<QString> get_value_strings(const QString &attribute, const QList<QByteArray> &value_list) const;
+    bool write(const QByteArray &data);
+};
+
+enum AdExportResult {
+    AdExportResult_Complete,
+    AdExportResult_Stopped,
+    AdExportResult_SearchFailed,
+    AdExportResult_WriteFailed,
+};
+
+typedef std::function<void(const int object_count)> AdExportProgressCallback;
+
+// Searches for objects and writes them using writer, page
+// by page. Pages are discarded after they are written.
+// Progress callback is called after each page with the
+// number of objects written so far. Stops early if stop
+// flag is set.
+AdExportResult ad_export_search(AdInterface &ad, const QString &base, const SearchScope scope, const QString &filter, AdExportWriter *writer, const AdExportProgressCallback &progress, const bool *stop_flag);
+
+// Returns file extension for format, without the dot
+QString ad_export_format_extension(const AdExportFormat format);
+
+#endif /* AD_EXPORT_H */
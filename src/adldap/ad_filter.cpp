@@ -21,6 +21,7 @@
 #include "ad_filter.h"
 
 #include "ad_defines.h"
+#include "ad_filter_tree.h"
 
 #include <QCoreApplication>
 
@@ -47,17 +48,14 @@ const QList<QString> filter_classes = {
 QList<QString> process_subfilters(const QList<QString> &in);
 
 QString filter_CONDITION(const Condition condition, const QString &attribute, const QString &value) {
-    switch (condition) {
-        case Condition_Equals: return QString("(%1=%2)").arg(attribute, value);
-        case Condition_NotEquals: return QString("(!(%1=%2))").arg(attribute, value);
-        case Condition_StartsWith: return QString("(%1=%2*)").arg(attribute, value);
-        case Condition_EndsWith: return QString("(%1=*%2)").arg(attribute, value);
-        case Condition_Contains: return QString("(%1=*%2*)").arg(attribute, value);
-        case Condition_Set: return QString("(%1=*)").arg(attribute);
-        case Condition_Unset: return QString("(!(%1=*))").arg(attribute);
-        case Condition_COUNT: return QString();
+    if (condition == Condition_COUNT) {
+        return QString();
     }
-    return QString();
+
+    const FilterNode node = filter_node_condition(condition, attribute, value);
+    const QString out = filter_serialize(node);
+
+    return out;
 }
 
 // {x, y, z ...} => (&(x)(y)(z)...)
@@ -137,6 +135,13 @@ QString filter_dn_list(const QList<QString> &dn_list) {
 }
 
 QString filter_matching_rule_in_chain(const QString &attribute, const QString &dn_value) {
-    const QString filter = attribute + ":" + QString(MATCHING_RULE_IN_CHAIN_OID) + ":=" + dn_value;
-    return QString("(" + filter + ")");
+    FilterNode node;
+    node.type = FilterNodeType_Extensible;
+    node.attribute = attribute;
+    node.rule = MATCHING_RULE_IN_CHAIN_OID;
+    node.value = dn_value.toUtf8();
+
+    const QString out = filter_serialize(node);
+
+    return out;
 }
@@ -22,7 +22,9 @@
 #define AD_FILTER_H
 
 /**
- * Functions for constructing an LDAP filter.
+ * Functions for constructing an LDAP filter. Values are
+ * escaped, so they should be passed as is. See
+ * ad_filter_tree.h for working with filters as trees.
  */
 
 #include <QString>
@@ -0,0 +1,545 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ad_filter_match.h"
+
+#include "ad_config.h"
+#include "ad_defines.h"
+#include "ad_display.h"
+#include "ad_filter_tree.h"
+#include "ad_object.h"
+#include "ad_utils.h"
+
+#include <QRegularExpression>
+#include <QSet>
+
+#include <climits>
+
+// NOTE: default set of attributes that have ANR search
+// flag, used when schema is not available. Otherwise, ANR
+// attributes are taken from searchFlags in schema, same as
+// server does, because sites can add more of them.
+const QList<QString> default_anr_attributes = {
+    ATTRIBUTE_DISPLAY_NAME,
+    ATTRIBUTE_FIRST_NAME,
+    ATTRIBUTE_LAST_NAME,
+    ATTRIBUTE_NAME,
+    ATTRIBUTE_OFFICE,
+    ATTRIBUTE_SAM_ACCOUNT_NAME,
+    "legacyExchangeDN",
+    "proxyAddresses",
+    "msDS-AdditionalSamAccountName",
+};
+
+// Determines how values of an attribute are compared
+enum MatchSyntax {
+    // Schema is not available, guess from values
+    MatchSyntax_Auto,
+    MatchSyntax_String,
+    MatchSyntax_StringCase,
+    MatchSyntax_Number,
+    MatchSyntax_DN,
+    MatchSyntax_Binary,
+};
+
+MatchSyntax match_get_syntax(const QString &attribute, const AdConfig *adconfig);
+bool match_value(const FilterNode &node, const MatchSyntax syntax, const QByteArray &value);
+bool match_value_equals(const QString &attribute, const MatchSyntax syntax, const QByteArray &value, const QByteArray &asserted);
+int match_value_compare(const MatchSyntax syntax, const QByteArray &value, const QByteArray &asserted);
+bool match_value_substrings(const MatchSyntax syntax, const QByteArray &value, const QList<QByteArray> &substring_list);
+quint64 match_value_to_bits(const QByteArray &value);
+bool match_in_chain(const QString &dn, const QString &attribute, const QString &target, const FilterValueGetter &get_values);
+bool match_anr(const QString &dn, const QString &text, const FilterValueGetter &get_values, const AdConfig *adconfig);
+bool match_anr_prefix(const QString &dn, const QString &attribute, const QString &prefix, const FilterValueGetter &get_values);
+QString match_dn_normalize(const QString &dn);
+QSet<QString> filter_get_and_terms(const QString &filter, bool *ok);
+
+bool filter_match(const FilterNode &node, const QString &dn, const FilterValueGetter &get_values, const AdConfig *adconfig) {
+    switch (node.type) {
+        case FilterNodeType_And: {
+            for (const FilterNode &child : node.children) {
+                if (!filter_match(child, dn, get_values, adconfig)) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+        case FilterNodeType_Or: {
+            for (const FilterNode &child : node.children) {
+                if (filter_match(child, dn, get_values, adconfig)) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+        case FilterNodeType_Not: {
+            if (node.children.size() != 1) {
+                return false;
+            }
+
+            return !filter_match(node.children[0], dn, get_values, adconfig);
+        }
+        case FilterNodeType_Present: {
+            return !get_values(dn, node.attribute).isEmpty();
+        }
+        case FilterNodeType_Extensible: {
+            if (node.rule == MATCHING_RULE_IN_CHAIN_OID) {
+                return match_in_chain(dn, node.attribute, QString::fromUtf8(node.value), get_values);
+            }
+
+            break;
+        }
+        default: break;
+    }
+
+    const bool is_anr = (node.attribute.compare(ATTRIBUTE_ANR, Qt::CaseInsensitive) == 0);
+    if (is_anr) {
+        if (node.type == FilterNodeType_Equal) {
+            return match_anr(dn, QString::fromUtf8(node.value), get_values, adconfig);
+        } else {
+            return false;
+        }
+    }
+
+    const MatchSyntax syntax = match_get_syntax(node.attribute, adconfig);
+    const QList<QByteArray> values = get_values(dn, node.attribute);
+
+    for (const QByteArray &value : values) {
+        if (match_value(node, syntax, value)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool filter_match(const FilterNode &node, const AdObject &object, const AdConfig *adconfig) {
+    const QString object_dn = object.get_dn();
+    const QString object_key = match_dn_normalize(object_dn);
+    const QHash<QString, QList<QByteArray>> attributes_data = object.get_attributes_data();
+
+    const FilterValueGetter get_values = [&](const QString &dn, const QString &attribute) -> QList<QByteArray> {
+        if (match_dn_normalize(dn) != object_key) {
+            return QList<QByteArray>();
+        }
+
+        if (attributes_data.contains(attribute)) {
+            return attributes_data[attribute];
+        }
+
+        for (auto it = attributes_data.begin(); it != attributes_data.end(); it++) {
+            if (it.key().compare(attribute, Qt::CaseInsensitive) == 0) {
+                return it.value();
+            }
+        }
+
+        // NOTE: DN is not always loaded as an
+        // attribute, but it's always known
+        if (attribute.compare(ATTRIBUTE_DN, Qt::CaseInsensitive) == 0) {
+            return QList<QByteArray>({object_dn.toUtf8()});
+        }
+
+        return QList<QByteArray>();
+    };
+
+    return filter_match(node, object_dn, get_values, adconfig);
+}
+
+bool filter_can_match_locally(const FilterNode &node, const QList<QString> &loaded_attributes, const AdConfig *adconfig) {
+    switch (node.type) {
+        case FilterNodeType_And:
+        case FilterNodeType_Or:
+        case FilterNodeType_Not: {
+            for (const FilterNode &child : node.children) {
+                if (!filter_can_match_locally(child, loaded_attributes, adconfig)) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+        case FilterNodeType_Extensible: {
+            // NOTE: in-chain rule needs objects outside of
+            // loaded set and ":dn" matches against DN
+            // components, neither is implemented
+            const bool rule_is_supported = (node.rule.isEmpty() || node.rule == MATCHING_RULE_BIT_AND_OID || node.rule == MATCHING_RULE_BIT_OR_OID);
+            if (!rule_is_supported || node.dn_attributes) {
+                return false;
+            }
+
+            break;
+        }
+        default: break;
+    }
+
+    const bool is_dn = (node.attribute.compare(ATTRIBUTE_DN, Qt::CaseInsensitive) == 0);
+    if (is_dn || loaded_attributes.contains("*")) {
+        return true;
+    }
+
+    auto attribute_is_loaded = [&](const QString &attribute) {
+        for (const QString &loaded : loaded_attributes) {
+            if (loaded.compare(attribute, Qt::CaseInsensitive) == 0) {
+                return true;
+            }
+        }
+
+        return false;
+    };
+
+    const bool is_anr = (node.attribute.compare(ATTRIBUTE_ANR, Qt::CaseInsensitive) == 0);
+    if (is_anr) {
+        for (const QString &attribute : filter_get_anr_attributes(adconfig)) {
+            if (!attribute_is_loaded(attribute)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    return attribute_is_loaded(node.attribute);
+}
+
+QList<QString> filter_get_anr_attributes(const AdConfig *adconfig) {
+    if (adconfig != nullptr) {
+        const QList<QString> out = adconfig->get_anr_attributes();
+
+        if (!out.isEmpty()) {
+            return out;
+        }
+    }
+
+    return default_anr_attributes;
+}
+
+bool filter_is_narrowing(const QString &narrow, const QString &wide) {
+    bool narrow_ok;
+    bool wide_ok;
+    const QSet<QString> narrow_terms = filter_get_and_terms(narrow, &narrow_ok);
+    const QSet<QString> wide_terms = filter_get_and_terms(wide, &wide_ok);
+
+    if (!narrow_ok || !wide_ok) {
+        return false;
+    }
+
+    const bool out = narrow_terms.contains(wide_terms);
+
+    return out;
+}
+
+MatchSyntax match_get_syntax(const QString &attribute, const AdConfig *adconfig) {
+    if (adconfig == nullptr || !adconfig->get_attribute_is_known(attribute)) {
+        return MatchSyntax_Auto;
+    }
+
+    const AttributeType type = adconfig->get_attribute_type(attribute);
+
+    switch (type) {
+        case AttributeType_Enumeration: return MatchSyntax_Number;
+        case AttributeType_Integer: return MatchSyntax_Number;
+        case AttributeType_LargeInteger: return MatchSyntax_Number;
+        case AttributeType_Numeric: return MatchSyntax_Number;
+        case AttributeType_StringCase: return MatchSyntax_StringCase;
+        case AttributeType_DSDN: return MatchSyntax_DN;
+        case AttributeType_NTSecDesc: return MatchSyntax_Binary;
+        case AttributeType_Octet: return MatchSyntax_Binary;
+        case AttributeType_ReplicaLink: return MatchSyntax_Binary;
+        case AttributeType_Sid: return MatchSyntax_Binary;
+        default: return MatchSyntax_String;
+    }
+}
+
+bool match_value(const FilterNode &node, const MatchSyntax syntax, const QByteArray &value) {
+    switch (node.type) {
+        case FilterNodeType_Equal:
+        case FilterNodeType_Approx: return match_value_equals(node.attribute, syntax, value, node.value);
+        case FilterNodeType_Greater: return (match_value_compare(syntax, value, node.value) >= 0);
+        case FilterNodeType_Less: return (match_value_compare(syntax, value, node.value) <= 0);
+        case FilterNodeType_Substring: return match_value_substrings(syntax, value, node.substring_list);
+        case FilterNodeType_Extensible: {
+            const quint64 value_bits = match_value_to_bits(value);
+            const quint64 asserted_bits = match_value_to_bits(node.value);
+
+            if (node.rule == MATCHING_RULE_BIT_AND_OID) {
+                return ((value_bits & asserted_bits) == asserted_bits);
+            } else if (node.rule == MATCHING_RULE_BIT_OR_OID) {
+                return ((value_bits & asserted_bits) != 0);
+            } else {
+                return match_value_equals(node.attribute, syntax, value, node.value);
+            }
+        }
+        default: return false;
+    }
+}
+
+bool match_value_equals(const QString &attribute, const MatchSyntax syntax, const QByteArray &value, const QByteArray &asserted) {
+    if (value == asserted) {
+        return true;
+    }
+
+    // NOTE: AD accepts SID's in string form in filters
+    const bool is_sid_string = (attribute.compare(ATTRIBUTE_OBJECT_SID, Qt::CaseInsensitive) == 0 && asserted.startsWith("S-"));
+    if (is_sid_string) {
+        return (object_sid_display_value(value) == QString::fromUtf8(asserted));
+    }
+
+    // NOTE: AD accepts short form of objectCategory, for
+    // example "person" instead of full DN
+    const bool is_short_category = (attribute.compare(ATTRIBUTE_OBJECT_CATEGORY, Qt::CaseInsensitive) == 0 && !asserted.contains('='));
+    if (is_short_category) {
+        const QString category_name = dn_get_name(QString::fromUtf8(value));
+
+        return (category_name.compare(QString::fromUtf8(asserted), Qt::CaseInsensitive) == 0);
+    }
+
+    // NOTE: without schema, equality is checked as a
+    // string even if values look like numbers
+    if (syntax == MatchSyntax_Auto) {
+        return (QString::fromUtf8(value).compare(QString::fromUtf8(asserted), Qt::CaseInsensitive) == 0);
+    }
+
+    return (match_value_compare(syntax, value, asserted) == 0);
+}
+
+// Returns negative, zero or positive value, like
+// QString::compare()
+int match_value_compare(const MatchSyntax syntax, const QByteArray &value, const QByteArray &asserted) {
+    switch (syntax) {
+        case MatchSyntax_Binary: {
+            if (value < asserted) {
+                return -1;
+            } else if (value > asserted) {
+                return 1;
+            } else {
+                return 0;
+            }
+        }
+        case MatchSyntax_DN: {
+            return match_dn_normalize(QString::fromUtf8(value)).compare(match_dn_normalize(QString::fromUtf8(asserted)));
+        }
+        case MatchSyntax_StringCase: {
+            return QString::fromUtf8(value).compare(QString::fromUtf8(asserted), Qt::CaseSensitive);
+        }
+        default: break;
+    }
+
+    const bool can_compare_as_numbers = (syntax == MatchSyntax_Number || syntax == MatchSyntax_Auto);
+    if (can_compare_as_numbers) {
+        bool value_is_number;
+        bool asserted_is_number;
+        const qlonglong value_number = value.toLongLong(&value_is_number);
+        const qlonglong asserted_number = asserted.toLongLong(&asserted_is_number);
+
+        if (value_is_number && asserted_is_number) {
+            if (value_number < asserted_number) {
+                return -1;
+            } else if (value_number > asserted_number) {
+                return 1;
+            } else {
+                return 0;
+            }
+        }
+    }
+
+    return QString::fromUtf8(value).compare(QString::fromUtf8(asserted), Qt::CaseInsensitive);
+}
+
+bool match_value_substrings(const MatchSyntax syntax, const QByteArray &value, const QList<QByteArray> &substring_list) {
+    if (substring_list.isEmpty()) {
+        return false;
+    }
+
+    const Qt::CaseSensitivity cs = [&]() {
+        if (syntax == MatchSyntax_StringCase || syntax == MatchSyntax_Binary) {
+            return Qt::CaseSensitive;
+        } else {
+            return Qt::CaseInsensitive;
+        }
+    }();
+
+    const QString value_string = QString::fromUtf8(value);
+    const QString initial = QString::fromUtf8(substring_list.first());
+    const QString final_part = QString::fromUtf8(substring_list.last());
+
+    if (!value_string.startsWith(initial, cs)) {
+        return false;
+    }
+
+    int position = initial.size();
+
+    for (int i = 1; i < substring_list.size() - 1; i++) {
+        const QString any = QString::fromUtf8(substring_list[i]);
+        const int any_i = value_string.indexOf(any, position, cs);
+
+        if (any_i == -1) {
+            return false;
+        }
+
+        position = any_i + any.size();
+    }
+
+    const int final_i = value_string.size() - final_part.size();
+    const bool final_match = (final_i >= position && value_string.endsWith(final_part, cs));
+
+    return final_match;
+}
+
+// NOTE: 32-bit flags like groupType are stored as signed
+// numbers, so "-2147483646" and "2147483650" must produce
+// same bits
+quint64 match_value_to_bits(const QByteArray &value) {
+    const qlonglong number = value.toLongLong();
+    const bool is_32bit = (number >= INT_MIN && number <= static_cast<qlonglong>(UINT_MAX));
+
+    if (is_32bit) {
+        return static_cast<quint32>(number);
+    } else {
+        return static_cast<quint64>(number);
+    }
+}
+
+// Follows values of a DN attribute through referenced
+// objects, until target is found or chain ends
+bool match_in_chain(const QString &dn, const QString &attribute, const QString &target, const FilterValueGetter &get_values) {
+    const QString target_key = match_dn_normalize(target);
+
+    QSet<QString> visited;
+    QList<QString> queue;
+
+    for (const QByteArray &value : get_values(dn, attribute)) {
+        queue.append(QString::fromUtf8(value));
+    }
+
+    while (!queue.isEmpty()) {
+        const QString current = queue.takeFirst();
+        const QString key = match_dn_normalize(current);
+
+        if (key == target_key) {
+            return true;
+        }
+
+        if (visited.contains(key)) {
+            continue;
+        }
+        visited.insert(key);
+
+        for (const QByteArray &value : get_values(current, attribute)) {
+            queue.append(QString::fromUtf8(value));
+        }
+    }
+
+    return false;
+}
+
+// Matches if any of ANR attributes starts with given text.
+// Text with a space is also matched as "first last" and
+// "last first" against given name and surname. Text that
+// starts with "=" requires an exact match.
+bool match_anr(const QString &dn, const QString &text_raw, const FilterValueGetter &get_values, const AdConfig *adconfig) {
+    const QString text = text_raw.trimmed();
+    const QList<QString> anr_attributes = filter_get_anr_attributes(adconfig);
+
+    const bool is_exact = text.startsWith('=');
+    if (is_exact) {
+        const QByteArray exact_value = text.mid(1).toUtf8();
+
+        for (const QString &attribute : anr_attributes) {
+            for (const QByteArray &value : get_values(dn, attribute)) {
+                if (match_value_equals(attribute, MatchSyntax_String, value, exact_value)) {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    for (const QString &attribute : anr_attributes) {
+        if (match_anr_prefix(dn, attribute, text, get_values)) {
+            return true;
+        }
+    }
+
+    const int space_i = text.indexOf(' ');
+    if (space_i != -1) {
+        const QString first_part = text.left(space_i);
+        const QString second_part = text.mid(space_i + 1).trimmed();
+
+        const bool first_last = (match_anr_prefix(dn, ATTRIBUTE_FIRST_NAME, first_part, get_values) && match_anr_prefix(dn, ATTRIBUTE_LAST_NAME, second_part, get_values));
+        const bool last_first = (match_anr_prefix(dn, ATTRIBUTE_LAST_NAME, first_part, get_values) && match_anr_prefix(dn, ATTRIBUTE_FIRST_NAME, second_part, get_values));
+
+        return (first_last || last_first);
+    }
+
+    return false;
+}
+
+bool match_anr_prefix(const QString &dn, const QString &attribute, const QString &prefix, const FilterValueGetter &get_values) {
+    for (const QByteArray &value : get_values(dn, attribute)) {
+        if (QString::fromUtf8(value).startsWith(prefix, Qt::CaseInsensitive)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// NOTE: DN's are case insensitive and may have spaces
+// after separators, "CN=a, DC=b" is same as "cn=a,dc=b"
+QString match_dn_normalize(const QString &dn) {
+    static const QRegularExpression separator_spaces("\\s*,\\s*");
+
+    QString out = dn.trimmed().toLower();
+    out.replace(separator_spaces, ",");
+
+    return out;
+}
+
+// Returns set of serialized terms of the filter's top
+// level AND. If filter is not an AND, it is the only term.
+QSet<QString> filter_get_and_terms(const QString &filter, bool *ok) {
+    FilterNode node;
+    *ok = filter_parse(filter, &node);
+    if (!*ok) {
+        return QSet<QString>();
+    }
+
+    // NOTE: optimize without schema to flatten nested
+    // AND's without rewriting any terms
+    const FilterNode flat = filter_optimize(node, nullptr);
+
+    const QList<FilterNode> term_list = [&]() {
+        if (flat.type == FilterNodeType_And) {
+            return flat.children;
+        } else {
+            return QList<FilterNode>({flat});
+        }
+    }();
+
+    QSet<QString> out;
+    for (const FilterNode &term : term_list) {
+        out.insert(filter_serialize(term));
+    }
+
+    return out;
+}
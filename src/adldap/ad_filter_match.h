@@ -0,0 +1,80 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AD_FILTER_MATCH_H
+#define AD_FILTER_MATCH_H
+
+/**
+ * Evaluates filters on the client, so that objects that
+ * were already loaded can be checked against a filter
+ * without asking the server. Values are compared using
+ * matching rules of attribute syntaxes from AdConfig: case
+ * insensitive strings, DN's, integers, binary values and
+ * the bit AND/OR matching rules. If adconfig is null,
+ * values that look like numbers are compared as numbers
+ * and everything else as case insensitive strings.
+ * Ambiguous name resolution ("anr=") is evaluated against
+ * attributes with ANR search flag in schema, or a default
+ * set of them if adconfig is null.
+ */
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+#include <functional>
+
+class AdConfig;
+class AdObject;
+class FilterNode;
+
+// Returns values of an attribute of object with given DN.
+// Attribute names should be compared case insensitively.
+// Also used to follow links for the in-chain matching
+// rule, so it may be called for DN's of other objects.
+typedef std::function<QList<QByteArray>(const QString &dn, const QString &attribute)> FilterValueGetter;
+
+bool filter_match(const FilterNode &node, const QString &dn, const FilterValueGetter &get_values, const AdConfig *adconfig);
+
+// Matches a loaded object. In-chain matching rule only
+// checks object's own values because other objects are not
+// available.
+bool filter_match(const FilterNode &node, const AdObject &object, const AdConfig *adconfig);
+
+// Returns true if filter can be evaluated for objects
+// loaded with given attributes and give same results as
+// the server would. False if filter uses attributes that
+// weren't loaded, the in-chain rule or ":dn" extensible
+// matches. Adconfig should be the same that is used for
+// matching.
+bool filter_can_match_locally(const FilterNode &node, const QList<QString> &loaded_attributes, const AdConfig *adconfig);
+
+// Returns true if all objects matching "narrow" filter
+// also match "wide" filter, which is the case if narrow
+// filter is an AND of all terms of the wide filter plus
+// some extra terms. Returns false if this can't be
+// determined.
+bool filter_is_narrowing(const QString &narrow, const QString &wide);
+
+// Returns attributes that "anr=" filters are matched
+// against. Load them to be able to match ANR locally.
+QList<QString> filter_get_anr_attributes(const AdConfig *adconfig);
+
+#endif /* AD_FILTER_MATCH_H */
@@ -0,0 +1,636 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ad_filter_tree.h"
+
+#include "ad_config.h"
+#include "ad_defines.h"
+#include "ad_utils.h"
+
+#include <QCoreApplication>
+#include <QSet>
+
+#include <algorithm>
+
+// NOTE: order matters, terms of AND's are sorted by cost
+enum FilterTermCost {
+    FilterTermCost_IndexedEqual,
+    FilterTermCost_Indexed,
+    FilterTermCost_Unindexed,
+    FilterTermCost_Negation,
+};
+
+QString filter_escape_internal(const QByteArray &value, const bool escape_non_ascii);
+QString filter_serialize_value(const QByteArray &value);
+bool filter_parse_node(const QString &filter, int *i, FilterNode *out);
+bool filter_parse_item(const QString &item, FilterNode *out);
+bool attribute_has_search_flag(const QString &attribute, const SearchFlagsBit flag, const AdConfig *adconfig);
+bool attribute_is_indexed(const QString &attribute, const AdConfig *adconfig);
+bool filter_node_can_use_index(const FilterNode &node, const AdConfig *adconfig, QList<QString> *reasons);
+FilterTermCost filter_term_cost(const FilterNode &node, const AdConfig *adconfig);
+
+FilterNode::FilterNode() {
+    type = FilterNodeType_And;
+    dn_attributes = false;
+}
+
+QString filter_escape(const QString &value) {
+    return filter_escape_internal(value.toUtf8(), false);
+}
+
+QString filter_escape_bytes(const QByteArray &value) {
+    return filter_escape_internal(value, true);
+}
+
+// Replaces "\XX" escapes with corresponding bytes
+QByteArray filter_unescape(const QString &value) {
+    const QByteArray value_bytes = value.toUtf8();
+
+    QByteArray out;
+    for (int i = 0; i < value_bytes.size(); i++) {
+        const bool is_escape = (value_bytes[i] == '\\' && i + 2 < value_bytes.size());
+
+        if (is_escape) {
+            out.append(QByteArray::fromHex(value_bytes.mid(i + 1, 2)));
+            i += 2;
+        } else {
+            out.append(value_bytes[i]);
+        }
+    }
+
+    return out;
+}
+
+bool filter_parse(const QString &filter_raw, FilterNode *out) {
+    const QString filter_trimmed = filter_raw.trimmed();
+    if (filter_trimmed.isEmpty()) {
+        return false;
+    }
+
+    // NOTE: a single term may be written without
+    // parentheses, "name=x" is same as "(name=x)"
+    const QString filter = [&]() {
+        if (filter_trimmed.startsWith('(')) {
+            return filter_trimmed;
+        } else {
+            return QString("(%1)").arg(filter_trimmed);
+        }
+    }();
+
+    int i = 0;
+    FilterNode node;
+    const bool parse_success = filter_parse_node(filter, &i, &node);
+    if (!parse_success || i != filter.size()) {
+        return false;
+    }
+
+    *out = node;
+
+    return true;
+}
+
+QString filter_serialize(const FilterNode &node) {
+    switch (node.type) {
+        case FilterNodeType_And:
+        case FilterNodeType_Or: {
+            QString out = (node.type == FilterNodeType_And) ? "(&" : "(|";
+            for (const FilterNode &child : node.children) {
+                out += filter_serialize(child);
+            }
+            out += ")";
+
+            return out;
+        }
+        case FilterNodeType_Not: {
+            const QString child_string = [&]() {
+                if (!node.children.isEmpty()) {
+                    return filter_serialize(node.children[0]);
+                } else {
+                    return QString();
+                }
+            }();
+
+            return QString("(!%1)").arg(child_string);
+        }
+        case FilterNodeType_Equal: return QString("(%1=%2)").arg(node.attribute, filter_serialize_value(node.value));
+        case FilterNodeType_Approx: return QString("(%1~=%2)").arg(node.attribute, filter_serialize_value(node.value));
+        case FilterNodeType_Greater: return QString("(%1>=%2)").arg(node.attribute, filter_serialize_value(node.value));
+        case FilterNodeType_Less: return QString("(%1<=%2)").arg(node.attribute, filter_serialize_value(node.value));
+        case FilterNodeType_Present: return QString("(%1=*)").arg(node.attribute);
+        case FilterNodeType_Substring: {
+            QList<QString> part_list;
+            for (const QByteArray &part : node.substring_list) {
+                part_list.append(filter_serialize_value(part));
+            }
+
+            return QString("(%1=%2)").arg(node.attribute, part_list.join("*"));
+        }
+        case FilterNodeType_Extensible: {
+            QString lhs = node.attribute;
+            if (node.dn_attributes) {
+                lhs += ":dn";
+            }
+            if (!node.rule.isEmpty()) {
+                lhs += ":" + node.rule;
+            }
+
+            return QString("(%1:=%2)").arg(lhs, filter_serialize_value(node.value));
+        }
+    }
+
+    return QString();
+}
+
+FilterNode filter_node_and(const QList<FilterNode> &children) {
+    FilterNode out;
+    out.type = FilterNodeType_And;
+    out.children = children;
+
+    return out;
+}
+
+FilterNode filter_node_or(const QList<FilterNode> &children) {
+    FilterNode out;
+    out.type = FilterNodeType_Or;
+    out.children = children;
+
+    return out;
+}
+
+FilterNode filter_node_not(const FilterNode &child) {
+    FilterNode out;
+    out.type = FilterNodeType_Not;
+    out.children = {child};
+
+    return out;
+}
+
+FilterNode filter_node_condition(const Condition condition, const QString &attribute, const QString &value) {
+    FilterNode term;
+    term.attribute = attribute;
+
+    const QByteArray value_bytes = value.toUtf8();
+
+    switch (condition) {
+        case Condition_Equals:
+        case Condition_NotEquals: {
+            term.type = FilterNodeType_Equal;
+            term.value = value_bytes;
+
+            break;
+        }
+        case Condition_StartsWith: {
+            term.type = FilterNodeType_Substring;
+            term.substring_list = {value_bytes, QByteArray()};
+
+            break;
+        }
+        case Condition_EndsWith: {
+            term.type = FilterNodeType_Substring;
+            term.substring_list = {QByteArray(), value_bytes};
+
+            break;
+        }
+        case Condition_Contains: {
+            term.type = FilterNodeType_Substring;
+            term.substring_list = {QByteArray(), value_bytes, QByteArray()};
+
+            break;
+        }
+        case Condition_Set:
+        case Condition_Unset: {
+            term.type = FilterNodeType_Present;
+
+            break;
+        }
+        case Condition_COUNT: break;
+    }
+
+    const bool is_negated = (condition == Condition_NotEquals || condition == Condition_Unset);
+    if (is_negated) {
+        return filter_node_not(term);
+    } else {
+        return term;
+    }
+}
+
+FilterNode filter_optimize(const FilterNode &node, const AdConfig *adconfig) {
+    switch (node.type) {
+        case FilterNodeType_And:
+        case FilterNodeType_Or: {
+            QList<FilterNode> children;
+            QSet<QString> serialized_set;
+
+            for (const FilterNode &child_raw : node.children) {
+                const FilterNode child = filter_optimize(child_raw, adconfig);
+
+                // "(&(&(a)(b))(c))" => "(&(a)(b)(c))"
+                const QList<FilterNode> term_list = [&]() {
+                    if (child.type == node.type) {
+                        return child.children;
+                    } else {
+                        return QList<FilterNode>({child});
+                    }
+                }();
+
+                for (const FilterNode &term : term_list) {
+                    const QString serialized = filter_serialize(term);
+                    if (serialized_set.contains(serialized)) {
+                        continue;
+                    }
+
+                    serialized_set.insert(serialized);
+                    children.append(term);
+                }
+            }
+
+            if (children.size() == 1) {
+                return children[0];
+            }
+
+            // NOTE: sort is stable so that terms with equal
+            // cost stay in the order given by the user
+            if (node.type == FilterNodeType_And) {
+                std::stable_sort(children.begin(), children.end(),
+                    [adconfig](const FilterNode &a, const FilterNode &b) {
+                        return (filter_term_cost(a, adconfig) < filter_term_cost(b, adconfig));
+                    });
+            }
+
+            FilterNode out = node;
+            out.children = children;
+
+            return out;
+        }
+        case FilterNodeType_Not: {
+            if (node.children.size() != 1) {
+                return node;
+            }
+
+            const FilterNode child = filter_optimize(node.children[0], adconfig);
+
+            // "(!(!(a)))" => "(a)"
+            const bool is_double_negation = (child.type == FilterNodeType_Not && child.children.size() == 1);
+            if (is_double_negation) {
+                return child.children[0];
+            }
+
+            return filter_node_not(child);
+        }
+        case FilterNodeType_Equal: {
+            // NOTE: objectClass is either not indexed or
+            // has a poor index, depending on server.
+            // objectCategory is always indexed.
+            const bool is_object_class = (node.attribute.compare(ATTRIBUTE_OBJECT_CLASS, Qt::CaseInsensitive) == 0);
+            if (is_object_class && adconfig != nullptr) {
+                const QString object_class = QString::fromUtf8(node.value);
+                const QString category = adconfig->get_class_unique_object_category(object_class);
+
+                if (!category.isEmpty()) {
+                    FilterNode out = node;
+                    out.attribute = ATTRIBUTE_OBJECT_CATEGORY;
+                    out.value = category.toUtf8();
+
+                    return out;
+                }
+            }
+
+            return node;
+        }
+        default: break;
+    }
+
+    return node;
+}
+
+QString filter_optimize(const QString &filter, const AdConfig *adconfig) {
+    FilterNode node;
+    const bool parse_success = filter_parse(filter, &node);
+    if (!parse_success) {
+        return filter;
+    }
+
+    const FilterNode optimized = filter_optimize(node, adconfig);
+    const QString out = filter_serialize(optimized);
+
+    return out;
+}
+
+QList<QString> filter_get_slow_reasons(const QString &filter, const AdConfig *adconfig) {
+    if (adconfig == nullptr) {
+        return QList<QString>();
+    }
+
+    FilterNode node;
+    const bool parse_success = filter_parse(filter, &node);
+    if (!parse_success) {
+        return QList<QString>();
+    }
+
+    QList<QString> out;
+    const bool can_use_index = filter_node_can_use_index(node, adconfig, &out);
+    if (can_use_index) {
+        return QList<QString>();
+    }
+
+    out.removeDuplicates();
+
+    return out;
+}
+
+// NOTE: escaping special characters is required, control
+// characters and non-ASCII bytes are escaped so that the
+// filter stays readable and valid UTF-8
+QString filter_escape_internal(const QByteArray &value, const bool escape_non_ascii) {
+    QByteArray out;
+
+    for (const char c : value) {
+        const uchar byte = static_cast<uchar>(c);
+
+        const bool is_special = (c == '*' || c == '(' || c == ')' || c == '\\' || byte == 0);
+        const bool is_control = (byte < 0x20 || byte == 0x7f);
+        const bool is_non_ascii = (byte >= 0x80);
+        const bool need_escape = (is_special || is_control || (escape_non_ascii && is_non_ascii));
+
+        if (need_escape) {
+            out.append('\\');
+            out.append(QByteArray::number(byte, 16).rightJustified(2, '0'));
+        } else {
+            out.append(c);
+        }
+    }
+
+    return QString::fromUtf8(out);
+}
+
+// Values that are valid UTF-8 are serialized as text,
+// other values are treated as binary
+QString filter_serialize_value(const QByteArray &value) {
+    const QString value_string = QString::fromUtf8(value);
+    const bool is_text = (value_string.toUtf8() == value);
+
+    if (is_text) {
+        return filter_escape(value_string);
+    } else {
+        return filter_escape_bytes(value);
+    }
+}
+
+bool filter_parse_node(const QString &filter, int *i, FilterNode *out) {
+    if (*i >= filter.size() || filter[*i] != '(') {
+        return false;
+    }
+    (*i)++;
+
+    if (*i >= filter.size()) {
+        return false;
+    }
+
+    const QChar op = filter[*i];
+    if (op == '&' || op == '|' || op == '!') {
+        (*i)++;
+
+        out->type = [&]() {
+            if (op == '&') {
+                return FilterNodeType_And;
+            } else if (op == '|') {
+                return FilterNodeType_Or;
+            } else {
+                return FilterNodeType_Not;
+            }
+        }();
+
+        while (*i < filter.size() && filter[*i] == '(') {
+            FilterNode child;
+            if (!filter_parse_node(filter, i, &child)) {
+                return false;
+            }
+
+            out->children.append(child);
+        }
+
+        const bool bad_not = (out->type == FilterNodeType_Not && out->children.size() != 1);
+        if (bad_not || *i >= filter.size() || filter[*i] != ')') {
+            return false;
+        }
+        (*i)++;
+
+        return true;
+    }
+
+    // NOTE: values can't contain unescaped parentheses,
+    // so item ends at first closing parenthesis
+    const int end = filter.indexOf(')', *i);
+    if (end == -1) {
+        return false;
+    }
+
+    const QString item = filter.mid(*i, end - *i);
+    *i = end + 1;
+
+    return filter_parse_item(item, out);
+}
+
+bool filter_parse_item(const QString &item, FilterNode *out) {
+    const int equals_i = item.indexOf('=');
+    if (equals_i <= 0) {
+        return false;
+    }
+
+    const QString value = item.mid(equals_i + 1);
+    const QChar before_equals = item[equals_i - 1];
+
+    if (before_equals == ':') {
+        // attr[:dn][:rule]:=value
+        const QList<QString> lhs = item.left(equals_i - 1).split(':');
+
+        out->type = FilterNodeType_Extensible;
+        out->attribute = lhs[0];
+
+        for (int part_i = 1; part_i < lhs.size(); part_i++) {
+            const QString part = lhs[part_i];
+
+            if (part.compare("dn", Qt::CaseInsensitive) == 0) {
+                out->dn_attributes = true;
+            } else {
+                out->rule = part;
+            }
+        }
+
+        out->value = filter_unescape(value);
+
+        return !out->attribute.isEmpty();
+    }
+
+    if (before_equals == '~' || before_equals == '>' || before_equals == '<') {
+        out->type = [&]() {
+            if (before_equals == '~') {
+                return FilterNodeType_Approx;
+            } else if (before_equals == '>') {
+                return FilterNodeType_Greater;
+            } else {
+                return FilterNodeType_Less;
+            }
+        }();
+        out->attribute = item.left(equals_i - 1);
+        out->value = filter_unescape(value);
+
+        return !out->attribute.isEmpty();
+    }
+
+    out->attribute = item.left(equals_i);
+
+    if (value == "*") {
+        out->type = FilterNodeType_Present;
+    } else if (value.contains('*')) {
+        out->type = FilterNodeType_Substring;
+
+        for (const QString &part : value.split('*')) {
+            out->substring_list.append(filter_unescape(part));
+        }
+    } else {
+        out->type = FilterNodeType_Equal;
+        out->value = filter_unescape(value);
+    }
+
+    return true;
+}
+
+bool attribute_has_search_flag(const QString &attribute, const SearchFlagsBit flag, const AdConfig *adconfig) {
+    if (adconfig == nullptr) {
+        return false;
+    }
+
+    const int search_flags = adconfig->get_attribute_search_flags(attribute);
+    const bool out = bitmask_is_set(search_flags, flag);
+
+    return out;
+}
+
+bool attribute_is_indexed(const QString &attribute, const AdConfig *adconfig) {
+    // NOTE: DN's are resolved by the directory itself and
+    // ANR is resolved using ANR attributes, which are
+    // always indexed
+    const bool is_dn = (attribute.compare(ATTRIBUTE_DN, Qt::CaseInsensitive) == 0);
+    const bool is_anr = (attribute.compare(ATTRIBUTE_ANR, Qt::CaseInsensitive) == 0);
+    if (is_dn || is_anr) {
+        return true;
+    }
+
+    return attribute_has_search_flag(attribute, SearchFlagsBit_Indexed, adconfig);
+}
+
+// Returns true if server can find objects matching this
+// node using indexes. Otherwise adds reasons to the list.
+// Reasons list may be null.
+bool filter_node_can_use_index(const FilterNode &node, const AdConfig *adconfig, QList<QString> *reasons) {
+    auto add_reason = [&](const QString &reason) {
+        if (reasons != nullptr) {
+            reasons->append(reason);
+        }
+    };
+
+    switch (node.type) {
+        case FilterNodeType_And: {
+            // NOTE: one indexed term is enough to narrow
+            // down the candidates, other terms are checked
+            // only for them
+            QList<QString> child_reasons;
+            for (const FilterNode &child : node.children) {
+                if (filter_node_can_use_index(child, adconfig, &child_reasons)) {
+                    return true;
+                }
+            }
+
+            if (reasons != nullptr) {
+                reasons->append(child_reasons);
+            }
+
+            return false;
+        }
+        case FilterNodeType_Or: {
+            // NOTE: all terms need to be indexed, otherwise
+            // all objects have to be checked anyway
+            bool out = true;
+            for (const FilterNode &child : node.children) {
+                if (!filter_node_can_use_index(child, adconfig, reasons)) {
+                    out = false;
+                }
+            }
+
+            return out;
+        }
+        case FilterNodeType_Not: {
+            add_reason(QCoreApplication::translate("filter", "Negation can't use an index: %1").arg(filter_serialize(node)));
+
+            return false;
+        }
+        case FilterNodeType_Substring: {
+            const bool has_initial = (!node.substring_list.isEmpty() && !node.substring_list.first().isEmpty());
+            if (has_initial) {
+                break;
+            }
+
+            const bool is_tuple_indexed = attribute_has_search_flag(node.attribute, SearchFlagsBit_TupleIndexed, adconfig);
+            if (is_tuple_indexed) {
+                return true;
+            }
+
+            add_reason(QCoreApplication::translate("filter", "Value starts with a wildcard and attribute \"%1\" has no tuple index: %2").arg(node.attribute, filter_serialize(node)));
+
+            return false;
+        }
+        case FilterNodeType_Extensible: {
+            // NOTE: chain is followed through links
+            if (node.rule == MATCHING_RULE_IN_CHAIN_OID) {
+                return true;
+            }
+
+            add_reason(QCoreApplication::translate("filter", "Matching rule can't use an index: %1").arg(filter_serialize(node)));
+
+            return false;
+        }
+        default: break;
+    }
+
+    if (attribute_is_indexed(node.attribute, adconfig)) {
+        return true;
+    }
+
+    add_reason(QCoreApplication::translate("filter", "Attribute \"%1\" is not indexed: %2").arg(node.attribute, filter_serialize(node)));
+
+    return false;
+}
+
+FilterTermCost filter_term_cost(const FilterNode &node, const AdConfig *adconfig) {
+    if (node.type == FilterNodeType_Not) {
+        return FilterTermCost_Negation;
+    }
+
+    const bool can_use_index = filter_node_can_use_index(node, adconfig, nullptr);
+
+    if (!can_use_index) {
+        return FilterTermCost_Unindexed;
+    } else if (node.type == FilterNodeType_Equal) {
+        return FilterTermCost_IndexedEqual;
+    } else {
+        return FilterTermCost_Indexed;
+    }
+}
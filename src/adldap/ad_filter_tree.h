@@ -0,0 +1,110 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AD_FILTER_TREE_H
+#define AD_FILTER_TREE_H
+
+/**
+ * Filter expression tree. Filters can be parsed from
+ * strings, built from nodes and serialized back to
+ * strings, with values escaped as described in RFC 4515.
+ * Also contains an optimizer that uses schema information
+ * from AdConfig to rewrite filters into equivalent ones
+ * which the server can process faster and a check for
+ * filters which can't use server indexes at all.
+ */
+
+#include "ad_filter.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+class AdConfig;
+
+enum FilterNodeType {
+    FilterNodeType_And,
+    FilterNodeType_Or,
+    FilterNodeType_Not,
+    FilterNodeType_Equal,
+    FilterNodeType_Approx,
+    FilterNodeType_Greater,
+    FilterNodeType_Less,
+    FilterNodeType_Present,
+    FilterNodeType_Substring,
+    FilterNodeType_Extensible,
+};
+
+class FilterNode {
+public:
+    FilterNode();
+
+    FilterNodeType type;
+    QString attribute;
+
+    // Matching rule of extensible filters and whether
+    // ":dn" was specified. Rule may be empty.
+    QString rule;
+    bool dn_attributes;
+
+    // Unescaped value
+    QByteArray value;
+
+    // For substring filters: initial part, any parts and
+    // final part. Initial and final parts may be empty.
+    QList<QByteArray> substring_list;
+
+    QList<FilterNode> children;
+};
+
+// Escapes special characters of a filter value. Escaping
+// bytes version also escapes all non-ASCII bytes, use it
+// for binary values.
+QString filter_escape(const QString &value);
+QString filter_escape_bytes(const QByteArray &value);
+QByteArray filter_unescape(const QString &value);
+
+// Returns false if filter is malformed. Outer parentheses
+// are optional.
+bool filter_parse(const QString &filter, FilterNode *out);
+QString filter_serialize(const FilterNode &node);
+
+FilterNode filter_node_and(const QList<FilterNode> &children);
+FilterNode filter_node_or(const QList<FilterNode> &children);
+FilterNode filter_node_not(const FilterNode &child);
+FilterNode filter_node_condition(const Condition condition, const QString &attribute, const QString &value = QString());
+
+// Rewrites filter into an equivalent filter that is faster
+// to process: flattens nested AND's and OR's, removes
+// duplicate terms and double negations, replaces
+// objectClass terms with objectCategory terms where that
+// doesn't change results and moves indexed terms of AND's
+// to the front. Schema rewrites are skipped if adconfig is
+// null. Malformed and empty filters are returned as is.
+FilterNode filter_optimize(const FilterNode &node, const AdConfig *adconfig);
+QString filter_optimize(const QString &filter, const AdConfig *adconfig);
+
+// Returns reasons why filter can't be processed using
+// server indexes, which means that all objects in search
+// scope have to be checked. Returns empty list if filter
+// can use indexes or if it can't be determined.
+QList<QString> filter_get_slow_reasons(const QString &filter, const AdConfig *adconfig);
+
+#endif /* AD_FILTER_TREE_H */
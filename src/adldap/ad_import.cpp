@@ -0,0 +1,187 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ad_import.h"
+
+#include "ad_csv.h"
+
+#include <QCoreApplication>
+#include <QPair>
+
+#include <algorithm>
+
+// Number of requests that are sent without waiting for
+// results. Large enough to hide round trip latency, small
+// enough to not overload the server.
+#define IMPORT_WINDOW_SIZE_DEFAULT 32
+
+#define IMPORT_MAX_RETRIES_DEFAULT 2
+
+int ad_import_dn_depth(const QString &dn);
+
+AdImportOptions::AdImportOptions() {
+    window_size = IMPORT_WINDOW_SIZE_DEFAULT;
+    max_retries = IMPORT_MAX_RETRIES_DEFAULT;
+    update_existing = false;
+}
+
+AdImportReport::AdImportReport() {
+    total_count = 0;
+    added_count = 0;
+    updated_count = 0;
+    skipped_count = 0;
+}
+
+bool AdImportReport::is_ok() const {
+    return (failures.isEmpty() && skipped_count == 0);
+}
+
+QString AdImportReport::failures_text() const {
+    QString out;
+
+    for (const AdImportFailure &failure : failures) {
+        out += QString("%1: %2\n").arg(failure.dn, failure.error);
+    }
+
+    return out;
+}
+
+// NOTE: parent always has less RDN's than it's child, so
+// sorting by depth puts parents first. Stable sort keeps
+// the original order of siblings.
+QList<LdifEntry> ad_import_sort_entries(const QList<LdifEntry> &entry_list) {
+    QList<QPair<int, int>> depth_list;
+    for (int i = 0; i < entry_list.size(); i++) {
+        const int depth = ad_import_dn_depth(entry_list[i].dn);
+
+        depth_list.append({depth, i});
+    }
+
+    std::stable_sort(depth_list.begin(), depth_list.end(),
+        [](const QPair<int, int> &a, const QPair<int, int> &b) {
+            return (a.first < b.first);
+        });
+
+    QList<LdifEntry> out;
+    for (const QPair<int, int> &pair : depth_list) {
+        out.append(entry_list[pair.second]);
+    }
+
+    return out;
+}
+
+bool ad_import_entries_from_csv(const QByteArray &data, QList<LdifEntry> *entry_list, QString *error, const bool keep_empty) {
+    QList<QList<QString>> row_list;
+    const bool parse_success = csv_parse(data, &row_list, error);
+    if (!parse_success) {
+        return false;
+    }
+
+    if (row_list.isEmpty()) {
+        return true;
+    }
+
+    const QList<QString> header = row_list.takeFirst();
+
+    int dn_column = -1;
+    for (int i = 0; i < header.size(); i++) {
+        if (header[i].compare("dn", Qt::CaseInsensitive) == 0) {
+            dn_column = i;
+
+            break;
+        }
+    }
+
+    if (dn_column == -1) {
+        *error = QCoreApplication::translate("ad_import", "CSV header doesn't contain \"dn\" column.");
+
+        return false;
+    }
+
+    for (int row_i = 0; row_i < row_list.size(); row_i++) {
+        const QList<QString> &row = row_list[row_i];
+
+        // NOTE: skip blank lines
+        const bool row_is_blank = (row.size() == 1 && row[0].isEmpty());
+        if (row_is_blank) {
+            continue;
+        }
+
+        if (row.size() != header.size()) {
+            *error = QCoreApplication::translate("ad_import", "Row %1 has %2 fields, but header has %3.").arg(row_i + 2).arg(row.size()).arg(header.size());
+
+            return false;
+        }
+
+        LdifEntry entry;
+        entry.dn = row[dn_column];
+
+        for (int i = 0; i < header.size(); i++) {
+            const QString &field = row[i];
+
+            if (i == dn_column) {
+                continue;
+            }
+
+            if (field.isEmpty()) {
+                if (keep_empty && !entry.attributes.contains(header[i])) {
+                    entry.attributes[header[i]] = QList<QByteArray>();
+                }
+
+                continue;
+            }
+
+            for (const QString &value : field.split(";")) {
+                entry.attributes[header[i]].append(value.toUtf8());
+            }
+        }
+
+        entry_list->append(entry);
+    }
+
+    return true;
+}
+
+QString ad_import_dn_parent(const QString &dn) {
+    for (int i = 0; i < dn.size(); i++) {
+        const QChar c = dn[i];
+
+        if (c == '\\') {
+            // Skip escaped character
+            i++;
+        } else if (c == ',') {
+            return dn.mid(i + 1);
+        }
+    }
+
+    return QString();
+}
+
+int ad_import_dn_depth(const QString &dn) {
+    int out = 0;
+
+    QString current = dn;
+    while (!current.isEmpty()) {
+        current = ad_import_dn_parent(current);
+        out++;
+    }
+
+    return out;
+}
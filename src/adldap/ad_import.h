@@ -0,0 +1,101 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AD_IMPORT_H
+#define AD_IMPORT_H
+
+/**
+ * Types and helpers for bulk import of objects, which is
+ * done by AdInterface::import_entries(). Entries are
+ * created so that parents are created before their
+ * children, each entry with one add request that contains
+ * all of it's attributes.
+ */
+
+#include "ad_ldif.h"
+
+#include <QList>
+#include <QString>
+
+#include <functional>
+
+class AdImportOptions {
+public:
+    AdImportOptions();
+
+    // Max number of requests that are sent to server
+    // without waiting for their results
+    int window_size;
+
+    // Number of times a request is repeated after a
+    // transient error, like server being busy
+    int max_retries;
+
+    // If object already exists, replace values of it's
+    // attributes instead of failing
+    bool update_existing;
+};
+
+class AdImportFailure {
+public:
+    QString dn;
+    QString error;
+    int attempts;
+};
+
+class AdImportReport {
+public:
+    AdImportReport();
+
+    int total_count;
+    int added_count;
+    int updated_count;
+
+    // Entries that were not processed because import was
+    // stopped or connection was lost
+    int skipped_count;
+
+    QList<AdImportFailure> failures;
+
+    bool is_ok() const;
+
+    // Returns failures as text, one per line, in
+    // "dn: error" format
+    QString failures_text() const;
+};
+
+typedef std::function<void(const int done_count, const int total_count)> AdImportProgressCallback;
+
+// Returns entries sorted so that parents are before their
+// children. Otherwise, order of entries is preserved.
+QList<LdifEntry> ad_import_sort_entries(const QList<LdifEntry> &entry_list);
+
+// Unlike dn_get_parent(), handles escaped commas in RDN's
+// and returns empty string for DN's without a parent
+QString ad_import_dn_parent(const QString &dn);
+
+// Converts CSV to entries. Header must contain "dn" column,
+// other columns are attributes. Multiple values are
+// separated by ";". Empty fields are skipped, unless
+// "keep_empty" is true, in which case the attribute is
+// added with no values.
+bool ad_import_entries_from_csv(const QByteArray &data, QList<LdifEntry> *entry_list, QString *error, const bool keep_empty = false);
+
+#endif /* AD_IMPORT_H */
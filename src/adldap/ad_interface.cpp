@@ -21,6 +21,7 @@
 #include "ad_interface.h"
 #include "ad_interface_p.h"
 
+#include "ad_backend.h"
 #include "ad_config.h"
 #include "ad_display.h"
 #include "ad_object.h"
@@ -34,6 +35,8 @@
 #include "samba/security_descriptor.h"
 
 #include "ad_filter.h"
+#include "ad_filter_tree.h"
+#include "ad_import.h"
 
 #include <cstdio>
 #include <cstdlib>
@@ -49,8 +52,14 @@
 #include <sys/types.h>
 #include <uuid/uuid.h>
 
+#include <QAtomicInt>
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QMap>
 #include <QTextCodec>
+#include <QThread>
+#include <QThreadStorage>
+#include <QVector>
 
 // NOTE: LDAP library char* inputs are non-const in the API
 // but are const for practical purposes so we use forced
@@ -67,6 +76,24 @@
 #define MAX_DN_LENGTH 1024
 #define MAX_PASSWORD_LENGTH 255
 
+// Max number of SMB contexts used in parallel for
+// operations on GPT contents
+#define GPT_WORKER_COUNT 4
+
+// Number of GPO's verified in parallel before results are
+// passed to caller
+#define GPO_VERIFY_BATCH_SIZE 50
+
+// Time to wait for a result of a bulk import request
+// before giving up on the connection, in seconds
+#define IMPORT_RESULT_TIMEOUT 120
+
+// Delay before resending a bulk import request after a
+// transient error, in milliseconds. Doubled for every
+// following attempt, up to IMPORT_RETRY_DELAY_MAX.
+#define IMPORT_RETRY_DELAY 250
+#define IMPORT_RETRY_DELAY_MAX 8000
+
 typedef struct sasl_defaults_gssapi {
     char *mech;
     char *realm;
@@ -80,13 +107,80 @@ enum AceMaskFormat {
     AceMaskFormat_Decimal,
 };
 
+// Calls function for indexes taken from a shared counter
+// until all indexes are processed or function returns
+// false. Counter and stop flag are shared between all
+// workers of a batch.
+class SmbWorker final : public QThread {
+public:
+    SmbWorker(SMBCCTX *context, const int count, QAtomicInt *next_index, QAtomicInt *stopped, const SmbFunction &function);
+
+    void run() override;
+
+private:
+    SMBCCTX *context;
+    int count;
+    QAtomicInt *next_index;
+    QAtomicInt *stopped;
+    SmbFunction function;
+};
+
+// Converts mod list to an array of LDAPMod's for libldap.
+// Array points to storage owned by this object, so it is
+// only valid while this object is alive.
+class LdapModArray final {
+public:
+    LdapModArray(const QList<AdBackendMod> &mod_list);
+
+    LDAPMod **get();
+
+private:
+    QVector<QByteArray> type_storage;
+    QVector<LDAPMod> mod_storage;
+    QVector<LDAPMod *> mods;
+    QVector<QVector<struct berval>> bvalue_storage;
+    QVector<QVector<struct berval *>> bvalues;
+
+    Q_DISABLE_COPY(LdapModArray)
+};
+
+// Request of bulk import that was sent and is waiting for
+// result
+class ImportRequest {
+public:
+    int index;
+    bool is_update;
+    QElapsedTimer timer;
+};
+
+// SMB context owned by a thread. Freed when the thread
+// exits.
+class SmbThreadContext final {
+public:
+    SmbThreadContext(SMBCCTX *context);
+    ~SmbThreadContext();
+
+    SMBCCTX *context;
+
+    Q_DISABLE_COPY(SmbThreadContext)
+};
+
 QList<QString> query_server_for_hosts(const char *dname);
 int sasl_interact_gssapi(LDAP *ld, unsigned flags, void *indefaults, void *in);
 QString get_gpt_sd_string(const AdObject &gpc_object, const AceMaskFormat format);
+QList<QString> gpc_perms_attributes();
 int create_sd_control(bool get_sacl, int is_critical, LDAPControl **ctrlp, bool set_dacl = false);
+SMBCCTX *smb_context_new();
+SMBCCTX *smb_thread_context();
+bool gpt_ini_parse_version(const QByteArray &ini_contents, int *version_out);
+QList<AdBackendMod> import_mod_list(const LdifEntry &entry, const bool is_update);
+bool import_result_is_transient(const int result);
 
 AdConfig *AdInterfacePrivate::adconfig = nullptr;
+AdBackend *AdInterfacePrivate::s_backend = nullptr;
 bool AdInterfacePrivate::s_log_searches = false;
+QHash<QString, bool> AdInterfacePrivate::s_domain_admin_cache = QHash<QString, bool>();
+AdObjectCache AdInterfacePrivate::s_object_cache;
 QString AdInterfacePrivate::s_dc = QString();
 bool AdInterfacePrivate::s_domain_is_default = true;
 QString AdInterfacePrivate::s_custom_domain = QString();
@@ -95,6 +189,7 @@ int AdInterfacePrivate::s_port = 0;
 CertStrategy AdInterfacePrivate::s_cert_strat = CertStrategy_Never;
 SMBCCTX *AdInterfacePrivate::smbc = NULL;
 QMutex AdInterfacePrivate::mutex;
+QThreadStorage<SmbThreadContext *> smb_thread_contexts;
 
 void get_auth_data_fn(const char *pServer, const char *pShare, char *pWorkgroup, int maxLenWorkgroup, char *pUsername, int maxLenUsername, char *pPassword, int maxLenPassword) {
     UNUSED_ARG(pServer);
@@ -107,6 +202,77 @@ void get_auth_data_fn(const char *pServer, const char *pShare, char *pWorkgroup,
     UNUSED_ARG(maxLenPassword);
 }
 
+// Creates an additional SMB context, setup the same way as
+// the main one. Returns NULL on failure.
+SMBCCTX *smb_context_new() {
+    SMBCCTX *context = smbc_new_context();
+    if (context == NULL) {
+        return NULL;
+    }
+
+    smbc_setFunctionAuthData(context, get_auth_data_fn);
+    smbc_setOptionUseKerberos(context, true);
+    smbc_setOptionFallbackAfterKerberos(context, true);
+
+    if (!smbc_init_context(context)) {
+        smbc_free_context(context, 1);
+
+        return NULL;
+    }
+
+    return context;
+}
+
+SmbThreadContext::SmbThreadContext(SMBCCTX *context_arg) {
+    context = context_arg;
+}
+
+SmbThreadContext::~SmbThreadContext() {
+    smbc_free_context(context, 1);
+}
+
+// Returns SMB context of current thread, creating it on
+// first call. Context stays alive until thread exits, so
+// long-lived threads don't have to setup a new context
+// for every operation. Returns NULL on failure.
+SMBCCTX *smb_thread_context() {
+    if (!smb_thread_contexts.hasLocalData()) {
+        SMBCCTX *context = smb_context_new();
+        if (context == NULL) {
+            return NULL;
+        }
+
+        smb_thread_contexts.setLocalData(new SmbThreadContext(context));
+    }
+
+    return smb_thread_contexts.localData()->context;
+}
+
+SmbWorker::SmbWorker(SMBCCTX *context_arg, const int count_arg, QAtomicInt *next_index_arg, QAtomicInt *stopped_arg, const SmbFunction &function_arg)
+: QThread() {
+    context = context_arg;
+    count = count_arg;
+    next_index = next_index_arg;
+    stopped = stopped_arg;
+    function = function_arg;
+}
+
+void SmbWorker::run() {
+    while (stopped->loadAcquire() == 0) {
+        const int index = next_index->fetchAndAddOrdered(1);
+        if (index >= count) {
+            break;
+        }
+
+        const bool success = function(context, index);
+        if (!success) {
+            stopped->storeRelease(1);
+
+            break;
+        }
+    }
+}
+
 AdInterface::AdInterface() {
     d = new AdInterfacePrivate(this);
 
@@ -114,6 +280,18 @@ AdInterface::AdInterface() {
 
     d->ld = NULL;
 
+    d->backend = AdInterfacePrivate::s_backend;
+    d->backend_result = LDAP_SUCCESS;
+
+    if (d->backend != nullptr) {
+        d->domain = d->backend->domain();
+        d->dc = d->backend->dc();
+        d->client_user = d->backend->client_user();
+        d->is_connected = true;
+
+        return;
+    }
+
     const QString connect_error_context = tr("Failed to connect.");
 
     if (AdInterfacePrivate::s_domain_is_default)
@@ -187,6 +365,13 @@ void AdInterface::set_config(AdConfig *config_arg) {
     AdInterfacePrivate::adconfig = config_arg;
 }
 
+void AdInterface::set_backend(AdBackend *backend) {
+    AdInterfacePrivate::s_backend = backend;
+
+    // NOTE: cached objects belong to previous directory
+    AdInterfacePrivate::s_object_cache.clear();
+}
+
 void AdInterface::set_log_searches(const bool enabled) {
     AdInterfacePrivate::s_log_searches = enabled;
 }
@@ -226,6 +411,12 @@ AdInterfacePrivate::AdInterfacePrivate(AdInterface *q_arg) {
     mutex.lock();
     q = q_arg;
     mutex.unlock();
+
+    cache_search_results = true;
+}
+
+void AdInterface::set_cache_search_results(const bool enabled) {
+    d->cache_search_results = enabled;
 }
 
 bool AdInterface::is_connected() const {
@@ -302,9 +493,15 @@ bool AdInterfacePrivate::search_paged_internal(const char *base, const int scope
     }
     LDAPControl *server_controls[3] = {page_control, sd_control, NULL};
 
+    AdOperationRecord *record = cookie->record;
+
     // Perform search
+    QElapsedTimer wait_timer;
+    wait_timer.start();
     const int attrsonly = 0;
     result = ldap_search_ext_s(ld, base, scope, filter, attributes, attrsonly, server_controls, NULL, NULL, LDAP_NO_LIMIT, &res);
+    const qint64 wait_time = wait_timer.nsecsElapsed() / 1000;
+    record->wait_time += wait_time;
 
     if ((result != LDAP_SUCCESS) && (result != LDAP_PARTIAL_RESULTS)) {
         // NOTE: it's not really an error for an object to
@@ -319,10 +516,19 @@ bool AdInterfacePrivate::search_paged_internal(const char *base, const int scope
         return false;
     }
 
+    const int entry_count = ldap_count_entries(ld, res);
+    if (entry_count > 0 && record->first_entry_time < 0) {
+        record->first_entry_time = record->total_time + wait_time;
+    }
+    record->entries += entry_count;
+
     // Collect results for this search
+    QElapsedTimer decode_timer;
+    decode_timer.start();
     for (LDAPMessage *entry = ldap_first_entry(ld, res); entry != NULL; entry = ldap_next_entry(ld, entry)) {
         char *dn_cstr = ldap_get_dn(ld, entry);
         const QString dn(dn_cstr);
+        record->bytes += strlen(dn_cstr);
         ldap_memfree(dn_cstr);
 
         QHash<QString, QList<QByteArray>> object_attributes;
@@ -339,6 +545,7 @@ bool AdInterfacePrivate::search_paged_internal(const char *base, const int scope
                     for (int i = 0; i < values_count; i++) {
                         struct berval value_berval = *values_ldap[i];
                         const QByteArray value_bytes(value_berval.bv_val, value_berval.bv_len);
+                        record->bytes += value_berval.bv_len;
 
                         out.append(value_bytes);
                     }
@@ -361,6 +568,7 @@ bool AdInterfacePrivate::search_paged_internal(const char *base, const int scope
 
         results->insert(dn, object);
     }
+    record->decode_time += decode_timer.nsecsElapsed() / 1000;
 
     // Parse the results to retrieve returned controls
     int errcodep;
@@ -435,20 +643,65 @@ bool AdInterface::search_paged(const QString &base, const SearchScope scope, con
     if (need_to_log) {
         const QString attributes_string = "{" + attributes.join(",") + "}";
 
-        const QString scope_string = [&scope]() -> QString {
-            switch (scope) {
-                case SearchScope_Object: return "object";
-                case SearchScope_Children: return "children";
-                case SearchScope_Descendants: return "descendants";
-                case SearchScope_All: return "all";
-                default: break;
-            }
-            return QString();
-        }();
+        const QString scope_string = search_scope_string(scope);
 
         d->success_message(QString(tr("Search:\n\tfilter = \"%1\"\n\tattributes = %2\n\tscope = \"%3\"\n\tbase = \"%4\"")).arg(filter, attributes_string, scope_string, base));
     }
 
+#ifdef QT_DEBUG
+    // NOTE: searches for multiple objects without a list
+    // of attributes return every attribute of every
+    // object, including large ones like security
+    // descriptors and certificates. Callers should request
+    // only attributes they use.
+    const bool unprojected = (is_first_page && scope != SearchScope_Object && attributes.isEmpty());
+    if (unprojected) {
+        qWarning() << "Search without attribute list, base =" << base << ", scope =" << search_scope_string(scope);
+    }
+#endif
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (cookie->record == nullptr) {
+        cookie->record = new AdOperationRecord();
+        cookie->record->type = AdOperationType_Search;
+        cookie->record->start = QDateTime::currentDateTime();
+        cookie->record->base = base;
+        cookie->record->scope = scope;
+        cookie->record->filter_hash = qHash(filter);
+    }
+
+    // NOTE: results of this page are collected separately
+    // so that only they are added to the cache and not
+    // results of previous pages
+    QHash<QString, AdObject> page_results;
+
+    if (d->backend != nullptr) {
+        d->backend_result = d->backend->search(base, scope, filter, attributes, &page_results, &cookie->offset);
+
+        const qint64 elapsed = timer.nsecsElapsed() / 1000;
+        const int page_entries = page_results.size();
+        cookie->record->wait_time += elapsed;
+        cookie->record->entries += page_entries;
+        if (page_entries > 0 && cookie->record->first_entry_time < 0) {
+            cookie->record->first_entry_time = cookie->record->total_time + elapsed;
+        }
+
+        if (d->backend_result != LDAP_SUCCESS) {
+            results->clear();
+
+            d->search_record_page(cookie, timer, false);
+
+            return false;
+        }
+
+        d->search_add_page(page_results, attributes, results, get_sacl);
+        d->search_record_page(cookie, timer, true);
+
+        return true;
+    }
+
     const char *base_cstr = cstr(base);
 
     const int scope_int = [&]() {
@@ -461,13 +714,20 @@ bool AdInterface::search_paged(const QString &base, const SearchScope scope, con
         return 0;
     }();
 
+    // NOTE: filter is rewritten into an equivalent one
+    // that is faster for the server to process. This is
+    // only done for the server, the memory backend doesn't
+    // use indexes. Rewrite is deterministic, so all pages
+    // of a search get the same filter.
+    const QString optimized_filter = filter_optimize(filter, d->adconfig);
+
     const char *filter_cstr = [&]() {
-        if (filter.isEmpty()) {
+        if (optimized_filter.isEmpty()) {
             // NOTE: need to pass NULL instead of empty
             // string to denote "no filter"
             return (const char *) NULL;
         } else {
-            return cstr(filter);
+            return cstr(optimized_filter);
         }
     }();
 
@@ -488,10 +748,12 @@ bool AdInterface::search_paged(const QString &base, const SearchScope scope, con
         }
     }
 
-    const bool search_success = d->search_paged_internal(base_cstr, scope_int, filter_cstr, attributes_array, results, cookie, get_sacl);
+    const bool search_success = d->search_paged_internal(base_cstr, scope_int, filter_cstr, attributes_array, &page_results, cookie, get_sacl);
     if (!search_success) {
         results->clear();
 
+        d->search_record_page(cookie, timer, false);
+
         return false;
     }
 
@@ -502,9 +764,63 @@ bool AdInterface::search_paged(const QString &base, const SearchScope scope, con
         free(attributes_array);
     }
 
+    d->search_add_page(page_results, attributes, results, get_sacl);
+    d->search_record_page(cookie, timer, true);
+
     return true;
 }
 
+void AdInterfacePrivate::search_add_page(const QHash<QString, AdObject> &page_results, const QList<QString> &attributes, QHash<QString, AdObject> *results, const bool get_sacl) {
+    // NOTE: security descriptors loaded with SACL differ
+    // from default ones, so don't mix them in the cache
+    const bool can_cache = (!get_sacl && cache_search_results);
+
+    for (const AdObject &object : page_results) {
+        if (can_cache) {
+            s_object_cache.insert(object, attributes);
+        }
+
+        results->insert(object.get_dn(), object);
+    }
+}
+
+void AdInterfacePrivate::search_record_page(AdCookie *cookie, const QElapsedTimer &timer, const bool success) {
+    AdOperationRecord *record = cookie->record;
+
+    record->pages++;
+    record->total_time += timer.nsecsElapsed() / 1000;
+
+    if (!success) {
+        record->result = get_ldap_result();
+
+        // NOTE: failed search can have a success result
+        // code if it failed on the client side
+        if (record->result == LDAP_SUCCESS) {
+            record->result = LDAP_OTHER;
+        }
+    }
+
+    const bool search_finished = (!success || !cookie->more_pages());
+    if (search_finished) {
+        ad_metrics_record(*record);
+
+        delete cookie->record;
+        cookie->record = nullptr;
+    }
+}
+
+void AdInterfacePrivate::record_operation(const AdOperationType type, const QString &dn, const int result, const QElapsedTimer &timer) {
+    AdOperationRecord record;
+    record.type = type;
+    record.base = dn;
+    record.result = result;
+    record.total_time = timer.nsecsElapsed() / 1000;
+    record.wait_time = record.total_time;
+    record.start = QDateTime::currentDateTime().addMSecs(-record.total_time / 1000);
+
+    ad_metrics_record(record);
+}
+
 AdObject AdInterface::search_object(const QString &dn, const QList<QString> &attributes, const bool get_sacl) {
     const QString base = dn;
     const SearchScope scope = SearchScope_Object;
@@ -518,6 +834,48 @@ AdObject AdInterface::search_object(const QString &dn, const QList<QString> &att
     }
 }
 
+AdObject AdInterface::search_object_cached(const QString &dn, const QList<QString> &attributes, const int max_age) {
+    if (max_age == CacheMaxAge_None) {
+        return search_object(dn, attributes);
+    }
+
+    AdObject cached_object;
+    QList<QString> missing;
+    const bool cache_hit = AdInterfacePrivate::s_object_cache.get(dn, attributes, max_age, &cached_object, &missing);
+
+    if (cache_hit) {
+        return cached_object;
+    }
+
+    // NOTE: if all attributes were requested, "missing" is
+    // empty which also loads all attributes
+    const AdObject loaded_object = search_object(dn, missing);
+
+    // Object doesn't exist anymore
+    // NOTE: need to check both because rootDSE has empty DN
+    const bool object_not_found = (loaded_object.get_dn().isEmpty() && loaded_object.is_empty());
+    if (object_not_found) {
+        AdInterfacePrivate::s_object_cache.invalidate_object(dn);
+
+        return AdObject();
+    }
+
+    QHash<QString, QList<QByteArray>> attributes_data = cached_object.get_attributes_data();
+    const QHash<QString, QList<QByteArray>> loaded_data = loaded_object.get_attributes_data();
+    for (auto it = loaded_data.begin(); it != loaded_data.end(); it++) {
+        attributes_data[it.key()] = it.value();
+    }
+
+    AdObject out;
+    out.load(loaded_object.get_dn(), attributes_data);
+
+    return out;
+}
+
+AdObjectCache *AdInterface::object_cache() {
+    return &AdInterfacePrivate::s_object_cache;
+}
+
 bool AdInterface::attribute_replace_values(const QString &dn, const QString &attribute, const QList<QByteArray> &values, const DoStatusMsg do_msg, const bool set_dacl) {
     const AdObject object = search_object(dn, {attribute});
     const QList<QByteArray> old_values = object.get_values(attribute);
@@ -569,9 +927,22 @@ bool AdInterface::attribute_replace_values(const QString &dn, const QString &att
         server_controls[0] = sd_control;
     }
 
-    result = ldap_modify_ext_s(d->ld, cstr(dn), attrs, server_controls, NULL);
+    QElapsedTimer timer;
+    timer.start();
+
+    if (d->backend != nullptr) {
+        const AdBackendMod mod = {AdBackendModOp_Replace, attribute, values};
+        result = d->backend->modify(dn, {mod});
+        d->backend_result = result;
+    } else {
+        result = ldap_modify_ext_s(d->ld, cstr(dn), attrs, server_controls, NULL);
+    }
+
+    d->record_operation(AdOperationType_Modify, dn, result, timer);
 
     if (result == LDAP_SUCCESS) {
+        d->invalidate_modified(dn, old_values + values);
+
         d->success_message(QString(tr("Attribute %1 of object %2 was changed from \"%3\" to \"%4\".")).arg(attribute, name, old_values_display, values_display), do_msg);
 
         return true;
@@ -616,9 +987,27 @@ bool AdInterface::attribute_add_value(const QString &dn, const QString &attribut
 
     LDAPMod *attrs[] = {&attr, NULL};
 
-    const int result = ldap_modify_ext_s(d->ld, cstr(dn), attrs, NULL, NULL);
+    QElapsedTimer timer;
+    timer.start();
+
+    const int result = [&]() {
+        if (d->backend != nullptr) {
+            const AdBackendMod mod = {AdBackendModOp_Add, attribute, {value}};
+            d->backend_result = d->backend->modify(dn, {mod});
+
+            return d->backend_result;
+        } else {
+            return ldap_modify_ext_s(d->ld, cstr(dn), attrs, NULL, NULL);
+        }
+    }();
+
+    d->record_operation(AdOperationType_Modify, dn, result, timer);
     free(data_copy);
 
+    if (result == LDAP_SUCCESS) {
+        d->invalidate_modified(dn, {value});
+    }
+
     const QString name = dn_get_name(dn);
     const QString new_display_value = attribute_display_value(attribute, value, d->adconfig);
 
@@ -659,9 +1048,27 @@ bool AdInterface::attribute_delete_value(const QString &dn, const QString &attri
 
     LDAPMod *attrs[] = {&attr, NULL};
 
-    const int result = ldap_modify_ext_s(d->ld, cstr(dn), attrs, NULL, NULL);
+    QElapsedTimer timer;
+    timer.start();
+
+    const int result = [&]() {
+        if (d->backend != nullptr) {
+            const AdBackendMod mod = {AdBackendModOp_Delete, attribute, {value}};
+            d->backend_result = d->backend->modify(dn, {mod});
+
+            return d->backend_result;
+        } else {
+            return ldap_modify_ext_s(d->ld, cstr(dn), attrs, NULL, NULL);
+        }
+    }();
+
+    d->record_operation(AdOperationType_Modify, dn, result, timer);
     free(data_copy);
 
+    if (result == LDAP_SUCCESS) {
+        d->invalidate_modified(dn, {value});
+    }
+
     if (result == LDAP_SUCCESS) {
         const QString context = QString(tr("Value \"%1\" for attribute %2 of object %3 was deleted.")).arg(value_display, attribute, name);
 
@@ -697,7 +1104,81 @@ bool AdInterface::attribute_replace_datetime(const QString &dn, const QString &a
     return result;
 }
 
+bool AdInterface::attribute_modify(const QString &dn, const QList<AdBackendMod> &mod_list, const DoStatusMsg do_msg) {
+    if (mod_list.isEmpty()) {
+        return true;
+    }
+
+    const QString name = dn_get_name(dn);
+
+    const QString attributes_display = [&]() {
+        QList<QString> out;
+
+        for (const AdBackendMod &mod : mod_list) {
+            if (!out.contains(mod.attribute)) {
+                out.append(mod.attribute);
+            }
+        }
+
+        return QStringList(out).join(", ");
+    }();
+
+    QList<QByteArray> all_values;
+    for (const AdBackendMod &mod : mod_list) {
+        all_values.append(mod.values);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const int result = [&]() {
+        if (d->backend != nullptr) {
+            d->backend_result = d->backend->modify(dn, mod_list);
+
+            return d->backend_result;
+        }
+
+        // NOTE: not using cstr() so that this f-n can be
+        // used by multiple threads at the same time
+        const QByteArray dn_bytes = dn.toUtf8();
+
+        LdapModArray mods(mod_list);
+
+        return ldap_modify_ext_s(d->ld, dn_bytes.constData(), mods.get(), NULL, NULL);
+    }();
+
+    d->record_operation(AdOperationType_Modify, dn, result, timer);
+
+    if (result == LDAP_SUCCESS) {
+        d->invalidate_modified(dn, all_values);
+
+        d->success_message(QString(tr("Attributes %1 of object %2 were changed.")).arg(attributes_display, name), do_msg);
+
+        return true;
+    } else {
+        const QString context = QString(tr("Failed to change attributes %1 of object %2.")).arg(attributes_display, name);
+
+        d->error_message(context, d->default_error(), do_msg);
+
+        return false;
+    }
+}
+
 bool AdInterface::object_add(const QString &dn, const QHash<QString, QList<QString>> &attrs_map) {
+    QElapsedTimer timer;
+    timer.start();
+
+    if (d->backend != nullptr) {
+        QHash<QString, QList<QByteArray>> attributes;
+        for (auto it = attrs_map.begin(); it != attrs_map.end(); it++) {
+            for (const QString &value : it.value()) {
+                attributes[it.key()].append(value.toUtf8());
+            }
+        }
+
+        d->backend_result = d->backend->add(dn, attributes);
+    }
+
     LDAPMod **attrs = [&attrs_map]() {
         LDAPMod **out = (LDAPMod **) malloc((attrs_map.size() + 1) * sizeof(LDAPMod *));
 
@@ -727,11 +1208,33 @@ bool AdInterface::object_add(const QString &dn, const QHash<QString, QList<QStri
         return out;
     }();
 
-    const int result = ldap_add_ext_s(d->ld, cstr(dn), attrs, NULL, NULL);
+    const int result = [&]() {
+        if (d->backend != nullptr) {
+            return d->backend_result;
+        } else {
+            return ldap_add_ext_s(d->ld, cstr(dn), attrs, NULL, NULL);
+        }
+    }();
+
+    d->record_operation(AdOperationType_Add, dn, result, timer);
 
     ldap_mods_free(attrs, 1);
 
     if (result == LDAP_SUCCESS) {
+        const QList<QByteArray> added_values = [&]() {
+            QList<QByteArray> out;
+
+            for (const QList<QString> &value_list : attrs_map) {
+                for (const QString &value : value_list) {
+                    out.append(value.toUtf8());
+                }
+            }
+
+            return out;
+        }();
+
+        d->invalidate_modified(dn, added_values);
+
         d->success_message(QString(tr("Object %1 was created.")).arg(dn));
 
         return true;
@@ -774,79 +1277,423 @@ bool AdInterface::object_add(const QString &dn, const QString &object_class) {
     return success;
 }
 
-bool AdInterface::object_delete(const QString &dn, const DoStatusMsg do_msg) {
-    int result;
-    LDAPControl *tree_delete_control = NULL;
+AdImportReport AdInterface::import_entries(const QList<LdifEntry> &entry_list, const AdImportOptions &options, const AdImportProgressCallback &progress, const bool *stop_flag) {
+    AdImportReport report;
 
-    auto cleanup = [tree_delete_control]() {
-        ldap_control_free(tree_delete_control);
-    };
+    const QList<LdifEntry> sorted_list = ad_import_sort_entries(entry_list);
+    const int count = sorted_list.size();
+    const int window_size = qMax(1, options.window_size);
 
-    const QString name = dn_get_name(dn);
+    report.total_count = count;
 
-    const QString error_context = QString(tr("Failed to delete object %1.")).arg(name);
+    // Children of each entry that are also imported. They
+    // are sent only after their parent was created.
+    QVector<QList<int>> children_list(count);
+    QList<int> ready_list;
+    {
+        QHash<QString, int> index_map;
+        for (int i = 0; i < count; i++) {
+            index_map[sorted_list[i].dn.toLower()] = i;
+        }
 
-    // Use a tree delete control to enable recursive delete
-    result = ldap_control_create(LDAP_CONTROL_X_TREE_DELETE, 1, NULL, 0, &tree_delete_control);
-    if (result != LDAP_SUCCESS) {
-        d->error_message(error_context, tr("LDAP Operation error - Failed to create tree delete control."));
-        cleanup();
+        for (int i = 0; i < count; i++) {
+            const QString parent = ad_import_dn_parent(sorted_list[i].dn).toLower();
+            const int parent_index = index_map.value(parent, -1);
 
-        return false;
+            if (parent_index != -1 && parent_index < i) {
+                children_list[parent_index].append(i);
+            } else {
+                ready_list.append(i);
+            }
+        }
     }
 
-    LDAPControl *server_controls[2] = {NULL, NULL};
+    QVector<int> attempts(count, 0);
+    QVector<bool> is_update(count, false);
+    QHash<int, ImportRequest> in_flight;
 
-    const bool tree_delete_is_supported = adconfig()->control_is_supported(LDAP_CONTROL_X_TREE_DELETE);
-    if (tree_delete_is_supported) {
-        server_controls[0] = tree_delete_control;
-    }
+    // Entries waiting to be resent after a transient
+    // error. Entries are resent when their retry time,
+    // measured by retry_clock, is reached.
+    QList<int> retry_list;
+    QVector<qint64> retry_time(count, 0);
+    QElapsedTimer retry_clock;
+    retry_clock.start();
 
-    result = ldap_delete_ext_s(d->ld, cstr(dn), server_controls, NULL);
+    // Results of requests that completed without going
+    // through libldap's async API, when using a backend or
+    // when request couldn't be sent. These use negative
+    // id's, which don't clash with LDAP message id's.
+    QList<QPair<int, int>> completed_list;
+    int next_local_id = -1;
 
-    cleanup();
+    int done_count = 0;
 
-    if (result == LDAP_SUCCESS) {
-        d->success_message(QString(tr("Object %1 was deleted.")).arg(name), do_msg);
+    auto fail_entry = [&](const int index, const QString &error) {
+        report.failures.append(AdImportFailure{sorted_list[index].dn, error, attempts[index]});
+        done_count++;
 
-        return true;
-    } else {
-        d->error_message(error_context, d->default_error(), do_msg);
+        // NOTE: children can't be created without parent
+        QList<int> descendant_stack = children_list[index];
+        while (!descendant_stack.isEmpty()) {
+            const int descendant = descendant_stack.takeLast();
+            const QString parent_error = tr("Parent object was not created.");
 
-        return false;
-    }
-}
+            report.failures.append(AdImportFailure{sorted_list[descendant].dn, parent_error, 0});
+            done_count++;
 
-bool AdInterface::object_move(const QString &dn, const QString &new_container) {
-    const QString rdn = dn.split(',')[0];
-    const QString new_dn = rdn + "," + new_container;
-    const QString object_name = dn_get_name(dn);
-    const QString container_name = dn_get_name(new_container);
+            descendant_stack.append(children_list[descendant]);
+        }
+    };
 
-    const int result = ldap_rename_s(d->ld, cstr(dn), cstr(rdn), cstr(new_container), 1, NULL, NULL);
+    auto retry_later = [&](const int index) {
+        const int delay = qMin(IMPORT_RETRY_DELAY << qMin(attempts[index] - 1, 16), IMPORT_RETRY_DELAY_MAX);
 
-    if (result == LDAP_SUCCESS) {
-        d->success_message(QString(tr("Object %1 was moved to %2.")).arg(object_name, container_name));
+        retry_time[index] = retry_clock.elapsed() + delay;
+        retry_list.append(index);
+    };
 
-        return true;
-    } else {
-        const QString context = QString(tr("Failed to move object %1 to %2.")).arg(object_name, container_name);
+    auto send = [&](const int index) {
+        const LdifEntry &entry = sorted_list[index];
+        const QList<AdBackendMod> mod_list = import_mod_list(entry, is_update[index]);
 
-        d->error_message(context, d->default_error());
+        attempts[index]++;
 
-        return false;
-    }
-}
+        ImportRequest request;
+        request.index = index;
+        request.is_update = is_update[index];
+        request.timer.start();
 
-bool AdInterface::object_rename(const QString &dn, const QString &new_name) {
-    const QString new_dn = dn_rename(dn, new_name);
-    const QString new_rdn = new_dn.split(",")[0];
-    const QString old_name = dn_get_name(dn);
+        if (d->backend != nullptr) {
+            const int result = [&]() {
+                if (request.is_update) {
+                    return d->backend->modify(entry.dn, mod_list);
+                } else {
+                    return d->backend->add(entry.dn, entry.attributes);
+                }
+            }();
 
-    const int result = ldap_rename_s(d->ld, cstr(dn), cstr(new_rdn), NULL, 1, NULL, NULL);
+            const int id = next_local_id--;
+            in_flight.insert(id, request);
+            completed_list.append({id, result});
 
-    if (result == LDAP_SUCCESS) {
-        d->success_message(QString(tr("Object %1 was renamed to %2.")).arg(old_name, new_name));
+            return;
+        }
+
+        const QByteArray dn_bytes = entry.dn.toUtf8();
+        LdapModArray mods(mod_list);
+        int msgid;
+
+        // NOTE: requests are encoded and sent right away,
+        // so mods don't need to outlive this call
+        const int send_result = [&]() {
+            if (request.is_update) {
+                return ldap_modify_ext(d->ld, dn_bytes.constData(), mods.get(), NULL, NULL, &msgid);
+            } else {
+                return ldap_add_ext(d->ld, dn_bytes.constData(), mods.get(), NULL, NULL, &msgid);
+            }
+        }();
+
+        if (send_result == LDAP_SUCCESS) {
+            in_flight.insert(msgid, request);
+        } else {
+            const int id = next_local_id--;
+            in_flight.insert(id, request);
+            completed_list.append({id, send_result});
+        }
+    };
+
+    bool connection_lost = false;
+
+    while (true) {
+        const bool stopped = (stop_flag != nullptr && *stop_flag);
+
+        for (int i = 0; i < retry_list.size();) {
+            const int index = retry_list[i];
+
+            if (retry_time[index] <= retry_clock.elapsed()) {
+                ready_list.append(index);
+                retry_list.removeAt(i);
+            } else {
+                i++;
+            }
+        }
+
+        while (!stopped && in_flight.size() < window_size && !ready_list.isEmpty()) {
+            const int index = ready_list.takeFirst();
+
+            send(index);
+        }
+
+        if (in_flight.isEmpty()) {
+            if (stopped || retry_list.isEmpty()) {
+                break;
+            }
+
+            // NOTE: nothing to wait for except retries, so
+            // sleep until the earliest one is due
+            const qint64 next_retry_time = [&]() {
+                qint64 out = retry_time[retry_list[0]];
+                for (const int index : retry_list) {
+                    out = qMin(out, retry_time[index]);
+                }
+
+                return out;
+            }();
+
+            const qint64 sleep_time = next_retry_time - retry_clock.elapsed();
+            if (sleep_time > 0) {
+                QThread::msleep(sleep_time);
+            }
+
+            continue;
+        }
+
+        int id;
+        int result;
+        QString server_error;
+
+        if (!completed_list.isEmpty()) {
+            const QPair<int, int> completed = completed_list.takeFirst();
+            id = completed.first;
+            result = completed.second;
+        } else {
+            struct timeval timeout;
+            timeout.tv_sec = IMPORT_RESULT_TIMEOUT;
+            timeout.tv_usec = 0;
+
+            LDAPMessage *message = NULL;
+            const int wait_result = ldap_result(d->ld, LDAP_RES_ANY, LDAP_MSG_ONE, &timeout, &message);
+
+            if (wait_result <= 0) {
+                // NOTE: results of requests in flight
+                // won't arrive, so fail them and skip
+                // the rest
+                const QString error = [&]() {
+                    if (wait_result == 0) {
+                        return tr("Timed out waiting for server.");
+                    } else {
+                        return d->ldap_result_string(d->get_ldap_result());
+                    }
+                }();
+
+                for (const ImportRequest &request : in_flight) {
+                    fail_entry(request.index, error);
+                }
+
+                in_flight.clear();
+                connection_lost = true;
+
+                break;
+            }
+
+            id = ldap_msgid(message);
+
+            char *error_message = NULL;
+            result = LDAP_OTHER;
+            ldap_parse_result(d->ld, message, &result, NULL, &error_message, NULL, NULL, 1);
+
+            if (error_message != NULL) {
+                server_error = QString(error_message);
+                ldap_memfree(error_message);
+            }
+        }
+
+        if (!in_flight.contains(id)) {
+            continue;
+        }
+
+        const ImportRequest request = in_flight.take(id);
+        const int index = request.index;
+        const LdifEntry &entry = sorted_list[index];
+
+        const AdOperationType operation_type = (request.is_update ? AdOperationType_Modify : AdOperationType_Add);
+        d->record_operation(operation_type, entry.dn, result, request.timer);
+
+        auto get_error = [&]() {
+            QString out = d->ldap_result_string(result);
+
+            if (!server_error.isEmpty()) {
+                out += QString(" (%1)").arg(server_error);
+            }
+
+            return out;
+        };
+
+        if (result == LDAP_SUCCESS) {
+            QList<QByteArray> all_values;
+            for (const QList<QByteArray> &value_list : entry.attributes) {
+                all_values.append(value_list);
+            }
+
+            d->invalidate_modified(entry.dn, all_values);
+
+            if (request.is_update) {
+                report.updated_count++;
+            } else {
+                report.added_count++;
+            }
+
+            done_count++;
+
+            ready_list.append(children_list[index]);
+        } else if (result == LDAP_ALREADY_EXISTS && !request.is_update && options.update_existing) {
+            is_update[index] = true;
+            attempts[index] = 0;
+
+            // NOTE: update goes to the front so that it
+            // doesn't wait for the rest of the queue
+            ready_list.prepend(index);
+        } else if (result == LDAP_ALREADY_EXISTS && !request.is_update) {
+            report.failures.append(AdImportFailure{entry.dn, get_error(), attempts[index]});
+            done_count++;
+
+            // NOTE: entry failed, but the object exists,
+            // so children can still be created in it
+            ready_list.append(children_list[index]);
+        } else if (import_result_is_transient(result) && attempts[index] <= options.max_retries) {
+            retry_later(index);
+        } else {
+            fail_entry(index, get_error());
+        }
+
+        if (progress) {
+            progress(done_count, count);
+        }
+    }
+
+    report.skipped_count = count - done_count;
+
+    if (report.is_ok()) {
+        d->success_message(QString(tr("Imported %1 objects.")).arg(count));
+    } else {
+        const int failed_count = report.failures.size() + report.skipped_count;
+
+        d->error_message_plain(QString(tr("Failed to import %1 of %2 objects.")).arg(failed_count).arg(count));
+
+        if (connection_lost) {
+            d->error_message_plain(tr("Connection to server was lost during import."));
+        }
+    }
+
+    return report;
+}
+
+bool AdInterface::object_delete(const QString &dn, const DoStatusMsg do_msg) {
+    int result;
+    LDAPControl *tree_delete_control = NULL;
+
+    auto cleanup = [tree_delete_control]() {
+        ldap_control_free(tree_delete_control);
+    };
+
+    const QString name = dn_get_name(dn);
+
+    const QString error_context = QString(tr("Failed to delete object %1.")).arg(name);
+
+    // Use a tree delete control to enable recursive delete
+    result = ldap_control_create(LDAP_CONTROL_X_TREE_DELETE, 1, NULL, 0, &tree_delete_control);
+    if (result != LDAP_SUCCESS) {
+        d->error_message(error_context, tr("LDAP Operation error - Failed to create tree delete control."));
+        cleanup();
+
+        return false;
+    }
+
+    LDAPControl *server_controls[2] = {NULL, NULL};
+
+    const bool tree_delete_is_supported = adconfig()->control_is_supported(LDAP_CONTROL_X_TREE_DELETE);
+    if (tree_delete_is_supported) {
+        server_controls[0] = tree_delete_control;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (d->backend != nullptr) {
+        result = d->backend->remove(dn, tree_delete_is_supported);
+        d->backend_result = result;
+    } else {
+        result = ldap_delete_ext_s(d->ld, cstr(dn), server_controls, NULL);
+    }
+
+    d->record_operation(AdOperationType_Delete, dn, result, timer);
+
+    cleanup();
+
+    if (result == LDAP_SUCCESS) {
+        d->invalidate_renamed(dn);
+
+        d->success_message(QString(tr("Object %1 was deleted.")).arg(name), do_msg);
+
+        return true;
+    } else {
+        d->error_message(error_context, d->default_error(), do_msg);
+
+        return false;
+    }
+}
+
+bool AdInterface::object_move(const QString &dn, const QString &new_container) {
+    const QString rdn = dn.split(',')[0];
+    const QString new_dn = rdn + "," + new_container;
+    const QString object_name = dn_get_name(dn);
+    const QString container_name = dn_get_name(new_container);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const int result = [&]() {
+        if (d->backend != nullptr) {
+            d->backend_result = d->backend->rename(dn, rdn, new_container);
+
+            return d->backend_result;
+        } else {
+            return ldap_rename_s(d->ld, cstr(dn), cstr(rdn), cstr(new_container), 1, NULL, NULL);
+        }
+    }();
+
+    d->record_operation(AdOperationType_Rename, dn, result, timer);
+
+    if (result == LDAP_SUCCESS) {
+        d->invalidate_renamed(dn);
+
+        d->success_message(QString(tr("Object %1 was moved to %2.")).arg(object_name, container_name));
+
+        return true;
+    } else {
+        const QString context = QString(tr("Failed to move object %1 to %2.")).arg(object_name, container_name);
+
+        d->error_message(context, d->default_error());
+
+        return false;
+    }
+}
+
+bool AdInterface::object_rename(const QString &dn, const QString &new_name) {
+    const QString new_dn = dn_rename(dn, new_name);
+    const QString new_rdn = new_dn.split(",")[0];
+    const QString old_name = dn_get_name(dn);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const int result = [&]() {
+        if (d->backend != nullptr) {
+            d->backend_result = d->backend->rename(dn, new_rdn, QString());
+
+            return d->backend_result;
+        } else {
+            return ldap_rename_s(d->ld, cstr(dn), cstr(new_rdn), NULL, 1, NULL, NULL);
+        }
+    }();
+
+    d->record_operation(AdOperationType_Rename, dn, result, timer);
+
+    if (result == LDAP_SUCCESS) {
+        d->invalidate_renamed(dn);
+
+        d->success_message(QString(tr("Object %1 was renamed to %2.")).arg(old_name, new_name));
 
         return true;
     } else {
@@ -1183,6 +2030,10 @@ bool AdInterface::gpo_add(const QString &display_name, QString &dn_out) {
         d->error_message(tr("Failed to create GPO."), error);
     };
 
+    if (!d->check_smb_available(tr("Failed to create GPO."))) {
+        return false;
+    }
+
     //
     // Generate UUID used for directory and object names
     //
@@ -1351,27 +2202,28 @@ bool AdInterface::gpo_add(const QString &display_name, QString &dn_out) {
     return true;
 }
 
-QList<QString> AdInterfacePrivate::gpo_get_gpt_contents(const QString &gpt_root_path, bool *ok) {
+QList<GptEntry> AdInterfacePrivate::gpo_get_gpt_contents(const QString &gpt_root_path, bool *ok) {
     // Collect all contents of the path into a list
-    QList<QString> explore_stack;
-    QList<QString> seen_stack;
+    QList<GptEntry> explore_stack;
+    QList<GptEntry> seen_stack;
 
-    explore_stack.append(gpt_root_path);
-    seen_stack.append(gpt_root_path);
+    const GptEntry root_entry = {gpt_root_path, true, 0};
+    explore_stack.append(root_entry);
+    seen_stack.append(root_entry);
 
     const QString error_context = QString(tr("Failed to get contents of GPT \"%1\".")).arg(gpt_root_path);
 
     while (!explore_stack.isEmpty()) {
-        const QString path = explore_stack.takeLast();
+        const GptEntry entry = explore_stack.takeLast();
 
-        const int dirp = smbc_opendir(cstr(path));
+        const int dirp = smbc_opendir(cstr(entry.path));
 
         if (dirp < 0) {
             *ok = false;
 
             error_message(error_context, tr("Failed to open dir."));
 
-            return QList<QString>();
+            return QList<GptEntry>();
         }
 
         // NOTE: set errno to 0, so that we know
@@ -1387,35 +2239,160 @@ QList<QString> AdInterfacePrivate::gpo_get_gpt_contents(const QString &gpt_root_
             if (is_dot_path) {
                 continue;
             } else {
-                const QString child_path = path + "/" + child_name;
+                // NOTE: dirent already contains entry type,
+                // so there's no need to stat every entry
+                const bool child_is_dir = (child_dirent->smbc_type == SMBC_DIR);
+                const GptEntry child_entry = {entry.path + "/" + child_name, child_is_dir, entry.depth + 1};
 
-                seen_stack.append(child_path);
-
-                const bool child_is_dir = smb_path_is_dir(child_path, ok);
-                if (!*ok) {
-                    return QList<QString>();
-                }
+                seen_stack.append(child_entry);
 
                 if (child_is_dir) {
-                    explore_stack.append(child_path);
+                    explore_stack.append(child_entry);
                 }
             }
         }
 
-        if (errno != 0) {
+        const bool read_failed = (errno != 0);
+
+        smbc_closedir(dirp);
+
+        if (read_failed) {
             *ok = false;
 
             error_message(error_context, tr("Failed to read dir."));
 
-            return QList<QString>();
+            return QList<GptEntry>();
         }
-
-        smbc_closedir(dirp);
     }
 
     return seen_stack;
 }
 
+bool AdInterfacePrivate::gpt_run_parallel(const QList<GptEntry> &entry_list, const GptOrder order, const GptOperation &operation, GptEntry *failed_entry_out, int *error_out) {
+    // Group entries by depth
+    QMap<int, QList<GptEntry>> depth_map;
+    for (const GptEntry &entry : entry_list) {
+        depth_map[entry.depth].append(entry);
+    }
+
+    QList<int> depth_list = depth_map.keys();
+    if (order == GptOrder_ChildrenFirst) {
+        std::reverse(depth_list.begin(), depth_list.end());
+    }
+
+    const int max_level_size = [&]() {
+        int out = 0;
+        for (const QList<GptEntry> &level : depth_map) {
+            out = qMax(out, level.size());
+        }
+
+        return out;
+    }();
+
+    errno = 0;
+    const QList<SMBCCTX *> pool = smb_context_pool_new(qMin(GPT_WORKER_COUNT, max_level_size));
+
+    // NOTE: nothing was done yet, so report failure on
+    // the root entry
+    if (pool.isEmpty()) {
+        *failed_entry_out = entry_list.value(0);
+        *error_out = (errno != 0) ? errno : ENOMEM;
+
+        return false;
+    }
+
+    bool success = true;
+    QMutex failure_mutex;
+
+    for (const int depth : depth_list) {
+        const QList<GptEntry> &level = depth_map[depth];
+
+        const SmbFunction function = [&](SMBCCTX *context, const int index) {
+            const GptEntry &entry = level[index];
+
+            const int result = operation(context, entry);
+
+            if (result == 0) {
+                return true;
+            } else {
+                QMutexLocker locker(&failure_mutex);
+
+                // NOTE: report only first failure
+                if (success) {
+                    success = false;
+                    *failed_entry_out = entry;
+                    *error_out = result;
+                }
+
+                return false;
+            }
+        };
+
+        smb_run_parallel(pool, level.size(), function);
+
+        if (!success) {
+            break;
+        }
+    }
+
+    smb_context_pool_free(pool);
+
+    return success;
+}
+
+QList<SMBCCTX *> AdInterfacePrivate::smb_context_pool_new(const int size) {
+    QList<SMBCCTX *> out;
+
+    for (int i = 0; i < size; i++) {
+        SMBCCTX *context = smb_context_new();
+        if (context == NULL) {
+            break;
+        }
+
+        out.append(context);
+    }
+
+    return out;
+}
+
+void AdInterfacePrivate::smb_context_pool_free(const QList<SMBCCTX *> &pool) {
+    for (SMBCCTX *context : pool) {
+        smbc_free_context(context, 1);
+    }
+}
+
+void AdInterfacePrivate::smb_run_parallel(const QList<SMBCCTX *> &pool, const int count, const SmbFunction &function) {
+    QAtomicInt next_index(0);
+    QAtomicInt stopped(0);
+
+    const int worker_count = qMin(pool.size(), count);
+
+    // NOTE: run single worker in this thread, no need
+    // to start a thread for it
+    if (worker_count == 1) {
+        SmbWorker worker(pool[0], count, &next_index, &stopped, function);
+        worker.run();
+
+        return;
+    }
+
+    QList<SmbWorker *> worker_list;
+    for (int i = 0; i < worker_count; i++) {
+        auto worker = new SmbWorker(pool[i], count, &next_index, &stopped, function);
+        worker_list.append(worker);
+    }
+
+    for (SmbWorker *worker : worker_list) {
+        worker->start();
+    }
+
+    for (SmbWorker *worker : worker_list) {
+        worker->wait();
+    }
+
+    qDeleteAll(worker_list);
+}
+
 bool AdInterface::gpo_delete(const QString &dn, bool *deleted_object) {
     // NOTE: try to execute both steps, even if first one
     // (deleting gpc) fails
@@ -1615,6 +2592,10 @@ bool AdInterface::ldap_init() {
 }
 
 void AdInterface::ldap_free() {
+    if (d->backend != nullptr) {
+        return;
+    }
+
     if (d->is_connected) {
         ldap_unbind_ext(d->ld, NULL, NULL);
     } else {
@@ -1623,19 +2604,29 @@ void AdInterface::ldap_free() {
 }
 
 bool AdInterface::gpo_check_perms(const QString &gpo, bool *ok) {
+    return gpo_check_perms(gpo, ok, nullptr);
+}
+
+bool AdInterface::gpo_check_perms(const QString &gpo, bool *ok, SdStringDiff *diff_out) {
     // NOTE: skip perms check for non-admins, because don't
     // have enough rights to get full sd
     if (!logged_in_as_domain_admin()) {
         return true;
     }
 
-    const QList<QString> attributes = QList<QString>();
+    const QList<QString> attributes = gpc_perms_attributes();
     const bool get_sacl = true;
     const AdObject gpc_object = search_object(gpo, attributes, get_sacl);
     const QString name = gpc_object.get_string(ATTRIBUTE_DISPLAY_NAME);
 
     const QString error_context = QString(tr("Failed to check permissions for GPO \"%1\".")).arg(name);
 
+    if (!d->check_smb_available(error_context)) {
+        *ok = false;
+
+        return false;
+    }
+
     const QString gpc_sd = [&]() {
         const QString out = get_gpt_sd_string(gpc_object, AceMaskFormat_Hexadecimal);
 
@@ -1651,103 +2642,82 @@ bool AdInterface::gpo_check_perms(const QString &gpo, bool *ok) {
     const QString gpt_sd = [&]() {
         const QString filesys_path = gpc_object.get_string(ATTRIBUTE_GPC_FILE_SYS_PATH);
         const QString smb_path = filesys_path_to_smb_path(filesys_path);
-        const char *smb_path_cstr = cstr(smb_path);
+        const QByteArray smb_path_bytes = smb_path.toUtf8();
+
+        // NOTE: check is done from perms thread while GUI
+        // thread uses main context, so use thread's own
+        // context. SMB contexts are not thread-safe.
+        SMBCCTX *context = smb_thread_context();
+        if (context == NULL) {
+            d->error_message(error_context, tr("Failed to create SMB context."));
+
+            return QString();
+        }
+
+        smbc_getxattr_fn getxattr_fn = smbc_getFunctionGetxattr(context);
 
         // NOTE: the length of gpt sd string doesn't have a
         // well defined bound, so we have to use an
         // expanding buffer
-        size_t buffer_size = 1024 * sizeof(char);
-        char *buffer = (char *) malloc(buffer_size);
+        QByteArray buffer(1024, '\0');
 
-        while (true) {
-            const int getxattr_result = smbc_getxattr(smb_path_cstr, "system.nt_sec_desc.*", buffer, buffer_size);
+        const QString out = [&]() {
+            while (true) {
+                const int getxattr_result = getxattr_fn(context, smb_path_bytes.constData(), "system.nt_sec_desc.*", buffer.data(), buffer.size());
 
-            // NOTE: for some reason getxattr() returns positive
-            // non-zero return code on success, even though f-n
-            // description says it "returns 0 on success"
-            const bool success = (getxattr_result >= 0);
+                // NOTE: for some reason getxattr() returns
+                // positive non-zero return code on success,
+                // even though f-n description says it
+                // "returns 0 on success"
+                const bool success = (getxattr_result >= 0);
 
-            if (success) {
-                break;
-            } else {
-                const bool buffer_is_too_small = (errno == ERANGE);
-
-                if (buffer_is_too_small) {
+                if (success) {
+                    return QString(buffer.constData());
+                } else if (errno == ERANGE) {
                     // Error occured, but it is due to
                     // insufficient buffer size, so try
                     // again with bigger buffer
-                    buffer_size = 2 * buffer_size;
-                    buffer = (char *) realloc(buffer, buffer_size);
+                    buffer.resize(2 * buffer.size());
+                    buffer.fill('\0');
                 } else {
                     const QString text = QString(tr("Failed to get GPT security descriptor, %1.")).arg(strerror(errno));
                     d->error_message(error_context, text);
 
-                    free(buffer);
-
                     return QString();
                 }
             }
-        }
-
-        const QString out = QString(buffer);
-
-        free(buffer);
+        }();
 
         return out;
     }();
 
-    qDebug() << "--------";
-    qDebug() << "gpc_sd:";
-    for (auto e : QString(gpc_sd).split(",")) {
-        qDebug() << e;
-    }
-
-    qDebug() << "--------";
-    qDebug() << "gpt_sd:";
-    for (auto e : QString(gpt_sd).split(",")) {
-        qDebug() << e;
-    }
-
     if (gpc_sd.isEmpty() || gpt_sd.isEmpty()) {
         *ok = false;
 
         return false;
     }
 
-    // SD's match if they both contain all lines of the
-    // other one. Order doesn't matter. Note that
-    // simple equality doesn't work because entry order
-    // may not match.
-    //
-    // NOTE: there's also a weird thing where RSAT
-    // creates GPO's with duplicate ace's for Domain
-    // Admins. Not sure why that happens but this
-    // matching method ignores that quirk.
-    const bool sd_match = [&]() {
-        const QList<QString> gpt_list = QString(gpt_sd).split(",");
-        const QList<QString> gpc_list = QString(gpc_sd).split(",");
-
-        for (const QString &line : gpt_list) {
-            if (!gpc_list.contains(line)) {
-                return false;
-            }
-        }
+    // NOTE: compare ACE's as sets, because ACE order and
+    // mask format may differ
+    const SdStringDiff diff = sd_string_compare(gpc_sd, gpt_sd, ok);
+    if (!*ok) {
+        d->error_message(error_context, tr("Failed to parse security descriptor."));
 
-        for (const QString &line : gpc_list) {
-            if (!gpt_list.contains(line)) {
-                return false;
-            }
-        }
+        return false;
+    }
 
-        return true;
-    }();
+    if (diff_out != nullptr) {
+        *diff_out = diff;
+    }
+
+    const bool sd_match = diff.is_match();
 
     return sd_match;
 }
 
 bool AdInterface::gpo_sync_perms(const QString &dn) {
     // First get GPC descriptor
-    const QList<QString> attributes = QList<QString>();
+    const QList<QString> attributes = gpc_perms_attributes();
     const bool get_sacl = true;
     const AdObject gpc_object = search_object(dn, attributes, get_sacl);
     const QString name = gpc_object.get_string(ATTRIBUTE_DISPLAY_NAME);
@@ -1755,6 +2725,10 @@ bool AdInterface::gpo_sync_perms(const QString &dn) {
 
     const QString error_context = QString(tr("Failed to sync permissions of GPO \"%1\".")).arg(name);
 
+    if (!d->check_smb_available(error_context)) {
+        return false;
+    }
+
     if (gpt_sd_string.isEmpty()) {
         d->error_message(error_context, tr("Failed to generate GPT security descriptor."));
 
@@ -1763,27 +2737,43 @@ bool AdInterface::gpo_sync_perms(const QString &dn) {
 
     // Get list of GPT contents
 
-    // NOTE: order is important, have to set perms of parent
-    // folders before their contents, otherwise fails to
-    // set! Default gpo_get_gpt_contents() order is good.
     const QString filesys_path = gpc_object.get_string(ATTRIBUTE_GPC_FILE_SYS_PATH);
     const QString smb_path = filesys_path_to_smb_path(filesys_path);
     bool ok = true;
-    const QList<QString> path_list = d->gpo_get_gpt_contents(smb_path, &ok);
-    if (!ok || path_list.isEmpty()) {
+    const QList<GptEntry> entry_list = d->gpo_get_gpt_contents(smb_path, &ok);
+    if (!ok || entry_list.isEmpty()) {
         d->error_message(error_context, QString(tr("Failed to read GPT contents of \"%1\".")).arg(smb_path));
         return false;
     }
 
     // Set descriptor on all GPT contents
-    for (const QString &path : path_list) {
-        const int set_sd_result = smbc_setxattr(cstr(path), "system.nt_sec_desc.*", cstr(gpt_sd_string), strlen(cstr(gpt_sd_string)), 0);
-        if (set_sd_result != 0) {
-            const QString error = QString(tr("Failed to set permissions, %1.")).arg(strerror(errno));
-            d->error_message(error_context, error);
+    const QByteArray gpt_sd_bytes = gpt_sd_string.toUtf8();
+    const GptOperation set_sd = [gpt_sd_bytes](SMBCCTX *context, const GptEntry &entry) {
+        // NOTE: not using cstr() because it's not thread
+        // safe
+        const QByteArray path_bytes = entry.path.toUtf8();
 
-            return false;
+        smbc_setxattr_fn setxattr_fn = smbc_getFunctionSetxattr(context);
+        const int result = setxattr_fn(context, path_bytes.constData(), "system.nt_sec_desc.*", gpt_sd_bytes.constData(), gpt_sd_bytes.size(), 0);
+
+        if (result == 0) {
+            return 0;
+        } else {
+            return errno;
         }
+    };
+
+    // NOTE: order is important, have to set perms of parent
+    // folders before their contents, otherwise fails to
+    // set!
+    GptEntry failed_entry;
+    int error = 0;
+    const bool set_success = d->gpt_run_parallel(entry_list, GptOrder_ParentsFirst, set_sd, &failed_entry, &error);
+    if (!set_success) {
+        const QString error_text = QString(tr("Failed to set permissions, %1.")).arg(strerror(error));
+        d->error_message(error_context, error_text);
+
+        return false;
     }
 
     d->success_message(QString(tr("Synced permissions of GPO \"%1\".")).arg(name));
@@ -1794,6 +2784,10 @@ bool AdInterface::gpo_sync_perms(const QString &dn) {
 bool AdInterface::gpo_get_sysvol_version(const AdObject &gpc_object, int *version_out) {
     const QString error_context = tr("Failed to load GPO's sysvol version.");
 
+    if (!d->check_smb_available(error_context)) {
+        return false;
+    }
+
     const QString ini_contents = [&]() {
         const QString filesys_path = gpc_object.get_string(ATTRIBUTE_GPC_FILE_SYS_PATH);
         const QString smb_path = filesys_path_to_smb_path(filesys_path);
@@ -1832,8 +2826,7 @@ bool AdInterface::gpo_get_sysvol_version(const AdObject &gpc_object, int *versio
     const int version = [&]() {
         int out;
 
-        const int scan_result = sscanf(cstr(ini_contents), "[General]\r\nVersion=%i\r\n", &out);
-        const bool scan_success = (scan_result > 0);
+        const bool scan_success = gpt_ini_parse_version(ini_contents.toUtf8(), &out);
 
         if (!scan_success) {
             const QString error_text = QString(tr("Failed to extract version from GPT.INI, %1.")).arg(strerror(errno));
@@ -1854,6 +2847,274 @@ bool AdInterface::gpo_get_sysvol_version(const AdObject &gpc_object, int *versio
     }
 }
 
+bool AdInterface::gpo_verify_all(const GpoVerifyCallback &callback, const bool *stop_flag) {
+    const QString error_context = tr("Failed to verify policies.");
+
+    if (!d->check_smb_available(error_context)) {
+        return false;
+    }
+
+    const bool check_perms = logged_in_as_domain_admin();
+
+    const QList<QString> attributes = {
+        ATTRIBUTE_DISPLAY_NAME,
+        ATTRIBUTE_GPC_FILE_SYS_PATH,
+        ATTRIBUTE_VERSION_NUMBER,
+        ATTRIBUTE_SECURITY_DESCRIPTOR,
+    };
+    const QString base = adconfig()->policies_dn();
+    const QString filter = filter_CONDITION(Condition_Equals, ATTRIBUTE_OBJECT_CLASS, CLASS_GP_CONTAINER);
+    const bool get_sacl = check_perms;
+    const QHash<QString, AdObject> gpc_map = search(base, SearchScope_All, filter, attributes, get_sacl);
+
+    if (any_error_messages()) {
+        return false;
+    }
+
+    // Prepare results for GPC's. Expected GPT security
+    // descriptors are generated here, because generating
+    // them is not thread safe.
+    QList<GpoVerifyResult> gpc_result_list;
+    QList<QString> expected_sd_list;
+    QSet<QString> gpt_folder_set;
+    QSet<QString> policies_path_set;
+
+    for (const AdObject &gpc_object : gpc_map) {
+        GpoVerifyResult result;
+        result.dn = gpc_object.get_dn();
+        result.name = gpc_object.get_string(ATTRIBUTE_DISPLAY_NAME);
+        result.gpc_version = gpc_object.get_int(ATTRIBUTE_VERSION_NUMBER);
+
+        const QString filesys_path = gpc_object.get_string(ATTRIBUTE_GPC_FILE_SYS_PATH);
+        result.gpt_path = filesys_path_to_smb_path(filesys_path);
+
+        const QString expected_sd = [&]() {
+            if (check_perms) {
+                return get_gpt_sd_string(gpc_object, AceMaskFormat_Hexadecimal);
+            } else {
+                return QString();
+            }
+        }();
+
+        gpc_result_list.append(result);
+        expected_sd_list.append(expected_sd);
+
+        const int folder_index = result.gpt_path.lastIndexOf('/');
+        const QString gpt_folder = result.gpt_path.mid(folder_index + 1);
+        const QString policies_path = result.gpt_path.left(folder_index);
+        gpt_folder_set.insert(gpt_folder.toLower());
+        policies_path_set.insert(policies_path);
+    }
+
+    // NOTE: this is called from a thread, so can't use the
+    // main SMB context, only contexts from the pool
+    const QList<SMBCCTX *> pool = d->smb_context_pool_new(GPT_WORKER_COUNT);
+    if (pool.isEmpty()) {
+        d->error_message(error_context, tr("Failed to create SMB context."));
+
+        return false;
+    }
+
+    // Find orphaned GPT folders. These are folders in
+    // policies folder which don't belong to any GPC.
+    SMBCCTX *scan_context = pool[0];
+    smbc_opendir_fn opendir_fn = smbc_getFunctionOpendir(scan_context);
+    smbc_readdir_fn readdir_fn = smbc_getFunctionReaddir(scan_context);
+    smbc_closedir_fn closedir_fn = smbc_getFunctionClosedir(scan_context);
+
+    QList<GpoVerifyResult> orphan_result_list;
+    for (const QString &policies_path : policies_path_set) {
+        const QByteArray policies_path_bytes = policies_path.toUtf8();
+
+        SMBCFILE *dir = opendir_fn(scan_context, policies_path_bytes.constData());
+        if (dir == NULL) {
+            d->error_message(error_context, QString(tr("Failed to open policies folder \"%1\", %2.")).arg(policies_path, strerror(errno)));
+
+            continue;
+        }
+
+        smbc_dirent *child_dirent;
+        while ((child_dirent = readdir_fn(scan_context, dir)) != NULL) {
+            const QString child_name = QString(child_dirent->name);
+
+            const bool is_dot_path = (child_name == "." || child_name == "..");
+            const bool is_dir = (child_dirent->smbc_type == SMBC_DIR);
+
+            // NOTE: central store of administrative
+            // templates is not a GPT
+            const bool is_central_store = (child_name.compare("PolicyDefinitions", Qt::CaseInsensitive) == 0);
+
+            if (is_dot_path || !is_dir || is_central_store) {
+                continue;
+            }
+
+            if (!gpt_folder_set.contains(child_name.toLower())) {
+                GpoVerifyResult result;
+                result.orphaned = true;
+                result.gpt_exists = true;
+                result.name = child_name;
+                result.gpt_path = policies_path + "/" + child_name;
+
+                orphan_result_list.append(result);
+            }
+        }
+
+        closedir_fn(scan_context, dir);
+    }
+
+    if (!orphan_result_list.isEmpty()) {
+        callback(orphan_result_list);
+    }
+
+    // Check GPT's of GPC's in batches, so that results
+    // are passed to caller as they become available
+
+    for (int batch_start = 0; batch_start < gpc_result_list.size(); batch_start += GPO_VERIFY_BATCH_SIZE) {
+        if (stop_flag != nullptr && *stop_flag) {
+            break;
+        }
+
+        const int batch_size = qMin(GPO_VERIFY_BATCH_SIZE, gpc_result_list.size() - batch_start);
+
+        QVector<GpoVerifyResult> batch_results = gpc_result_list.mid(batch_start, batch_size).toVector();
+
+        // NOTE: workers write to different elements of
+        // the array, which is safe because it is not
+        // resized or detached while they work
+        GpoVerifyResult *batch_data = batch_results.data();
+
+        const SmbFunction function = [&](SMBCCTX *context, const int index) {
+            const QString &expected_sd = expected_sd_list.at(batch_start + index);
+            AdInterfacePrivate::gpo_verify_gpt(context, &batch_data[index], expected_sd, check_perms);
+
+            return true;
+        };
+
+        d->smb_run_parallel(pool, batch_size, function);
+
+        callback(batch_results.toList());
+    }
+
+    d->smb_context_pool_free(pool);
+
+    return true;
+}
+
+// Checks GPT of one GPO. Called from worker threads, so
+// must only use given context.
+void AdInterfacePrivate::gpo_verify_gpt(SMBCCTX *context, GpoVerifyResult *result, const QString &expected_sd, const bool check_perms) {
+    // NOTE: not using cstr() because it's not thread
+    // safe
+    const QByteArray gpt_path_bytes = result->gpt_path.toUtf8();
+
+    // Check that GPT exists
+    struct stat filestat;
+    smbc_stat_fn stat_fn = smbc_getFunctionStat(context);
+    const int stat_result = stat_fn(context, gpt_path_bytes.constData(), &filestat);
+    if (stat_result != 0) {
+        if (errno == ENOENT) {
+            result->gpt_exists = false;
+        } else {
+            result->error = QString(tr("Failed to open GPT, %1.")).arg(strerror(errno));
+        }
+
+        return;
+    }
+
+    result->gpt_exists = true;
+
+    // Check version
+    const QByteArray ini_path_bytes = (result->gpt_path + "/GPT.INI").toUtf8();
+    const QByteArray ini_contents = [&]() {
+        smbc_open_fn open_fn = smbc_getFunctionOpen(context);
+        SMBCFILE *ini_file = open_fn(context, ini_path_bytes.constData(), O_RDONLY, 0);
+        if (ini_file == NULL) {
+            result->error = QString(tr("Failed to open GPT.INI, %1.")).arg(strerror(errno));
+
+            return QByteArray();
+        }
+
+        char buffer[2000];
+        smbc_read_fn read_fn = smbc_getFunctionRead(context);
+        const ssize_t bytes_read = read_fn(context, ini_file, buffer, sizeof(buffer));
+
+        smbc_close_fn close_fn = smbc_getFunctionClose(context);
+        close_fn(context, ini_file);
+
+        if (bytes_read < 0) {
+            result->error = QString(tr("Failed to read GPT.INI, %1.")).arg(strerror(errno));
+
+            return QByteArray();
+        }
+
+        return QByteArray(buffer, bytes_read);
+    }();
+
+    if (!ini_contents.isEmpty()) {
+        result->version_checked = gpt_ini_parse_version(ini_contents, &result->gpt_version);
+
+        if (!result->version_checked) {
+            result->error = tr("Failed to extract version from GPT.INI.");
+        }
+    }
+
+    if (!check_perms) {
+        return;
+    }
+
+    // Check permissions
+    const QString actual_sd = [&]() {
+        smbc_getxattr_fn getxattr_fn = smbc_getFunctionGetxattr(context);
+
+        // NOTE: the length of gpt sd string doesn't have a
+        // well defined bound, so we have to use an
+        // expanding buffer
+        QByteArray buffer(1024, '\0');
+
+        while (true) {
+            const int getxattr_result = getxattr_fn(context, gpt_path_bytes.constData(), "system.nt_sec_desc.*", buffer.data(), buffer.size());
+
+            if (getxattr_result >= 0) {
+                return QString(buffer.constData());
+            } else if (errno == ERANGE) {
+                buffer.resize(2 * buffer.size());
+                buffer.fill('\0');
+            } else {
+                result->error = QString(tr("Failed to get GPT security descriptor, %1.")).arg(strerror(errno));
+
+                return QString();
+            }
+        }
+    }();
+
+    if (expected_sd.isEmpty() || actual_sd.isEmpty()) {
+        if (result->error.isEmpty()) {
+            result->error = tr("Failed to get GPT security descriptor.");
+        }
+
+        return;
+    }
+
+    bool compare_ok;
+    const SdStringDiff diff = sd_string_compare(expected_sd, actual_sd, &compare_ok);
+    if (!compare_ok) {
+        result->error = tr("Failed to parse security descriptor.");
+
+        return;
+    }
+
+    result->perms_checked = true;
+    result->perms_match = diff.is_match();
+
+    for (const SdStringAce &ace : diff.missing_aces) {
+        result->missing_aces.append(ace.to_string());
+    }
+
+    for (const SdStringAce &ace : diff.extra_aces) {
+        result->extra_aces.append(ace.to_string());
+    }
+}
+
 void AdInterfacePrivate::success_message(const QString &msg, const DoStatusMsg do_msg) {
     if (do_msg == DoStatusMsg_No) {
         return;
@@ -1894,6 +3155,11 @@ void AdInterfacePrivate::error_message_plain(const QString &text, const DoStatus
 
 QString AdInterfacePrivate::default_error() const {
     const int ldap_result = get_ldap_result();
+
+    return ldap_result_string(ldap_result);
+}
+
+QString AdInterfacePrivate::ldap_result_string(const int ldap_result) const {
     switch (ldap_result) {
         case LDAP_NO_SUCH_OBJECT: return tr("No such object");
         case LDAP_CONSTRAINT_VIOLATION: return tr("Constraint violation");
@@ -1908,68 +3174,145 @@ QString AdInterfacePrivate::default_error() const {
 }
 
 int AdInterfacePrivate::get_ldap_result() const {
+    if (backend != nullptr) {
+        return backend_result;
+    }
+
     int result;
     ldap_get_option(ld, LDAP_OPT_RESULT_CODE, &result);
 
     return result;
 }
 
+void AdInterfacePrivate::invalidate_modified(const QString &dn, const QList<QByteArray> &values) {
+    // NOTE: whole object is dropped because modifications
+    // can have side effects on other attributes, for
+    // example changing userAccountControl or password.
+    s_object_cache.invalidate_object(dn);
+
+    // Values that are DN's of other objects can also
+    // change back links of those objects, for example
+    // adding a member changes memberOf of the member.
+    // Values that are not DN's don't match any cached
+    // object so it's fine to try them all.
+    for (const QByteArray &value : values) {
+        s_object_cache.invalidate_object(QString::fromUtf8(value));
+    }
+}
+
+void AdInterfacePrivate::invalidate_renamed(const QString &dn) {
+    // NOTE: DN's of descendants change as well, and the
+    // server updates references in other objects
+    s_object_cache.invalidate_subtree(dn);
+    s_object_cache.invalidate_references(dn);
+}
+
+bool AdInterfacePrivate::check_domain_admin(bool *ok) {
+    const QString sam_account_name = client_user.split('@')[0];
+    const QString client_user_filter = filter_CONDITION(Condition_Equals, ATTRIBUTE_SAM_ACCOUNT_NAME, sam_account_name);
+    const QHash<QString, AdObject> client_user_results = q->search(q->adconfig()->domain_dn(), SearchScope_All, client_user_filter, {ATTRIBUTE_PRIMARY_GROUP_ID});
+    if (client_user_results.isEmpty()) {
+        *ok = false;
+
+        return false;
+    }
+
+    const QString user_dn = client_user_results.keys()[0];
+    if (user_dn.isEmpty()) {
+        *ok = false;
+
+        return false;
+    }
+
+    int primary_group_id = client_user_results.values()[0].get_int(ATTRIBUTE_PRIMARY_GROUP_ID);
+    const int domain_admins_rid = 512;
+    if (primary_group_id == domain_admins_rid) {
+        return true;
+    }
+
+    const QString domain_admins_sid = q->adconfig()->domain_sid() + "-" + QString::number(domain_admins_rid);
+    const QString filter_group = filter_CONDITION(Condition_Equals, ATTRIBUTE_OBJECT_CLASS, CLASS_GROUP);
+    const QString filter_sid = filter_CONDITION(Condition_Equals, ATTRIBUTE_OBJECT_SID, domain_admins_sid);
+    const QString filter = filter_AND({filter_group, filter_sid});
+    const QHash<QString, AdObject> admin_group_results = q->search(q->adconfig()->domain_dn(), SearchScope_All, filter, {ATTRIBUTE_DN});
+    if (admin_group_results.isEmpty()) {
+        error_message(tr("Failed to check user permissions."), tr("Can't find domain admins group with SID ") + domain_admins_sid);
+        *ok = false;
+
+        return false;
+    }
+
+    const AdObject domain_admins_object = admin_group_results.values()[0];
+    const QString rule_in_chain_filter = filter_matching_rule_in_chain(ATTRIBUTE_MEMBER_OF, domain_admins_object.get_dn());
+    const QHash<QString, AdObject> res = q->search(user_dn, SearchScope_Object, rule_in_chain_filter, {ATTRIBUTE_DN});
+
+    return res.keys().contains(user_dn);
+}
+
 bool AdInterfacePrivate::delete_gpt(const QString &parent_path) {
+    if (!check_smb_available(tr("Failed to delete GPT."))) {
+        return false;
+    }
+
     bool ok = true;
 
-    QList<QString> path_list = gpo_get_gpt_contents(parent_path, &ok);
+    const QList<GptEntry> entry_list = gpo_get_gpt_contents(parent_path, &ok);
     if (!ok) {
         return false;
     }
 
-    // NOTE: have to reverse so deepest paths are first to
-    // delete correctly
-    std::reverse(path_list.begin(), path_list.end());
-
-    for (const QString &path : path_list) {
-        const bool is_dir = smb_path_is_dir(path, &ok);
-        if (!ok) {
-            return false;
-        }
+    const GptOperation delete_entry = [](SMBCCTX *context, const GptEntry &entry) {
+        // NOTE: not using cstr() because it's not thread
+        // safe
+        const QByteArray path_bytes = entry.path.toUtf8();
 
-        if (is_dir) {
-            const int result_rmdir = smbc_rmdir(cstr(path));
+        const int result = [&]() {
+            if (entry.is_dir) {
+                smbc_rmdir_fn rmdir_fn = smbc_getFunctionRmdir(context);
+                return rmdir_fn(context, path_bytes.constData());
+            } else {
+                smbc_unlink_fn unlink_fn = smbc_getFunctionUnlink(context);
+                return unlink_fn(context, path_bytes.constData());
+            }
+        }();
 
-            if (result_rmdir != 0) {
-                error_message(QString(tr("Failed to delete GPT folder %1.")).arg(path), strerror(errno));
+        if (result == 0) {
+            return 0;
+        } else {
+            return errno;
+        }
+    };
 
-                return false;
+    // NOTE: deepest paths have to be deleted first, because
+    // only empty folders can be deleted
+    GptEntry failed_entry;
+    int error = 0;
+    const bool delete_success = gpt_run_parallel(entry_list, GptOrder_ChildrenFirst, delete_entry, &failed_entry, &error);
+    if (!delete_success) {
+        const QString error_context = [&]() {
+            if (failed_entry.is_dir) {
+                return QString(tr("Failed to delete GPT folder %1.")).arg(failed_entry.path);
+            } else {
+                return QString(tr("Failed to delete GPT file %1.")).arg(failed_entry.path);
             }
-        } else {
-            const int result_unlink = smbc_unlink(cstr(path));
+        }();
 
-            if (result_unlink != 0) {
-                error_message(QString(tr("Failed to delete GPT file %1.")).arg(path), strerror(errno));
+        error_message(error_context, strerror(error));
 
-                return false;
-            }
-        }
+        return false;
     }
 
     return true;
 }
 
-bool AdInterfacePrivate::smb_path_is_dir(const QString &path, bool *ok) {
-    struct stat filestat;
-    const int stat_result = smbc_stat(cstr(path), &filestat);
-    if (stat_result != 0) {
-        error_message(QString(tr("Failed to get filestat for \"%1\".")).arg(path), strerror(errno));
-
-        *ok = false;
-
-        return false;
-    } else {
-        *ok = true;
+bool AdInterfacePrivate::check_smb_available(const QString &error_context) {
+    if (backend == nullptr) {
+        return true;
+    }
 
-        const bool is_dir = S_ISDIR(filestat.st_mode);
+    error_message(error_context, tr("SYSVOL is not available when using an offline backend."));
 
-        return is_dir;
-    }
+    return false;
 }
 
 // NOTE: this f-n is analogous to
@@ -2011,39 +3354,34 @@ int create_sd_control(bool get_sacl, int is_critical, LDAPControl **ctrlp, bool
 }
 
 bool AdInterface::logged_in_as_domain_admin() {
-    const QString sam_account_name = d->client_user.split('@')[0];
-    const QString client_user_filter = filter_CONDITION(Condition_Equals, ATTRIBUTE_SAM_ACCOUNT_NAME, sam_account_name);
-    const QHash<QString, AdObject> client_user_results = search(adconfig()->domain_dn(), SearchScope_All, client_user_filter, {ATTRIBUTE_PRIMARY_GROUP_ID});
-    if (client_user_results.isEmpty()) {
-        return false;
-    }
+    // NOTE: group membership of the user is fixed for the
+    // duration of the session, so the check doesn't need
+    // to be repeated. This matters because the check costs
+    // three searches, one of them with an in-chain
+    // matching rule.
+    const QString cache_key = QString("%1:%2").arg(d->domain, d->client_user).toLower();
 
-    const QString user_dn = client_user_results.keys()[0];
-    if (user_dn.isEmpty()) {
-        return false;
-    }
+    AdInterfacePrivate::mutex.lock();
+    const bool is_cached = AdInterfacePrivate::s_domain_admin_cache.contains(cache_key);
+    const bool cached_result = AdInterfacePrivate::s_domain_admin_cache.value(cache_key, false);
+    AdInterfacePrivate::mutex.unlock();
 
-    int primary_group_id = client_user_results.values()[0].get_int(ATTRIBUTE_PRIMARY_GROUP_ID);
-    const int domain_admins_rid = 512;
-    if (primary_group_id == domain_admins_rid) {
-        return true;
+    if (is_cached) {
+        return cached_result;
     }
 
-    const QString domain_admins_sid = adconfig()->domain_sid() + "-" + QString::number(domain_admins_rid);
-    const QString filter_group = filter_CONDITION(Condition_Equals, ATTRIBUTE_OBJECT_CLASS, CLASS_GROUP);
-    const QString filter_sid = filter_CONDITION(Condition_Equals, ATTRIBUTE_OBJECT_SID, domain_admins_sid);
-    const QString filter = filter_AND({filter_group, filter_sid});
-    const QHash<QString, AdObject> admin_group_results = search(adconfig()->domain_dn(), SearchScope_All, filter, QList<QString>());
-    if (admin_group_results.isEmpty()) {
-        d->error_message(tr("Failed to check user permissions."), tr("Can't find domain admins group with SID ") + domain_admins_sid);
-        return false;
-    }
+    bool ok = true;
+    const bool out = d->check_domain_admin(&ok);
 
-    const AdObject domain_admins_object = admin_group_results.values()[0];
-    const QString rule_in_chain_filter = filter_matching_rule_in_chain(ATTRIBUTE_MEMBER_OF, domain_admins_object.get_dn());
-    const QHash<QString, AdObject> res = search(user_dn, SearchScope_Object, rule_in_chain_filter, QList<QString>());
+    // NOTE: don't cache failed checks, so that they are
+    // retried
+    if (ok) {
+        AdInterfacePrivate::mutex.lock();
+        AdInterfacePrivate::s_domain_admin_cache[cache_key] = out;
+        AdInterfacePrivate::mutex.unlock();
+    }
 
-    return res.keys().contains(user_dn);
+    return out;
 }
 
 QString AdInterface::get_dc() const {
@@ -2057,6 +3395,10 @@ QString AdInterface::get_domain() const {
 void AdInterface::update_dc() {
     d->dc = AdInterfacePrivate::s_dc;
 
+    if (d->backend != nullptr) {
+        return;
+    }
+
     // Reinit ldap connection with updated DC
     ldap_free();
     ldap_init();
@@ -2242,6 +3584,18 @@ int sasl_interact_gssapi(LDAP *ld, unsigned flags, void *indefaults, void *in) {
     return LDAP_SUCCESS;
 }
 
+// Attributes of GPC needed to check and sync permissions
+// of GPT
+QList<QString> gpc_perms_attributes() {
+    const QList<QString> out = {
+        ATTRIBUTE_DISPLAY_NAME,
+        ATTRIBUTE_GPC_FILE_SYS_PATH,
+        ATTRIBUTE_SECURITY_DESCRIPTOR,
+    };
+
+    return out;
+}
+
 // NOTE: decimal format option is provided to deal with this
 // bug in libsmbclient:
 // https://bugzilla.samba.org/show_bug.cgi?id=14303. You
@@ -2316,14 +3670,23 @@ QString get_gpt_sd_string(const AdObject &gpc_object, const AceMaskFormat format
 
 AdCookie::AdCookie() {
     cookie = NULL;
+    offset = 0;
+    record = nullptr;
 }
 
 bool AdCookie::more_pages() const {
-    return (cookie != NULL);
+    return (cookie != NULL || offset != 0);
 }
 
 AdCookie::~AdCookie() {
     ber_bvfree(cookie);
+
+    // NOTE: search was abandoned before last page, record
+    // what was done so far
+    if (record != nullptr) {
+        ad_metrics_record(*record);
+        delete record;
+    }
 }
 
 AdMessage::AdMessage(const QString &text, const AdMessageType &type) {
@@ -2338,3 +3701,124 @@ QString AdMessage::text() const {
 AdMessageType AdMessage::type() const {
     return m_type;
 }
+
+GpoVerifyResult::GpoVerifyResult() {
+    orphaned = false;
+    gpt_exists = false;
+    version_checked = false;
+    gpc_version = 0;
+    gpt_version = 0;
+    perms_checked = false;
+    perms_match = false;
+}
+
+bool GpoVerifyResult::is_ok() const {
+    const bool version_ok = (!version_checked || gpc_version == gpt_version);
+    const bool perms_ok = (!perms_checked || perms_match);
+
+    return (!orphaned && gpt_exists && error.isEmpty() && version_ok && perms_ok);
+}
+
+// Extracts version from contents of GPT.INI, which look
+// like this:
+//
+// [General]
+// Version=65537
+bool gpt_ini_parse_version(const QByteArray &ini_contents, int *version_out) {
+    const QList<QByteArray> line_list = ini_contents.split('\n');
+
+    for (const QByteArray &line : line_list) {
+        const QByteArray trimmed = line.trimmed();
+
+        if (trimmed.toLower().startsWith("version=")) {
+            bool ok;
+            const int version = trimmed.mid(QByteArray("version=").size()).toInt(&ok);
+
+            if (ok) {
+                *version_out = version;
+            }
+
+            return ok;
+        }
+    }
+
+    return false;
+}
+
+LdapModArray::LdapModArray(const QList<AdBackendMod> &mod_list)
+: type_storage(mod_list.size()), mod_storage(mod_list.size()), mods(mod_list.size() + 1), bvalue_storage(mod_list.size()), bvalues(mod_list.size()) {
+    for (int i = 0; i < mod_list.size(); i++) {
+        const AdBackendMod &mod = mod_list[i];
+
+        type_storage[i] = mod.attribute.toUtf8();
+
+        bvalue_storage[i].resize(mod.values.size());
+        bvalues[i].resize(mod.values.size() + 1);
+        for (int j = 0; j < mod.values.size(); j++) {
+            struct berval *bvalue = &bvalue_storage[i][j];
+            bvalue->bv_val = (char *) mod.values[j].constData();
+            bvalue->bv_len = (size_t) mod.values[j].size();
+
+            bvalues[i][j] = bvalue;
+        }
+        bvalues[i][mod.values.size()] = NULL;
+
+        const int op = [&]() {
+            switch (mod.op) {
+                case AdBackendModOp_Add: return LDAP_MOD_ADD;
+                case AdBackendModOp_Delete: return LDAP_MOD_DELETE;
+                case AdBackendModOp_Replace: return LDAP_MOD_REPLACE;
+            }
+            return LDAP_MOD_REPLACE;
+        }();
+
+        LDAPMod *ldap_mod = &mod_storage[i];
+        ldap_mod->mod_op = (op | LDAP_MOD_BVALUES);
+        ldap_mod->mod_type = type_storage[i].data();
+        ldap_mod->mod_bvalues = bvalues[i].data();
+
+        mods[i] = ldap_mod;
+    }
+    mods[mod_list.size()] = NULL;
+}
+
+LDAPMod **LdapModArray::get() {
+    return mods.data();
+}
+
+// For new objects, all attributes are added in one request.
+// For existing objects, values are replaced, except for
+// object class and naming attribute which can't be
+// changed by a modify.
+QList<AdBackendMod> import_mod_list(const LdifEntry &entry, const bool is_update) {
+    const QString rdn_attribute = entry.dn.left(entry.dn.indexOf('='));
+
+    QList<AdBackendMod> out;
+
+    for (auto it = entry.attributes.begin(); it != entry.attributes.end(); it++) {
+        const QString &attribute = it.key();
+
+        if (is_update) {
+            const bool is_immutable = (attribute.compare(ATTRIBUTE_OBJECT_CLASS, Qt::CaseInsensitive) == 0 || attribute.compare(rdn_attribute, Qt::CaseInsensitive) == 0);
+
+            if (!is_immutable) {
+                out.append(AdBackendMod{AdBackendModOp_Replace, attribute, it.value()});
+            }
+        } else {
+            out.append(AdBackendMod{AdBackendModOp_Add, attribute, it.value()});
+        }
+    }
+
+    return out;
+}
+
+// Errors after which request may succeed if it is repeated
+bool import_result_is_transient(const int result) {
+    switch (result) {
+        case LDAP_BUSY: return true;
+        case LDAP_UNAVAILABLE: return true;
+        case LDAP_TIMELIMIT_EXCEEDED: return true;
+        case LDAP_TIMEOUT: return true;
+        default: return false;
+    }
+}
@@ -30,14 +30,22 @@
 #include <QHash>
 #include <QSet>
 
+#include <functional>
+
 #include "ad_defines.h"
+#include "ad_import.h"
+#include "ad_object_cache.h"
 
 class AdInterfacePrivate;
+class AdBackend;
+class AdBackendMod;
+class AdOperationRecord;
 class QString;
 class QByteArray;
 class QDateTime;
 class AdObject;
 class AdConfig;
+class SdStringDiff;
 template <typename T>
 class QList;
 typedef void TALLOC_CTX;
@@ -65,6 +73,15 @@ public:
 private:
     struct berval *cookie;
 
+    // Position of next page, used when searching
+    // through a backend
+    int offset;
+
+    // Metrics of the search that this cookie is used
+    // for, recorded when search finishes or cookie is
+    // destroyed
+    AdOperationRecord *record;
+
     friend class AdInterface;
     friend class AdInterfacePrivate;
 };
@@ -82,6 +99,38 @@ private:
     AdMessageType m_type;
 };
 
+// Result of verifying consistency of a GPO's GPC and GPT.
+// Orphaned results are for GPT folders in sysvol which
+// have no GPC, those only have GPT path set.
+class GpoVerifyResult {
+public:
+    GpoVerifyResult();
+
+    QString dn;
+    QString name;
+    QString gpt_path;
+    bool orphaned;
+    bool gpt_exists;
+
+    bool version_checked;
+    int gpc_version;
+    int gpt_version;
+
+    // NOTE: perms are checked only for domain admins,
+    // because others can't read full security descriptors
+    bool perms_checked;
+    bool perms_match;
+    QList<QString> missing_aces;
+    QList<QString> extra_aces;
+
+    // Error which prevented some of the checks
+    QString error;
+
+    bool is_ok() const;
+};
+
+typedef std::function<void(const QList<GpoVerifyResult> &results)> GpoVerifyCallback;
+
 class AdInterface {
     Q_DECLARE_TR_FUNCTIONS(AdInterface)
 
@@ -98,6 +147,15 @@ public:
      */
     static void set_config(AdConfig *config);
 
+    /**
+     * Route all LDAP operations of AdInterface's created
+     * after this call to given backend instead of a domain
+     * controller. Pass nullptr to return to default
+     * behavior. Note that AdInterface is not responsible
+     * for deleting the backend.
+     */
+    static void set_backend(AdBackend *backend);
+
     static void set_log_searches(const bool enabled);
 
     static void set_dc(const QString &dc);
@@ -113,6 +171,8 @@ public:
     void clear_messages();
     AdConfig *adconfig() const;
     QString client_user() const;
+    // NOTE: result is computed once per session for each
+    // user and domain, later calls return cached result
     bool logged_in_as_domain_admin();
     QString get_dc() const;
     QString get_domain() const;
@@ -121,6 +181,12 @@ public:
     // It is needed when DC changes after AdInterface object was constructed.
     void update_dc();
 
+    // Controls whether search results of this instance are
+    // added to the object cache. Disable for searches that
+    // go through a lot of objects only once, like exports,
+    // so that they don't evict useful entries.
+    void set_cache_search_results(const bool enabled);
+
     // NOTE: If request attributes list is empty, all
     // attributes are returned
 
@@ -140,6 +206,18 @@ public:
     // of one object
     AdObject search_object(const QString &dn, const QList<QString> &attributes = QList<QString>(), const bool get_sacl = false);
 
+    // Version of search_object() which uses session-wide
+    // object cache. Only attributes that are not cached or
+    // are older than "max_age" are loaded. Use this when
+    // slightly out of date data is acceptable, for example
+    // to display an object that was just loaded by
+    // console. All searches add their results to the
+    // cache and modifications done through AdInterface
+    // invalidate affected objects.
+    AdObject search_object_cached(const QString &dn, const QList<QString> &attributes = QList<QString>(), const int max_age = CacheMaxAge_Default);
+
+    static AdObjectCache *object_cache();
+
     bool attribute_replace_values(const QString &dn, const QString &attribute, const QList<QByteArray> &values, const DoStatusMsg do_msg = DoStatusMsg_Yes, const bool set_dacl = false);
 
     bool attribute_replace_value(const QString &dn, const QString &attribute, const QByteArray &value, const DoStatusMsg do_msg = DoStatusMsg_Yes, const bool set_dacl = false);
@@ -150,6 +228,11 @@ public:
     bool attribute_replace_int(const QString &dn, const QString &attribute, const int value, const DoStatusMsg do_msg = DoStatusMsg_Yes);
     bool attribute_replace_datetime(const QString &dn, const QString &attribute, const QDateTime &datetime);
 
+    // Applies all modifications in one request, so either
+    // all of them are applied or none are. Unlike other
+    // attribute f-ns, doesn't read old values first.
+    bool attribute_modify(const QString &dn, const QList<AdBackendMod> &mod_list, const DoStatusMsg do_msg = DoStatusMsg_Yes);
+
     // NOTE: attrs_map should contain attribute values
     // that will be added to the newly created object.
     // Note that it *must* contain a valid value for
@@ -159,6 +242,14 @@ public:
     // objectClass value
     bool object_add(const QString &dn, const QString &object_class);
 
+    // Creates objects for all entries. Parents are created
+    // before their children, entries whose parent failed
+    // are not attempted. Several requests are sent at once
+    // without waiting for results, see AdImportOptions.
+    // Progress callback may be empty. Stops early if stop
+    // flag is set, stop flag may be nullptr.
+    AdImportReport import_entries(const QList<LdifEntry> &entry_list, const AdImportOptions &options, const AdImportProgressCallback &progress, const bool *stop_flag);
+
     bool object_delete(const QString &dn, const DoStatusMsg do_msg = DoStatusMsg_Yes);
     bool object_move(const QString &dn, const QString &new_container);
     bool object_rename(const QString &dn, const QString &new_name);
@@ -179,9 +270,22 @@ public:
     bool gpo_add(const QString &name, QString &dn_out);
     bool gpo_delete(const QString &dn, bool *deleted_object);
     bool gpo_check_perms(const QString &gpo, bool *ok);
+
+    // Also returns difference between GPC and GPT
+    // permissions through diff_out
+    bool gpo_check_perms(const QString &gpo, bool *ok, SdStringDiff *diff_out);
     bool gpo_sync_perms(const QString &gpo);
     bool gpo_get_sysvol_version(const AdObject &gpc_object, int *version);
 
+    // Verifies all GPO's in the domain: checks that GPT
+    // exists, that GPT version matches GPC version and
+    // that GPT permissions match GPC permissions. Also
+    // finds GPT folders that have no GPC. SMB operations
+    // are done by a pool of workers in parallel. Results
+    // are passed to callback in batches, as they become
+    // available. Stops early if stop flag is set.
+    bool gpo_verify_all(const GpoVerifyCallback &callback, const bool *stop_flag);
+
     QString filesys_path_to_smb_path(const QString &filesys_path) const;
 
 private:
@@ -21,16 +21,53 @@
 #ifndef AD_INTERFACE_P_H
 #define AD_INTERFACE_P_H
 
+#include "ad_metrics.h"
+#include "ad_object_cache.h"
+
 #include <QCoreApplication>
+#include <QHash>
 #include <QList>
 #include <QMutex>
 
+#include <functional>
+
 class AdInterface;
 class AdConfig;
+class GpoVerifyResult;
+class AdBackend;
 class QString;
+class QElapsedTimer;
 typedef struct ldap LDAP;
 typedef struct _SMBCCTX SMBCCTX;
 
+// File or folder in GPT. Depth is relative to GPT root,
+// root's depth is 0.
+class GptEntry {
+public:
+    QString path;
+    bool is_dir;
+    int depth;
+};
+
+enum GptOrder {
+    // Parents are processed before their children. Use for
+    // setting permissions, because contents inherit them
+    // from parents.
+    GptOrder_ParentsFirst,
+
+    // Children are processed before their parents. Use for
+    // deleting, because only empty folders can be deleted.
+    GptOrder_ChildrenFirst,
+};
+
+// Operation performed on a GPT entry using given SMB
+// context. Should return 0 on success and errno on failure.
+typedef std::function<int(SMBCCTX *context, const GptEntry &entry)> GptOperation;
+
+// F-n called by parallel SMB workers for an index of a work
+// item. Return false to stop processing remaining items.
+typedef std::function<bool(SMBCCTX *context, const int index)> SmbFunction;
+
 class AdInterfacePrivate {
     Q_DECLARE_TR_FUNCTIONS(AdInterfacePrivate)
 
@@ -41,7 +78,11 @@ public:
     AdInterfacePrivate(AdInterface *q);
 
     LDAP *ld;
+    AdBackend *backend;
+    // Result of last backend operation
+    int backend_result;
     bool is_connected;
+    bool cache_search_results;
     QString domain;
     QString dc;
     QString client_user;
@@ -51,19 +92,70 @@ public:
     void error_message(const QString &context, const QString &error, const DoStatusMsg do_msg = DoStatusMsg_Yes);
     void error_message_plain(const QString &text, const DoStatusMsg do_msg = DoStatusMsg_Yes);
     QString default_error() const;
+    QString ldap_result_string(const int ldap_result) const;
     int get_ldap_result() const;
     bool search_paged_internal(const char *base, const int scope, const char *filter, char **attributes, QHash<QString, AdObject> *results, AdCookie *cookie, const bool get_sacl);
+
+    // Adds time spent on current page to search's metrics
+    // and records them if this is the last page or search
+    // failed
+    void search_add_page(const QHash<QString, AdObject> &page_results, const QList<QString> &attributes, QHash<QString, AdObject> *results, const bool get_sacl);
+    void search_record_page(AdCookie *cookie, const QElapsedTimer &timer, const bool success);
+
+    // Records metrics of a modification
+    void record_operation(const AdOperationType type, const QString &dn, const int result, const QElapsedTimer &timer);
     bool connect_via_ldap(const char *uri);
     bool delete_gpt(const QString &parent_path);
-    bool smb_path_is_dir(const QString &path, bool *ok);
 
-    // Returns GPT contents including the root path, in
-    // order of increasing depth, so root path is first
-    QList<QString> gpo_get_gpt_contents(const QString &gpt_root_path, bool *ok);
+    // Performs the searches needed to determine whether
+    // client user is a domain admin. Sets ok to false if
+    // that couldn't be determined.
+    bool check_domain_admin(bool *ok);
+
+    // Invalidate cached objects affected by a successful
+    // modification
+    void invalidate_modified(const QString &dn, const QList<QByteArray> &values);
+    void invalidate_renamed(const QString &dn);
+
+    // Returns false and adds an error message if SMB is
+    // not available, which is the case when using a
+    // backend
+    bool check_smb_available(const QString &error_context);
+
+    // Returns GPT contents including the root path.
+    // Parents are always before their children, so root
+    // path is first.
+    QList<GptEntry> gpo_get_gpt_contents(const QString &gpt_root_path, bool *ok);
+
+    // Performs operation on all entries, using several SMB
+    // contexts in parallel. Entries are processed depth by
+    // depth in given order, all entries of one depth at the
+    // same time. Stops at first failed operation and
+    // returns false, failed entry and it's errno are
+    // returned through out args.
+    bool gpt_run_parallel(const QList<GptEntry> &entry_list, const GptOrder order, const GptOperation &operation, GptEntry *failed_entry_out, int *error_out);
+
+    // Creates a pool of up to "size" SMB contexts for
+    // parallel workers. Pool is empty if no contexts could
+    // be created, the main context is never included
+    // because it's not thread safe.
+    QList<SMBCCTX *> smb_context_pool_new(const int size);
+    void smb_context_pool_free(const QList<SMBCCTX *> &pool);
+
+    // Calls function for every index in [0, count) using
+    // one worker thread per context in pool. Items are
+    // processed in no particular order. Stops early if
+    // function returns false.
+    void smb_run_parallel(const QList<SMBCCTX *> &pool, const int count, const SmbFunction &function);
+
+    static void gpo_verify_gpt(SMBCCTX *context, GpoVerifyResult *result, const QString &expected_sd, const bool check_perms);
 
 private:
     static AdConfig *adconfig;
+    static AdBackend *s_backend;
     static bool s_log_searches;
+    static QHash<QString, bool> s_domain_admin_cache;
+    static AdObjectCache s_object_cache;
     static QString s_dc;
     static void *s_sasl_nocanon;
     static int s_port;
@@ -0,0 +1,210 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ad_ldif.h"
+
+#include <QCoreApplication>
+#include <algorithm>
+
+// Max length of a line in written LDIF, longer lines are
+// folded
+#define LDIF_LINE_LENGTH 76
+
+QList<QByteArray> ldif_unfold_lines(const QByteArray &data);
+bool ldif_value_is_safe(const QByteArray &value);
+void ldif_write_line(QByteArray *out, const QString &attribute, const QByteArray &value);
+
+// Splits data into logical lines, joining folded lines.
+// Empty lines are kept because they separate entries.
+QList<QByteArray> ldif_unfold_lines(const QByteArray &data) {
+    QList<QByteArray> out;
+
+    for (QByteArray line : data.split('\n')) {
+        if (line.endsWith('\r')) {
+            line.chop(1);
+        }
+
+        const bool is_continuation = (line.startsWith(' ') && !out.isEmpty() && !out.last().isEmpty());
+        if (is_continuation) {
+            out.last().append(line.mid(1));
+        } else {
+            out.append(line);
+        }
+    }
+
+    return out;
+}
+
+bool ldif_parse(const QByteArray &data, QList<LdifEntry> *entry_list, QString *error) {
+    const QList<QByteArray> line_list = ldif_unfold_lines(data);
+
+    LdifEntry current;
+    bool have_current = false;
+
+    auto finish_entry = [&]() {
+        if (have_current) {
+            entry_list->append(current);
+        }
+
+        current = LdifEntry();
+        have_current = false;
+    };
+
+    for (int i = 0; i < line_list.size(); i++) {
+        const QByteArray &line = line_list[i];
+
+        if (line.isEmpty()) {
+            finish_entry();
+
+            continue;
+        }
+
+        if (line.startsWith('#')) {
+            continue;
+        }
+
+        const int colon_i = line.indexOf(':');
+        if (colon_i <= 0) {
+            *error = QCoreApplication::translate("ldif", "Line %1 is malformed.").arg(i + 1);
+
+            return false;
+        }
+
+        const QString attribute = QString::fromUtf8(line.left(colon_i));
+
+        // NOTE: "attr:: value" denotes base64 encoded
+        // value, "attr: value" is plain
+        const bool is_base64 = (line.size() > colon_i + 1 && line[colon_i + 1] == ':');
+        const int value_i = colon_i + (is_base64 ? 2 : 1);
+        const QByteArray value_raw = line.mid(value_i).trimmed();
+        const QByteArray value = is_base64 ? QByteArray::fromBase64(value_raw) : value_raw;
+
+        if (!have_current) {
+            if (attribute.compare("version", Qt::CaseInsensitive) == 0) {
+                continue;
+            }
+
+            if (attribute.compare("dn", Qt::CaseInsensitive) != 0) {
+                *error = QCoreApplication::translate("ldif", "Line %1: expected \"dn\", got \"%2\".").arg(QString::number(i + 1), attribute);
+
+                return false;
+            }
+
+            current.dn = QString::fromUtf8(value);
+            have_current = true;
+
+            continue;
+        }
+
+        if (attribute.compare("changetype", Qt::CaseInsensitive) == 0) {
+            *error = QCoreApplication::translate("ldif", "Line %1: change records are not supported.").arg(i + 1);
+
+            return false;
+        }
+
+        current.attributes[attribute].append(value);
+    }
+
+    finish_entry();
+
+    return true;
+}
+
+QByteArray ldif_write_entry(const LdifEntry &entry, const QList<QString> &attribute_order) {
+    const QList<QString> attribute_list = [&]() {
+        if (attribute_order.isEmpty()) {
+            QList<QString> out = entry.attributes.keys();
+            std::sort(out.begin(), out.end());
+
+            return out;
+        } else {
+            return attribute_order;
+        }
+    }();
+
+    QByteArray out;
+
+    ldif_write_line(&out, "dn", entry.dn.toUtf8());
+
+    for (const QString &attribute : attribute_list) {
+        const auto it = entry.attributes.constFind(attribute);
+        if (it == entry.attributes.constEnd()) {
+            continue;
+        }
+
+        for (const QByteArray &value : it.value()) {
+            ldif_write_line(&out, attribute, value);
+        }
+    }
+
+    out.append('\n');
+
+    return out;
+}
+
+// Safe string as defined by RFC 2849. Also values with
+// trailing spaces are not safe because parser trims them.
+bool ldif_value_is_safe(const QByteArray &value) {
+    if (value.isEmpty()) {
+        return true;
+    }
+
+    const char first = value[0];
+    if (first == ' ' || first == ':' || first == '<') {
+        return false;
+    }
+
+    if (value.endsWith(' ')) {
+        return false;
+    }
+
+    for (const char c : value) {
+        const unsigned char byte = (unsigned char) c;
+        const bool is_safe_char = (byte != 0 && byte != '\n' && byte != '\r' && byte < 0x80);
+
+        if (!is_safe_char) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void ldif_write_line(QByteArray *out, const QString &attribute, const QByteArray &value) {
+    QByteArray line = attribute.toUtf8();
+
+    if (ldif_value_is_safe(value)) {
+        line.append(": ");
+        line.append(value);
+    } else {
+        line.append(":: ");
+        line.append(value.toBase64());
+    }
+
+    // Fold long lines, continuation lines start with a
+    // space
+    out->append(line.left(LDIF_LINE_LENGTH));
+    out->append('\n');
+    for (int i = LDIF_LINE_LENGTH; i < line.size(); i += LDIF_LINE_LENGTH - 1) {
+        out->append(' ');
+        out->append(line.mid(i, LDIF_LINE_LENGTH - 1));
+        out->append('\n');
+    }
+}
@@ -0,0 +1,51 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AD_LDIF_H
+#define AD_LDIF_H
+
+/**
+ * Reading and writing of LDIF (RFC 2849) files in
+ * "content" form, as produced by ldapsearch or ldbsearch.
+ * Only entries are supported, change records are rejected.
+ */
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+class LdifEntry {
+public:
+    QString dn;
+    QHash<QString, QList<QByteArray>> attributes;
+};
+
+// Returns false and sets "error" if data is malformed
+bool ldif_parse(const QByteArray &data, QList<LdifEntry> *entry_list, QString *error);
+
+// Returns entry in LDIF format, followed by an empty line.
+// Attributes are written in given order, attributes which
+// entry doesn't have are skipped. If order is empty, all
+// attributes are written in alphabetical order. Values
+// that are not safe strings are base64 encoded.
+QByteArray ldif_write_entry(const LdifEntry &entry, const QList<QString> &attribute_order = QList<QString>());
+
+#endif /* AD_LDIF_H */
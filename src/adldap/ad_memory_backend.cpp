@@ -0,0 +1,711 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ad_memory_backend.h"
+
+#include "ad_filter_match.h"
+#include "ad_filter_tree.h"
+#include "ad_ldif.h"
+#include "ad_object.h"
+#include "ad_utils.h"
+
+#include <ldap.h>
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QMutexLocker>
+#include <QStringList>
+#include <QUuid>
+
+#include <algorithm>
+
+#define ATTRIBUTE_LDAP_DISPLAY_NAME "lDAPDisplayName"
+#define ATTRIBUTE_SUB_CLASS_OF "subClassOf"
+#define ATTRIBUTE_UNICODE_PWD "unicodePwd"
+#define CLASS_CLASS_SCHEMA "classSchema"
+
+// Max number of paged searches that are in progress at the
+// same time
+#define PAGED_SEARCH_MAX 64
+
+static QString dn_normalize(const QString &dn);
+static int dn_separator_index(const QString &dn);
+static QString dn_parent_key(const QString &key);
+
+AdMemoryBackend::AdMemoryBackend(const QString &domain, const QString &dc, const QString &client_user) {
+    m_domain = domain;
+    m_dc = dc;
+    m_client_user = client_user;
+    m_page_size = 100;
+    usn = 0;
+    next_cookie = 0;
+}
+
+bool AdMemoryBackend::load_ldif(const QString &path, QString *error) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *error = QCoreApplication::translate("AdMemoryBackend", "Failed to open %1: %2").arg(path, file.errorString());
+
+        return false;
+    }
+
+    const QByteArray data = file.readAll();
+
+    QList<LdifEntry> entry_list;
+    const bool parse_success = ldif_parse(data, &entry_list, error);
+    if (!parse_success) {
+        return false;
+    }
+
+    for (const LdifEntry &entry : entry_list) {
+        add_entry(entry.dn, entry.attributes);
+    }
+
+    return true;
+}
+
+void AdMemoryBackend::add_entry(const QString &dn, const QHash<QString, QList<QByteArray>> &attributes) {
+    QMutexLocker locker(&mutex);
+
+    const QString key = dn_normalize(dn);
+
+    if (entry_map.contains(key)) {
+        take_entry(key);
+    }
+
+    Entry entry;
+    entry.dn = dn;
+    entry.attributes = attributes;
+
+    insert_entry(key, entry);
+
+    // NOTE: keep usn ahead of seeded values, so that
+    // changes made later are "newer" than the dataset
+    const QString usn_attribute = attributes_data_find_name(attributes, ATTRIBUTE_USN_CHANGED);
+    if (!usn_attribute.isEmpty()) {
+        const qint64 entry_usn = attributes[usn_attribute].value(0).toLongLong();
+        usn = std::max(usn, entry_usn);
+    }
+}
+
+void AdMemoryBackend::set_page_size(const int page_size) {
+    QMutexLocker locker(&mutex);
+
+    m_page_size = std::max(page_size, 1);
+}
+
+int AdMemoryBackend::entry_count() const {
+    QMutexLocker locker(&mutex);
+
+    return entry_map.size();
+}
+
+QString AdMemoryBackend::domain() const {
+    return m_domain;
+}
+
+QString AdMemoryBackend::dc() const {
+    return m_dc;
+}
+
+QString AdMemoryBackend::client_user() const {
+    return m_client_user;
+}
+
+int AdMemoryBackend::search(const QString &base, const SearchScope scope, const QString &filter, const QList<QString> &attributes, QHash<QString, AdObject> *results, int *cookie) {
+    QMutexLocker locker(&mutex);
+
+    const QString base_key = dn_normalize(base);
+    if (!entry_map.contains(base_key)) {
+        *cookie = 0;
+
+        return LDAP_NO_SUCH_OBJECT;
+    }
+
+    FilterNode filter_node;
+    const bool filter_is_empty = filter.trimmed().isEmpty();
+    if (!filter_is_empty) {
+        const bool parse_success = filter_parse(filter, &filter_node);
+        if (!parse_success) {
+            *cookie = 0;
+
+            return LDAP_FILTER_ERROR;
+        }
+    }
+
+    // NOTE: matching is done once, on the first page. Keys
+    // of matching entries are stored under the cookie that
+    // is returned and later pages are sliced from them.
+    if (*cookie != 0 && !paged_search_map.contains(*cookie)) {
+        *cookie = 0;
+
+        return LDAP_UNWILLING_TO_PERFORM;
+    }
+
+    if (*cookie == 0) {
+        const QList<QString> scope_keys = get_scope_keys(base_key, scope);
+
+        const FilterValueGetter get_values_for_match = [this](const QString &dn, const QString &attribute) {
+            const QString key = dn_normalize(dn);
+            if (!entry_map.contains(key)) {
+                return QList<QByteArray>();
+            }
+
+            return get_values(entry_map[key], attribute);
+        };
+
+        PagedSearch paged_search;
+        paged_search.position = 0;
+
+        for (const QString &key : scope_keys) {
+            const Entry &entry = entry_map[key];
+
+            const bool is_match = (filter_is_empty || filter_match(filter_node, entry.dn, get_values_for_match, nullptr));
+            if (is_match) {
+                paged_search.key_list.append(key);
+            }
+        }
+
+        // NOTE: searches that were abandoned before last
+        // page are never finished, drop oldest ones
+        if (paged_search_map.size() >= PAGED_SEARCH_MAX) {
+            const QList<int> cookie_list = paged_search_map.keys();
+            const int oldest_cookie = *std::min_element(cookie_list.begin(), cookie_list.end());
+            paged_search_map.remove(oldest_cookie);
+        }
+
+        next_cookie++;
+        *cookie = next_cookie;
+        paged_search_map[*cookie] = paged_search;
+    }
+
+    PagedSearch &paged_search = paged_search_map[*cookie];
+    const int page_end = qMin(paged_search.position + m_page_size, paged_search.key_list.size());
+
+    for (int i = paged_search.position; i < page_end; i++) {
+        const QString &key = paged_search.key_list[i];
+
+        // NOTE: entry may have been deleted since first page
+        if (!entry_map.contains(key)) {
+            continue;
+        }
+
+        const Entry &entry = entry_map[key];
+
+        AdObject object;
+        object.load(entry.dn, get_projection(entry, attributes));
+        results->insert(entry.dn, object);
+    }
+
+    paged_search.position = page_end;
+
+    if (paged_search.position >= paged_search.key_list.size()) {
+        paged_search_map.remove(*cookie);
+        *cookie = 0;
+    }
+
+    return LDAP_SUCCESS;
+}
+
+int AdMemoryBackend::add(const QString &dn, const QHash<QString, QList<QByteArray>> &attributes) {
+    QMutexLocker locker(&mutex);
+
+    const QString key = dn_normalize(dn);
+    if (entry_map.contains(key)) {
+        return LDAP_ALREADY_EXISTS;
+    }
+
+    const QString parent_key = dn_parent_key(key);
+    if (!entry_map.contains(parent_key)) {
+        return LDAP_NO_SUCH_OBJECT;
+    }
+
+    const QString object_class_attribute = attributes_data_find_name(attributes, ATTRIBUTE_OBJECT_CLASS);
+    if (object_class_attribute.isEmpty() || attributes[object_class_attribute].isEmpty()) {
+        return LDAP_OBJECT_CLASS_VIOLATION;
+    }
+
+    Entry entry;
+    entry.dn = dn;
+    entry.attributes = attributes;
+    entry.attributes.remove(attributes_data_find_name(attributes, ATTRIBUTE_UNICODE_PWD));
+
+    const QList<QByteArray> class_chain = get_class_chain(attributes[object_class_attribute]);
+    entry.attributes[object_class_attribute] = class_chain;
+
+    const QString rdn = dn.left(dn_separator_index(dn));
+    const QString rdn_attribute = rdn.left(rdn.indexOf('=')).toLower();
+    const QByteArray name = dn_get_name(rdn).toUtf8();
+    if (attributes_data_find_name(entry.attributes, rdn_attribute).isEmpty()) {
+        entry.attributes[rdn_attribute] = {name};
+    }
+    entry.attributes[ATTRIBUTE_NAME] = {name};
+    entry.attributes[ATTRIBUTE_DN] = {dn.toUtf8()};
+    entry.attributes[ATTRIBUTE_OBJECT_GUID] = {QUuid::createUuid().toRfc4122()};
+
+    const bool need_category = attributes_data_find_name(entry.attributes, ATTRIBUTE_OBJECT_CATEGORY).isEmpty();
+    const QString class_schema_key = class_schema_map.value(QString::fromUtf8(class_chain.last()).toLower());
+    if (need_category && entry_map.contains(class_schema_key)) {
+        const QList<QByteArray> category = get_values(entry_map[class_schema_key], ATTRIBUTE_DEFAULT_OBJECT_CATEGORY);
+
+        if (!category.isEmpty()) {
+            entry.attributes[ATTRIBUTE_OBJECT_CATEGORY] = category;
+        }
+    }
+
+    stamp_entry(&entry, true);
+    insert_entry(key, entry);
+
+    return LDAP_SUCCESS;
+}
+
+int AdMemoryBackend::modify(const QString &dn, const QList<AdBackendMod> &mod_list) {
+    QMutexLocker locker(&mutex);
+
+    const QString key = dn_normalize(dn);
+    if (!entry_map.contains(key)) {
+        return LDAP_NO_SUCH_OBJECT;
+    }
+
+    Entry entry = entry_map[key];
+
+    for (const AdBackendMod &mod : mod_list) {
+        // NOTE: passwords are accepted but never
+        // returned, same as in AD
+        if (mod.attribute.compare(ATTRIBUTE_UNICODE_PWD, Qt::CaseInsensitive) == 0) {
+            continue;
+        }
+
+        const QString existing_attribute = attributes_data_find_name(entry.attributes, mod.attribute);
+        const QString attribute = existing_attribute.isEmpty() ? mod.attribute : existing_attribute;
+        QList<QByteArray> values = entry.attributes.value(attribute);
+
+        switch (mod.op) {
+            case AdBackendModOp_Add: {
+                for (const QByteArray &value : mod.values) {
+                    if (values.contains(value)) {
+                        return LDAP_TYPE_OR_VALUE_EXISTS;
+                    }
+
+                    values.append(value);
+                }
+
+                break;
+            }
+            case AdBackendModOp_Delete: {
+                if (existing_attribute.isEmpty()) {
+                    return LDAP_NO_SUCH_ATTRIBUTE;
+                }
+
+                if (mod.values.isEmpty()) {
+                    values.clear();
+                }
+
+                for (const QByteArray &value : mod.values) {
+                    const bool removed = values.removeOne(value);
+
+                    if (!removed) {
+                        return LDAP_NO_SUCH_ATTRIBUTE;
+                    }
+                }
+
+                break;
+            }
+            case AdBackendModOp_Replace: {
+                values = mod.values;
+
+                break;
+            }
+        }
+
+        if (values.isEmpty()) {
+            entry.attributes.remove(attribute);
+        } else {
+            entry.attributes[attribute] = values;
+        }
+    }
+
+    stamp_entry(&entry, false);
+
+    unindex_entry(key);
+    entry_map[key] = entry;
+    index_entry(key);
+
+    return LDAP_SUCCESS;
+}
+
+int AdMemoryBackend::remove(const QString &dn, const bool tree_delete) {
+    QMutexLocker locker(&mutex);
+
+    const QString key = dn_normalize(dn);
+    if (!entry_map.contains(key)) {
+        return LDAP_NO_SUCH_OBJECT;
+    }
+
+    const bool has_children = !children_map.value(key).isEmpty();
+    if (has_children && !tree_delete) {
+        return LDAP_NOT_ALLOWED_ON_NONLEAF;
+    }
+
+    // NOTE: delete deepest objects first
+    QList<QString> subtree_keys = get_scope_keys(key, SearchScope_All);
+    std::reverse(subtree_keys.begin(), subtree_keys.end());
+
+    for (const QString &subtree_key : subtree_keys) {
+        // Remove deleted object from groups, same as AD
+        // does for linked attributes
+        const QSet<QString> group_key_set = member_of_map.value(subtree_key);
+        for (const QString &group_key : group_key_set) {
+            unindex_entry(group_key);
+
+            Entry &group = entry_map[group_key];
+            const QString member_attribute = attributes_data_find_name(group.attributes, ATTRIBUTE_MEMBER);
+            QList<QByteArray> &member_list = group.attributes[member_attribute];
+            member_list.erase(std::remove_if(member_list.begin(), member_list.end(), [&](const QByteArray &member) {
+                return (dn_normalize(QString::fromUtf8(member)) == subtree_key);
+            }), member_list.end());
+            if (member_list.isEmpty()) {
+                group.attributes.remove(member_attribute);
+            }
+
+            index_entry(group_key);
+        }
+
+        take_entry(subtree_key);
+    }
+
+    return LDAP_SUCCESS;
+}
+
+int AdMemoryBackend::rename(const QString &dn, const QString &new_rdn, const QString &new_superior) {
+    QMutexLocker locker(&mutex);
+
+    const QString key = dn_normalize(dn);
+    if (!entry_map.contains(key)) {
+        return LDAP_NO_SUCH_OBJECT;
+    }
+
+    const QString new_parent = [&]() {
+        if (new_superior.isEmpty()) {
+            const QString &old_dn = entry_map[key].dn;
+
+            return old_dn.mid(dn_separator_index(old_dn) + 1);
+        } else {
+            return new_superior;
+        }
+    }();
+
+    if (!entry_map.contains(dn_normalize(new_parent))) {
+        return LDAP_NO_SUCH_OBJECT;
+    }
+
+    const QString new_dn = QString("%1,%2").arg(new_rdn, new_parent);
+    const QString new_key = dn_normalize(new_dn);
+    if (new_key == key) {
+        return LDAP_SUCCESS;
+    }
+    if (entry_map.contains(new_key)) {
+        return LDAP_ALREADY_EXISTS;
+    }
+    if (new_key.endsWith("," + key)) {
+        return LDAP_UNWILLING_TO_PERFORM;
+    }
+
+    const QList<QString> subtree_keys = get_scope_keys(key, SearchScope_All);
+    const QString old_root_dn = entry_map[key].dn;
+
+    auto get_moved_dn = [&](const QString &old_dn) {
+        const QString prefix = old_dn.left(old_dn.size() - old_root_dn.size());
+
+        return prefix + new_dn;
+    };
+
+    // Update links to moved objects
+    for (const QString &subtree_key : subtree_keys) {
+        const QString moved_dn = get_moved_dn(entry_map[subtree_key].dn);
+
+        const QSet<QString> group_key_set = member_of_map.value(subtree_key);
+        for (const QString &group_key : group_key_set) {
+            unindex_entry(group_key);
+
+            Entry &group = entry_map[group_key];
+            const QString member_attribute = attributes_data_find_name(group.attributes, ATTRIBUTE_MEMBER);
+            for (QByteArray &member : group.attributes[member_attribute]) {
+                if (dn_normalize(QString::fromUtf8(member)) == subtree_key) {
+                    member = moved_dn.toUtf8();
+                }
+            }
+
+            index_entry(group_key);
+        }
+    }
+
+    QList<Entry> moved_list;
+    for (const QString &subtree_key : subtree_keys) {
+        Entry entry = entry_map[subtree_key];
+        entry.dn = get_moved_dn(entry.dn);
+        entry.attributes[attributes_data_find_name(entry.attributes, ATTRIBUTE_DN)] = {entry.dn.toUtf8()};
+
+        moved_list.append(entry);
+
+        take_entry(subtree_key);
+    }
+
+    Entry &root = moved_list.first();
+    const QString rdn_attribute = new_rdn.left(new_rdn.indexOf('=')).toLower();
+    const QByteArray name = dn_get_name(new_rdn).toUtf8();
+    const QString existing_rdn_attribute = attributes_data_find_name(root.attributes, rdn_attribute);
+    root.attributes[existing_rdn_attribute.isEmpty() ? rdn_attribute : existing_rdn_attribute] = {name};
+    root.attributes[ATTRIBUTE_NAME] = {name};
+    stamp_entry(&root, false);
+
+    for (const Entry &entry : moved_list) {
+        insert_entry(dn_normalize(entry.dn), entry);
+    }
+
+    return LDAP_SUCCESS;
+}
+
+void AdMemoryBackend::insert_entry(const QString &key, const Entry &entry) {
+    entry_map.insert(key, entry);
+
+    if (!key.isEmpty()) {
+        children_map[dn_parent_key(key)].insert(key);
+    }
+
+    index_entry(key);
+}
+
+void AdMemoryBackend::take_entry(const QString &key) {
+    unindex_entry(key);
+
+    entry_map.remove(key);
+
+    if (!key.isEmpty()) {
+        children_map[dn_parent_key(key)].remove(key);
+    }
+}
+
+void AdMemoryBackend::index_entry(const QString &key) {
+    const Entry &entry = entry_map[key];
+
+    for (const QByteArray &member : get_values(entry, ATTRIBUTE_MEMBER)) {
+        const QString member_key = dn_normalize(QString::fromUtf8(member));
+        member_of_map[member_key].insert(key);
+    }
+
+    const bool is_class_schema = get_values(entry, ATTRIBUTE_OBJECT_CLASS).contains(CLASS_CLASS_SCHEMA);
+    if (is_class_schema) {
+        const QString class_name = QString::fromUtf8(get_values(entry, ATTRIBUTE_LDAP_DISPLAY_NAME).value(0)).toLower();
+        class_schema_map[class_name] = key;
+    }
+}
+
+void AdMemoryBackend::unindex_entry(const QString &key) {
+    const Entry &entry = entry_map[key];
+
+    for (const QByteArray &member : get_values(entry, ATTRIBUTE_MEMBER)) {
+        const QString member_key = dn_normalize(QString::fromUtf8(member));
+        member_of_map[member_key].remove(key);
+
+        if (member_of_map[member_key].isEmpty()) {
+            member_of_map.remove(member_key);
+        }
+    }
+
+    const bool is_class_schema = get_values(entry, ATTRIBUTE_OBJECT_CLASS).contains(CLASS_CLASS_SCHEMA);
+    if (is_class_schema) {
+        const QString class_name = QString::fromUtf8(get_values(entry, ATTRIBUTE_LDAP_DISPLAY_NAME).value(0)).toLower();
+        class_schema_map.remove(class_name);
+    }
+}
+
+// Returns keys in a stable order, parents before their
+// children
+QList<QString> AdMemoryBackend::get_scope_keys(const QString &base_key, const SearchScope scope) const {
+    auto get_sorted_children = [&](const QString &key) {
+        QList<QString> out = children_map.value(key).values();
+        std::sort(out.begin(), out.end());
+
+        return out;
+    };
+
+    switch (scope) {
+        case SearchScope_Object: return {base_key};
+        case SearchScope_Children: return get_sorted_children(base_key);
+        case SearchScope_Descendants:
+        case SearchScope_All: {
+            QList<QString> out;
+
+            QList<QString> stack = {base_key};
+            while (!stack.isEmpty()) {
+                const QString key = stack.takeLast();
+                out.append(key);
+
+                QList<QString> children = get_sorted_children(key);
+                std::reverse(children.begin(), children.end());
+                stack.append(children);
+            }
+
+            if (scope == SearchScope_Descendants) {
+                out.removeFirst();
+            }
+
+            return out;
+        }
+    }
+
+    return QList<QString>();
+}
+
+QList<QByteArray> AdMemoryBackend::get_values(const Entry &entry, const QString &attribute) const {
+    // NOTE: memberOf is a backlink, which is not stored
+    // but constructed from member values of groups
+    if (attribute.compare(ATTRIBUTE_MEMBER_OF, Qt::CaseInsensitive) == 0) {
+        const QSet<QString> group_key_set = member_of_map.value(dn_normalize(entry.dn));
+
+        QList<QString> group_key_list = group_key_set.values();
+        std::sort(group_key_list.begin(), group_key_list.end());
+
+        QList<QByteArray> out;
+        for (const QString &group_key : group_key_list) {
+            out.append(entry_map[group_key].dn.toUtf8());
+        }
+
+        return out;
+    }
+
+    // NOTE: highestCommittedUSN of rootDSE is the usn of
+    // the latest change
+    const bool is_highest_usn = (entry.dn.isEmpty() && attribute.compare(ATTRIBUTE_HIGHEST_COMMITTED_USN, Qt::CaseInsensitive) == 0);
+    if (is_highest_usn) {
+        return {QByteArray::number(usn)};
+    }
+
+    const QString found_attribute = attributes_data_find_name(entry.attributes, attribute);
+
+    return entry.attributes.value(found_attribute);
+}
+
+QHash<QString, QList<QByteArray>> AdMemoryBackend::get_projection(const Entry &entry, const QList<QString> &attributes) const {
+    const bool get_all = (attributes.isEmpty() || attributes.contains("*"));
+
+    QHash<QString, QList<QByteArray>> out;
+
+    if (get_all) {
+        out = entry.attributes;
+    } else {
+        for (const QString &attribute : attributes) {
+            const QString found_attribute = attributes_data_find_name(entry.attributes, attribute);
+
+            if (!found_attribute.isEmpty()) {
+                out[found_attribute] = entry.attributes[found_attribute];
+            }
+        }
+    }
+
+    const bool need_member_of = (get_all || QStringList(attributes).contains(ATTRIBUTE_MEMBER_OF, Qt::CaseInsensitive));
+    if (need_member_of) {
+        const QList<QByteArray> member_of = get_values(entry, ATTRIBUTE_MEMBER_OF);
+
+        if (!member_of.isEmpty()) {
+            out[ATTRIBUTE_MEMBER_OF] = member_of;
+        }
+    }
+
+    const bool need_highest_usn = (entry.dn.isEmpty() && (get_all || QStringList(attributes).contains(ATTRIBUTE_HIGHEST_COMMITTED_USN, Qt::CaseInsensitive)));
+    if (need_highest_usn) {
+        out[ATTRIBUTE_HIGHEST_COMMITTED_USN] = get_values(entry, ATTRIBUTE_HIGHEST_COMMITTED_USN);
+    }
+
+    return out;
+}
+
+// Expands objectClass values into full inheritance chain,
+// using classSchema objects from the dataset. If class is
+// not in the schema, values are left as is.
+QList<QByteArray> AdMemoryBackend::get_class_chain(const QList<QByteArray> &object_class_list) const {
+    if (object_class_list.isEmpty()) {
+        return object_class_list;
+    }
+
+    QList<QByteArray> out;
+
+    QString current_class = QString::fromUtf8(object_class_list.last());
+    while (!current_class.isEmpty()) {
+        const QString class_key = class_schema_map.value(current_class.toLower());
+        if (!entry_map.contains(class_key)) {
+            return object_class_list;
+        }
+
+        const Entry &class_entry = entry_map[class_key];
+        const QByteArray class_name = get_values(class_entry, ATTRIBUTE_LDAP_DISPLAY_NAME).value(0);
+        out.prepend(class_name);
+
+        const QString super_class = QString::fromUtf8(get_values(class_entry, ATTRIBUTE_SUB_CLASS_OF).value(0));
+        const bool reached_top = (super_class.isEmpty() || super_class.compare(current_class, Qt::CaseInsensitive) == 0);
+        if (reached_top) {
+            break;
+        }
+
+        current_class = super_class;
+    }
+
+    return out;
+}
+
+void AdMemoryBackend::stamp_entry(Entry *entry, const bool is_new) {
+    usn++;
+
+    const QByteArray usn_bytes = QByteArray::number(usn);
+    const QByteArray time_bytes = QDateTime::currentDateTimeUtc().toString("yyyyMMddhhmmss.0Z").toUtf8();
+
+    if (is_new) {
+        entry->attributes[ATTRIBUTE_USN_CREATED] = {usn_bytes};
+        entry->attributes[ATTRIBUTE_WHEN_CREATED] = {time_bytes};
+    }
+
+    entry->attributes[ATTRIBUTE_USN_CHANGED] = {usn_bytes};
+    entry->attributes[ATTRIBUTE_WHEN_CHANGED] = {time_bytes};
+}
+
+static QString dn_normalize(const QString &dn) {
+    return dn.trimmed().toLower();
+}
+
+// Returns index of the comma that separates rdn from
+// parent dn, skipping escaped commas. If there's no
+// parent, returns size of dn.
+static int dn_separator_index(const QString &dn) {
+    for (int i = 0; i < dn.size(); i++) {
+        if (dn[i] == '\\') {
+            i++;
+        } else if (dn[i] == ',') {
+            return i;
+        }
+    }
+
+    return dn.size();
+}
+
+static QString dn_parent_key(const QString &key) {
+    return key.mid(dn_separator_index(key) + 1);
+}
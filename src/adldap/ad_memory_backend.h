@@ -0,0 +1,116 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AD_MEMORY_BACKEND_H
+#define AD_MEMORY_BACKEND_H
+
+/**
+ * Directory that lives in process memory. Serves searches
+ * and modifications from a dataset seeded from LDIF, so
+ * code that uses AdInterface can be run without a domain.
+ * To use it, create an instance, seed it and install it
+ * with AdInterface::set_backend().
+ *
+ * Emulates the parts of AD that ADMC depends on: paged
+ * searches with filters (including the bit and in-chain
+ * matching rules), the memberOf backlink, objectClass
+ * inheritance chain and objectCategory of new objects
+ * (if schema is present in the dataset), tree delete and
+ * bookkeeping attributes like uSNChanged and
+ * highestCommittedUSN of rootDSE. Access control,
+ * security descriptor controls and SYSVOL are not
+ * emulated.
+ */
+
+#include "ad_backend.h"
+
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QSet>
+
+class AdMemoryBackend final : public AdBackend {
+public:
+    AdMemoryBackend(const QString &domain, const QString &dc, const QString &client_user);
+
+    // Adds entries from LDIF file to the dataset
+    bool load_ldif(const QString &path, QString *error);
+
+    // Adds an entry as is, without any of the processing
+    // done by add()
+    void add_entry(const QString &dn, const QHash<QString, QList<QByteArray>> &attributes);
+
+    void set_page_size(const int page_size);
+    int entry_count() const;
+
+    QString domain() const override;
+    QString dc() const override;
+    QString client_user() const override;
+
+    int search(const QString &base, const SearchScope scope, const QString &filter, const QList<QString> &attributes, QHash<QString, AdObject> *results, int *cookie) override;
+    int add(const QString &dn, const QHash<QString, QList<QByteArray>> &attributes) override;
+    int modify(const QString &dn, const QList<AdBackendMod> &mod_list) override;
+    int remove(const QString &dn, const bool tree_delete) override;
+    int rename(const QString &dn, const QString &new_rdn, const QString &new_superior) override;
+
+private:
+    class Entry {
+    public:
+        QString dn;
+        QHash<QString, QList<QByteArray>> attributes;
+    };
+
+    // Keys of entries that matched a paged search and
+    // position of the next page
+    class PagedSearch {
+    public:
+        QList<QString> key_list;
+        int position;
+    };
+
+    mutable QMutex mutex;
+    QString m_domain;
+    QString m_dc;
+    QString m_client_user;
+    int m_page_size;
+    qint64 usn;
+    int next_cookie;
+    QHash<int, PagedSearch> paged_search_map;
+
+    // All maps are keyed by normalized (lowercase) DN's
+    QMap<QString, Entry> entry_map;
+    QHash<QString, QSet<QString>> children_map;
+    QHash<QString, QSet<QString>> member_of_map;
+
+    // lDAPDisplayName (lowercase) => classSchema key
+    QHash<QString, QString> class_schema_map;
+
+    void insert_entry(const QString &key, const Entry &entry);
+    void take_entry(const QString &key);
+    void index_entry(const QString &key);
+    void unindex_entry(const QString &key);
+    QList<QString> get_scope_keys(const QString &base_key, const SearchScope scope) const;
+    QList<QByteArray> get_values(const Entry &entry, const QString &attribute) const;
+    QHash<QString, QList<QByteArray>> get_projection(const Entry &entry, const QList<QString> &attributes) const;
+    QList<QByteArray> get_class_chain(const QList<QByteArray> &object_class_list) const;
+    void stamp_entry(Entry *entry, const bool is_new);
+};
+
+#endif /* AD_MEMORY_BACKEND_H */
@@ -0,0 +1,260 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ad_metrics.h"
+
+#include "ad_utils.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <cmath>
+
+// NOTE: enough to cover everything that happens during a
+// few console actions
+#define RECORDS_MAX 1000
+
+#define HISTOGRAM_BUCKET_COUNT 16
+
+static QJsonObject record_to_json(const AdOperationRecord &record);
+static QJsonObject histogram_to_json(const AdHistogram &histogram);
+
+static QMutex metrics_mutex;
+static QList<AdOperationRecord> metrics_records;
+static AdOperationStats metrics_stats[AdOperationType_COUNT];
+
+AdOperationRecord::AdOperationRecord() {
+    type = AdOperationType_Search;
+    scope = SearchScope_Object;
+    filter_hash = 0;
+    result = 0;
+    pages = 0;
+    entries = 0;
+    bytes = 0;
+    first_entry_time = -1;
+    total_time = 0;
+    wait_time = 0;
+    decode_time = 0;
+}
+
+AdHistogram::AdHistogram() {
+    buckets = QVector<int>(HISTOGRAM_BUCKET_COUNT, 0);
+    total = 0;
+}
+
+void AdHistogram::add(const qint64 duration) {
+    const int i = [&]() {
+        for (int bucket = 0; bucket < HISTOGRAM_BUCKET_COUNT - 1; bucket++) {
+            // NOTE: duration is in microseconds and bounds
+            // are in milliseconds
+            if (duration < bucket_bound(bucket) * 1000) {
+                return bucket;
+            }
+        }
+
+        return HISTOGRAM_BUCKET_COUNT - 1;
+    }();
+
+    buckets[i]++;
+    total++;
+}
+
+int AdHistogram::count() const {
+    return total;
+}
+
+int AdHistogram::bucket_count() const {
+    return buckets.size();
+}
+
+int AdHistogram::get_bucket(const int i) const {
+    return buckets.value(i, 0);
+}
+
+qint64 AdHistogram::bucket_bound(const int i) {
+    if (i >= HISTOGRAM_BUCKET_COUNT - 1) {
+        return -1;
+    } else {
+        return ((qint64) 1) << i;
+    }
+}
+
+qint64 AdHistogram::percentile(const double p) const {
+    if (total == 0) {
+        return 0;
+    }
+
+    const int target = (int) std::ceil(total * p);
+
+    int sum = 0;
+    for (int i = 0; i < buckets.size(); i++) {
+        sum += buckets[i];
+
+        if (sum >= target) {
+            return bucket_bound(i);
+        }
+    }
+
+    return -1;
+}
+
+AdOperationStats::AdOperationStats() {
+    count = 0;
+    error_count = 0;
+    entries = 0;
+    bytes = 0;
+    total_time = 0;
+    max_time = 0;
+}
+
+void ad_metrics_record(const AdOperationRecord &record) {
+    QMutexLocker locker(&metrics_mutex);
+
+    metrics_records.append(record);
+    if (metrics_records.size() > RECORDS_MAX) {
+        metrics_records.removeFirst();
+    }
+
+    AdOperationStats &stats = metrics_stats[record.type];
+    stats.count++;
+    if (record.result != 0) {
+        stats.error_count++;
+    }
+    stats.entries += record.entries;
+    stats.bytes += record.bytes;
+    stats.total_time += record.total_time;
+    stats.max_time = qMax(stats.max_time, record.total_time);
+    stats.total_histogram.add(record.total_time);
+    if (record.first_entry_time >= 0) {
+        stats.first_entry_histogram.add(record.first_entry_time);
+    }
+}
+
+QList<AdOperationRecord> ad_metrics_get_records() {
+    QMutexLocker locker(&metrics_mutex);
+
+    return metrics_records;
+}
+
+AdOperationStats ad_metrics_get_stats(const AdOperationType type) {
+    QMutexLocker locker(&metrics_mutex);
+
+    return metrics_stats[type];
+}
+
+void ad_metrics_clear() {
+    QMutexLocker locker(&metrics_mutex);
+
+    metrics_records.clear();
+
+    for (int i = 0; i < AdOperationType_COUNT; i++) {
+        metrics_stats[i] = AdOperationStats();
+    }
+}
+
+QByteArray ad_metrics_to_json() {
+    const QList<AdOperationRecord> record_list = ad_metrics_get_records();
+
+    QJsonObject stats_json;
+    for (int i = 0; i < AdOperationType_COUNT; i++) {
+        const AdOperationType type = (AdOperationType) i;
+        const AdOperationStats stats = ad_metrics_get_stats(type);
+
+        QJsonObject type_json;
+        type_json["count"] = stats.count;
+        type_json["error_count"] = stats.error_count;
+        type_json["entries"] = stats.entries;
+        type_json["bytes"] = stats.bytes;
+        type_json["total_time_us"] = stats.total_time;
+        type_json["max_time_us"] = stats.max_time;
+        type_json["total_time_histogram"] = histogram_to_json(stats.total_histogram);
+        type_json["first_entry_time_histogram"] = histogram_to_json(stats.first_entry_histogram);
+
+        stats_json[ad_operation_type_string(type)] = type_json;
+    }
+
+    QJsonArray records_json;
+    for (const AdOperationRecord &record : record_list) {
+        records_json.append(record_to_json(record));
+    }
+
+    QJsonObject out;
+    out["stats"] = stats_json;
+    out["operations"] = records_json;
+
+    const QJsonDocument document(out);
+
+    return document.toJson();
+}
+
+QString ad_operation_type_string(const AdOperationType type) {
+    switch (type) {
+        case AdOperationType_Search: return "search";
+        case AdOperationType_Add: return "add";
+        case AdOperationType_Modify: return "modify";
+        case AdOperationType_Delete: return "delete";
+        case AdOperationType_Rename: return "rename";
+        case AdOperationType_COUNT: return "COUNT";
+    }
+    return "";
+}
+
+static QJsonObject record_to_json(const AdOperationRecord &record) {
+    QJsonObject out;
+    out["type"] = ad_operation_type_string(record.type);
+    out["start"] = record.start.toString(Qt::ISODateWithMs);
+    out["base"] = record.base;
+    out["result"] = record.result;
+    out["total_time_us"] = record.total_time;
+
+    if (record.type == AdOperationType_Search) {
+        out["scope"] = search_scope_string(record.scope);
+        out["filter_hash"] = QString::number(record.filter_hash, 16);
+        out["pages"] = record.pages;
+        out["entries"] = record.entries;
+        out["bytes"] = record.bytes;
+        out["first_entry_time_us"] = record.first_entry_time;
+        out["wait_time_us"] = record.wait_time;
+        out["decode_time_us"] = record.decode_time;
+    }
+
+    return out;
+}
+
+static QJsonObject histogram_to_json(const AdHistogram &histogram) {
+    QJsonArray bounds_json;
+    QJsonArray counts_json;
+    for (int i = 0; i < histogram.bucket_count(); i++) {
+        bounds_json.append(AdHistogram::bucket_bound(i));
+        counts_json.append(histogram.get_bucket(i));
+    }
+
+    QJsonObject out;
+    out["bounds_ms"] = bounds_json;
+    out["counts"] = counts_json;
+    out["p50_ms"] = histogram.percentile(0.5);
+    out["p90_ms"] = histogram.percentile(0.9);
+    out["p99_ms"] = histogram.percentile(0.99);
+
+    return out;
+}
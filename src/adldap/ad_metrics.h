@@ -0,0 +1,134 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AD_METRICS_H
+#define AD_METRICS_H
+
+/**
+ * Per-operation metrics collected by AdInterface. Each
+ * search (all of it's pages) and each modification is
+ * recorded once it finishes. Metrics are kept for the whole
+ * session: recent operations are stored as is and all
+ * operations are aggregated into duration histograms per
+ * operation type. Functions are thread-safe because
+ * AdInterface's are used from search threads.
+ */
+
+#include "ad_defines.h"
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+enum AdOperationType {
+    AdOperationType_Search,
+    AdOperationType_Add,
+    AdOperationType_Modify,
+    AdOperationType_Delete,
+    AdOperationType_Rename,
+    AdOperationType_COUNT,
+};
+
+class AdOperationRecord {
+public:
+    AdOperationRecord();
+
+    AdOperationType type;
+    QDateTime start;
+    // Search base or target DN for modifications
+    QString base;
+    SearchScope scope;
+    // NOTE: hash instead of filter text because filters
+    // may contain sensitive values
+    uint filter_hash;
+    // LDAP result code
+    int result;
+    int pages;
+    int entries;
+    qint64 bytes;
+
+    // Durations in microseconds. Time to first entry is -1
+    // if no entries were received. Total time only counts
+    // time spent inside AdInterface, not time that caller
+    // spent between pages. Wait is time spent waiting for
+    // server responses, decode is time spent converting
+    // responses to AdObject's.
+    qint64 first_entry_time;
+    qint64 total_time;
+    qint64 wait_time;
+    qint64 decode_time;
+};
+
+// Histogram of durations with logarithmic buckets. Bucket
+// i counts durations below 2^i milliseconds that don't fit
+// into previous buckets, last bucket counts everything
+// else.
+class AdHistogram {
+public:
+    AdHistogram();
+
+    void add(const qint64 duration);
+
+    int count() const;
+    int bucket_count() const;
+    int get_bucket(const int i) const;
+
+    // Upper bound of bucket in milliseconds, -1 for last
+    // bucket
+    static qint64 bucket_bound(const int i);
+
+    // Approximate percentile in milliseconds, as bound of
+    // the bucket that contains it
+    qint64 percentile(const double p) const;
+
+private:
+    QVector<int> buckets;
+    int total;
+};
+
+class AdOperationStats {
+public:
+    AdOperationStats();
+
+    int count;
+    int error_count;
+    qint64 entries;
+    qint64 bytes;
+    qint64 total_time;
+    qint64 max_time;
+    AdHistogram total_histogram;
+    AdHistogram first_entry_histogram;
+};
+
+void ad_metrics_record(const AdOperationRecord &record);
+
+// Returns recent operations, oldest first
+QList<AdOperationRecord> ad_metrics_get_records();
+AdOperationStats ad_metrics_get_stats(const AdOperationType type);
+void ad_metrics_clear();
+
+// Dumps all metrics in JSON format
+QByteArray ad_metrics_to_json();
+
+QString ad_operation_type_string(const AdOperationType type);
+
+#endif /* AD_METRICS_H */
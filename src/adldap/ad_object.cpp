@@ -35,12 +35,25 @@
 #include <QString>
 #include <algorithm>
 
+enum AdObjectCached {
+    AdObjectCached_UserAccountControl = (1 << 0),
+    AdObjectCached_SystemFlags = (1 << 1),
+    AdObjectCached_GroupType = (1 << 2),
+    AdObjectCached_MostDerivedClass = (1 << 3),
+};
+
 AdObject::AdObject() {
+    cached_mask = 0;
+    cached_user_account_control = 0;
+    cached_system_flags = 0;
+    cached_group_type_bits = 0;
 }
 
 void AdObject::load(const QString &dn_arg, const QHash<QString, QList<QByteArray>> &attributes_data_arg) {
     dn = dn_arg;
     attributes_data = attributes_data_arg;
+
+    cached_mask = 0;
 }
 
 QString AdObject::get_dn() const {
@@ -64,18 +77,17 @@ QList<QString> AdObject::attributes() const {
 }
 
 QList<QByteArray> AdObject::get_values(const QString &attribute) const {
-    if (contains(attribute)) {
-        return attributes_data[attribute];
-    } else {
-        return QList<QByteArray>();
-    }
+    return attributes_data.value(attribute);
 }
 
+// NOTE: single value getters access values in place
+// instead of going through get_values() or other list
+// getters, which would copy and decode all values
 QByteArray AdObject::get_value(const QString &attribute) const {
-    const QList<QByteArray> values = get_values(attribute);
+    const auto it = attributes_data.constFind(attribute);
 
-    if (!values.isEmpty()) {
-        return values.first();
+    if (it != attributes_data.constEnd() && !it.value().isEmpty()) {
+        return it.value().first();
     } else {
         return QByteArray();
     }
@@ -94,18 +106,12 @@ QList<QString> AdObject::get_strings(const QString &attribute) const {
 }
 
 QString AdObject::get_string(const QString &attribute) const {
-    const QList<QString> strings = get_strings(attribute);
-
     // NOTE: return last object class because that is the most derived one and is what's needed most of the time
-    if (!strings.isEmpty()) {
-        if (attribute == ATTRIBUTE_OBJECT_CLASS) {
-            return strings.last();
-        } else {
-            return strings.first();
-        }
-    } else {
-        return QString();
+    if (attribute == ATTRIBUTE_OBJECT_CLASS) {
+        return get_most_derived_class();
     }
+
+    return QString(get_value(attribute));
 }
 
 QList<int> AdObject::get_ints(const QString &attribute) const {
@@ -121,13 +127,9 @@ QList<int> AdObject::get_ints(const QString &attribute) const {
 }
 
 int AdObject::get_int(const QString &attribute) const {
-    const QList<int> ints = get_ints(attribute);
+    const QByteArray value = get_value(attribute);
 
-    if (!ints.isEmpty()) {
-        return ints.first();
-    } else {
-        return 0;
-    }
+    return value.toInt();
 }
 
 QDateTime AdObject::get_datetime(const QString &attribute, const AdConfig *adconfig) const {
@@ -150,24 +152,50 @@ QList<bool> AdObject::get_bools(const QString &attribute) const {
 }
 
 bool AdObject::get_bool(const QString &attribute) const {
-    const QList<bool> bools = get_bools(attribute);
+    const auto it = attributes_data.constFind(attribute);
 
-    if (!bools.isEmpty()) {
-        return bools.first();
+    if (it != attributes_data.constEnd() && !it.value().isEmpty()) {
+        const QString string = QString(it.value().first());
+
+        return ad_string_to_bool(string);
     } else {
         return false;
     }
 }
 
-bool AdObject::get_system_flag(const SystemFlagsBit bit) const {
-    if (contains(ATTRIBUTE_SYSTEM_FLAGS)) {
-        const int system_flags_bits = get_int(ATTRIBUTE_SYSTEM_FLAGS);
-        const bool is_set = bitmask_is_set(system_flags_bits, bit);
+int AdObject::get_user_account_control() const {
+    return get_cached_int(ATTRIBUTE_USER_ACCOUNT_CONTROL, AdObjectCached_UserAccountControl, &cached_user_account_control);
+}
 
-        return is_set;
-    } else {
-        return false;
+int AdObject::get_system_flags() const {
+    return get_cached_int(ATTRIBUTE_SYSTEM_FLAGS, AdObjectCached_SystemFlags, &cached_system_flags);
+}
+
+int AdObject::get_group_type_bits() const {
+    return get_cached_int(ATTRIBUTE_GROUP_TYPE, AdObjectCached_GroupType, &cached_group_type_bits);
+}
+
+QString AdObject::get_most_derived_class() const {
+    if (!(cached_mask & AdObjectCached_MostDerivedClass)) {
+        const auto it = attributes_data.constFind(ATTRIBUTE_OBJECT_CLASS);
+
+        if (it != attributes_data.constEnd() && !it.value().isEmpty()) {
+            cached_most_derived_class = QString(it.value().last());
+        } else {
+            cached_most_derived_class = QString();
+        }
+
+        cached_mask |= AdObjectCached_MostDerivedClass;
     }
+
+    return cached_most_derived_class;
+}
+
+bool AdObject::get_system_flag(const SystemFlagsBit bit) const {
+    const int system_flags_bits = get_system_flags();
+    const bool is_set = bitmask_is_set(system_flags_bits, bit);
+
+    return is_set;
 }
 
 bool AdObject::get_account_option(AccountOption option, AdConfig *adconfig) const {
@@ -189,23 +217,19 @@ bool AdObject::get_account_option(AccountOption option, AdConfig *adconfig) cons
         }
         default: {
             // Account option is a UAC bit
-            if (contains(ATTRIBUTE_USER_ACCOUNT_CONTROL)) {
-                const int control = get_int(ATTRIBUTE_USER_ACCOUNT_CONTROL);
-                const int bit = account_option_bit(option);
+            const int control = get_user_account_control();
+            const int bit = account_option_bit(option);
 
-                const bool set = ((control & bit) != 0);
+            const bool set = ((control & bit) != 0);
 
-                return set;
-            } else {
-                return false;
-            }
+            return set;
         }
     }
 }
 
 // NOTE: "group type" is really only the last bit of the groupType attribute, yeah it's confusing
 GroupType AdObject::get_group_type() const {
-    const int group_type = get_int(ATTRIBUTE_GROUP_TYPE);
+    const int group_type = get_group_type_bits();
 
     const bool security_bit_set = ((group_type & GROUP_TYPE_BIT_SECURITY) != 0);
 
@@ -217,7 +241,7 @@ GroupType AdObject::get_group_type() const {
 }
 
 GroupScope AdObject::get_group_scope() const {
-    const int group_type = get_int(ATTRIBUTE_GROUP_TYPE);
+    const int group_type = get_group_type_bits();
 
     for (int i = 0; i < GroupScope_COUNT; i++) {
         const GroupScope this_scope = (GroupScope) i;
@@ -232,7 +256,7 @@ GroupScope AdObject::get_group_scope() const {
 }
 
 bool AdObject::is_class(const QString &object_class) const {
-    const QString this_object_class = get_string(ATTRIBUTE_OBJECT_CLASS);
+    const QString this_object_class = get_most_derived_class();
     const bool is_class = (this_object_class == object_class);
 
     return is_class;
@@ -274,3 +298,12 @@ security_descriptor *AdObject::get_security_descriptor(TALLOC_CTX *mem_ctx_arg)
 
     return out;
 }
+
+int AdObject::get_cached_int(const QString &attribute, const int cached_bit, int *cached_value) const {
+    if (!(cached_mask & cached_bit)) {
+        *cached_value = get_int(attribute);
+        cached_mask |= cached_bit;
+    }
+
+    return *cached_value;
+}
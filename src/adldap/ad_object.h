@@ -29,6 +29,14 @@
  * with data once and not updated afterwards so it WILL
  * become out of date after any AD modification. Therefore,
  * do not keep it around for too long.
+ *
+ * Single value getters only decode the value that is
+ * returned. Values of attributes which are needed for
+ * almost every object (userAccountControl, systemFlags,
+ * groupType and most derived objectClass) are decoded once
+ * and cached inside the object. Because of this cache,
+ * one object instance shouldn't be used from multiple
+ * threads at the same time, copies are fine.
  */
 
 #include "ad_defines.h"
@@ -70,6 +78,13 @@ public:
 
     QDateTime get_datetime(const QString &attribute, const AdConfig *adconfig) const;
 
+    // Cached values of frequently used attributes. Return
+    // 0 or empty string if attribute is not present.
+    int get_user_account_control() const;
+    int get_system_flags() const;
+    int get_group_type_bits() const;
+    QString get_most_derived_class() const;
+
     bool get_system_flag(const SystemFlagsBit bit) const;
 
     bool get_account_option(AccountOption option, AdConfig *adconfig) const;
@@ -90,6 +105,16 @@ public:
 private:
     QString dn;
     QHash<QString, QList<QByteArray>> attributes_data;
+
+    // Bitmask of AdObjectCached values, set bits mark
+    // values which are loaded into cache
+    mutable int cached_mask;
+    mutable int cached_user_account_control;
+    mutable int cached_system_flags;
+    mutable int cached_group_type_bits;
+    mutable QString cached_most_derived_class;
+
+    int get_cached_int(const QString &attribute, const int cached_bit, int *cached_value) const;
 };
 
 #endif /* AD_OBJECT_H */
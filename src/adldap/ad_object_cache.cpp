@@ -0,0 +1,282 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ad_object_cache.h"
+
+#include "ad_object.h"
+#include "ad_utils.h"
+
+#include <QMutexLocker>
+#include <QPair>
+
+#include <algorithm>
+
+// Values longer than this are not considered to be DN's
+#define REFERENCE_SIZE_MAX 2048
+
+static QSet<QString> get_reference_set(const QHash<QString, QList<QByteArray>> &attributes_data);
+
+AdObjectCacheEntry::AdObjectCacheEntry() {
+    complete_time = -1;
+    last_load_time = 0;
+}
+
+AdObjectCache::AdObjectCache() {
+    clock.start();
+}
+
+void AdObjectCache::insert(const AdObject &object, const QList<QString> &attributes) {
+    QMutexLocker locker(&mutex);
+
+    const qint64 now = clock.elapsed();
+    const QString dn = object.get_dn();
+    const QHash<QString, QList<QByteArray>> data = object.get_attributes_data();
+    const QString key = dn.toLower();
+
+    AdObjectCacheEntry &entry = entry_map[key];
+    entry.dn = dn;
+    entry.last_load_time = now;
+
+    if (attributes.isEmpty()) {
+        entry.attributes_data = data;
+        entry.load_time_map.clear();
+        entry.complete_time = now;
+    } else {
+        // NOTE: requested attributes that weren't returned
+        // are also marked as loaded, which remembers that
+        // object doesn't have them
+        for (const QString &attribute : attributes) {
+            const QString old_attribute = attributes_data_find_name(entry.attributes_data, attribute);
+            entry.attributes_data.remove(old_attribute);
+            entry.load_time_map[attribute.toLower()] = now;
+        }
+
+        for (auto it = data.begin(); it != data.end(); it++) {
+            const QString attribute = it.key();
+            const QString old_attribute = attributes_data_find_name(entry.attributes_data, attribute);
+            entry.attributes_data.remove(old_attribute);
+            entry.attributes_data[attribute] = it.value();
+            entry.load_time_map[attribute.toLower()] = now;
+        }
+    }
+
+    update_references(key, &entry);
+
+    if (entry_map.size() > CACHE_SIZE_MAX) {
+        evict_old_entries();
+    }
+}
+
+bool AdObjectCache::get(const QString &dn, const QList<QString> &attributes, const int max_age, AdObject *object, QList<QString> *missing) const {
+    QMutexLocker locker(&mutex);
+
+    *object = AdObject();
+    missing->clear();
+
+    const qint64 now = clock.elapsed();
+
+    auto is_fresh = [&](const qint64 load_time) {
+        if (load_time < 0 || max_age == CacheMaxAge_None) {
+            return false;
+        } else if (max_age == CacheMaxAge_Any) {
+            return true;
+        } else {
+            return (now - load_time <= max_age);
+        }
+    };
+
+    const auto entry_it = entry_map.constFind(dn.toLower());
+    if (entry_it == entry_map.constEnd()) {
+        *missing = attributes;
+
+        return false;
+    }
+
+    const AdObjectCacheEntry &entry = entry_it.value();
+
+    if (attributes.isEmpty()) {
+        const bool complete_is_fresh = is_fresh(entry.complete_time);
+
+        if (complete_is_fresh) {
+            object->load(entry.dn, entry.attributes_data);
+        }
+
+        return complete_is_fresh;
+    }
+
+    QHash<QString, QList<QByteArray>> out_data;
+
+    for (const QString &attribute : attributes) {
+        const qint64 load_time = std::max(entry.load_time_map.value(attribute.toLower(), -1), entry.complete_time);
+
+        if (is_fresh(load_time)) {
+            const QString cached_attribute = attributes_data_find_name(entry.attributes_data, attribute);
+
+            if (!cached_attribute.isEmpty()) {
+                out_data[cached_attribute] = entry.attributes_data[cached_attribute];
+            }
+        } else {
+            missing->append(attribute);
+        }
+    }
+
+    object->load(entry.dn, out_data);
+
+    return missing->isEmpty();
+}
+
+void AdObjectCache::invalidate_object(const QString &dn) {
+    QMutexLocker locker(&mutex);
+
+    const auto it = entry_map.find(dn.toLower());
+    if (it != entry_map.end()) {
+        erase_entry(it);
+    }
+}
+
+void AdObjectCache::invalidate_subtree(const QString &dn) {
+    QMutexLocker locker(&mutex);
+
+    const QString dn_lower = dn.toLower();
+    const QString suffix = "," + dn_lower;
+
+    for (auto it = entry_map.begin(); it != entry_map.end();) {
+        const QString key = it.key();
+        const bool in_subtree = (key == dn_lower || key.endsWith(suffix));
+
+        if (in_subtree) {
+            it = erase_entry(it);
+        } else {
+            it++;
+        }
+    }
+}
+
+void AdObjectCache::invalidate_references(const QString &dn) {
+    QMutexLocker locker(&mutex);
+
+    // NOTE: this also matches values that only end with
+    // the DN without being a DN of a descendant, which is
+    // harmless since it only drops a few extra objects
+    const QString dn_lower = dn.toLower();
+
+    QSet<QString> key_set;
+    for (auto it = reference_map.constBegin(); it != reference_map.constEnd(); it++) {
+        if (it.key().endsWith(dn_lower)) {
+            key_set.unite(it.value());
+        }
+    }
+
+    for (const QString &key : key_set) {
+        const auto it = entry_map.find(key);
+        if (it != entry_map.end()) {
+            erase_entry(it);
+        }
+    }
+}
+
+void AdObjectCache::clear() {
+    QMutexLocker locker(&mutex);
+
+    entry_map.clear();
+    reference_map.clear();
+}
+
+int AdObjectCache::size() const {
+    QMutexLocker locker(&mutex);
+
+    return entry_map.size();
+}
+
+// NOTE: evicts older half of the cache at once, so that
+// the cost of this is spread over many inserts. Evicted
+// count is fixed instead of using a load time threshold,
+// because many entries can share the same load time when
+// they are loaded in a burst.
+void AdObjectCache::evict_old_entries() {
+    QList<QPair<qint64, QString>> age_list;
+    for (auto it = entry_map.begin(); it != entry_map.end(); it++) {
+        age_list.append({it.value().last_load_time, it.key()});
+    }
+
+    std::sort(age_list.begin(), age_list.end(),
+        [](const QPair<qint64, QString> &a, const QPair<qint64, QString> &b) {
+            return (a.first < b.first);
+        });
+
+    const int evict_count = age_list.size() / 2;
+
+    for (int i = 0; i < evict_count; i++) {
+        const QString &key = age_list[i].second;
+        const auto it = entry_map.find(key);
+
+        if (it != entry_map.end()) {
+            erase_entry(it);
+        }
+    }
+}
+
+void AdObjectCache::update_references(const QString &key, AdObjectCacheEntry *entry) {
+    remove_references(key, *entry);
+
+    entry->reference_set = get_reference_set(entry->attributes_data);
+
+    for (const QString &reference : entry->reference_set) {
+        reference_map[reference].insert(key);
+    }
+}
+
+void AdObjectCache::remove_references(const QString &key, const AdObjectCacheEntry &entry) {
+    for (const QString &reference : entry.reference_set) {
+        const auto it = reference_map.find(reference);
+
+        if (it != reference_map.end()) {
+            it.value().remove(key);
+
+            if (it.value().isEmpty()) {
+                reference_map.erase(it);
+            }
+        }
+    }
+}
+
+QHash<QString, AdObjectCacheEntry>::iterator AdObjectCache::erase_entry(QHash<QString, AdObjectCacheEntry>::iterator it) {
+    remove_references(it.key(), it.value());
+
+    return entry_map.erase(it);
+}
+
+// NOTE: only values that look like DN's are indexed. Other
+// values that happen to pass the check only cost memory.
+static QSet<QString> get_reference_set(const QHash<QString, QList<QByteArray>> &attributes_data) {
+    QSet<QString> out;
+
+    for (const QList<QByteArray> &values : attributes_data) {
+        for (const QByteArray &value : values) {
+            const bool maybe_dn = (value.size() <= REFERENCE_SIZE_MAX && value.contains('=') && value.contains(','));
+
+            if (maybe_dn) {
+                out.insert(QString::fromUtf8(value).toLower());
+            }
+        }
+    }
+
+    return out;
+}
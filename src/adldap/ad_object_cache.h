@@ -0,0 +1,136 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AD_OBJECT_CACHE_H
+#define AD_OBJECT_CACHE_H
+
+/**
+ * Session-wide cache of objects loaded by AdInterface.
+ * Objects are keyed by DN. For each object the cache
+ * remembers which attributes were loaded and when, so
+ * that partial loads of the same object are merged and a
+ * later request only has to load attributes that are
+ * missing or too old. Attributes that were requested but
+ * which the object doesn't have are remembered as well.
+ *
+ * AdInterface feeds results of all searches into the cache
+ * and invalidates affected objects after it's own
+ * successful modifications. Changes made by other clients
+ * are not tracked, which is why every read specifies how
+ * old the data is allowed to be. Functions are thread-safe
+ * because AdInterface's are used from search threads.
+ */
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+
+class AdObject;
+
+// NOTE: enough to hold a few large console containers,
+// objects beyond that are evicted starting from oldest
+#define CACHE_SIZE_MAX 20000
+
+// Max age of cached data in milliseconds
+enum CacheMaxAge {
+    // Data of any age is accepted
+    CacheMaxAge_Any = -1,
+    // Cache is not used
+    CacheMaxAge_None = 0,
+    CacheMaxAge_Default = 30000,
+};
+
+class AdObjectCacheEntry {
+public:
+    AdObjectCacheEntry();
+
+    QString dn;
+    QHash<QString, QList<QByteArray>> attributes_data;
+
+    // Load time for each attribute that was requested or
+    // loaded, including ones that object doesn't have.
+    // Keys are lowercase since attribute names are case
+    // insensitive.
+    QHash<QString, qint64> load_time_map;
+
+    // Time of last load of all attributes, -1 if all
+    // attributes were never loaded
+    qint64 complete_time;
+
+    qint64 last_load_time;
+
+    // Lowercase values that may be DN's of other objects,
+    // same as keys of this entry in reference map
+    QSet<QString> reference_set;
+};
+
+class AdObjectCache {
+public:
+    AdObjectCache();
+
+    // Stores attributes of object. "attributes" is the
+    // list that was requested when object was loaded, empty
+    // list means that all attributes were requested.
+    void insert(const AdObject &object, const QList<QString> &attributes);
+
+    // Returns true if all requested attributes are cached
+    // and are not older than "max_age". "object" is set to
+    // cached values of attributes which are fresh enough.
+    // "missing" is set to attributes that have to be
+    // loaded. Empty attributes list requests all
+    // attributes, in which case "missing" stays empty if
+    // cache can't satisfy the request.
+    bool get(const QString &dn, const QList<QString> &attributes, const int max_age, AdObject *object, QList<QString> *missing) const;
+
+    // Drops one object
+    void invalidate_object(const QString &dn);
+
+    // Drops object and all of it's descendants
+    void invalidate_subtree(const QString &dn);
+
+    // Drops objects that have values which refer to given
+    // DN or any of it's descendants. Used when DN of an
+    // object changes or when it's deleted, because the
+    // server updates references to it in other objects.
+    void invalidate_references(const QString &dn);
+
+    void clear();
+    int size() const;
+
+private:
+    mutable QMutex mutex;
+    QElapsedTimer clock;
+    QHash<QString, AdObjectCacheEntry> entry_map;
+
+    // Reverse index of references, from lowercase DN
+    // values to keys of entries that have them
+    QHash<QString, QSet<QString>> reference_map;
+
+    void evict_old_entries();
+    void update_references(const QString &key, AdObjectCacheEntry *entry);
+    void remove_references(const QString &key, const AdObjectCacheEntry &entry);
+    QHash<QString, AdObjectCacheEntry>::iterator erase_entry(QHash<QString, AdObjectCacheEntry>::iterator it);
+};
+
+#endif /* AD_OBJECT_CACHE_H */
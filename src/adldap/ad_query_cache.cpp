@@ -0,0 +1,364 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ad_query_cache.h"
+
+#include "ad_config.h"
+#include "ad_filter.h"
+#include "ad_interface.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+
+#include <algorithm>
+
+#define QUERY_CACHE_MAGIC "ADMCQC"
+
+// Increase when format of saved data changes
+#define QUERY_CACHE_VERSION 1
+
+// Max number of objects that are loaded one by one during
+// incremental refresh because they started matching
+// without being changed themselves. If there are more, all
+// objects are loaded again.
+#define QUERY_CACHE_MISSING_MAX 100
+
+bool query_cache_search(AdInterface &ad, const QString &base, const SearchScope scope, const QString &filter, const QList<QString> &attributes, QHash<QString, AdObject> *results);
+qint64 query_cache_server_usn(AdInterface &ad);
+bool query_cache_has_backlinks(const QList<QString> &attributes, const AdConfig *adconfig);
+
+AdQueryCache::AdQueryCache()
+: AdQueryCache(QString(), SearchScope_All, QString(), QList<QString>()) {
+}
+
+AdQueryCache::AdQueryCache(const QString &base_arg, const SearchScope scope_arg, const QString &filter_arg, const QList<QString> &attributes_arg) {
+    base = base_arg;
+    scope = scope_arg;
+    filter = filter_arg;
+
+    // NOTE: sort so that key doesn't depend on attribute
+    // order. uSNChanged is needed for incremental refresh,
+    // empty list means all attributes which includes it.
+    attributes = attributes_arg;
+    std::sort(attributes.begin(), attributes.end());
+
+    const bool need_usn = [&]() {
+        for (const QString &attribute : attributes) {
+            if (attribute.compare(ATTRIBUTE_USN_CHANGED, Qt::CaseInsensitive) == 0) {
+                return false;
+            }
+        }
+
+        return !attributes.isEmpty();
+    }();
+
+    if (need_usn) {
+        attributes.append(ATTRIBUTE_USN_CHANGED);
+    }
+
+    highest_usn = -1;
+}
+
+QString AdQueryCache::get_key() const {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(base.toLower().toUtf8());
+    hash.addData("\n");
+    hash.addData(QByteArray::number(scope));
+    hash.addData("\n");
+    hash.addData(filter.toUtf8());
+    hash.addData("\n");
+    hash.addData(attributes.join(",").toLower().toUtf8());
+
+    const QString out = QString(hash.result().toHex());
+
+    return out;
+}
+
+bool AdQueryCache::is_empty() const {
+    return (highest_usn == -1);
+}
+
+QList<AdObject> AdQueryCache::get_objects() const {
+    return object_map.values();
+}
+
+qint64 AdQueryCache::get_highest_usn() const {
+    return highest_usn;
+}
+
+bool AdQueryCache::refresh(AdInterface &ad, QList<AdObject> *changed, QList<QString> *removed) {
+    const QString current_dc = ad.get_dc();
+
+    // NOTE: server's usn is read before searching, so that
+    // changes made while searching are newer than it and
+    // are found by next refresh. Usn's of found objects
+    // can't be used for this, because objects returned in
+    // earlier pages may be changed again before the last
+    // page.
+    const qint64 server_usn = query_cache_server_usn(ad);
+
+    // NOTE: results are built separately and replace
+    // current ones only if all searches succeeded
+    QHash<QString, AdObject> new_object_map;
+    QList<AdObject> changed_list;
+
+    const bool incremental_done = [&]() {
+        // NOTE: changes of backlinks, like memberOf,
+        // don't change uSNChanged of the object, so
+        // incremental refresh would miss them
+        const bool can_be_incremental = (!is_empty() && current_dc == dc && !query_cache_has_backlinks(attributes, ad.adconfig()));
+        if (!can_be_incremental) {
+            return false;
+        }
+
+        QHash<QString, AdObject> dn_results;
+        const bool dn_success = query_cache_search(ad, base, scope, filter, {ATTRIBUTE_DN}, &dn_results);
+        if (!dn_success) {
+            return false;
+        }
+
+        const QString usn_filter = QString("(%1>=%2)").arg(ATTRIBUTE_USN_CHANGED, QString::number(highest_usn + 1));
+        const QString changed_filter = filter_AND({filter, usn_filter});
+
+        QHash<QString, AdObject> changed_results;
+        const bool changed_success = query_cache_search(ad, base, scope, changed_filter, attributes, &changed_results);
+        if (!changed_success) {
+            return false;
+        }
+
+        // Objects that started matching without being
+        // changed themselves, for example when filter
+        // checks a backlink
+        QList<QString> missing_list;
+        for (const QString &dn : dn_results.keys()) {
+            if (!object_map.contains(dn) && !changed_results.contains(dn)) {
+                missing_list.append(dn);
+            }
+        }
+
+        if (missing_list.size() > QUERY_CACHE_MISSING_MAX) {
+            return false;
+        }
+
+        for (const QString &dn : dn_results.keys()) {
+            if (object_map.contains(dn) && !changed_results.contains(dn)) {
+                new_object_map[dn] = object_map[dn];
+            }
+        }
+
+        // NOTE: objects created between the two searches
+        // are only in changed results, keep them too
+        for (const AdObject &object : changed_results) {
+            new_object_map[object.get_dn()] = object;
+            changed_list.append(object);
+        }
+
+        for (const QString &dn : missing_list) {
+            const AdObject object = ad.search_object(dn, attributes);
+
+            // NOTE: object might have been deleted since
+            // the first search
+            if (object.is_empty()) {
+                continue;
+            }
+
+            new_object_map[dn] = object;
+            changed_list.append(object);
+        }
+
+        return true;
+    }();
+
+    if (!incremental_done) {
+        new_object_map.clear();
+        changed_list.clear();
+
+        const bool success = query_cache_search(ad, base, scope, filter, attributes, &new_object_map);
+        if (!success) {
+            return false;
+        }
+
+        changed_list = new_object_map.values();
+    }
+
+    QList<QString> removed_list;
+    for (const QString &dn : object_map.keys()) {
+        if (!new_object_map.contains(dn)) {
+            removed_list.append(dn);
+        }
+    }
+
+    // NOTE: if server's usn is unknown, keep old value for
+    // incremental refresh so that changes are searched for
+    // again next time. After full refresh, every object
+    // is treated as changed next time.
+    const qint64 new_highest_usn = [&]() -> qint64 {
+        if (server_usn != -1) {
+            return server_usn;
+        } else if (incremental_done) {
+            return highest_usn;
+        } else {
+            return 0;
+        }
+    }();
+
+    object_map = new_object_map;
+    highest_usn = new_highest_usn;
+    dc = current_dc;
+
+    if (changed != nullptr) {
+        *changed = changed_list;
+    }
+
+    if (removed != nullptr) {
+        *removed = removed_list;
+    }
+
+    return true;
+}
+
+void AdQueryCache::invalidate() {
+    highest_usn = -1;
+}
+
+QByteArray AdQueryCache::save() const {
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    stream << QByteArray(QUERY_CACHE_MAGIC);
+    stream << qint32(QUERY_CACHE_VERSION);
+    stream << get_key();
+    stream << dc;
+    stream << highest_usn;
+    stream << qint32(object_map.size());
+
+    for (const AdObject &object : object_map) {
+        stream << object.get_dn();
+        stream << object.get_attributes_data();
+    }
+
+    // NOTE: attribute values compress well, especially
+    // the repeated ones like object classes
+    const QByteArray out = qCompress(data);
+
+    return out;
+}
+
+bool AdQueryCache::load(const QByteArray &compressed_data) {
+    const QByteArray data = qUncompress(compressed_data);
+    if (data.isEmpty()) {
+        return false;
+    }
+
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    QByteArray magic;
+    qint32 version;
+    QString saved_key;
+    stream >> magic >> version >> saved_key;
+
+    const bool header_ok = (stream.status() == QDataStream::Ok && magic == QUERY_CACHE_MAGIC && version == QUERY_CACHE_VERSION && saved_key == get_key());
+    if (!header_ok) {
+        return false;
+    }
+
+    QString saved_dc;
+    qint64 saved_highest_usn;
+    qint32 count;
+    stream >> saved_dc >> saved_highest_usn >> count;
+
+    QHash<QString, AdObject> saved_object_map;
+
+    for (int i = 0; i < count && stream.status() == QDataStream::Ok; i++) {
+        QString dn;
+        QHash<QString, QList<QByteArray>> attributes_data;
+        stream >> dn >> attributes_data;
+
+        AdObject object;
+        object.load(dn, attributes_data);
+
+        saved_object_map[dn] = object;
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    dc = saved_dc;
+    highest_usn = saved_highest_usn;
+    object_map = saved_object_map;
+
+    return true;
+}
+
+// NOTE: search() can't tell an empty result from a failed
+// search, so go through pages here
+bool query_cache_search(AdInterface &ad, const QString &base, const SearchScope scope, const QString &filter, const QList<QString> &attributes, QHash<QString, AdObject> *results) {
+    AdCookie cookie;
+
+    while (true) {
+        const bool success = ad.search_paged(base, scope, filter, attributes, results, &cookie);
+
+        if (!success) {
+            return false;
+        }
+
+        if (!cookie.more_pages()) {
+            return true;
+        }
+    }
+}
+
+// Returns highestCommittedUSN of the server or -1 if it
+// couldn't be read
+qint64 query_cache_server_usn(AdInterface &ad) {
+    const AdObject rootDSE_object = ad.search_object(ROOT_DSE, {ATTRIBUTE_HIGHEST_COMMITTED_USN});
+    const QByteArray value = rootDSE_object.get_value(ATTRIBUTE_HIGHEST_COMMITTED_USN);
+
+    if (value.isEmpty()) {
+        return -1;
+    }
+
+    return value.toLongLong();
+}
+
+// NOTE: empty list means all attributes, which include
+// backlinks. Without adconfig there's no way to tell which
+// attributes are backlinks, so they are assumed to be
+// absent.
+bool query_cache_has_backlinks(const QList<QString> &attributes, const AdConfig *adconfig) {
+    if (attributes.isEmpty()) {
+        return true;
+    }
+
+    if (adconfig == nullptr) {
+        return false;
+    }
+
+    for (const QString &attribute : attributes) {
+        if (adconfig->get_attribute_is_backlink(attribute)) {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,92 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AD_QUERY_CACHE_H
+#define AD_QUERY_CACHE_H
+
+/**
+ * Materialized results of a search. Lets a saved query
+ * display it's last results right away and then bring them
+ * up to date in the background.
+ *
+ * Refresh is incremental when possible. A search that
+ * returns only DN's finds objects that were deleted or
+ * stopped matching, then only objects with uSNChanged
+ * above highestCommittedUSN of the server at the time of
+ * previous refresh are loaded fully.
+ * uSNChanged is local to each DC, so if results were made
+ * on another DC, all objects are loaded again. Changes of
+ * backlinks, like memberOf, don't change uSNChanged of the
+ * object, so refresh is always full if requested
+ * attributes include a backlink.
+ */
+
+#include "ad_defines.h"
+#include "ad_object.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+class AdInterface;
+
+class AdQueryCache {
+public:
+    AdQueryCache();
+    AdQueryCache(const QString &base, const SearchScope scope, const QString &filter, const QList<QString> &attributes);
+
+    // Identifies search parameters, use it to name stored
+    // results
+    QString get_key() const;
+
+    // Returns true if results were never refreshed
+    bool is_empty() const;
+
+    QList<AdObject> get_objects() const;
+    qint64 get_highest_usn() const;
+
+    // Brings results up to date. "changed" is set to
+    // objects that were added or changed and "removed" to
+    // DN's of objects that no longer match. Returns false
+    // if a search failed, in which case results are not
+    // changed.
+    bool refresh(AdInterface &ad, QList<AdObject> *changed, QList<QString> *removed);
+
+    // Forces next refresh to load all objects
+    void invalidate();
+
+    QByteArray save() const;
+
+    // Returns false if data is malformed or was saved for
+    // different search parameters
+    bool load(const QByteArray &data);
+
+private:
+    QString base;
+    SearchScope scope;
+    QString filter;
+    QList<QString> attributes;
+    QString dc;
+    qint64 highest_usn;
+    QHash<QString, AdObject> object_map;
+};
+
+#endif /* AD_QUERY_CACHE_H */
@@ -30,6 +30,9 @@
 #include "ad_filter.h"
 
 #include <QDebug>
+#include <QSet>
+
+#include <algorithm>
 
 #define UNUSED_ARG(x) (void) (x)
 
@@ -41,6 +44,8 @@ QList<security_ace> security_descriptor_get_dacl(const security_descriptor *sd);
 void ad_security_replace_dacl(security_descriptor *sd, const QList<security_ace> &new_dacl);
 uint32_t ad_security_map_access_mask(const uint32_t access_mask);
 int ace_compare_simplified(const security_ace &ace1, const security_ace &ace2);
+bool sd_string_parse_ace(const QString &ace_string, SdStringAce *ace_out);
+QList<SdStringAce> sd_string_ace_count_diff(const QHash<SdStringAce, int> &count_map, const QHash<SdStringAce, int> &other_count_map);
 
 // NOTE: these "base" f-ns are used by the full
 // versions of add/remove right f-ns. Base f-ns do only
@@ -215,7 +220,7 @@ QString ad_security_get_trustee_name(AdInterface &ad, const QByteArray &trustee)
             ATTRIBUTE_DISPLAY_NAME,
             ATTRIBUTE_SAM_ACCOUNT_NAME,
         };
-        const auto trustee_search = ad.search(ad.adconfig()->domain_dn(), SearchScope_All, filter, QList<QString>());
+        const auto trustee_search = ad.search(ad.adconfig()->domain_dn(), SearchScope_All, filter, attributes);
         if (!trustee_search.isEmpty()) {
             // NOTE: this is some weird name selection logic
             // but that's how microsoft does it. Maybe need
@@ -1134,3 +1139,181 @@ int ace_compare_simplified(const security_ace &ace1, const security_ace &ace2) {
 
     return 0;
 }
+
+QString SdStringAce::to_string() const {
+    const QString mask_string = QString("0x%1").arg(mask, 8, 16, QLatin1Char('0'));
+
+    QString out = QString("ACL:%1:%2/%3/%4").arg(trustee, QString::number(type), QString::number(flags), mask_string);
+
+    if (!object_type.isEmpty()) {
+        out += "/" + object_type;
+    }
+
+    return out;
+}
+
+bool SdStringAce::operator==(const SdStringAce &other) const {
+    return (trustee == other.trustee && type == other.type && flags == other.flags && mask == other.mask && object_type == other.object_type);
+}
+
+uint qHash(const SdStringAce &ace, uint seed) {
+    return qHash(ace.trustee, seed) ^ qHash(ace.mask, seed) ^ qHash((ace.type << 8) | ace.flags, seed) ^ qHash(ace.object_type, seed);
+}
+
+SdStringDiff::SdStringDiff() {
+    owner_match = true;
+    group_match = true;
+}
+
+bool SdStringDiff::is_match() const {
+    return (owner_match && group_match && missing_aces.isEmpty() && extra_aces.isEmpty());
+}
+
+bool sd_string_parse(const QString &sd_string, QString *owner_out, QString *group_out, QList<SdStringAce> *ace_list_out) {
+    owner_out->clear();
+    group_out->clear();
+    ace_list_out->clear();
+
+    if (sd_string.isEmpty()) {
+        return false;
+    }
+
+    const QList<QString> element_list = sd_string.split(",");
+
+    for (const QString &element : element_list) {
+        const int separator_index = element.indexOf(':');
+        if (separator_index == -1) {
+            return false;
+        }
+
+        const QString tag = element.left(separator_index);
+        const QString value = element.mid(separator_index + 1);
+
+        if (tag == "OWNER") {
+            *owner_out = value.toUpper();
+        } else if (tag == "GROUP") {
+            *group_out = value.toUpper();
+        } else if (tag == "ACL") {
+            SdStringAce ace;
+            const bool parse_success = sd_string_parse_ace(value, &ace);
+            if (!parse_success) {
+                return false;
+            }
+
+            ace_list_out->append(ace);
+        }
+
+        // NOTE: ignore other elements, for example
+        // "REVISION"
+    }
+
+    return true;
+}
+
+SdStringDiff sd_string_compare(const QString &expected, const QString &actual, bool *ok) {
+    SdStringDiff out;
+
+    QString expected_owner;
+    QString expected_group;
+    QList<SdStringAce> expected_list;
+    const bool parse_expected_success = sd_string_parse(expected, &expected_owner, &expected_group, &expected_list);
+
+    QString actual_owner;
+    QString actual_group;
+    QList<SdStringAce> actual_list;
+    const bool parse_actual_success = sd_string_parse(actual, &actual_owner, &actual_group, &actual_list);
+
+    if (!parse_expected_success || !parse_actual_success) {
+        *ok = false;
+
+        return out;
+    }
+
+    *ok = true;
+
+    out.owner_match = (expected_owner == actual_owner);
+    out.group_match = (expected_group == actual_group);
+
+    // NOTE: ACE's are compared as multisets, so a
+    // duplicate ACE that is missing or extra counts as a
+    // mismatch
+    QHash<SdStringAce, int> expected_count_map;
+    for (const SdStringAce &ace : expected_list) {
+        expected_count_map[ace]++;
+    }
+
+    QHash<SdStringAce, int> actual_count_map;
+    for (const SdStringAce &ace : actual_list) {
+        actual_count_map[ace]++;
+    }
+
+    out.missing_aces = sd_string_ace_count_diff(expected_count_map, actual_count_map);
+    out.extra_aces = sd_string_ace_count_diff(actual_count_map, expected_count_map);
+
+    return out;
+}
+
+// Parses ACE value, which is the part after "ACL:"
+bool sd_string_parse_ace(const QString &ace_string, SdStringAce *ace_out) {
+    // NOTE: trustee can't contain ":", so it's everything
+    // before last ":"
+    const int separator_index = ace_string.lastIndexOf(':');
+    if (separator_index <= 0) {
+        return false;
+    }
+
+    const QString trustee = ace_string.left(separator_index);
+    const QList<QString> field_list = ace_string.mid(separator_index + 1).split("/");
+
+    if (field_list.size() != 3 && field_list.size() != 4) {
+        return false;
+    }
+
+    bool type_ok;
+    bool flags_ok;
+    bool mask_ok;
+    const int type = field_list[0].toInt(&type_ok);
+    const int flags = field_list[1].toInt(&flags_ok);
+
+    // NOTE: mask may be in hex or decimal format, base 0
+    // handles both
+    const uint32_t mask = field_list[2].toUInt(&mask_ok, 0);
+
+    if (!type_ok || !flags_ok || !mask_ok) {
+        return false;
+    }
+
+    ace_out->trustee = trustee.toUpper();
+    ace_out->type = type;
+    ace_out->flags = flags;
+    ace_out->mask = mask;
+
+    if (field_list.size() == 4) {
+        ace_out->object_type = field_list[3].toUpper();
+    } else {
+        ace_out->object_type = QString();
+    }
+
+    return true;
+}
+
+// Returns ACE's that are in count map more times than in
+// other count map, repeated by the difference in counts
+QList<SdStringAce> sd_string_ace_count_diff(const QHash<SdStringAce, int> &count_map, const QHash<SdStringAce, int> &other_count_map) {
+    QList<SdStringAce> out;
+
+    for (auto it = count_map.begin(); it != count_map.end(); it++) {
+        const int surplus = it.value() - other_count_map.value(it.key(), 0);
+
+        for (int i = 0; i < surplus; i++) {
+            out.append(it.key());
+        }
+    }
+
+    std::sort(out.begin(), out.end(),
+        [](const SdStringAce &a, const SdStringAce &b) {
+            return (a.to_string() < b.to_string());
+        });
+
+    return out;
+}
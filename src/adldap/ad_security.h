@@ -69,6 +69,42 @@ public:
     QByteArray object_type;
 };
 
+// ACE from a security descriptor string in the format used
+// by SMB xattr's: "ACL:trustee:type/flags/mask". Trustee
+// and object type are normalized to upper case, so ACE's
+// from different sources can be compared.
+class SdStringAce {
+public:
+    QString trustee;
+    int type;
+    int flags;
+    uint32_t mask;
+    QString object_type;
+
+    QString to_string() const;
+    bool operator==(const SdStringAce &other) const;
+};
+
+uint qHash(const SdStringAce &ace, uint seed = 0);
+
+// Difference between expected and actual security
+// descriptor strings. Missing ACE's are in expected SD but
+// not in actual SD, extra ACE's are in actual SD but not
+// in expected SD. Duplicate ACE's are counted, so an ACE
+// that is in expected SD twice but in actual SD once is
+// missing once.
+class SdStringDiff {
+public:
+    SdStringDiff();
+
+    bool owner_match;
+    bool group_match;
+    QList<SdStringAce> missing_aces;
+    QList<SdStringAce> extra_aces;
+
+    bool is_match() const;
+};
+
 QString ad_security_get_well_known_trustee_name(const QByteArray &trustee);
 QString ad_security_get_trustee_name(AdInterface &ad, const QByteArray &trustee);
 bool ad_security_get_protected_against_deletion(const AdObject &object);
@@ -105,6 +141,15 @@ void security_descriptor_remove_trustee(security_descriptor *sd, const QList<QBy
 void security_descriptor_add_right(security_descriptor *sd, AdConfig *adconfig, const QList<QString> &class_list, const QByteArray &trustee, const uint32_t access_mask, const QByteArray &object_type, const bool allow);
 void security_descriptor_remove_right(security_descriptor *sd, AdConfig *adconfig, const QList<QString> &class_list, const QByteArray &trustee, const uint32_t access_mask, const QByteArray &object_type, const bool allow);
 
+// Parses SD string into owner, group and ACE's. Returns
+// false if string is malformed.
+bool sd_string_parse(const QString &sd_string, QString *owner_out, QString *group_out, QList<SdStringAce> *ace_list_out);
+
+// Compares SD strings regardless of ACE order. Duplicate
+// ACE's are ignored. Sets ok to false if either string is
+// malformed.
+SdStringDiff sd_string_compare(const QString &expected, const QString &actual, bool *ok);
+
 QList<SecurityRight> ad_security_get_right_list_for_class(AdConfig *adconfig, const QList<QString> &class_list);
 QList<SecurityRight> ad_security_get_superior_right_list(const uint32_t access_mask, const QByteArray &object_type);
 QList<SecurityRight> ad_security_get_subordinate_right_list(AdConfig *adconfig, const uint32_t access_mask, const QByteArray &object_type, const QList<QString> &class_list);
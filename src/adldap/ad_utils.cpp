@@ -190,6 +190,16 @@ QString group_scope_string(GroupScope scope) {
     return "";
 }
 
+QString search_scope_string(const SearchScope scope) {
+    switch (scope) {
+        case SearchScope_Object: return "object";
+        case SearchScope_Children: return "children";
+        case SearchScope_Descendants: return "descendants";
+        case SearchScope_All: return "all";
+    }
+    return "";
+}
+
 QString group_type_string(GroupType type) {
     switch (type) {
         case GroupType_Security: return QCoreApplication::translate("ad_utils", "Security");
@@ -491,3 +501,17 @@ QHash<int, QString> attribute_value_bit_string_map(const QString &attribute)
     }
     return bit_string_map;
 }
+
+QString attributes_data_find_name(const QHash<QString, QList<QByteArray>> &attributes_data, const QString &attribute) {
+    if (attributes_data.contains(attribute)) {
+        return attribute;
+    }
+
+    for (auto it = attributes_data.begin(); it != attributes_data.end(); it++) {
+        if (it.key().compare(attribute, Qt::CaseInsensitive) == 0) {
+            return it.key();
+        }
+    }
+
+    return QString();
+}
@@ -46,6 +46,9 @@ int account_option_bit(const AccountOption &option);
 int group_scope_bit(GroupScope scope);
 QString group_scope_string(GroupScope scope);
 
+// NOTE: not translated, used in logs
+QString search_scope_string(const SearchScope scope);
+
 QString group_type_string(GroupType type);
 QString group_type_string_adjective(GroupType type);
 
@@ -88,4 +91,9 @@ QString int_to_hex_string(const int n);
 
 QHash<int, QString> attribute_value_bit_string_map(const QString &attribute);
 
+// Finds attribute in a case insensitive way. Returns name
+// as it is stored or empty string if there's no such
+// attribute.
+QString attributes_data_find_name(const QHash<QString, QList<QByteArray>> &attributes_data, const QString &attribute);
+
 #endif /* AD_UTILS_H */
@@ -21,12 +21,23 @@
 #ifndef ADLDAP_H
 #define ADLDAP_H
 
+#include "ad_backend.h"
 #include "ad_config.h"
+#include "ad_csv.h"
 #include "ad_defines.h"
 #include "ad_display.h"
+#include "ad_export.h"
 #include "ad_filter.h"
+#include "ad_filter_match.h"
+#include "ad_filter_tree.h"
+#include "ad_import.h"
 #include "ad_interface.h"
+#include "ad_ldif.h"
+#include "ad_memory_backend.h"
+#include "ad_metrics.h"
 #include "ad_object.h"
+#include "ad_object_cache.h"
+#include "ad_query_cache.h"
 #include "ad_security.h"
 #include "ad_utils.h"
 #include "gplink.h"
@@ -0,0 +1,450 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cli_commands.h"
+
+#include "adldap.h"
+#include "cli_modify.h"
+
+#include <QCommandLineParser>
+#include <QFile>
+#include <QTextStream>
+
+// Number of connections used for bulk modification if
+// not specified by user
+#define DEFAULT_JOB_COUNT 4
+
+bool cli_check_arg_count(const QList<QString> &args, const int min_count, const QString &usage);
+bool cli_gplink_modify(AdInterface &ad, const QList<QString> &args, const bool link);
+int cli_group_modify(AdInterface &ad, const QCommandLineParser &parser, const QList<QString> &args, const AdBackendModOp op);
+int cli_finish(AdInterface &ad, const QCommandLineParser &parser, const bool success);
+
+int cli_search(AdInterface &ad, const QCommandLineParser &parser, const QList<QString> &args) {
+    if (!cli_check_arg_count(args, 1, "search <filter>")) {
+        return CliExit_Usage;
+    }
+
+    const QString filter = args[0];
+
+    const QString base = [&]() {
+        if (parser.isSet("base")) {
+            return parser.value("base");
+        } else {
+            return ad.adconfig()->domain_dn();
+        }
+    }();
+
+    const QString scope_string = parser.value("scope");
+    const QHash<QString, SearchScope> scope_map = {
+        {"base", SearchScope_Object},
+        {"one", SearchScope_Children},
+        {"sub", SearchScope_All},
+    };
+    if (!scope_map.contains(scope_string)) {
+        cli_print_error(QObject::tr("Invalid scope \"%1\", expected base, one or sub.").arg(scope_string));
+
+        return CliExit_Usage;
+    }
+    const SearchScope scope = scope_map[scope_string];
+
+    const QString format_string = parser.value("format");
+    const QHash<QString, AdExportFormat> format_map = {
+        {"csv", AdExportFormat_Csv},
+        {"jsonl", AdExportFormat_JsonLines},
+        {"ldif", AdExportFormat_Ldif},
+    };
+    if (!format_map.contains(format_string)) {
+        cli_print_error(QObject::tr("Invalid format \"%1\", expected csv, jsonl or ldif.").arg(format_string));
+
+        return CliExit_Usage;
+    }
+    const AdExportFormat format = format_map[format_string];
+
+    const QList<QString> attributes = [&]() {
+        QList<QString> out;
+
+        for (const QString &attribute : parser.value("attributes").split(",")) {
+            const QString trimmed = attribute.trimmed();
+
+            if (!trimmed.isEmpty()) {
+                out.append(trimmed);
+            }
+        }
+
+        return out;
+    }();
+
+    if (format == AdExportFormat_Csv && attributes.isEmpty()) {
+        cli_print_error(QObject::tr("CSV format requires a list of attributes."));
+
+        return CliExit_Usage;
+    }
+
+    const AdExportValues values = [&]() {
+        if (parser.isSet("raw")) {
+            return AdExportValues_Raw;
+        } else {
+            return AdExportValues_Display;
+        }
+    }();
+
+    QFile file;
+    const bool open_success = [&]() {
+        if (parser.isSet("output")) {
+            file.setFileName(parser.value("output"));
+
+            return file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+        } else {
+            return file.open(stdout, QIODevice::WriteOnly);
+        }
+    }();
+
+    if (!open_success) {
+        cli_print_error(QObject::tr("Failed to open output file: %1").arg(file.errorString()));
+
+        return CliExit_Failure;
+    }
+
+    // NOTE: results are seen only once, don't cache them
+    ad.set_cache_search_results(false);
+
+    AdExportWriter writer(&file, format, values, attributes, ad.adconfig());
+    writer.write_header();
+
+    const bool stop_flag = false;
+    const AdExportProgressCallback progress = [](const int) {};
+
+    const AdExportResult result = ad_export_search(ad, base, scope, filter, &writer, progress, &stop_flag);
+
+    file.close();
+
+    if (result == AdExportResult_WriteFailed) {
+        cli_print_error(QObject::tr("Failed to write results: %1").arg(file.errorString()));
+    }
+
+    if (parser.isSet("verbose")) {
+        QTextStream(stderr) << QObject::tr("Exported %1 objects.").arg(writer.get_object_count()) << "\n";
+    }
+
+    return cli_finish(ad, parser, (result == AdExportResult_Complete));
+}
+
+int cli_modify(AdInterface &ad, const QCommandLineParser &parser, const QList<QString> &args) {
+    if (!cli_check_arg_count(args, 1, "modify <file>")) {
+        return CliExit_Usage;
+    }
+
+    const QString file_path = args[0];
+
+    QFile file(file_path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        cli_print_error(QObject::tr("Failed to open file \"%1\": %2").arg(file_path, file.errorString()));
+
+        return CliExit_Failure;
+    }
+
+    const QByteArray data = file.readAll();
+    file.close();
+
+    // NOTE: format is taken from option if it was set
+    // explicitly, otherwise from file extension
+    const bool is_csv = [&]() {
+        if (parser.isSet("format")) {
+            return (parser.value("format") == "csv");
+        } else {
+            return file_path.endsWith(".csv", Qt::CaseInsensitive);
+        }
+    }();
+
+    QList<CliModifyJob> job_list;
+    QString error;
+    const bool parse_success = [&]() {
+        if (is_csv) {
+            return cli_modify_jobs_from_csv(data, parser.isSet("raw"), &job_list, &error);
+        } else {
+            return cli_modify_jobs_from_ldif(data, &job_list, &error);
+        }
+    }();
+
+    if (!parse_success) {
+        cli_print_error(QObject::tr("Failed to read \"%1\": %2").arg(file_path, error));
+
+        return CliExit_Failure;
+    }
+
+    const int job_count = [&]() {
+        bool ok = false;
+        const int out = parser.value("jobs").toInt(&ok);
+
+        if (ok && out > 0) {
+            return out;
+        } else {
+            return DEFAULT_JOB_COUNT;
+        }
+    }();
+
+    bool failed_to_connect;
+    const QList<QString> failures = cli_modify_apply(job_list, job_count, &failed_to_connect);
+
+    if (failed_to_connect && !job_list.isEmpty()) {
+        cli_print_error(QObject::tr("Failed to connect to server."));
+
+        return CliExit_Failure;
+    }
+
+    for (const QString &failure : failures) {
+        cli_print_error(failure);
+    }
+
+    if (parser.isSet("verbose") || !failures.isEmpty()) {
+        const int modified_count = job_list.size() - failures.size();
+
+        QTextStream(stderr) << QObject::tr("Modified %1 of %2 objects.").arg(modified_count).arg(job_list.size()) << "\n";
+    }
+
+    return cli_finish(ad, parser, failures.isEmpty());
+}
+
+int cli_import(AdInterface &ad, const QCommandLineParser &parser, const QList<QString> &args) {
+    if (!cli_check_arg_count(args, 1, "import <file>")) {
+        return CliExit_Usage;
+    }
+
+    const QString file_path = args[0];
+
+    QFile file(file_path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        cli_print_error(QObject::tr("Failed to open file \"%1\": %2").arg(file_path, file.errorString()));
+
+        return CliExit_Failure;
+    }
+
+    const QByteArray data = file.readAll();
+    file.close();
+
+    const bool is_csv = [&]() {
+        if (parser.isSet("format")) {
+            return (parser.value("format") == "csv");
+        } else {
+            return file_path.endsWith(".csv", Qt::CaseInsensitive);
+        }
+    }();
+
+    QList<LdifEntry> entry_list;
+    QString error;
+    const bool parse_success = [&]() {
+        if (is_csv) {
+            return ad_import_entries_from_csv(data, &entry_list, &error);
+        } else {
+            return ldif_parse(data, &entry_list, &error);
+        }
+    }();
+
+    if (!parse_success) {
+        cli_print_error(QObject::tr("Failed to read \"%1\": %2").arg(file_path, error));
+
+        return CliExit_Failure;
+    }
+
+    AdImportOptions options;
+    options.update_existing = parser.isSet("update-existing");
+
+    if (parser.isSet("window")) {
+        options.window_size = parser.value("window").toInt();
+    }
+
+    const AdImportReport report = ad.import_entries(entry_list, options, AdImportProgressCallback(), nullptr);
+
+    QTextStream(stderr) << report.failures_text();
+
+    if (parser.isSet("verbose") || !report.is_ok()) {
+        QTextStream(stderr) << QObject::tr("Added %1, updated %2, failed %3, skipped %4 of %5 objects.").arg(report.added_count).arg(report.updated_count).arg(report.failures.size()).arg(report.skipped_count).arg(report.total_count) << "\n";
+    }
+
+    return cli_finish(ad, parser, report.is_ok());
+}
+
+int cli_gpo_create(AdInterface &ad, const QCommandLineParser &parser, const QList<QString> &args) {
+    if (!cli_check_arg_count(args, 1, "gpo-create <name>")) {
+        return CliExit_Usage;
+    }
+
+    const QString name = args[0];
+
+    QString dn;
+    const bool success = ad.gpo_add(name, dn);
+
+    // NOTE: print DN so that scripts can link the policy
+    // right after creating it
+    if (success) {
+        QTextStream(stdout) << dn << "\n";
+    }
+
+    return cli_finish(ad, parser, success);
+}
+
+int cli_gpo_link(AdInterface &ad, const QCommandLineParser &parser, const QList<QString> &args) {
+    if (!cli_check_arg_count(args, 2, "gpo-link <gpo dn> <target dn>...")) {
+        return CliExit_Usage;
+    }
+
+    const bool success = cli_gplink_modify(ad, args, true);
+
+    return cli_finish(ad, parser, success);
+}
+
+int cli_gpo_unlink(AdInterface &ad, const QCommandLineParser &parser, const QList<QString> &args) {
+    if (!cli_check_arg_count(args, 2, "gpo-unlink <gpo dn> <target dn>...")) {
+        return CliExit_Usage;
+    }
+
+    const bool success = cli_gplink_modify(ad, args, false);
+
+    return cli_finish(ad, parser, success);
+}
+
+int cli_gpo_sync_perms(AdInterface &ad, const QCommandLineParser &parser, const QList<QString> &args) {
+    if (!cli_check_arg_count(args, 1, "gpo-sync-perms <gpo dn>...")) {
+        return CliExit_Usage;
+    }
+
+    bool all_success = true;
+
+    for (const QString &gpo : args) {
+        const bool success = ad.gpo_sync_perms(gpo);
+
+        all_success = (all_success && success);
+    }
+
+    return cli_finish(ad, parser, all_success);
+}
+
+int cli_group_add(AdInterface &ad, const QCommandLineParser &parser, const QList<QString> &args) {
+    return cli_group_modify(ad, parser, args, AdBackendModOp_Add);
+}
+
+int cli_group_remove(AdInterface &ad, const QCommandLineParser &parser, const QList<QString> &args) {
+    return cli_group_modify(ad, parser, args, AdBackendModOp_Delete);
+}
+
+void cli_print_error(const QString &text) {
+    QTextStream(stderr) << text << "\n";
+}
+
+void cli_print_messages(const QList<AdMessage> &messages, const bool verbose) {
+    QTextStream stream(stderr);
+
+    for (const AdMessage &message : messages) {
+        const bool is_error = (message.type() == AdMessageType_Error);
+
+        if (is_error || verbose) {
+            stream << message.text() << "\n";
+        }
+    }
+}
+
+bool cli_check_arg_count(const QList<QString> &args, const int min_count, const QString &usage) {
+    if (args.size() >= min_count) {
+        return true;
+    }
+
+    cli_print_error(QObject::tr("Usage: admc-cli [options] %1").arg(usage));
+
+    return false;
+}
+
+// Adds or removes GPO to/from gplink of all targets. Each
+// target is modified with one request.
+bool cli_gplink_modify(AdInterface &ad, const QList<QString> &args, const bool link) {
+    const QString gpo = args[0];
+    const QList<QString> target_list = args.mid(1);
+
+    bool all_success = true;
+
+    for (const QString &target : target_list) {
+        const AdObject target_object = ad.search_object(target, {ATTRIBUTE_GPLINK});
+        if (target_object.is_empty()) {
+            cli_print_error(QObject::tr("Failed to load object %1.").arg(target));
+            all_success = false;
+
+            continue;
+        }
+
+        Gplink gplink = Gplink(target_object.get_string(ATTRIBUTE_GPLINK));
+
+        if (link) {
+            gplink.add(gpo);
+        } else {
+            gplink.remove(gpo);
+        }
+
+        const bool success = ad.attribute_replace_string(target, ATTRIBUTE_GPLINK, gplink.to_string());
+
+        all_success = (all_success && success);
+    }
+
+    return all_success;
+}
+
+// NOTE: all members are changed in one request, so if one
+// of them can't be added or removed, group is not changed
+int cli_group_modify(AdInterface &ad, const QCommandLineParser &parser, const QList<QString> &args, const AdBackendModOp op) {
+    const QString usage = [&]() {
+        if (op == AdBackendModOp_Add) {
+            return QString("group-add <group dn> <member dn>...");
+        } else {
+            return QString("group-remove <group dn> <member dn>...");
+        }
+    }();
+
+    if (!cli_check_arg_count(args, 2, usage)) {
+        return CliExit_Usage;
+    }
+
+    const QString group = args[0];
+
+    const QList<QByteArray> member_values = [&]() {
+        QList<QByteArray> out;
+
+        for (const QString &member : args.mid(1)) {
+            out.append(member.toUtf8());
+        }
+
+        return out;
+    }();
+
+    const QList<AdBackendMod> mod_list = {
+        AdBackendMod{op, ATTRIBUTE_MEMBER, member_values},
+    };
+
+    const bool success = ad.attribute_modify(group, mod_list);
+
+    return cli_finish(ad, parser, success);
+}
+
+int cli_finish(AdInterface &ad, const QCommandLineParser &parser, const bool success) {
+    cli_print_messages(ad.messages(), parser.isSet("verbose"));
+
+    if (success) {
+        return CliExit_Success;
+    } else {
+        return CliExit_Failure;
+    }
+}
@@ -0,0 +1,63 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CLI_COMMANDS_H
+#define CLI_COMMANDS_H
+
+/**
+ * Subcommands of admc-cli. Each command receives parsed
+ * options and it's positional arguments and returns
+ * process exit code. Messages are printed to stderr, so
+ * that stdout only contains command output, like exported
+ * objects or DN of created policy.
+ */
+
+#include <QList>
+#include <QString>
+
+class AdInterface;
+class AdMessage;
+class QCommandLineParser;
+
+enum CliExit {
+    CliExit_Success = 0,
+    CliExit_Failure = 1,
+    CliExit_Usage = 2,
+};
+
+typedef int (*CliCommand)(AdInterface &ad, const QCommandLineParser &parser, const QList<QString> &args);
+
+int cli_search(AdInterface &ad, const QCommandLineParser &parser, const QList<QString> &args);
+int cli_modify(AdInterface &ad, const QCommandLineParser &parser, const QList<QString> &args);
+int cli_import(AdInterface &ad, const QCommandLineParser &parser, const QList<QString> &args);
+int cli_gpo_create(AdInterface &ad, const QCommandLineParser &parser, const QList<QString> &args);
+int cli_gpo_link(AdInterface &ad, const QCommandLineParser &parser, const QList<QString> &args);
+int cli_gpo_unlink(AdInterface &ad, const QCommandLineParser &parser, const QList<QString> &args);
+int cli_gpo_sync_perms(AdInterface &ad, const QCommandLineParser &parser, const QList<QString> &args);
+int cli_group_add(AdInterface &ad, const QCommandLineParser &parser, const QList<QString> &args);
+int cli_group_remove(AdInterface &ad, const QCommandLineParser &parser, const QList<QString> &args);
+
+void cli_print_error(const QString &text);
+
+// Errors are always printed, success messages only in
+// verbose mode
+void cli_print_messages(const QList<AdMessage> &messages, const bool verbose);
+
+#endif /* CLI_COMMANDS_H */
@@ -0,0 +1,175 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cli_modify.h"
+
+#include "adldap.h"
+
+#include <QAtomicInt>
+#include <QThread>
+
+// Worker which applies jobs using it's own connection.
+// Workers take next job index from a shared counter until
+// all jobs are processed.
+class CliModifyWorker final : public QThread {
+public:
+    const QList<CliModifyJob> *job_list;
+    QAtomicInt *next_index;
+
+    bool failed_to_connect;
+    QList<QString> failures;
+
+    void run() override;
+};
+
+bool cli_modify_jobs_from_csv(const QByteArray &data, const bool raw, QList<CliModifyJob> *job_list, QString *error) {
+    // NOTE: empty fields are kept, because they delete
+    // the attribute
+    QList<LdifEntry> entry_list;
+    const bool keep_empty = true;
+    const bool parse_success = ad_import_entries_from_csv(data, &entry_list, error, keep_empty);
+    if (!parse_success) {
+        return false;
+    }
+
+    for (const LdifEntry &entry : entry_list) {
+        CliModifyJob job;
+        job.dn = entry.dn;
+
+        for (auto it = entry.attributes.begin(); it != entry.attributes.end(); it++) {
+            QList<QByteArray> values;
+            for (const QByteArray &value : it.value()) {
+                if (raw) {
+                    values.append(QByteArray::fromBase64(value));
+                } else {
+                    values.append(value);
+                }
+            }
+
+            job.mod_list.append(AdBackendMod{AdBackendModOp_Replace, it.key(), values});
+        }
+
+        job_list->append(job);
+    }
+
+    return true;
+}
+
+bool cli_modify_jobs_from_ldif(const QByteArray &data, QList<CliModifyJob> *job_list, QString *error) {
+    QList<LdifEntry> entry_list;
+    const bool parse_success = ldif_parse(data, &entry_list, error);
+    if (!parse_success) {
+        return false;
+    }
+
+    for (const LdifEntry &entry : entry_list) {
+        CliModifyJob job;
+        job.dn = entry.dn;
+
+        for (auto it = entry.attributes.begin(); it != entry.attributes.end(); it++) {
+            job.mod_list.append(AdBackendMod{AdBackendModOp_Replace, it.key(), it.value()});
+        }
+
+        job_list->append(job);
+    }
+
+    return true;
+}
+
+QList<QString> cli_modify_apply(const QList<CliModifyJob> &job_list, const int connection_count, bool *failed_to_connect) {
+    QAtomicInt next_index(0);
+
+    const int worker_count = qMax(1, qMin(connection_count, job_list.size()));
+
+    QList<CliModifyWorker *> worker_list;
+    for (int i = 0; i < worker_count; i++) {
+        auto worker = new CliModifyWorker();
+        worker->job_list = &job_list;
+        worker->next_index = &next_index;
+        worker->failed_to_connect = false;
+
+        worker_list.append(worker);
+        worker->start();
+    }
+
+    // NOTE: if some workers failed to connect, their share
+    // of jobs was processed by other workers, so only a
+    // failure if all of them failed
+    *failed_to_connect = true;
+
+    QList<QString> failures;
+
+    for (CliModifyWorker *worker : worker_list) {
+        worker->wait();
+
+        *failed_to_connect = (*failed_to_connect && worker->failed_to_connect);
+        failures.append(worker->failures);
+
+        delete worker;
+    }
+
+    return failures;
+}
+
+void CliModifyWorker::run() {
+    AdInterface ad;
+    if (!ad.is_connected()) {
+        failed_to_connect = true;
+
+        return;
+    }
+
+    // NOTE: objects are modified once and not read again,
+    // no point in caching them
+    ad.set_cache_search_results(false);
+
+    while (true) {
+        const int index = next_index->fetchAndAddOrdered(1);
+        if (index >= job_list->size()) {
+            break;
+        }
+
+        const CliModifyJob &job = job_list->at(index);
+
+        const bool success = ad.attribute_modify(job.dn, job.mod_list);
+
+        if (!success) {
+            const QList<AdMessage> message_list = ad.messages();
+
+            const QString error_text = [&]() {
+                if (!message_list.isEmpty()) {
+                    return message_list.last().text();
+                } else {
+                    return QString(QObject::tr("Failed to modify object."));
+                }
+            }();
+
+            // NOTE: messages contain only object's name, add
+            // full DN so that failed objects can be found
+            const QString failure = QString("%1: %2").arg(job.dn, error_text);
+
+            failures.append(failure);
+        }
+
+        // NOTE: clear messages so that they don't
+        // accumulate over large batches
+        ad.clear_messages();
+    }
+}
@@ -0,0 +1,61 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CLI_MODIFY_H
+#define CLI_MODIFY_H
+
+/**
+ * Bulk modification of objects for admc-cli. Modifications
+ * are read from a CSV or LDIF file and applied by several
+ * workers in parallel, each using it's own connection.
+ * Every object is modified with one request which contains
+ * all of it's changes.
+ */
+
+#include "ad_backend.h"
+
+#include <QList>
+#include <QString>
+
+class AdMessage;
+
+class CliModifyJob {
+public:
+    QString dn;
+    QList<AdBackendMod> mod_list;
+};
+
+// Reads modifications from CSV. First row is the header,
+// which must contain a "dn" column, other columns are
+// attributes. Multiple values are separated by ";". Value
+// of each attribute is replaced, empty field deletes the
+// attribute. If "raw" is true, values are base64 encoded,
+// same as values exported with "--raw".
+bool cli_modify_jobs_from_csv(const QByteArray &data, const bool raw, QList<CliModifyJob> *job_list, QString *error);
+
+// Reads modifications from LDIF. Values of all attributes
+// present in an entry are replaced.
+bool cli_modify_jobs_from_ldif(const QByteArray &data, QList<CliModifyJob> *job_list, QString *error);
+
+// Applies jobs using "connection_count" connections at the
+// same time. Returns error text for each failed job.
+QList<QString> cli_modify_apply(const QList<CliModifyJob> &job_list, const int connection_count, bool *failed_to_connect);
+
+#endif /* CLI_MODIFY_H */
@@ -0,0 +1,131 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * admc-cli is a command line front-end for adldap, for
+ * scripted and bulk operations that don't need the GUI.
+ * Only links to adldap and QtCore.
+ */
+
+#include "adldap.h"
+#include "cli_commands.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTranslator>
+
+int main(int argc, char **argv) {
+    Q_INIT_RESOURCE(adldap);
+
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("admc-cli");
+    app.setApplicationVersion(ADMC_CLI_VERSION);
+
+    const QLocale locale = QLocale::system();
+
+    QTranslator adldap_translator;
+    load_adldap_translation(adldap_translator, locale);
+    app.installTranslator(&adldap_translator);
+
+    const QHash<QString, CliCommand> command_map = {
+        {"search", cli_search},
+        {"modify", cli_modify},
+        {"import", cli_import},
+        {"gpo-create", cli_gpo_create},
+        {"gpo-link", cli_gpo_link},
+        {"gpo-unlink", cli_gpo_unlink},
+        {"gpo-sync-perms", cli_gpo_sync_perms},
+        {"group-add", cli_group_add},
+        {"group-remove", cli_group_remove},
+    };
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QObject::tr(
+        "Command line interface for managing Active Directory.\n"
+        "\n"
+        "Commands:\n"
+        "  search <filter>                      Write objects matching filter to output.\n"
+        "  modify <file>                        Replace attribute values using a CSV or LDIF file.\n"
+        "                                       CSV must have a \"dn\" column, multiple values are\n"
+        "                                       separated by \";\" and empty fields delete values.\n"
+        "  import <file>                        Create objects from a CSV or LDIF file. Parents are\n"
+        "                                       created before children.\n"
+        "  gpo-create <name>                    Create a policy and print it's DN.\n"
+        "  gpo-link <gpo dn> <target dn>...     Link policy to OU's or domain.\n"
+        "  gpo-unlink <gpo dn> <target dn>...   Unlink policy from OU's or domain.\n"
+        "  gpo-sync-perms <gpo dn>...           Sync GPT permissions to GPC permissions.\n"
+        "  group-add <group dn> <member dn>...  Add members to group.\n"
+        "  group-remove <group dn> <member dn>... Remove members from group."));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("command", QObject::tr("Command to run."));
+    parser.addPositionalArgument("args", QObject::tr("Command arguments."), "[args...]");
+    parser.addOptions({
+        {"dc", QObject::tr("Domain controller to connect to."), "host"},
+        {"port", QObject::tr("Port to connect to."), "port"},
+        {{"b", "base"}, QObject::tr("Search base, domain head by default."), "dn"},
+        {{"s", "scope"}, QObject::tr("Search scope: base, one or sub."), "scope", "sub"},
+        {{"a", "attributes"}, QObject::tr("Comma separated list of attributes to output. All attributes by default."), "list"},
+        {{"f", "format"}, QObject::tr("Format of search output and modify input: csv, jsonl or ldif."), "format", "ldif"},
+        {"raw", QObject::tr("Use raw values instead of formatted ones. In CSV and JSON raw values are base64 encoded.")},
+        {{"o", "output"}, QObject::tr("Write search results to file instead of stdout."), "file"},
+        {{"j", "jobs"}, QObject::tr("Number of connections used for bulk modification."), "count"},
+        {"window", QObject::tr("Number of import requests sent without waiting for results."), "count"},
+        {"update-existing", QObject::tr("When importing, update objects that already exist instead of failing.")},
+        {{"v", "verbose"}, QObject::tr("Print success messages.")},
+    });
+
+    parser.process(app);
+
+    const QList<QString> positional = parser.positionalArguments();
+    if (positional.isEmpty() || !command_map.contains(positional[0])) {
+        parser.showHelp(CliExit_Usage);
+    }
+
+    const CliCommand command = command_map[positional[0]];
+    const QList<QString> args = positional.mid(1);
+
+    if (parser.isSet("dc")) {
+        AdInterface::set_dc(parser.value("dc"));
+    }
+
+    if (parser.isSet("port")) {
+        AdInterface::set_port(parser.value("port").toInt());
+    }
+
+    AdInterface ad;
+    if (!ad.is_connected()) {
+        cli_print_messages(ad.messages(), true);
+        cli_print_error(QObject::tr("Failed to connect to server."));
+
+        return CliExit_Failure;
+    }
+
+    // NOTE: schema is loaded once per process and shared
+    // by all connections, including the ones opened by
+    // bulk modify workers
+    AdConfig adconfig;
+    adconfig.load(ad, locale);
+    AdInterface::set_config(&adconfig);
+
+    const int retval = command(ad, parser, args);
+
+    return retval;
+}
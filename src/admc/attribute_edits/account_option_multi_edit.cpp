@@ -74,6 +74,66 @@ bool AccountOptionMultiEdit::apply(AdInterface &ad, const QString &target) const
     return total_success;
 }
 
+// NOTE: unlike apply(), all bits are changed together with
+// one modification of userAccountControl
+AttributeEditModFunction AccountOptionMultiEdit::get_mod_function() const {
+    // NOTE: this option is stored in security descriptor,
+    // can't be changed with a simple modification
+    if (check_map.contains(AccountOption_CantChangePassword)) {
+        return AttributeEditModFunction();
+    }
+
+    const QHash<AccountOption, bool> new_state_map = [&]() {
+        QHash<AccountOption, bool> out;
+
+        for (const AccountOption &option : check_map.keys()) {
+            QCheckBox *check = check_map[option];
+            out[option] = check->isChecked();
+        }
+
+        return out;
+    }();
+
+    AdConfig *adconfig = g_adconfig;
+
+    return [new_state_map, adconfig](const AdObject &object, QList<AdBackendMod> *mod_list) {
+        const int uac = object.get_user_account_control();
+        int new_uac = uac;
+
+        for (const AccountOption &option : new_state_map.keys()) {
+            const bool current_option_state = object.get_account_option(option, adconfig);
+            const bool new_option_state = new_state_map[option];
+            const bool option_changed = (new_option_state != current_option_state);
+            if (!option_changed) {
+                continue;
+            }
+
+            if (option == AccountOption_PasswordExpired) {
+                const QString pwdLastSet_value = [&]() -> QString {
+                    if (new_option_state) {
+                        return AD_PWD_LAST_SET_EXPIRED;
+                    } else {
+                        return AD_PWD_LAST_SET_RESET;
+                    }
+                }();
+
+                mod_list->append(attribute_edit_replace_mod(ATTRIBUTE_PWD_LAST_SET, pwdLastSet_value));
+            } else {
+                const int bit = account_option_bit(option);
+                new_uac = bitmask_set(new_uac, bit, new_option_state);
+            }
+        }
+
+        if (new_uac != uac) {
+            mod_list->append(attribute_edit_replace_mod(ATTRIBUTE_USER_ACCOUNT_CONTROL, QString::number(new_uac)));
+        }
+    };
+}
+
+QList<QString> AccountOptionMultiEdit::get_mod_attributes() const {
+    return {ATTRIBUTE_USER_ACCOUNT_CONTROL, ATTRIBUTE_PWD_LAST_SET};
+}
+
 void AccountOptionMultiEdit::set_enabled(const bool enabled) {
     for (QCheckBox *check : check_map.values()) {
         check->setEnabled(enabled);
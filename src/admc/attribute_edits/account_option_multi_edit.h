@@ -42,6 +42,8 @@ public:
     AccountOptionMultiEdit(const QHash<AccountOption, QCheckBox *> &check_map, QObject *parent);
 
     bool apply(AdInterface &ad, const QString &target) const override;
+    AttributeEditModFunction get_mod_function() const override;
+    QList<QString> get_mod_attributes() const override;
     void set_enabled(const bool enabled) override;
 
 private:
@@ -20,6 +20,7 @@
 
 #include "attribute_edits/attribute_edit.h"
 
+#include "adldap.h"
 #include "utils.h"
 
 bool AttributeEdit::verify(AdInterface &ad, const QString &dn) const {
@@ -73,6 +74,36 @@ bool AttributeEdit::apply(AdInterface &ad, const QString &dn) const {
     return true;
 }
 
+AttributeEditModFunction AttributeEdit::get_mod_function() const {
+    return AttributeEditModFunction();
+}
+
+QList<QString> AttributeEdit::get_mod_attributes() const {
+    return QList<QString>();
+}
+
 void AttributeEdit::set_enabled(const bool enabled) {
     UNUSED_ARG(enabled);
 }
+
+AttributeEditModFunction attribute_edit_constant_mod_function(const QList<AdBackendMod> &mod_list) {
+    return [mod_list](const AdObject &object, QList<AdBackendMod> *mod_list_out) {
+        UNUSED_ARG(object);
+
+        mod_list_out->append(mod_list);
+    };
+}
+
+AdBackendMod attribute_edit_replace_mod(const QString &attribute, const QString &value) {
+    const QList<QByteArray> values = [&]() -> QList<QByteArray> {
+        if (value.isEmpty()) {
+            return QList<QByteArray>();
+        } else {
+            return {value.toUtf8()};
+        }
+    }();
+
+    const AdBackendMod out = {AdBackendModOp_Replace, attribute, values};
+
+    return out;
+}
@@ -23,6 +23,8 @@
 
 #include <QObject>
 
+#include <functional>
+
 /**
  * AttributeEdit's wrap regular Qt widgets so that they can
  * be used to edit attributes of an AD object. Depending on
@@ -32,6 +34,11 @@
 
 class AdInterface;
 class AdObject;
+class AdBackendMod;
+
+// Adds modifications needed to apply edit's input to given
+// object
+typedef std::function<void(const AdObject &object, QList<AdBackendMod> *mod_list)> AttributeEditModFunction;
 
 class AttributeEdit : public QObject {
     Q_OBJECT
@@ -68,6 +75,17 @@ public:
     // AD server
     virtual bool apply(AdInterface &ad, const QString &dn) const;
 
+    // Returns a f-n which adds modifications that apply
+    // current input to an object. This is used to apply
+    // edits to many objects with one request per object.
+    // Input is copied into the f-n, so it can be called
+    // outside of GUI thread. Object passed to the f-n
+    // contains attributes returned by get_mod_attributes().
+    // Edits which don't support this return an empty f-n
+    // and must be applied using apply().
+    virtual AttributeEditModFunction get_mod_function() const;
+    virtual QList<QString> get_mod_attributes() const;
+
     virtual void set_enabled(const bool enabled);
 
 signals:
@@ -75,4 +93,12 @@ signals:
     void edited();
 };
 
+// Returns mod f-n which adds same modifications to all
+// objects
+AttributeEditModFunction attribute_edit_constant_mod_function(const QList<AdBackendMod> &mod_list);
+
+// Returns modification which replaces attribute's value.
+// Empty value deletes the attribute.
+AdBackendMod attribute_edit_replace_mod(const QString &attribute, const QString &value);
+
 #endif /* ATTRIBUTE_EDIT_H */
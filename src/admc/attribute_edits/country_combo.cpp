@@ -21,6 +21,7 @@
 #include "attribute_edits/country_combo.h"
 
 #include "adldap.h"
+#include "attribute_edits/attribute_edit.h"
 #include "globals.h"
 #include "settings.h"
 #include "status.h"
@@ -228,3 +229,19 @@ bool country_combo_apply(const QComboBox *combo, AdInterface &ad, const QString
 
     return success;
 }
+
+QList<AdBackendMod> country_combo_get_mods(const QComboBox *combo) {
+    const int code = combo->currentData().toInt();
+
+    const QString code_string = QString::number(code);
+    const QString country_string = country_strings.value(code, QString());
+    const QString abbreviation = country_abbreviations.value(code, QString());
+
+    const QList<AdBackendMod> out = {
+        attribute_edit_replace_mod(ATTRIBUTE_COUNTRY_CODE, code_string),
+        attribute_edit_replace_mod(ATTRIBUTE_COUNTRY_ABBREVIATION, abbreviation),
+        attribute_edit_replace_mod(ATTRIBUTE_COUNTRY, country_string),
+    };
+
+    return out;
+}
@@ -25,10 +25,14 @@ class QComboBox;
 class AdObject;
 class AdInterface;
 class QString;
+class AdBackendMod;
+template <typename T>
+class QList;
 
 void country_combo_load_data();
 void country_combo_init(QComboBox *combo);
 void country_combo_load(QComboBox *combo, const AdObject &object);
 bool country_combo_apply(const QComboBox *combo, AdInterface &ad, const QString &dn);
+QList<AdBackendMod> country_combo_get_mods(const QComboBox *combo);
 
 #endif /* COUNTRY_COMBO_H */
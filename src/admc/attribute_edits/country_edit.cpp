@@ -48,6 +48,12 @@ bool CountryEdit::apply(AdInterface &ad, const QString &dn) const {
     return country_combo_apply(combo, ad, dn);
 }
 
+AttributeEditModFunction CountryEdit::get_mod_function() const {
+    const QList<AdBackendMod> mod_list = country_combo_get_mods(combo);
+
+    return attribute_edit_constant_mod_function(mod_list);
+}
+
 void CountryEdit::set_enabled(const bool enabled) {
     combo->setEnabled(enabled);
 }
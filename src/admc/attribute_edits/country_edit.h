@@ -32,6 +32,7 @@ public:
 
     void load(AdInterface &ad, const AdObject &object) override;
     bool apply(AdInterface &ad, const QString &dn) const override;
+    AttributeEditModFunction get_mod_function() const override;
     void set_enabled(const bool enabled) override;
 
 private:
@@ -44,6 +44,13 @@ bool ExpiryEdit::apply(AdInterface &ad, const QString &dn) const {
     return edit_widget->apply(ad, dn);
 }
 
+AttributeEditModFunction ExpiryEdit::get_mod_function() const {
+    const QString new_value = edit_widget->get_new_value();
+    const AdBackendMod mod = attribute_edit_replace_mod(ATTRIBUTE_ACCOUNT_EXPIRES, new_value);
+
+    return attribute_edit_constant_mod_function({mod});
+}
+
 void ExpiryEdit::set_enabled(const bool enabled) {
     edit_widget->setEnabled(enabled);
 }
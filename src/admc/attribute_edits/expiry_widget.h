@@ -41,11 +41,13 @@ public:
     void load(const AdObject &object);
     bool apply(AdInterface &ad, const QString &dn) const;
 
+    // Returns accountExpires value for current input
+    QString get_new_value() const;
+
 signals:
     void edited();
 
 private:
-    QString get_new_value() const;
     void on_never_check();
     void on_end_of_check();
 };
@@ -47,6 +47,13 @@ bool ManagerEdit::apply(AdInterface &ad, const QString &dn) const {
     return widget->apply(ad, dn);
 }
 
+AttributeEditModFunction ManagerEdit::get_mod_function() const {
+    const QString manager = widget->get_manager();
+    const AdBackendMod mod = attribute_edit_replace_mod(manager_attribute, manager);
+
+    return attribute_edit_constant_mod_function({mod});
+}
+
 void ManagerEdit::set_enabled(const bool enabled) {
     widget->setEnabled(enabled);
 }
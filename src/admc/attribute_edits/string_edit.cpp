@@ -56,6 +56,13 @@ bool StringEdit::apply(AdInterface &ad, const QString &dn) const {
     return success;
 }
 
+AttributeEditModFunction StringEdit::get_mod_function() const {
+    const QString new_value = edit->text().trimmed();
+    const AdBackendMod mod = attribute_edit_replace_mod(attribute, new_value);
+
+    return attribute_edit_constant_mod_function({mod});
+}
+
 void StringEdit::set_enabled(const bool enabled) {
     edit->setEnabled(enabled);
 }
@@ -87,7 +87,8 @@ bool UpnEdit::verify(AdInterface &ad, const QString &dn) const {
 
         return filter_AND({same_upn, not_object_itself});
     }();
-    const QList<QString> attributes = QList<QString>();
+    // NOTE: only need to know whether there are results
+    const QList<QString> attributes = {ATTRIBUTE_DN};
 
     const QHash<QString, AdObject> results = ad.search(base, scope, filter, attributes);
 
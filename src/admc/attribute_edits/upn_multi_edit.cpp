@@ -44,6 +44,21 @@ bool UpnMultiEdit::apply(AdInterface &ad, const QString &target) const {
     return ad.attribute_replace_string(target, ATTRIBUTE_USER_PRINCIPAL_NAME, new_value);
 }
 
+AttributeEditModFunction UpnMultiEdit::get_mod_function() const {
+    const QString new_suffix = upn_suffix_combo->currentText();
+
+    return [new_suffix](const AdObject &object, QList<AdBackendMod> *mod_list) {
+        const QString current_prefix = object.get_upn_prefix();
+        const QString new_value = QString("%1@%2").arg(current_prefix, new_suffix);
+
+        mod_list->append(attribute_edit_replace_mod(ATTRIBUTE_USER_PRINCIPAL_NAME, new_value));
+    };
+}
+
+QList<QString> UpnMultiEdit::get_mod_attributes() const {
+    return {ATTRIBUTE_USER_PRINCIPAL_NAME};
+}
+
 void UpnMultiEdit::set_enabled(const bool enabled) {
     upn_suffix_combo->setEnabled(enabled);
 }
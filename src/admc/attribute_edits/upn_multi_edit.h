@@ -38,6 +38,8 @@ public:
     UpnMultiEdit(QComboBox *upn_suffix_combo, AdInterface &ad, QObject *parent);
 
     bool apply(AdInterface &ad, const QString &target) const override;
+    AttributeEditModFunction get_mod_function() const override;
+    QList<QString> get_mod_attributes() const override;
     void set_enabled(const bool enabled) override;
 
 private:
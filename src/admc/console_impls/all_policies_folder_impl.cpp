@@ -22,12 +22,16 @@
 
 #include "adldap.h"
 #include "console_impls/item_type.h"
+#include "console_impls/my_console_role.h"
 #include "console_impls/policy_impl.h"
 #include "console_impls/policy_root_impl.h"
 #include "console_widget/results_view.h"
 #include "create_dialogs/create_policy_dialog.h"
 #include "globals.h"
+#include "gpo_verify_dialog.h"
 #include "gplink.h"
+#include "icon_manager/icon_manager.h"
+#include "search_thread.h"
 #include "status.h"
 #include "utils.h"
 #include "fsmo/fsmo_utils.h"
@@ -42,25 +46,97 @@ AllPoliciesFolderImpl::AllPoliciesFolderImpl(ConsoleWidget *console_arg)
     set_results_view(new ResultsView(console_arg));
 
     create_policy_action = new QAction(tr("Create policy"), this);
+    verify_policies_action = new QAction(tr("Verify all policies"), this);
 
     connect(
         create_policy_action, &QAction::triggered,
         this, &AllPoliciesFolderImpl::create_policy);
+    connect(
+        verify_policies_action, &QAction::triggered,
+        this, &AllPoliciesFolderImpl::verify_policies);
 }
 
 void AllPoliciesFolderImpl::fetch(const QModelIndex &index) {
-    AdInterface ad;
-    if (ad_failed(ad, console)) {
-        return;
-    }
+    auto search_id_matches = [](QStandardItem *item, SearchThread *thread) {
+        const int id_from_item = item->data(MyConsoleRole_SearchThreadId).toInt();
+        const int thread_id = thread->get_id();
+
+        const bool match = (id_from_item == thread_id);
+
+        return match;
+    };
+
+    QStandardItem *item = console->get_item(index);
+
+    // Set icon to indicate that item is in "search" state
+    item->setIcon(g_icon_manager->get_indicator_icon(g_icon_manager->search_indicator));
 
     const QString base = g_adconfig->policies_dn();
     const SearchScope scope = SearchScope_All;
     const QString filter = filter_CONDITION(Condition_Equals, ATTRIBUTE_OBJECT_CLASS, CLASS_GP_CONTAINER);
-    const QList<QString> attributes = QList<QString>();
-    const QHash<QString, AdObject> results = ad.search(base, scope, filter, attributes);
+    const QList<QString> attributes = console_policy_search_attributes();
+
+    auto search_thread = new SearchThread(base, scope, filter, attributes);
+
+    // NOTE: change item's search thread, this will be used
+    // later to handle situations where a thread is started
+    // while another is running
+    item->setData(search_thread->get_id(), MyConsoleRole_SearchThreadId);
+
+    const QPersistentModelIndex persistent_index = index;
+
+    connect(
+        search_thread, &SearchThread::results_ready,
+        this,
+        [=](const QHash<QString, AdObject> &results) {
+            if (!persistent_index.isValid()) {
+                search_thread->stop();
+
+                return;
+            }
+
+            QStandardItem *item_now = console->get_item(persistent_index);
 
-    all_policies_folder_impl_add_objects(console, results.values(), index);
+            // NOTE: if another thread was started for this
+            // item, abort this thread
+            const bool thread_id_match = search_id_matches(item_now, search_thread);
+            if (!thread_id_match) {
+                search_thread->stop();
+
+                return;
+            }
+
+            all_policies_folder_impl_add_objects(console, results.values(), persistent_index);
+        },
+        Qt::QueuedConnection);
+    connect(
+        search_thread, &SearchThread::finished,
+        this,
+        [=]() {
+            g_status->display_ad_messages(search_thread->get_ad_messages(), console);
+            search_thread_display_errors(search_thread, console);
+
+            search_thread->deleteLater();
+
+            if (!persistent_index.isValid()) {
+                return;
+            }
+
+            QStandardItem *item_now = console->get_item(persistent_index);
+
+            // NOTE: if another thread was started for this
+            // item, don't change item data. It will be
+            // changed by that other thread.
+            const bool thread_id_match = search_id_matches(item_now, search_thread);
+            if (!thread_id_match) {
+                return;
+            }
+
+            item_now->setIcon(g_icon_manager->get_object_icon(ADMC_CATEGORY_ALL_POLICIES_FOLDER));
+        },
+        Qt::QueuedConnection);
+
+    search_thread->start();
 }
 
 void AllPoliciesFolderImpl::refresh(const QList<QModelIndex> &index_list) {
@@ -74,6 +150,7 @@ QList<QAction *> AllPoliciesFolderImpl::get_all_custom_actions() const {
     QList<QAction *> out;
 
     out.append(create_policy_action);
+    out.append(verify_policies_action);
 
     return out;
 }
@@ -85,6 +162,7 @@ QSet<QAction *> AllPoliciesFolderImpl::get_custom_actions(const QModelIndex &ind
     QSet<QAction *> out;
 
     out.insert(create_policy_action);
+    out.insert(verify_policies_action);
 
     return out;
 }
@@ -149,12 +227,17 @@ void AllPoliciesFolderImpl::create_policy() {
             }
 
             const QString dn = dialog->get_created_dn();
-            const AdObject object = ad2.search_object(dn);
+            const AdObject object = ad2.search_object(dn, console_policy_search_attributes());
 
             all_policies_folder_impl_add_objects(console, {object}, parent_index);
         });
 }
 
+void AllPoliciesFolderImpl::verify_policies() {
+    auto dialog = new GpoVerifyDialog(console);
+    dialog->open();
+}
+
 QModelIndex get_all_policies_folder_index(ConsoleWidget *console) {
     const QModelIndex policy_tree_root = get_policy_tree_root(console);
     const QModelIndex out = console->search_item(policy_tree_root, {ItemType_AllPoliciesFolder});
@@ -50,8 +50,10 @@ public:
 
 private:
     QAction *create_policy_action;
+    QAction *verify_policies_action;
 
     void create_policy();
+    void verify_policies();
 };
 
 QModelIndex get_all_policies_folder_index(ConsoleWidget *console);
@@ -59,7 +59,7 @@ void DomainInfoImpl::refresh(const QList<QModelIndex> &index_list) {
 
     AdInterface ad;
     load_domain_info_item(ad);
-    domain_info_results_widget->update();
+    domain_info_results_widget->refresh();
     console->clear_scope_tree();
 
     console->set_current_scope(console->domain_info_index());
@@ -706,7 +706,7 @@ void ObjectImpl::selected_as_scope(const QModelIndex &index)
     }
 
     const QString dn = index.data(ObjectRole_DN).toString();
-    const AdObject object = ad.search_object(dn);
+    const AdObject object = ad.search_object_cached(dn);
 
     if (object.is_class(CLASS_GROUP)) {
         stacked_widget->setCurrentWidget(group_results_widget);
@@ -742,7 +742,7 @@ void ObjectImpl::update_results_widget(const QModelIndex &index) const
     }
 
     const QString dn = index.data(ObjectRole_DN).toString();
-    const AdObject object = ad.search_object(dn);
+    const AdObject object = ad.search_object_cached(dn);
 
     if (object.is_class(CLASS_GROUP)) {
         group_results_widget->update(ad, object);
@@ -926,7 +926,7 @@ void ObjectImpl::on_move() {
         return;
     }
 
-    auto dialog = new SelectContainerDialog(ad, console);
+    auto dialog = new SelectContainerDialog(ad, console, console);
     dialog->open();
 
     connect(
@@ -1235,17 +1235,7 @@ void ObjectImpl::set_disabled(const bool disabled) {
                 for (const QModelIndex &index : index_list) {
                     QStandardItem *item = target_console->get_item(index);
                     item->setData(disabled, ObjectRole_AccountDisabled);
-                    const QString category= dn_get_name(item->data(ObjectRole_ObjectCategory).toString());
-                    QIcon icon;
-                    if (category == OBJECT_CATEGORY_PERSON) {
-                        icon = disabled ? g_icon_manager->get_icon_for_type(ItemIconType_Person_Blocked) :
-                                            g_icon_manager->get_icon_for_type(ItemIconType_Person_Clean);
-                    }
-                    else if (category == OBJECT_CATEGORY_COMPUTER) {
-                        icon = disabled ? g_icon_manager->get_icon_for_type(ItemIconType_Computer_Blocked) :
-                                            g_icon_manager->get_icon_for_type(ItemIconType_Computer_Clean);
-                    }
-                    item->setIcon(icon);
+                    console_object_item_load_icon(item, disabled);
                 }
             }
         };
@@ -1499,6 +1489,12 @@ void ObjectImpl::update_toolbar_actions() {
 }
 
 void object_impl_add_objects_to_console(ConsoleWidget *console, const QList<AdObject> &object_list, const QModelIndex &parent) {
+    const ObjectRowLoader loader;
+
+    object_impl_add_objects_to_console(console, loader, object_list, parent);
+}
+
+void object_impl_add_objects_to_console(ConsoleWidget *console, const ObjectRowLoader &loader, const QList<AdObject> &object_list, const QModelIndex &parent) {
     if (!parent.isValid()) {
         return;
     }
@@ -1511,37 +1507,40 @@ void object_impl_add_objects_to_console(ConsoleWidget *console, const QList<AdOb
         return;
     }
 
+    // NOTE: read setting once per page instead of once per
+    // object, settings f-ns create a QSettings instance
+    // for every call
+    const bool show_non_containers_ON = settings_get_variant(SETTING_show_non_containers_in_console_tree).toBool();
+
+    // NOTE: load all rows first and then add them at once,
+    // so that console sorts them once per page
+    QList<QList<QStandardItem *>> row_list;
+
     for (const AdObject &object : object_list) {
         if (object.is_empty())
             continue;
-        const bool should_be_in_scope = [&]() {
-            // NOTE: "containers" referenced here don't mean
-            // objects with "container" object class.
-            // Instead it means all the objects that can
-            // have children(some of which are not
-            // "container" class).
-            const bool is_container = [=]() {
-                const QList<QString> filter_containers = g_adconfig->get_filter_containers();
-                const QString object_class = object.get_string(ATTRIBUTE_OBJECT_CLASS);
-
-                return filter_containers.contains(object_class);
-            }();
 
-            const bool show_non_containers_ON = settings_get_variant(SETTING_show_non_containers_in_console_tree).toBool();
-
-            return (is_container || show_non_containers_ON);
-        }();
+        // NOTE: "containers" referenced here don't mean
+        // objects with "container" object class.
+        // Instead it means all the objects that can
+        // have children(some of which are not
+        // "container" class).
+        const bool should_be_in_scope = (loader.is_container(object) || show_non_containers_ON);
 
         const QList<QStandardItem *> row = [&]() {
             if (should_be_in_scope) {
-                return console->add_scope_item(ItemType_Object, parent);
+                return console->make_scope_row(ItemType_Object, parent);
             } else {
-                return console->add_results_item(ItemType_Object, parent);
+                return console->make_results_row(ItemType_Object, parent);
             }
         }();
 
-        console_object_load(row, object);
+        loader.load(row, object);
+
+        row_list.append(row);
     }
+
+    console->add_rows(parent, row_list);
 }
 
 // Helper f-n that searches for objects and then adds them
@@ -1561,37 +1560,67 @@ void object_impl_add_objects_to_console_from_dns(ConsoleWidget *console, AdInter
 }
 
 void console_object_load(const QList<QStandardItem *> row, const AdObject &object) {
-    // Load attribute columns
-    for (int i = 0; i < g_adconfig->get_columns().count(); i++) {
-        if (g_adconfig->get_columns().count() > row.size()) {
-            break;
+    const ObjectRowLoader loader;
+    loader.load(row, object);
+}
+
+ObjectRowLoader::ObjectRowLoader() {
+    column_list = g_adconfig->get_columns();
+
+    for (const QString &attribute : column_list) {
+        if (attribute == ATTRIBUTE_OBJECT_CLASS) {
+            column_format_list.append(ColumnFormat_Class);
+        } else {
+            column_format_list.append(ColumnFormat_Value);
         }
+    }
+
+    const QList<QString> filter_containers = g_adconfig->get_filter_containers();
+    container_class_set = QSet<QString>(filter_containers.begin(), filter_containers.end());
+}
+
+bool ObjectRowLoader::is_container(const AdObject &object) const {
+    const QString object_class = object.get_string(ATTRIBUTE_OBJECT_CLASS);
+
+    return container_class_set.contains(object_class);
+}
+
+void ObjectRowLoader::load(const QList<QStandardItem *> &row, const AdObject &object) const {
+    // Load attribute columns
+    const bool row_has_all_columns = (column_list.size() <= row.size());
 
-        const QString attribute = g_adconfig->get_columns()[i];
+    for (int i = 0; i < column_list.size() && row_has_all_columns; i++) {
+        const QString &attribute = column_list[i];
 
         if (!object.contains(attribute)) {
             continue;
         }
 
-        const QString display_value = [attribute, object]() {
-            if (attribute == ATTRIBUTE_OBJECT_CLASS) {
-                const QString object_class = object.get_string(attribute);
+        const QString display_value = [&]() {
+            switch (column_format_list[i]) {
+                case ColumnFormat_Class: {
+                    const QString object_class = object.get_string(attribute);
 
-                if (object_class == CLASS_GROUP) {
-                    const GroupScope scope = object.get_group_scope();
-                    const QString scope_string = group_scope_string(scope);
+                    if (object_class == CLASS_GROUP) {
+                        const GroupScope scope = object.get_group_scope();
+                        const QString scope_string = group_scope_string(scope);
 
-                    const GroupType type = object.get_group_type();
-                    const QString type_string = group_type_string_adjective(type);
+                        const GroupType type = object.get_group_type();
+                        const QString type_string = group_type_string_adjective(type);
 
-                    return QString("%1 - %2").arg(type_string, scope_string);
-                } else {
-                    return g_adconfig->get_class_display_name(object_class);
+                        return QString("%1 - %2").arg(type_string, scope_string);
+                    } else {
+                        return g_adconfig->get_class_display_name(object_class);
+                    }
+                }
+                case ColumnFormat_Value: {
+                    const QByteArray value = object.get_value(attribute);
+
+                    return attribute_display_value(attribute, value, g_adconfig);
                 }
-            } else {
-                const QByteArray value = object.get_value(attribute);
-                return attribute_display_value(attribute, value, g_adconfig);
             }
+
+            return QString();
         }();
 
         row[i]->setText(display_value);
@@ -1599,7 +1628,7 @@ void console_object_load(const QList<QStandardItem *> row, const AdObject &objec
 
     console_object_item_data_load(row[0], object);
 
-    const bool cannot_move = object.get_system_flag(SystemFlagsBit_DomainCannotMove);
+    const bool cannot_move = row[0]->data(ObjectRole_CannotMove).toBool();
 
     for (auto item : row) {
         item->setDragEnabled(!cannot_move);
@@ -1702,6 +1731,10 @@ void console_object_search(ConsoleWidget *console, const QModelIndex &index, con
 
     auto search_thread = new SearchThread(base, scope, filter, attributes);
 
+    // NOTE: loader is created once per fetch and reused
+    // for all pages of results
+    const ObjectRowLoader loader;
+
     // NOTE: change item's search thread, this will be used
     // later to handle situations where a thread is started
     // while another is running
@@ -1742,7 +1775,7 @@ void console_object_search(ConsoleWidget *console, const QModelIndex &index, con
                 return;
             }
 
-            object_impl_add_objects_to_console(console, results.values(), persistent_index);
+            object_impl_add_objects_to_console(console, loader, results.values(), persistent_index);
         },
         Qt::QueuedConnection);
     QObject::connect(
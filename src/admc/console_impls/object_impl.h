@@ -31,6 +31,8 @@
 #include "console_widget/console_impl.h"
 #include "console_widget/console_widget.h"
 
+#include <QSet>
+
 class QStandardItem;
 class AdObject;
 class AdInterface;
@@ -160,7 +162,31 @@ private:
     void update_toolbar_actions();
 };
 
+// Loads object rows using data resolved once from
+// AdConfig: column list, display format of each column and
+// the set of container classes. Create one loader per
+// fetch and reuse it for all pages of results, instead of
+// querying AdConfig for every object.
+class ObjectRowLoader final {
+public:
+    ObjectRowLoader();
+
+    bool is_container(const AdObject &object) const;
+    void load(const QList<QStandardItem *> &row, const AdObject &object) const;
+
+private:
+    enum ColumnFormat {
+        ColumnFormat_Value,
+        ColumnFormat_Class,
+    };
+
+    QList<QString> column_list;
+    QList<ColumnFormat> column_format_list;
+    QSet<QString> container_class_set;
+};
+
 void object_impl_add_objects_to_console(ConsoleWidget *console, const QList<AdObject> &object_list, const QModelIndex &parent);
+void object_impl_add_objects_to_console(ConsoleWidget *console, const ObjectRowLoader &loader, const QList<AdObject> &object_list, const QModelIndex &parent);
 void object_impl_add_objects_to_console_from_dns(ConsoleWidget *console, AdInterface &ad, const QList<QString> &dn_list, const QModelIndex &parent);
 void console_object_load(const QList<QStandardItem *> row, const AdObject &object);
 void console_object_item_data_load(QStandardItem *item, const AdObject &object);
@@ -28,6 +28,7 @@
 #include "console_impls/policy_ou_impl.h"
 #include "console_impls/policy_root_impl.h"
 #include "globals.h"
+#include "gpo_perms_thread.h"
 #include "results_widgets/policy_results_widget.h"
 #include "properties_widgets/properties_dialog.h"
 #include "rename_dialogs/rename_policy_dialog.h"
@@ -41,10 +42,16 @@
 #include <QDebug>
 #include <QMessageBox>
 #include <QStandardItem>
+#include <QTimer>
+
+// Delay between selecting a policy and starting background
+// work for it, in milliseconds
+#define SELECTION_DELAY 300
 
 void policy_add_links(const QList<ConsoleWidget *> &console_list, PolicyResultsWidget *policy_results, const QList<QString> &policy_list, const QList<QString> &ou_list);
 void console_policy_update_policy_results(ConsoleWidget *console, PolicyResultsWidget *policy_results);
 void console_policy_remove_link(const QList<ConsoleWidget *> &console_list, PolicyResultsWidget *policy_results, const int item_type, const int dn_role, const QString &ou_dn);
+bool policy_is_current_scope(ConsoleWidget *console, const QString &gpo);
 
 PolicyImpl::PolicyImpl(ConsoleWidget *console_arg)
 : ConsoleImpl(console_arg) {
@@ -61,6 +68,15 @@ PolicyImpl::PolicyImpl(ConsoleWidget *console_arg)
     disable_action->setData(GplinkOption_Disabled);
     update_gplink_option_check_actions();
 
+    perms_thread = new GpoPermsThread(this);
+
+    selection_timer = new QTimer(this);
+    selection_timer->setSingleShot(true);
+    selection_timer->setInterval(SELECTION_DELAY);
+
+    connect(
+        selection_timer, &QTimer::timeout,
+        this, &PolicyImpl::on_selection_timer);
     connect(
         add_link_action, &QAction::triggered,
         this, &PolicyImpl::on_add_link);
@@ -70,6 +86,9 @@ PolicyImpl::PolicyImpl(ConsoleWidget *console_arg)
     connect(
         policy_results, &PolicyResultsWidget::ou_gplink_changed,
         this, &PolicyImpl::on_ou_gplink_changed);
+    connect(
+        perms_thread, &GpoPermsThread::check_finished,
+        this, &PolicyImpl::on_perms_check_finished);
     connect(
         enforce_action, &QAction::triggered, [this](){on_change_gplink_option_action(enforce_action);});
     connect(
@@ -100,47 +119,77 @@ void PolicyImpl::drop(const QList<QPersistentModelIndex> &dropped_list, const QS
 }
 
 void PolicyImpl::selected_as_scope(const QModelIndex &index) {
-    AdInterface ad;
-    if (ad_failed(ad, console)) {
+    selected_gpo = index.data(PolicyRole_DN).toString();
+
+    // Display links from last lookup right away, they are
+    // refreshed when selection settles
+    policy_results->load_cached(selected_gpo);
+
+    selection_timer->start();
+}
+
+void PolicyImpl::on_selection_timer() {
+    // NOTE: selection could've moved away from policies
+    // while timer was running
+    if (!policy_is_current_scope(console, selected_gpo)) {
         return;
     }
 
-    // When selecting a policy, check it's permissions to
-    // make sure that they permissions of GPT and GPC match.
-    // If they don't, offer to update GPT permissions.
-    const QString selected_gpo = index.data(PolicyRole_DN).toString();
-    bool ok = true;
-    const bool perms_ok = ad.gpo_check_perms(selected_gpo, &ok);
-
-    if (!perms_ok && ok) {
-        const QString title = tr("Incorrect permissions detected");
-        const QString text = tr("Permissions for this policy's GPT don't match the permissions for it's GPC object. Would you like to update GPT permissions?");
-
-        auto sync_warning_dialog = new QMessageBox(console);
-        sync_warning_dialog->setAttribute(Qt::WA_DeleteOnClose);
-        sync_warning_dialog->setStandardButtons(QMessageBox::Ok | QMessageBox::Cancel);
-        sync_warning_dialog->setWindowTitle(title);
-        sync_warning_dialog->setText(text);
-        sync_warning_dialog->setIcon(QMessageBox::Warning);
-
-        connect(
-            sync_warning_dialog, &QDialog::accepted,
-            console,
-            [this, selected_gpo]() {
-                AdInterface ad_inner;
-                if (ad_failed(ad_inner, console)) {
-                    return;
-                }
+    policy_results->update_in_background(selected_gpo);
 
-                ad_inner.gpo_sync_perms(selected_gpo);
+    start_perms_check();
+}
 
-                g_status->display_ad_messages(ad_inner, console);
-            });
-    }
+// When selecting a policy, check it's permissions to make
+// sure that they permissions of GPT and GPC match. If they
+// don't, offer to update GPT permissions.
+void PolicyImpl::start_perms_check() {
+    // NOTE: all checks go through one long-lived thread
+    // which keeps it's SMB context between checks, so
+    // that a new context isn't setup for every selected
+    // policy. Only the latest selection matters, so if a
+    // check is already running, it's result is discarded
+    // and the thread moves on to the new check.
+    perms_thread->check(selected_gpo);
+}
 
-    g_status->log_messages(ad);
+void PolicyImpl::on_perms_check_finished(const GpoPermsResult &result) {
+    const bool result_is_current = (result.gpo == selected_gpo && policy_is_current_scope(console, result.gpo));
 
-    policy_results->update(selected_gpo);
+    if (result_is_current) {
+        if (result.failed_to_connect) {
+            g_status->add_message(tr("Failed to connect to server while checking policy permissions."), StatusType_Error);
+        }
+
+        g_status->log_messages(result.ad_messages);
+
+        if (!result.perms_ok && result.check_ok) {
+            const QString gpo = result.gpo;
+            const QString title = tr("Incorrect permissions detected");
+            const QString text = tr("Permissions for this policy's GPT don't match the permissions for it's GPC object. Would you like to update GPT permissions?");
+
+            auto sync_warning_dialog = new QMessageBox(console);
+            sync_warning_dialog->setAttribute(Qt::WA_DeleteOnClose);
+            sync_warning_dialog->setStandardButtons(QMessageBox::Ok | QMessageBox::Cancel);
+            sync_warning_dialog->setWindowTitle(title);
+            sync_warning_dialog->setText(text);
+            sync_warning_dialog->setIcon(QMessageBox::Warning);
+
+            connect(
+                sync_warning_dialog, &QDialog::accepted,
+                console,
+                [this, gpo]() {
+                    AdInterface ad_inner;
+                    if (ad_failed(ad_inner, console)) {
+                        return;
+                    }
+
+                    ad_inner.gpo_sync_perms(gpo);
+
+                    g_status->display_ad_messages(ad_inner, console);
+                });
+        }
+    }
 }
 
 QList<QAction *> PolicyImpl::get_all_custom_actions() const {
@@ -331,6 +380,21 @@ void set_disabled_policy_icon(QStandardItem *policy_item, bool is_disabled)
     set_policy_link_icon(policy_item, is_enforced, is_disabled);
 }
 
+// Attributes needed to load policy items, both in console
+// and in policy dialogs
+QList<QString> console_policy_search_attributes() {
+    const QList<QString> out = {
+        ATTRIBUTE_DISPLAY_NAME,
+        ATTRIBUTE_CN,
+        // NOTE: needed to know which icon to use for object
+        ATTRIBUTE_OBJECT_CATEGORY,
+        // NOTE: needed to know gpo status
+        ATTRIBUTE_FLAGS,
+    };
+
+    return out;
+}
+
 void console_policy_load(const QList<QStandardItem *> &row, const AdObject &object) {
     QStandardItem *main_item = row[0];
     console_policy_load_item(main_item, object);
@@ -381,12 +445,12 @@ void console_policy_edit(ConsoleWidget *console, const int item_type, const int
     // TODO: remove this when gpui is able to load
     // policy name on their own
     const QString policy_name = [&]() {
-        const AdObject object = ad.search_object(dn);
+        const AdObject object = ad.search_object_cached(dn, {ATTRIBUTE_DISPLAY_NAME});
         return object.get_string(ATTRIBUTE_DISPLAY_NAME);
     }();
 
     const QString path = [&]() {
-        const AdObject object = ad.search_object(dn);
+        const AdObject object = ad.search_object_cached(dn, {ATTRIBUTE_GPC_FILE_SYS_PATH});
         QString filesys_path = object.get_string(ATTRIBUTE_GPC_FILE_SYS_PATH);
 
         const QString current_dc = ad.get_dc();
@@ -778,7 +842,7 @@ void policy_add_links(const QList<ConsoleWidget *> &console_list, PolicyResultsW
         const QString base = g_adconfig->policies_dn();
         const SearchScope scope = SearchScope_Children;
         const QString filter = filter_dn_list(policy_list);
-        const QList<QString> attributes = QList<QString>();
+        const QList<QString> attributes = console_policy_search_attributes();
 
         const QHash<QString, AdObject> search_results = ad.search(base, scope, filter, attributes);
 
@@ -860,3 +924,11 @@ bool policy_is_disabled(QStandardItem *policy_item)
 
     return is_disabled;
 }
+
+bool policy_is_current_scope(ConsoleWidget *console, const QString &gpo) {
+    const QModelIndex current_scope = console->get_current_scope_item();
+    const ItemType type = (ItemType) console_item_get_type(current_scope);
+    const QString dn = current_scope.data(PolicyRole_DN).toString();
+
+    return (type == ItemType_Policy && dn == gpo);
+}
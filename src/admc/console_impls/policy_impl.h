@@ -38,6 +38,9 @@ class AdObject;
 class AdInterface;
 class ConsoleActions;
 class PolicyResultsWidget;
+class GpoPermsThread;
+class GpoPermsResult;
+class QTimer;
 template <typename T>
 class QList;
 
@@ -79,6 +82,17 @@ private:
     mutable QAction *enforce_action;
     mutable QAction *disable_action;
 
+    // NOTE: checking perms and looking up links are slow,
+    // so they are done in background and only after
+    // selection settles, to not do them for every policy
+    // when moving through policies with arrow keys
+    QTimer *selection_timer;
+    QString selected_gpo;
+    GpoPermsThread *perms_thread;
+
+    void on_selection_timer();
+    void start_perms_check();
+    void on_perms_check_finished(const GpoPermsResult &result);
     void on_gpui_error(QProcess::ProcessError error);
     void set_policy_item_icon(const QModelIndex &policy_index, bool is_checked, GplinkOption option);
     void on_change_gplink_option_action(QAction *action);
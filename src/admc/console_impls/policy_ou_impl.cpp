@@ -29,6 +29,7 @@
 #include "find_widgets/find_policy_dialog.h"
 #include "globals.h"
 #include "gplink.h"
+#include "policy_ou_fetch_thread.h"
 #include "results_widgets/policy_ou_results_widget/policy_ou_results_widget.h"
 #include "select_dialogs/select_policy_dialog.h"
 #include "status.h"
@@ -41,6 +42,8 @@
 #include <QStandardItem>
 #include <QMessageBox>
 
+void policy_ou_impl_load_icon(QStandardItem *item);
+
 bool index_is_domain(const QModelIndex &index) {
     const QString dn = index.data(PolicyOURole_DN).toString();
     const QString domain_dn = g_adconfig->domain_dn();
@@ -83,27 +86,9 @@ void PolicyOUImpl::selected_as_scope(const QModelIndex &index) {
     policy_ou_results_widget->update(index);
 }
 
-// TODO: perform searches in separate threads
 void PolicyOUImpl::fetch(const QModelIndex &index) {
-    AdInterface ad;
-    if (ad_failed(ad, console)) {
-        return;
-    }
-
     const QString dn = index.data(PolicyOURole_DN).toString();
 
-    // Add child OU's
-    {
-        const QString base = dn;
-        const SearchScope scope = SearchScope_Children;
-        const QString filter = filter_CONDITION(Condition_Equals, ATTRIBUTE_OBJECT_CLASS, CLASS_OU);
-        QList<QString> attributes = console_object_search_attributes();
-
-        const QHash<QString, AdObject> results = ad.search(base, scope, filter, attributes);
-
-        policy_ou_impl_add_objects_to_console(console, results.values(), index);
-    }
-
     const bool is_domain = index_is_domain(index);
 
     // Add "All policies" folder if this is domain
@@ -117,16 +102,123 @@ void PolicyOUImpl::fetch(const QModelIndex &index) {
         console->set_item_sort_index(all_policies_item->index(), 2);
     }
 
-    // Add policies linked to this OU
-    const AdObject parent_object = ad.search_object(dn);
-    const QString gplink_string = parent_object.get_string(ATTRIBUTE_GPLINK);
-    const Gplink gplink = Gplink(gplink_string);
-    const QList<QString> gpo_list = gplink.get_gpo_list();
-    console->get_item(index)->setData(gplink_string, PolicyOURole_Gplink_String);
+    // Add child OU's and policies linked to this OU in a
+    // separate thread
+    auto fetch_id_matches = [](QStandardItem *item, PolicyOUFetchThread *thread) {
+        const int id_from_item = item->data(MyConsoleRole_SearchThreadId).toInt();
+        const int thread_id = thread->get_id();
+
+        const bool match = (id_from_item == thread_id);
+
+        return match;
+    };
+
+    QStandardItem *item = console->get_item(index);
+
+    // Set icon to indicate that item is in "search" state
+    item->setIcon(g_icon_manager->get_indicator_icon(g_icon_manager->search_indicator));
+    item->setDragEnabled(false);
+
+    auto fetch_thread = new PolicyOUFetchThread(dn);
 
-    policy_ou_impl_add_objects_from_dns(console, ad, gpo_list, index);
+    // NOTE: change item's search thread, this will be used
+    // later to handle situations where a thread is started
+    // while another is running, for example if item is
+    // refreshed during fetch
+    item->setData(fetch_thread->get_id(), MyConsoleRole_SearchThreadId);
 
-    policy_ou_results_widget->update_inheritance_widget(index);
+    const QPersistentModelIndex persistent_index = index;
+
+    // NOTE: returns item if results of thread should be
+    // loaded, otherwise stops the thread
+    auto get_item_for_results = [=]() -> QStandardItem * {
+        if (!persistent_index.isValid()) {
+            fetch_thread->stop();
+
+            return nullptr;
+        }
+
+        QStandardItem *item_now = console->get_item(persistent_index);
+
+        const bool thread_id_match = fetch_id_matches(item_now, fetch_thread);
+        if (!thread_id_match) {
+            fetch_thread->stop();
+
+            return nullptr;
+        }
+
+        return item_now;
+    };
+
+    connect(
+        fetch_thread, &PolicyOUFetchThread::ous_ready,
+        this,
+        [=](const QHash<QString, AdObject> &results) {
+            QStandardItem *item_now = get_item_for_results();
+            if (item_now == nullptr) {
+                return;
+            }
+
+            policy_ou_impl_add_objects_to_console(console, results.values(), persistent_index);
+        },
+        Qt::QueuedConnection);
+    connect(
+        fetch_thread, &PolicyOUFetchThread::policies_ready,
+        this,
+        [=](const QString &gplink_string, const QHash<QString, AdObject> &results) {
+            QStandardItem *item_now = get_item_for_results();
+            if (item_now == nullptr) {
+                return;
+            }
+
+            item_now->setData(gplink_string, PolicyOURole_Gplink_String);
+
+            // NOTE: add policies in the order of links
+            const QList<QString> gpo_list = Gplink(gplink_string).get_gpo_list();
+            QList<AdObject> object_list;
+            for (const QString &gpo : gpo_list) {
+                if (results.contains(gpo)) {
+                    object_list.append(results[gpo]);
+                }
+            }
+
+            policy_ou_impl_add_objects_to_console(console, object_list, persistent_index);
+
+            policy_ou_results_widget->update_inheritance_widget(persistent_index);
+        },
+        Qt::QueuedConnection);
+    connect(
+        fetch_thread, &PolicyOUFetchThread::finished,
+        this,
+        [=]() {
+            g_status->display_ad_messages(fetch_thread->get_ad_messages(), console);
+
+            if (fetch_thread->failed_to_connect()) {
+                error_log({tr("Failed to connect to server while searching for objects.")}, console);
+            }
+
+            fetch_thread->deleteLater();
+
+            if (!persistent_index.isValid()) {
+                return;
+            }
+
+            QStandardItem *item_now = console->get_item(persistent_index);
+
+            // NOTE: if another thread was started for this
+            // item, don't change item data. It will be
+            // changed by that other thread.
+            const bool thread_id_match = fetch_id_matches(item_now, fetch_thread);
+            if (!thread_id_match) {
+                return;
+            }
+
+            policy_ou_impl_load_icon(item_now);
+            item_now->setDragEnabled(true);
+        },
+        Qt::QueuedConnection);
+
+    fetch_thread->start();
 }
 
 bool PolicyOUImpl::can_drop(const QList<QPersistentModelIndex> &dropped_list, const QSet<int> &dropped_type_list, const QPersistentModelIndex &target, const int target_type) {
@@ -303,7 +395,7 @@ void PolicyOUImpl::create_and_link_gpo() {
             policy_ou_results_widget->update(current_scope);
 
             // Add policy to "all policies" folder
-            const AdObject gpo_object = ad2.search_object(gpo_dn);
+            const AdObject gpo_object = ad2.search_object(gpo_dn, console_policy_search_attributes());
             const QModelIndex all_policies_index = get_all_policies_folder_index(console);
             all_policies_folder_impl_add_objects(console, {gpo_object}, all_policies_index);
         });
@@ -347,8 +439,12 @@ void policy_ou_impl_add_objects_from_dns(ConsoleWidget *console, AdInterface &ad
     const QList<AdObject> object_list = [&]() {
         QList<AdObject> out;
 
+        // NOTE: policies are usually already cached by
+        // "All policies" folder
+        const QList<QString> attributes = console_policy_search_attributes();
+
         for (const QString &dn : dn_list) {
-            const AdObject object = ad.search_object(dn);
+            const AdObject object = ad.search_object_cached(dn, attributes);
             out.append(object);
         }
 
@@ -524,6 +620,31 @@ void policy_ou_impl_load_item_data(QStandardItem *item, const AdObject &object)
     item->setData(inheritance_is_blocked, PolicyOURole_Inheritance_Block);
 }
 
+// NOTE: loads icon from item data, used to restore icon
+// after fetch
+void policy_ou_impl_load_icon(QStandardItem *item) {
+    const bool is_domain = index_is_domain(item->index());
+    const bool inheritance_is_blocked = item->data(PolicyOURole_Inheritance_Block).toBool();
+
+    const ItemIconType icon_type = [&]() {
+        if (is_domain) {
+            if (inheritance_is_blocked) {
+                return ItemIconType_Domain_InheritanceBlocked;
+            } else {
+                return ItemIconType_Domain_Clean;
+            }
+        } else {
+            if (inheritance_is_blocked) {
+                return ItemIconType_OU_InheritanceBlocked;
+            } else {
+                return ItemIconType_OU_Clean;
+            }
+        }
+    }();
+
+    item->setIcon(g_icon_manager->get_icon_for_type(icon_type));
+}
+
 QModelIndex get_ou_child_policy_index(ConsoleWidget *console, const QModelIndex &ou_index, const QString &policy_dn) {
     QList<QModelIndex> found_policy_indexes = console->search_items(ou_index,
                                                                      PolicyRole_DN,
@@ -621,8 +621,10 @@ void console_query_move(ConsoleWidget *console, const QList<QPersistentModelInde
                 const QString base = index.data(QueryItemRole_Base).toString();
                 const QString name = index.data(Qt::DisplayRole).toString();
                 const bool scope_is_children = index.data(QueryItemRole_ScopeIsChildren).toBool();
+                const bool keep_results = index.data(QueryItemRole_KeepResults).toBool();
 
                 const QModelIndex item_index = console_query_item_create(console, name, description, filter, filter_state, base, scope_is_children, new_parent);
+                console->get_item(item_index)->setData(keep_results, QueryItemRole_KeepResults);
 
                 created_list.append(item_index);
             } else if (type == ItemType_QueryFolder) {
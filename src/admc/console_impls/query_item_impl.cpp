@@ -27,12 +27,16 @@
 #include "console_widget/results_view.h"
 #include "create_dialogs/create_query_item_dialog.h"
 #include "edit_query_widgets/edit_query_item_dialog.h"
+#include "export_results_dialog.h"
 #include "globals.h"
+#include "query_cache_thread.h"
 #include "settings.h"
+#include "status.h"
 #include "utils.h"
 #include "icon_manager/icon_manager.h"
 
 #include <QCoreApplication>
+#include <QFile>
 #include <QFileDialog>
 #include <QJsonDocument>
 #include <QMenu>
@@ -44,6 +48,10 @@
 
 const QString query_item_icon = "emblem-system";
 
+AdQueryCache query_item_make_cache(const QModelIndex &index);
+QString query_item_kept_results_path(const QString &key);
+void query_item_apply_changes(ConsoleWidget *console, const QModelIndex &index, const QList<AdObject> &changed, const QList<QString> &removed);
+
 QueryItemImpl::QueryItemImpl(ConsoleWidget *console_arg)
 : ConsoleImpl(console_arg) {
     query_folder_impl = nullptr;
@@ -52,6 +60,9 @@ QueryItemImpl::QueryItemImpl(ConsoleWidget *console_arg)
 
     edit_action = new QAction(tr("Edit..."), this);
     export_action = new QAction(tr("Export query..."), this);
+    export_results_action = new QAction(tr("Export results..."), this);
+    keep_results_action = new QAction(tr("Keep results"), this);
+    keep_results_action->setCheckable(true);
 
     connect(
         edit_action, &QAction::triggered,
@@ -59,6 +70,12 @@ QueryItemImpl::QueryItemImpl(ConsoleWidget *console_arg)
     connect(
         export_action, &QAction::triggered,
         this, &QueryItemImpl::on_export);
+    connect(
+        export_results_action, &QAction::triggered,
+        this, &QueryItemImpl::on_export_results);
+    connect(
+        keep_results_action, &QAction::triggered,
+        this, &QueryItemImpl::on_keep_results);
 }
 
 void QueryItemImpl::set_query_folder_impl(QueryFolderImpl *impl) {
@@ -72,6 +89,13 @@ void QueryItemImpl::fetch(const QModelIndex &index) {
     item->setIcon(g_icon_manager->get_object_icon(ADMC_CATEGORY_QUERY_ITEM));
     item->setToolTip("");
 
+    const bool keep_results = index.data(QueryItemRole_KeepResults).toBool();
+    if (keep_results) {
+        fetch_kept_results(index);
+
+        return;
+    }
+
     const QString filter = index.data(QueryItemRole_Filter).toString();
     const QString base = index.data(QueryItemRole_Base).toString();
     const QList<QString> search_attributes = console_object_search_attributes();
@@ -98,18 +122,23 @@ QList<QAction *> QueryItemImpl::get_all_custom_actions() const {
 
     out.append(edit_action);
     out.append(export_action);
+    out.append(export_results_action);
+    out.append(keep_results_action);
 
     return out;
 }
 
 QSet<QAction *> QueryItemImpl::get_custom_actions(const QModelIndex &index, const bool single_selection) const {
-    UNUSED_ARG(index);
-
     QSet<QAction *> out;
 
     if (single_selection) {
         out.insert(edit_action);
         out.insert(export_action);
+        out.insert(export_results_action);
+        out.insert(keep_results_action);
+
+        const bool keep_results = index.data(QueryItemRole_KeepResults).toBool();
+        keep_results_action->setChecked(keep_results);
     }
 
     return out;
@@ -141,6 +170,10 @@ void QueryItemImpl::refresh(const QList<QModelIndex> &index_list) {
 }
 
 void QueryItemImpl::delete_action(const QList<QModelIndex> &index_list) {
+    for (const QModelIndex &index : index_list) {
+        remove_kept_results(index);
+    }
+
     query_action_delete(console, index_list);
 }
 
@@ -191,6 +224,135 @@ void QueryItemImpl::on_export() {
     file.write(json_bytes);
 }
 
+// NOTE: this exports results of the query, as opposed to
+// on_export() which exports the query definition. Results
+// are searched again and streamed to file, so export
+// doesn't depend on whether the query was fetched and
+// isn't limited by object display limit.
+void QueryItemImpl::on_export_results() {
+    const QModelIndex index = console->get_selected_item(ItemType_QueryItem);
+
+    const QString name = index.data(Qt::DisplayRole).toString();
+    const QString filter = index.data(QueryItemRole_Filter).toString();
+    const QString base = index.data(QueryItemRole_Base).toString();
+    const SearchScope scope = [&]() {
+        const bool scope_is_children = index.data(QueryItemRole_ScopeIsChildren).toBool();
+        if (scope_is_children) {
+            return SearchScope_Children;
+        } else {
+            return SearchScope_All;
+        }
+    }();
+
+    auto dialog = new ExportResultsDialog(base, scope, filter, name, console);
+    dialog->open();
+}
+
+void QueryItemImpl::on_keep_results(const bool checked) {
+    const QModelIndex index = console->get_selected_item(ItemType_QueryItem);
+
+    if (!checked) {
+        remove_kept_results(index);
+    }
+
+    QStandardItem *item = console->get_item(index);
+    item->setData(checked, QueryItemRole_KeepResults);
+
+    console_query_tree_save(console);
+
+    // NOTE: fetch again so that results are kept right
+    // away instead of on next fetch
+    if (checked && console_item_get_was_fetched(index)) {
+        console->refresh_scope(index);
+    }
+}
+
+// NOTE: kept results are displayed right away and then
+// updated in the background. Only rows of changed objects
+// are updated, so rows that didn't change stay as they are
+// along with their selection.
+void QueryItemImpl::fetch_kept_results(const QModelIndex &index) {
+    const AdQueryCache cache = [&]() {
+        AdQueryCache out = query_item_make_cache(index);
+        const QString key = out.get_key();
+
+        if (kept_results_map.contains(key)) {
+            return kept_results_map[key];
+        }
+
+        // NOTE: if file doesn't exist or is out of date,
+        // cache stays empty and all objects are loaded
+        QFile file(query_item_kept_results_path(key));
+        const bool open_success = file.open(QIODevice::ReadOnly);
+        if (open_success) {
+            out.load(file.readAll());
+        }
+
+        return out;
+    }();
+
+    const QString key = cache.get_key();
+
+    object_impl_add_objects_to_console(console, cache.get_objects(), index);
+
+    // Set icon to indicate that item is in "search" state
+    QStandardItem *item = console->get_item(index);
+    item->setIcon(g_icon_manager->get_indicator_icon(g_icon_manager->search_indicator));
+    item->setData(true, ObjectRole_Fetching);
+    item->setDragEnabled(false);
+
+    auto cache_thread = new QueryCacheThread(cache, query_item_kept_results_path(key));
+
+    item->setData(cache_thread->get_id(), MyConsoleRole_SearchThreadId);
+
+    const QPersistentModelIndex persistent_index = index;
+
+    connect(
+        cache_thread, &QueryCacheThread::finished,
+        this,
+        [this, cache_thread, persistent_index, key]() {
+            if (!persistent_index.isValid()) {
+                return;
+            }
+
+            g_status->display_ad_messages(cache_thread->get_ad_messages(), console);
+            query_cache_thread_display_errors(cache_thread, console);
+
+            QStandardItem *item_now = console->get_item(persistent_index);
+
+            // NOTE: if another thread was started for this
+            // item, don't change item data. It will be
+            // changed by that other thread.
+            const bool thread_id_match = (item_now->data(MyConsoleRole_SearchThreadId).toInt() == cache_thread->get_id());
+            if (!thread_id_match) {
+                return;
+            }
+
+            if (cache_thread->is_complete()) {
+                kept_results_map[key] = cache_thread->get_cache();
+
+                query_item_apply_changes(console, persistent_index, cache_thread->get_changed(), cache_thread->get_removed());
+            }
+
+            item_now->setIcon(g_icon_manager->get_object_icon(ADMC_CATEGORY_QUERY_ITEM));
+            item_now->setData(false, ObjectRole_Fetching);
+            item_now->setDragEnabled(true);
+        },
+        Qt::QueuedConnection);
+    connect(
+        cache_thread, &QueryCacheThread::finished,
+        cache_thread, &QObject::deleteLater);
+
+    cache_thread->start();
+}
+
+void QueryItemImpl::remove_kept_results(const QModelIndex &index) {
+    const QString key = query_item_make_cache(index).get_key();
+
+    kept_results_map.remove(key);
+    QFile::remove(query_item_kept_results_path(key));
+}
+
 void console_query_item_load(const QList<QStandardItem *> row, const QString &name, const QString &description, const QString &filter, const QByteArray &filter_state, const QString &base, const bool scope_is_children) {
     QStandardItem *main_item = row[0];
     main_item->setData(description, QueryItemRole_Description);
@@ -227,6 +389,7 @@ QHash<QString, QVariant> console_query_item_save_hash(const QModelIndex &index)
     data["filter"] = filter;
     data["filter_state"] = filter_state.toHex();
     data["scope_is_children"] = scope_is_children;
+    data["keep_results"] = index.data(QueryItemRole_KeepResults).toBool();
 
     return data;
 }
@@ -242,12 +405,14 @@ void console_query_item_load_hash(ConsoleWidget *console, const QHash<QString, Q
     const bool scope_is_children = data["scope_is_children"].toBool();
     const QString filter = data["filter"].toString();
     const QByteArray filter_state = QByteArray::fromHex(data["filter_state"].toString().toLocal8Bit());
+    const bool keep_results = data["keep_results"].toBool();
 
     if (!console_query_or_folder_name_is_good(name, parent_index, console, QModelIndex())) {
         return;
     }
 
-    console_query_item_create(console, name, description, filter, filter_state, base, scope_is_children, parent_index);
+    const QModelIndex index = console_query_item_create(console, name, description, filter, filter_state, base, scope_is_children, parent_index);
+    console->get_item(index)->setData(keep_results, QueryItemRole_KeepResults);
 }
 
 void QueryItemImpl::on_edit_query_item() {
@@ -281,6 +446,10 @@ void QueryItemImpl::on_edit_query_item() {
             const QByteArray filter_state = dialog->filter_state();
             const bool scope_is_children = dialog->scope_is_children();
 
+            // NOTE: kept results are for previous search
+            // parameters, they won't be used again
+            remove_kept_results(index);
+
             const QList<QStandardItem *> row = console->get_row(index);
             console_query_item_load(row, name, description, filter, filter_state, base, scope_is_children);
 
@@ -297,3 +466,68 @@ void get_query_item_data(const QModelIndex &index, QString *name, QString *descr
     *filter_state = index.data(QueryItemRole_FilterState).toByteArray();
     *filter = index.data(QueryItemRole_Filter).toString();
 }
+
+AdQueryCache query_item_make_cache(const QModelIndex &index) {
+    const QString filter = index.data(QueryItemRole_Filter).toString();
+    const QString base = index.data(QueryItemRole_Base).toString();
+    const QList<QString> search_attributes = console_object_search_attributes();
+    const SearchScope scope = [&]() {
+        const bool scope_is_children = index.data(QueryItemRole_ScopeIsChildren).toBool();
+        if (scope_is_children) {
+            return SearchScope_Children;
+        } else {
+            return SearchScope_All;
+        }
+    }();
+
+    const AdQueryCache out = AdQueryCache(base, scope, filter, search_attributes);
+
+    return out;
+}
+
+QString query_item_kept_results_path(const QString &key) {
+    const QString cache_dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    const QString out = QString("%1/query_results/%2").arg(cache_dir, key);
+
+    return out;
+}
+
+void query_item_apply_changes(ConsoleWidget *console, const QModelIndex &index, const QList<AdObject> &changed, const QList<QString> &removed) {
+    // NOTE: use persistent indexes because deleting rows
+    // shifts the rest
+    const QHash<QString, QPersistentModelIndex> row_map = [&]() {
+        QHash<QString, QPersistentModelIndex> out;
+
+        QStandardItem *item = console->get_item(index);
+
+        for (int row = 0; row < item->rowCount(); row++) {
+            QStandardItem *child = item->child(row, 0);
+            const QString dn = child->data(ObjectRole_DN).toString();
+
+            out[dn] = QPersistentModelIndex(child->index());
+        }
+
+        return out;
+    }();
+
+    for (const QString &dn : removed) {
+        if (row_map.contains(dn)) {
+            console->delete_item(row_map[dn]);
+        }
+    }
+
+    QList<AdObject> added_list;
+
+    for (const AdObject &object : changed) {
+        const QString dn = object.get_dn();
+
+        if (row_map.contains(dn) && row_map[dn].isValid()) {
+            const QList<QStandardItem *> row = console->get_row(row_map[dn]);
+            console_object_load(row, object);
+        } else {
+            added_list.append(object);
+        }
+    }
+
+    object_impl_add_objects_to_console(console, added_list, index);
+}
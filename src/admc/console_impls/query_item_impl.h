@@ -28,9 +28,12 @@
  * or query tree root.
  */
 
+#include "ad_query_cache.h"
 #include "console_impls/my_console_role.h"
 #include "console_widget/console_impl.h"
 
+#include <QHash>
+
 enum QueryItemRole {
     QueryItemRole_Description = MyConsoleRole_LAST + 1,
     QueryItemRole_Filter,
@@ -38,6 +41,7 @@ enum QueryItemRole {
     QueryItemRole_Base,
     QueryItemRole_ScopeIsChildren,
     QueryItemRole_IsRoot,
+    QueryItemRole_KeepResults,
 
     QueryItemRole_LAST,
 };
@@ -76,13 +80,23 @@ public:
 
 private slots:
     void on_export();
+    void on_export_results();
+    void on_keep_results(const bool checked);
 
 private:
     QAction *edit_action;
     QAction *export_action;
+    QAction *export_results_action;
+    QAction *keep_results_action;
     QueryFolderImpl *query_folder_impl;
 
+    // Kept results of query items, by key of search
+    // parameters. Filled from files on first fetch.
+    QHash<QString, AdQueryCache> kept_results_map;
+
     void on_edit_query_item();
+    void fetch_kept_results(const QModelIndex &index);
+    void remove_kept_results(const QModelIndex &index);
 };
 
 void console_query_item_load(const QList<QStandardItem *> row, const QString &name, const QString &description, const QString &filter, const QByteArray &filter_state, const QString &base, const bool scope_is_children);
@@ -259,10 +259,10 @@ void ConsoleWidget::register_impl(const int type, ConsoleImpl *impl) {
 }
 
 QList<QStandardItem *> ConsoleWidget::add_scope_item(const int type, const QModelIndex &parent) {
-    const QList<QStandardItem *> row = add_results_item(type, parent);
+    const QList<QStandardItem *> row = make_scope_row(type, parent);
 
-    row[0]->setData(false, ConsoleRole_WasFetched);
-    row[0]->setData(true, ConsoleRole_IsScope);
+    QStandardItem *parent_item = d->get_parent_item(parent);
+    parent_item->appendRow(row);
 
     d->scope_proxy_model->sort(0, Qt::AscendingOrder);
 
@@ -270,41 +270,80 @@ QList<QStandardItem *> ConsoleWidget::add_scope_item(const int type, const QMode
 }
 
 QList<QStandardItem *> ConsoleWidget::add_results_item(const int type, const QModelIndex &parent) {
-    QStandardItem *parent_item = [&]() {
+    const QList<QStandardItem *> row = make_results_row(type, parent);
+
+    QStandardItem *parent_item = d->get_parent_item(parent);
+    parent_item->appendRow(row);
+
+    return row;
+}
+
+QList<QStandardItem *> ConsoleWidget::make_scope_row(const int type, const QModelIndex &parent) {
+    const QList<QStandardItem *> row = make_results_row(type, parent);
+
+    row[0]->setData(false, ConsoleRole_WasFetched);
+    row[0]->setData(true, ConsoleRole_IsScope);
+
+    return row;
+}
+
+QList<QStandardItem *> ConsoleWidget::make_results_row(const int type, const QModelIndex &parent) {
+    const int column_count = [&]() {
         if (parent.isValid()) {
-            return d->model->itemFromIndex(parent);
+            ConsoleImpl *parent_impl = d->get_impl(parent);
+            return parent_impl->column_labels().size();
         } else {
-            return d->model->invisibleRootItem();
+            return 1;
         }
     }();
 
-    // Make item row
-    const QList<QStandardItem *> row = [&]() {
-        QList<QStandardItem *> out;
+    QList<QStandardItem *> row;
+    for (int i = 0; i < column_count; i++) {
+        const auto item = new QStandardItem();
+        row.append(item);
+    }
 
-        const int column_count = [&]() {
-            if (parent_item == d->model->invisibleRootItem()) {
-                return 1;
-            } else {
-                ConsoleImpl *parent_impl = d->get_impl(parent);
-                return parent_impl->column_labels().size();
-            }
-        }();
+    row[0]->setData(false, ConsoleRole_IsScope);
+    row[0]->setData(type, ConsoleRole_Type);
 
-        for (int i = 0; i < column_count; i++) {
-            const auto item = new QStandardItem();
-            out.append(item);
-        }
+    return row;
+}
 
-        return out;
+void ConsoleWidget::add_rows(const QModelIndex &parent, const QList<QList<QStandardItem *>> &row_list) {
+    if (row_list.isEmpty()) {
+        return;
+    }
+
+    QStandardItem *parent_item = d->get_parent_item(parent);
+
+    // NOTE: rows are added under parent, so only results
+    // view of parent's impl displays them
+    ResultsView *results_view = [&]() -> ResultsView * {
+        if (parent.isValid()) {
+            ConsoleImpl *parent_impl = d->get_impl(parent);
+            return parent_impl->view();
+        } else {
+            return nullptr;
+        }
     }();
 
-    row[0]->setData(false, ConsoleRole_IsScope);
-    row[0]->setData(type, ConsoleRole_Type);
+    // NOTE: disable dynamic sorting while rows are added,
+    // otherwise proxies sort each row as it is added.
+    // Enabling it again sorts everything once.
+    d->scope_proxy_model->setDynamicSortFilter(false);
+    if (results_view != nullptr) {
+        results_view->begin_batch_insert();
+    }
 
-    parent_item->appendRow(row);
+    for (const QList<QStandardItem *> &row : row_list) {
+        parent_item->appendRow(row);
+    }
 
-    return row;
+    if (results_view != nullptr) {
+        results_view->end_batch_insert();
+    }
+    d->scope_proxy_model->setDynamicSortFilter(true);
+    d->scope_proxy_model->sort(0, Qt::AscendingOrder);
 }
 
 void ConsoleWidget::delete_item(const QModelIndex &index) {
@@ -926,6 +965,14 @@ ConsoleImpl *ConsoleWidgetPrivate::get_current_scope_impl() const {
     return impl;
 }
 
+QStandardItem *ConsoleWidgetPrivate::get_parent_item(const QModelIndex &parent) const {
+    if (parent.isValid()) {
+        return model->itemFromIndex(parent);
+    } else {
+        return model->invisibleRootItem();
+    }
+}
+
 ConsoleImpl *ConsoleWidgetPrivate::get_impl(const QModelIndex &index) const {
     const int type = index.data(ConsoleRole_Type).toInt();
     ConsoleImpl *impl = impl_map.value(type, default_impl);
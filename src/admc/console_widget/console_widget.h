@@ -110,6 +110,19 @@ public:
     QList<QStandardItem *> add_scope_item(const int type, const QModelIndex &parent);
     QList<QStandardItem *> add_results_item(const int type, const QModelIndex &parent);
 
+    // These f-ns are for adding many items at once, for
+    // example a page of search results. make_scope_row()
+    // and make_results_row() create rows which are not yet
+    // in console. Load their data, then add them all using
+    // add_rows(). This is much faster than adding items one
+    // by one because rows are sorted once after all of
+    // them are added, instead of after every row. Also,
+    // data is loaded before rows are added so there are no
+    // change notifications for it.
+    QList<QStandardItem *> make_scope_row(const int type, const QModelIndex &parent);
+    QList<QStandardItem *> make_results_row(const int type, const QModelIndex &parent);
+    void add_rows(const QModelIndex &parent, const QList<QList<QStandardItem *>> &row_list);
+
     // Deletes an item and all of it's columns
     void delete_item(const QModelIndex &index);
 
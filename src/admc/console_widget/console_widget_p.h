@@ -37,6 +37,7 @@ class QStackedWidget;
 class ScopeProxyModel;
 class ConsoleDragModel;
 class QStandardItemModel;
+class QStandardItem;
 class ConsoleWidget;
 class QSplitter;
 class ConsoleImpl;
@@ -102,6 +103,7 @@ public:
     void fetch_scope(const QModelIndex &index);
     ConsoleImpl *get_current_scope_impl() const;
     ConsoleImpl *get_impl(const QModelIndex &index) const;
+    QStandardItem *get_parent_item(const QModelIndex &parent) const;
     void update_description();
     QList<QModelIndex> get_all_selected_items() const;
     QList<QAction *> get_custom_action_list() const;
@@ -229,3 +229,14 @@ void ResultsView::set_row_hidden(int row, bool hidden)
 {
     m_detail_view->setRowHidden(row, QModelIndex(), hidden);
 }
+
+void ResultsView::begin_batch_insert() {
+    proxy_model->setDynamicSortFilter(false);
+    stacked_widget->setUpdatesEnabled(false);
+}
+
+void ResultsView::end_batch_insert() {
+    // NOTE: enabling dynamic sort sorts all rows
+    proxy_model->setDynamicSortFilter(true);
+    stacked_widget->setUpdatesEnabled(true);
+}
@@ -72,6 +72,13 @@ public:
 
     void set_row_hidden(int row, bool hidden);
 
+    // Call these before and after adding many rows to the
+    // model. While batch is in progress, added rows are not
+    // sorted and views are not repainted. Rows are sorted
+    // once when batch ends.
+    void begin_batch_insert();
+    void end_batch_insert();
+
 signals:
     void activated(const QModelIndex &index);
     void context_menu(const QPoint pos);
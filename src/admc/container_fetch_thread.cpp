@@ -0,0 +1,95 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "container_fetch_thread.h"
+
+#include "adldap.h"
+#include "utils.h"
+
+#include <QHash>
+
+ContainerFetchThread::ContainerFetchThread(const QList<QString> &base_list_arg, const QString &filter_arg, const QList<QString> &attributes_arg) {
+    stop_flag = false;
+    base_list = base_list_arg;
+    filter = filter_arg;
+    attributes = attributes_arg;
+    m_failed_to_connect = false;
+}
+
+void ContainerFetchThread::stop() {
+    stop_flag = true;
+}
+
+bool ContainerFetchThread::failed_to_connect() const {
+    return m_failed_to_connect;
+}
+
+QList<AdMessage> ContainerFetchThread::get_ad_messages() const {
+    return ad_messages;
+}
+
+void ContainerFetchThread::run() {
+    AdInterface ad;
+    if (!ad.is_connected()) {
+        m_failed_to_connect = true;
+
+        return;
+    }
+
+    for (const QString &base : base_list) {
+        if (stop_flag) {
+            break;
+        }
+
+        AdCookie cookie;
+        bool is_first_page = true;
+        bool base_completed = false;
+
+        while (true) {
+            QHash<QString, AdObject> results;
+
+            const bool success = ad.search_paged(base, SearchScope_Children, filter, attributes, &results, &cookie);
+
+            if (is_first_page) {
+                dev_mode_search_results(results, ad, base);
+                is_first_page = false;
+            }
+
+            emit results_ready(base, results);
+
+            const bool search_interrupted = (!success || stop_flag);
+            if (search_interrupted) {
+                break;
+            }
+
+            if (!cookie.more_pages()) {
+                base_completed = true;
+
+                break;
+            }
+        }
+
+        if (base_completed) {
+            emit base_fetched(base);
+        }
+    }
+
+    ad_messages = ad.messages();
+}
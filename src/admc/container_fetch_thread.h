@@ -0,0 +1,68 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CONTAINER_FETCH_THREAD_H
+#define CONTAINER_FETCH_THREAD_H
+
+/**
+ * Thread that loads children of several parents, one after
+ * another, using one connection. Used to fetch a container
+ * together with prefetching the containers below it.
+ * Results are emitted page by page together with the
+ * parent they belong to. base_fetched() is emitted once
+ * all children of a parent were loaded, it is not emitted
+ * for parents for which the search failed or was
+ * interrupted. Note that creator of thread should call
+ * thread's deleteLater() in the finished() slot.
+ */
+
+#include <QThread>
+
+#include "ad_defines.h"
+
+class AdObject;
+class AdMessage;
+
+class ContainerFetchThread final : public QThread {
+    Q_OBJECT
+
+public:
+    ContainerFetchThread(const QList<QString> &base_list, const QString &filter, const QList<QString> &attributes);
+
+    void stop();
+    bool failed_to_connect() const;
+    QList<AdMessage> get_ad_messages() const;
+
+signals:
+    void results_ready(const QString &base, const QHash<QString, AdObject> &results);
+    void base_fetched(const QString &base);
+
+private:
+    bool stop_flag;
+    QList<QString> base_list;
+    QString filter;
+    QList<QString> attributes;
+    bool m_failed_to_connect;
+    QList<AdMessage> ad_messages;
+
+    void run() override;
+};
+
+#endif /* CONTAINER_FETCH_THREAD_H */
@@ -96,7 +96,7 @@ void CreatePolicyDialog::accept() {
         const QString base = g_adconfig->domain_dn();
         const SearchScope scope = SearchScope_All;
         const QString filter = filter_CONDITION(Condition_Equals, ATTRIBUTE_DISPLAY_NAME, name);
-        const QList<QString> attributes = QList<QString>();
+        const QList<QString> attributes = {ATTRIBUTE_DN};
         const QHash<QString, AdObject> results = ad.search(base, scope, filter, attributes);
 
         return !results.isEmpty();
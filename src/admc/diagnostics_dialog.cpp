@@ -0,0 +1,230 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "diagnostics_dialog.h"
+#include "ui_diagnostics_dialog.h"
+
+#include "adldap.h"
+#include "settings.h"
+#include "utils.h"
+
+#include <QFile>
+#include <QFileDialog>
+#include <QStandardItemModel>
+#include <QStandardPaths>
+
+enum SummaryColumn {
+    SummaryColumn_Type,
+    SummaryColumn_Count,
+    SummaryColumn_Errors,
+    SummaryColumn_Entries,
+    SummaryColumn_Bytes,
+    SummaryColumn_Average,
+    SummaryColumn_P50,
+    SummaryColumn_P90,
+    SummaryColumn_P99,
+    SummaryColumn_Max,
+    SummaryColumn_FirstEntryP50,
+
+    SummaryColumn_COUNT,
+};
+
+enum OperationsColumn {
+    OperationsColumn_Start,
+    OperationsColumn_Type,
+    OperationsColumn_Base,
+    OperationsColumn_Scope,
+    OperationsColumn_FilterHash,
+    OperationsColumn_Pages,
+    OperationsColumn_Entries,
+    OperationsColumn_Bytes,
+    OperationsColumn_FirstEntry,
+    OperationsColumn_Total,
+    OperationsColumn_Wait,
+    OperationsColumn_Decode,
+    OperationsColumn_Result,
+
+    OperationsColumn_COUNT,
+};
+
+// Converts microseconds to milliseconds, rounded to one
+// decimal
+double usec_to_msec(const qint64 usec);
+
+DiagnosticsDialog::DiagnosticsDialog(QWidget *parent)
+: QDialog(parent) {
+    ui = new Ui::DiagnosticsDialog();
+    ui->setupUi(this);
+
+    setAttribute(Qt::WA_DeleteOnClose);
+
+    summary_model = new QStandardItemModel(0, SummaryColumn_COUNT, this);
+    set_horizontal_header_labels_from_map(summary_model,
+        {
+            {SummaryColumn_Type, tr("Operation")},
+            {SummaryColumn_Count, tr("Count")},
+            {SummaryColumn_Errors, tr("Errors")},
+            {SummaryColumn_Entries, tr("Entries")},
+            {SummaryColumn_Bytes, tr("Bytes")},
+            {SummaryColumn_Average, tr("Average, ms")},
+            {SummaryColumn_P50, tr("50%, ms")},
+            {SummaryColumn_P90, tr("90%, ms")},
+            {SummaryColumn_P99, tr("99%, ms")},
+            {SummaryColumn_Max, tr("Max, ms")},
+            {SummaryColumn_FirstEntryP50, tr("First entry 50%, ms")},
+        });
+    ui->summary_view->setModel(summary_model);
+
+    operations_model = new QStandardItemModel(0, OperationsColumn_COUNT, this);
+    set_horizontal_header_labels_from_map(operations_model,
+        {
+            {OperationsColumn_Start, tr("Start")},
+            {OperationsColumn_Type, tr("Operation")},
+            {OperationsColumn_Base, tr("Base")},
+            {OperationsColumn_Scope, tr("Scope")},
+            {OperationsColumn_FilterHash, tr("Filter hash")},
+            {OperationsColumn_Pages, tr("Pages")},
+            {OperationsColumn_Entries, tr("Entries")},
+            {OperationsColumn_Bytes, tr("Bytes")},
+            {OperationsColumn_FirstEntry, tr("First entry, ms")},
+            {OperationsColumn_Total, tr("Total, ms")},
+            {OperationsColumn_Wait, tr("Wait, ms")},
+            {OperationsColumn_Decode, tr("Decode, ms")},
+            {OperationsColumn_Result, tr("Result")},
+        });
+    ui->operations_view->setModel(operations_model);
+
+    settings_setup_dialog_geometry(SETTING_diagnostics_dialog_geometry, this);
+
+    connect(
+        ui->refresh_button, &QPushButton::clicked,
+        this, &DiagnosticsDialog::load);
+    connect(
+        ui->clear_button, &QPushButton::clicked,
+        this, &DiagnosticsDialog::clear);
+    connect(
+        ui->save_button, &QPushButton::clicked,
+        this, &DiagnosticsDialog::save);
+
+    load();
+}
+
+DiagnosticsDialog::~DiagnosticsDialog() {
+    delete ui;
+}
+
+void DiagnosticsDialog::load() {
+    summary_model->removeRows(0, summary_model->rowCount());
+    operations_model->removeRows(0, operations_model->rowCount());
+
+    for (int i = 0; i < AdOperationType_COUNT; i++) {
+        const AdOperationType type = (AdOperationType) i;
+        const AdOperationStats stats = ad_metrics_get_stats(type);
+
+        if (stats.count == 0) {
+            continue;
+        }
+
+        const QList<QStandardItem *> row = make_item_row(SummaryColumn_COUNT);
+
+        row[SummaryColumn_Type]->setText(ad_operation_type_string(type));
+        row[SummaryColumn_Count]->setData(stats.count, Qt::DisplayRole);
+        row[SummaryColumn_Errors]->setData(stats.error_count, Qt::DisplayRole);
+        row[SummaryColumn_Entries]->setData(stats.entries, Qt::DisplayRole);
+        row[SummaryColumn_Bytes]->setData(stats.bytes, Qt::DisplayRole);
+        row[SummaryColumn_Average]->setData(usec_to_msec(stats.total_time / stats.count), Qt::DisplayRole);
+        row[SummaryColumn_P50]->setData(stats.total_histogram.percentile(0.5), Qt::DisplayRole);
+        row[SummaryColumn_P90]->setData(stats.total_histogram.percentile(0.9), Qt::DisplayRole);
+        row[SummaryColumn_P99]->setData(stats.total_histogram.percentile(0.99), Qt::DisplayRole);
+        row[SummaryColumn_Max]->setData(usec_to_msec(stats.max_time), Qt::DisplayRole);
+        row[SummaryColumn_FirstEntryP50]->setData(stats.first_entry_histogram.percentile(0.5), Qt::DisplayRole);
+
+        summary_model->appendRow(row);
+    }
+
+    const QList<AdOperationRecord> record_list = ad_metrics_get_records();
+
+    for (const AdOperationRecord &record : record_list) {
+        const QList<QStandardItem *> row = make_item_row(OperationsColumn_COUNT);
+
+        const bool is_search = (record.type == AdOperationType_Search);
+
+        row[OperationsColumn_Start]->setText(record.start.toString("hh:mm:ss.zzz"));
+        row[OperationsColumn_Type]->setText(ad_operation_type_string(record.type));
+        row[OperationsColumn_Base]->setText(record.base);
+        row[OperationsColumn_Total]->setData(usec_to_msec(record.total_time), Qt::DisplayRole);
+        row[OperationsColumn_Wait]->setData(usec_to_msec(record.wait_time), Qt::DisplayRole);
+        row[OperationsColumn_Result]->setData(record.result, Qt::DisplayRole);
+
+        if (is_search) {
+            row[OperationsColumn_Scope]->setText(search_scope_string(record.scope));
+            row[OperationsColumn_FilterHash]->setText(QString::number(record.filter_hash, 16));
+            row[OperationsColumn_Pages]->setData(record.pages, Qt::DisplayRole);
+            row[OperationsColumn_Entries]->setData(record.entries, Qt::DisplayRole);
+            row[OperationsColumn_Bytes]->setData(record.bytes, Qt::DisplayRole);
+            row[OperationsColumn_Decode]->setData(usec_to_msec(record.decode_time), Qt::DisplayRole);
+
+            if (record.first_entry_time >= 0) {
+                row[OperationsColumn_FirstEntry]->setData(usec_to_msec(record.first_entry_time), Qt::DisplayRole);
+            }
+        }
+
+        operations_model->appendRow(row);
+    }
+
+    // Show newest operations first
+    ui->operations_view->sortByColumn(OperationsColumn_Start, Qt::DescendingOrder);
+}
+
+void DiagnosticsDialog::clear() {
+    ad_metrics_clear();
+
+    load();
+}
+
+void DiagnosticsDialog::save() {
+    const QString file_path = [&]() {
+        const QString caption = tr("Save Diagnostics");
+        const QString suggested_file = QString("%1/admc_diagnostics.json").arg(QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation));
+        const QString filter = tr("JSON (*.json)");
+
+        const QString out = QFileDialog::getSaveFileName(this, caption, suggested_file, filter);
+
+        return out;
+    }();
+
+    if (file_path.isEmpty()) {
+        return;
+    }
+
+    QFile file(file_path);
+    const bool open_success = file.open(QIODevice::WriteOnly);
+    if (!open_success) {
+        message_box_critical(this, tr("Error"), tr("Failed to open file for writing."));
+
+        return;
+    }
+
+    file.write(ad_metrics_to_json());
+}
+
+double usec_to_msec(const qint64 usec) {
+    return qRound64(usec / 100.0) / 10.0;
+}
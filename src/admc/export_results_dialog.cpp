@@ -0,0 +1,219 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "export_results_dialog.h"
+#include "ui_export_results_dialog.h"
+
+#include "adldap.h"
+#include "export_thread.h"
+#include "globals.h"
+#include "settings.h"
+#include "status.h"
+#include "utils.h"
+
+#include <QFileDialog>
+#include <QPushButton>
+#include <QStandardPaths>
+
+ExportResultsDialog::ExportResultsDialog(const QString &base_arg, const SearchScope scope_arg, const QString &filter_arg, const QString &name_arg, QWidget *parent)
+: QDialog(parent) {
+    ui = new Ui::ExportResultsDialog();
+    ui->setupUi(this);
+
+    setAttribute(Qt::WA_DeleteOnClose);
+
+    base = base_arg;
+    scope = scope_arg;
+    filter = filter_arg;
+    name = name_arg;
+    thread = nullptr;
+
+    // NOTE: order must match AdExportFormat
+    ui->format_combo->addItem(tr("CSV"), AdExportFormat_Csv);
+    ui->format_combo->addItem(tr("JSON Lines"), AdExportFormat_JsonLines);
+    ui->format_combo->addItem(tr("LDIF"), AdExportFormat_Ldif);
+
+    ui->values_combo->addItem(tr("Formatted for display"), AdExportValues_Display);
+    ui->values_combo->addItem(tr("Raw"), AdExportValues_Raw);
+
+    // By default export same attributes as displayed in
+    // console columns
+    const QList<QString> default_attributes = g_adconfig->get_columns();
+    ui->attributes_edit->setText(QStringList(default_attributes).join(", "));
+
+    settings_setup_dialog_geometry(SETTING_export_results_dialog_geometry, this);
+
+    connect(
+        ui->export_button, &QPushButton::clicked,
+        this, &ExportResultsDialog::start);
+    connect(
+        ui->stop_button, &QPushButton::clicked,
+        this, &ExportResultsDialog::stop);
+
+    update_buttons();
+}
+
+ExportResultsDialog::~ExportResultsDialog() {
+    // NOTE: thread deletes itself when it finishes, so
+    // only need to tell it to stop
+    stop();
+
+    delete ui;
+}
+
+void ExportResultsDialog::start() {
+    if (thread != nullptr) {
+        return;
+    }
+
+    const QList<QString> attributes = get_attributes();
+    if (attributes.isEmpty()) {
+        message_box_warning(this, tr("Error"), tr("Enter at least one attribute to export."));
+
+        return;
+    }
+
+    const AdExportFormat format = (AdExportFormat) ui->format_combo->currentData().toInt();
+    const AdExportValues values = (AdExportValues) ui->values_combo->currentData().toInt();
+
+    const QString file_path = [&]() {
+        const QString extension = ad_export_format_extension(format);
+        const QString caption = tr("Export Results");
+        const QString suggested_file = QString("%1/%2.%3").arg(QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation), name, extension);
+        const QString file_filter = QString("%1 (*.%2)").arg(ui->format_combo->currentText(), extension);
+
+        const QString out = QFileDialog::getSaveFileName(this, caption, suggested_file, file_filter);
+
+        return out;
+    }();
+
+    if (file_path.isEmpty()) {
+        return;
+    }
+
+    thread = new ExportThread(base, scope, filter, attributes, file_path, format, values);
+
+    ExportThread *this_thread = thread;
+
+    connect(
+        this_thread, &ExportThread::progress,
+        this,
+        [this, this_thread](const int object_count) {
+            if (this_thread != thread) {
+                return;
+            }
+
+            on_progress(object_count);
+        },
+        Qt::QueuedConnection);
+    connect(
+        this_thread, &ExportThread::finished,
+        this,
+        [this, this_thread, file_path]() {
+            if (this_thread != thread) {
+                return;
+            }
+
+            on_thread_finished(file_path);
+        },
+        Qt::QueuedConnection);
+    connect(
+        this_thread, &ExportThread::finished,
+        this_thread, &QObject::deleteLater);
+
+    on_progress(0);
+    update_buttons();
+
+    thread->start();
+}
+
+void ExportResultsDialog::stop() {
+    if (thread == nullptr) {
+        return;
+    }
+
+    // NOTE: thread stops after writing current page. It is
+    // detached from dialog right away so that it's
+    // progress and finish are ignored.
+    thread->stop();
+    thread = nullptr;
+
+    ui->status_label->setText(tr("Export stopped."));
+
+    update_buttons();
+}
+
+void ExportResultsDialog::on_progress(const int object_count) {
+    ui->status_label->setText(tr("Exporting... %1 objects written.").arg(object_count));
+}
+
+void ExportResultsDialog::on_thread_finished(const QString &file_path) {
+    ExportThread *finished_thread = thread;
+    thread = nullptr;
+
+    g_status->display_ad_messages(finished_thread->get_ad_messages(), this);
+
+    if (finished_thread->failed_to_connect()) {
+        error_log({tr("Failed to connect to server while exporting results.")}, this);
+    } else if (finished_thread->failed_to_write()) {
+        error_log({tr("Failed to write exported results to file \"%1\".").arg(file_path)}, this);
+    }
+
+    const QString status_text = [&]() {
+        const int object_count = finished_thread->get_object_count();
+
+        if (finished_thread->is_complete()) {
+            return tr("Exported %1 objects to \"%2\".").arg(object_count).arg(file_path);
+        } else {
+            return tr("Export failed after %1 objects.").arg(object_count);
+        }
+    }();
+
+    ui->status_label->setText(status_text);
+
+    update_buttons();
+}
+
+void ExportResultsDialog::update_buttons() {
+    const bool in_progress = (thread != nullptr);
+
+    ui->export_button->setEnabled(!in_progress);
+    ui->stop_button->setEnabled(in_progress);
+    ui->format_combo->setEnabled(!in_progress);
+    ui->values_combo->setEnabled(!in_progress);
+    ui->attributes_edit->setEnabled(!in_progress);
+}
+
+QList<QString> ExportResultsDialog::get_attributes() const {
+    const QString text = ui->attributes_edit->text();
+    const QList<QString> split = text.split(",");
+
+    QList<QString> out;
+
+    for (const QString &attribute : split) {
+        const QString trimmed = attribute.trimmed();
+
+        if (!trimmed.isEmpty() && !out.contains(trimmed)) {
+            out.append(trimmed);
+        }
+    }
+
+    return out;
+}
@@ -0,0 +1,68 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXPORT_RESULTS_DIALOG_H
+#define EXPORT_RESULTS_DIALOG_H
+
+/**
+ * Exports results of a search to a file in CSV, JSON Lines
+ * or LDIF format. Results are streamed to the file by
+ * ExportThread, they are never loaded into the console, so
+ * this works for result sets that are too large to
+ * display. User selects which attributes to export and
+ * whether values are formatted for display or written as
+ * is.
+ */
+
+#include <QDialog>
+
+#include "ad_defines.h"
+
+class ExportThread;
+
+namespace Ui {
+class ExportResultsDialog;
+}
+
+class ExportResultsDialog final : public QDialog {
+    Q_OBJECT
+
+public:
+    Ui::ExportResultsDialog *ui;
+
+    ExportResultsDialog(const QString &base, const SearchScope scope, const QString &filter, const QString &name, QWidget *parent);
+    ~ExportResultsDialog();
+
+private:
+    QString base;
+    SearchScope scope;
+    QString filter;
+    QString name;
+    ExportThread *thread;
+
+    void start();
+    void stop();
+    void on_progress(const int object_count);
+    void on_thread_finished(const QString &file_path);
+    void update_buttons();
+    QList<QString> get_attributes() const;
+};
+
+#endif /* EXPORT_RESULTS_DIALOG_H */
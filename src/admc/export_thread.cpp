@@ -0,0 +1,109 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "export_thread.h"
+
+#include "adldap.h"
+
+#include <QFile>
+
+ExportThread::ExportThread(const QString &base_arg, const SearchScope scope_arg, const QString &filter_arg, const QList<QString> &attributes_arg, const QString &file_path_arg, const AdExportFormat format_arg, const AdExportValues values_arg) {
+    stop_flag = false;
+    base = base_arg;
+    scope = scope_arg;
+    filter = filter_arg;
+    attributes = attributes_arg;
+    file_path = file_path_arg;
+    format = format_arg;
+    values = values_arg;
+    m_failed_to_connect = false;
+    m_failed_to_write = false;
+    m_is_complete = false;
+    object_count = 0;
+}
+
+void ExportThread::stop() {
+    stop_flag = true;
+}
+
+bool ExportThread::failed_to_connect() const {
+    return m_failed_to_connect;
+}
+
+bool ExportThread::failed_to_write() const {
+    return m_failed_to_write;
+}
+
+bool ExportThread::is_complete() const {
+    return m_is_complete;
+}
+
+int ExportThread::get_object_count() const {
+    return object_count;
+}
+
+QList<AdMessage> ExportThread::get_ad_messages() const {
+    return ad_messages;
+}
+
+void ExportThread::run() {
+    AdInterface ad;
+    if (!ad.is_connected()) {
+        m_failed_to_connect = true;
+
+        return;
+    }
+
+    // NOTE: export goes through every result once, caching
+    // them would only evict objects that console uses
+    ad.set_cache_search_results(false);
+
+    QFile file(file_path);
+    const bool open_success = file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    if (!open_success) {
+        m_failed_to_write = true;
+
+        return;
+    }
+
+    AdExportWriter writer(&file, format, values, attributes, ad.adconfig());
+
+    const bool header_success = writer.write_header();
+    if (!header_success) {
+        m_failed_to_write = true;
+
+        return;
+    }
+
+    const AdExportProgressCallback progress_callback = [this](const int count) {
+        object_count = count;
+
+        emit progress(count);
+    };
+
+    const AdExportResult result = ad_export_search(ad, base, scope, filter, &writer, progress_callback, &stop_flag);
+
+    ad_messages = ad.messages();
+
+    m_failed_to_write = (result == AdExportResult_WriteFailed);
+    m_is_complete = (result == AdExportResult_Complete);
+
+    file.close();
+}
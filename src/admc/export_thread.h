@@ -0,0 +1,82 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXPORT_THREAD_H
+#define EXPORT_THREAD_H
+
+/**
+ * A thread that writes results of a search to a file. Each
+ * page of results is written as soon as it arrives and is
+ * then discarded, so memory use doesn't depend on the
+ * number of results. Results are not limited by object
+ * display limit and are not added to the object cache.
+ * progress() signal is emitted after each page with the
+ * number of objects written so far. Use stop() to stop
+ * export, it stops once current page is written. Note that
+ * creator of thread should call thread's deleteLater() in
+ * the finished() slot.
+ */
+
+#include <QThread>
+
+#include "ad_defines.h"
+#include "ad_export.h"
+
+class AdMessage;
+
+class ExportThread final : public QThread {
+    Q_OBJECT
+
+public:
+    ExportThread(const QString &base, const SearchScope scope, const QString &filter, const QList<QString> &attributes, const QString &file_path, const AdExportFormat format, const AdExportValues values);
+
+    void stop();
+    bool failed_to_connect() const;
+    bool failed_to_write() const;
+
+    // Returns true if all pages were written, which means
+    // export was not stopped and didn't fail
+    bool is_complete() const;
+    int get_object_count() const;
+
+    QList<AdMessage> get_ad_messages() const;
+
+signals:
+    void progress(const int object_count);
+
+private:
+    bool stop_flag;
+    QString base;
+    SearchScope scope;
+    QString filter;
+    QList<QString> attributes;
+    QString file_path;
+    AdExportFormat format;
+    AdExportValues values;
+    bool m_failed_to_connect;
+    bool m_failed_to_write;
+    bool m_is_complete;
+    int object_count;
+    QList<AdMessage> ad_messages;
+
+    void run() override;
+};
+
+#endif /* EXPORT_THREAD_H */
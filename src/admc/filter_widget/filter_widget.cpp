@@ -25,12 +25,39 @@
 #include "filter_widget/filter_widget_normal_tab.h"
 #include "filter_widget/filter_widget_simple_tab.h"
 
+#include "adldap.h"
+#include "globals.h"
+
 #include <QDebug>
 
 FilterWidget::FilterWidget(QWidget *parent)
 : QWidget(parent) {
     ui = new Ui::FilterWidget();
     ui->setupUi(this);
+
+    ui->slow_filter_label->hide();
+
+    const QList<FilterWidgetTab *> tab_list = {
+        ui->simple_tab,
+        ui->normal_tab,
+        ui->advanced_tab,
+    };
+
+    for (FilterWidgetTab *tab : tab_list) {
+        connect(
+            tab, &FilterWidgetTab::changed,
+            this, &FilterWidget::update_slow_filter_label);
+        connect(
+            tab, &FilterWidgetTab::changed,
+            this, &FilterWidget::changed);
+    }
+
+    connect(
+        ui->tab_widget, &QTabWidget::currentChanged,
+        this, &FilterWidget::update_slow_filter_label);
+    connect(
+        ui->tab_widget, &QTabWidget::currentChanged,
+        this, &FilterWidget::changed);
 }
 
 FilterWidget::~FilterWidget() {
@@ -83,3 +110,18 @@ void FilterWidget::clear() {
     ui->normal_tab->clear();
     ui->advanced_tab->clear();
 }
+
+void FilterWidget::update_slow_filter_label() {
+    const QString filter = get_filter();
+    const QList<QString> reason_list = filter_get_slow_reasons(filter, g_adconfig);
+
+    if (reason_list.isEmpty()) {
+        ui->slow_filter_label->hide();
+
+        return;
+    }
+
+    const QString text = tr("Search with this filter may be slow because it can't use server indexes:") + "\n" + reason_list.join("\n");
+    ui->slow_filter_label->setText(text);
+    ui->slow_filter_label->show();
+}
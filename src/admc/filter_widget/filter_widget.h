@@ -24,7 +24,9 @@
 /**
  * Allows user to enter a filter, which is then passed on to
  * a parent widget. Has tabs for different ways to enter a
- * filter: normal and advanced tab.
+ * filter: normal and advanced tab. Warns user if the
+ * filter can't use server indexes, because such searches
+ * can take a long time on large domains.
  */
 
 #include <QWidget>
@@ -54,6 +56,14 @@ public:
     void clear();
 
     void enable_filtering_all_classes();
+
+signals:
+    // Emitted when filter returned by get_filter() might
+    // have changed
+    void changed();
+
+private:
+    void update_slow_filter_label();
 };
 
 class FilterWidgetTab : public QWidget {
@@ -62,6 +72,11 @@ class FilterWidgetTab : public QWidget {
 public:
     virtual QString get_filter() const = 0;
     virtual void clear() = 0;
+
+signals:
+    // Emitted when filter returned by get_filter() might
+    // have changed
+    void changed();
 };
 
 #endif /* FILTER_WIDGET_H */
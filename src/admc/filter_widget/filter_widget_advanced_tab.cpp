@@ -25,6 +25,10 @@ FilterWidgetAdvancedTab::FilterWidgetAdvancedTab()
 : FilterWidgetTab() {
     ui = new Ui::FilterWidgetAdvancedTab();
     ui->setupUi(this);
+
+    connect(
+        ui->ldap_filter_edit, &QPlainTextEdit::textChanged,
+        this, &FilterWidgetTab::changed);
 }
 
 FilterWidgetAdvancedTab::~FilterWidgetAdvancedTab() {
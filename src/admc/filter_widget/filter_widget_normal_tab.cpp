@@ -49,6 +49,20 @@ FilterWidgetNormalTab::FilterWidgetNormalTab()
     connect(
         ui->clear_button, &QAbstractButton::clicked,
         this, &FilterWidgetNormalTab::clear_filters);
+    connect(
+        ui->select_classes_widget, &SelectClassesWidget::changed,
+        this, &FilterWidgetTab::changed);
+
+    QAbstractItemModel *filter_list_model = ui->filter_list->model();
+    connect(
+        filter_list_model, &QAbstractItemModel::rowsInserted,
+        this, &FilterWidgetTab::changed);
+    connect(
+        filter_list_model, &QAbstractItemModel::rowsRemoved,
+        this, &FilterWidgetTab::changed);
+    connect(
+        filter_list_model, &QAbstractItemModel::modelReset,
+        this, &FilterWidgetTab::changed);
 }
 
 FilterWidgetNormalTab::~FilterWidgetNormalTab() {
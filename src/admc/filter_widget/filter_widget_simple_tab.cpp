@@ -27,6 +27,13 @@ FilterWidgetSimpleTab::FilterWidgetSimpleTab()
 : FilterWidgetTab() {
     ui = new Ui::FilterWidgetSimpleTab();
     ui->setupUi(this);
+
+    connect(
+        ui->name_edit, &QLineEdit::textChanged,
+        this, &FilterWidgetTab::changed);
+    connect(
+        ui->select_classes_widget, &SelectClassesWidget::changed,
+        this, &FilterWidgetTab::changed);
 }
 
 FilterWidgetSimpleTab::~FilterWidgetSimpleTab() {
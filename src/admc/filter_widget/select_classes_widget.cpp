@@ -132,4 +132,8 @@ void SelectClassesWidget::update_class_display() {
     // NOTE: set cursor to start because by default,
     // changing text causes line edit to scroll to the end
     ui->classes_display->setCursorPosition(0);
+
+    // NOTE: display is updated every time selection
+    // changes
+    emit changed();
 }
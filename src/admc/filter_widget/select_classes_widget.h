@@ -52,6 +52,9 @@ public:
     QVariant save_state() const;
     void restore_state(const QVariant &state);
 
+signals:
+    void changed();
+
 private:
     QList<QString> class_list;
     QList<QString> m_selected_list;
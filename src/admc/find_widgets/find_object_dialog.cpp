@@ -55,6 +55,7 @@ FindObjectDialog::FindObjectDialog(ConsoleWidget *buddy_console, const QString &
     ui->find_widget->setup_action_menu(action_menu);
     ui->find_widget->setup_view_menu(view_menu);
     ui->find_widget->enable_filtering_all_classes();
+    ui->find_widget->enable_export();
 
     settings_setup_dialog_geometry(SETTING_find_object_dialog_geometry, this);
 
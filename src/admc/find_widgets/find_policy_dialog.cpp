@@ -234,7 +234,7 @@ void FindPolicyDialog::find() {
 
         return out;
     }();
-    const QList<QString> search_attributes = QList<QString>();
+    const QList<QString> search_attributes = console_policy_search_attributes();
 
     auto search_thread = new SearchThread(base, SearchScope_Children, filter, search_attributes);
 
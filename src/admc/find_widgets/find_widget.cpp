@@ -25,6 +25,7 @@
 #include "console_impls/find_object_impl.h"
 #include "console_impls/item_type.h"
 #include "console_impls/object_impl.h"
+#include "export_results_dialog.h"
 #include "globals.h"
 #include "search_thread.h"
 #include "settings.h"
@@ -33,6 +34,16 @@
 
 #include <QMenu>
 #include <QStandardItem>
+#include <QTimer>
+
+// Delay between last filter edit and automatic search, in
+// milliseconds
+#define AUTO_FIND_DELAY 500
+
+// Minimum interval between additions of results to console
+// while search is in progress, in milliseconds. Pages that
+// arrive faster are accumulated and added together.
+#define ADD_RESULTS_INTERVAL 250
 
 FindWidget::FindWidget(QWidget *parent)
 : QWidget(parent) {
@@ -70,6 +81,8 @@ FindWidget::FindWidget(QWidget *parent)
 
     ui->console->set_actions(console_actions);
 
+    last_results_complete = false;
+
     object_impl = new ObjectImpl(ui->console);
     ui->console->register_impl(ItemType_Object, object_impl);
 
@@ -88,25 +101,50 @@ FindWidget::FindWidget(QWidget *parent)
     const QModelIndex head_index = head_item->index();
     ui->console->set_current_scope(head_index);
 
+    find_thread = nullptr;
+    row_loader = nullptr;
+
+    ui->export_button->setVisible(false);
+
+    auto_find_timer = new QTimer(this);
+    auto_find_timer->setSingleShot(true);
+    auto_find_timer->setInterval(AUTO_FIND_DELAY);
+
+    add_results_timer = new QTimer(this);
+    add_results_timer->setSingleShot(true);
+    add_results_timer->setInterval(ADD_RESULTS_INTERVAL);
+
     connect(
         ui->find_button, &QPushButton::clicked,
         this, &FindWidget::find);
     connect(
         ui->clear_button, &QPushButton::clicked,
         this, &FindWidget::on_clear_button);
-
-    // NOTE: need this for the case where dialog is closed
-    // while a search is in progress. Without this busy
-    // indicator stays on.
     connect(
-        this, &QObject::destroyed,
-        this,
-        []() {
-            hide_busy_indicator();
-        });
+        ui->export_button, &QPushButton::clicked,
+        this, &FindWidget::on_export_button);
+    connect(
+        ui->filter_widget, &FilterWidget::changed,
+        auto_find_timer, QOverload<>::of(&QTimer::start));
+    connect(
+        auto_find_timer, &QTimer::timeout,
+        this, &FindWidget::on_auto_find_timer);
+    connect(
+        add_results_timer, &QTimer::timeout,
+        this, &FindWidget::on_add_results_timer);
 }
 
 FindWidget::~FindWidget() {
+    // NOTE: need this for the case where dialog is closed
+    // while a search is in progress. Without this busy
+    // indicator stays on. Thread deletes itself when it
+    // finishes.
+    if (find_thread != nullptr) {
+        find_thread->stop();
+        hide_busy_indicator();
+    }
+
+    delete row_loader;
     delete ui;
 }
 
@@ -118,6 +156,10 @@ void FindWidget::enable_filtering_all_classes() {
     ui->filter_widget->enable_filtering_all_classes();
 }
 
+void FindWidget::enable_export() {
+    ui->export_button->setVisible(true);
+}
+
 void FindWidget::set_default_base(const QString &default_base) {
     ui->select_base_widget->set_default_base(default_base);
 }
@@ -150,62 +192,176 @@ void FindWidget::setup_view_menu(QMenu *menu) {
 }
 
 void FindWidget::clear_results() {
+    add_results_timer->stop();
+    pending_results.clear();
+
     const QModelIndex head_index = head_item->index();
     ui->console->delete_children(head_index);
 }
 
 void FindWidget::find() {
+    auto_find_timer->stop();
+
     // Prepare search args
     const QString filter = ui->filter_widget->get_filter();
     const QString base = ui->select_base_widget->get_base();
     const QList<QString> search_attributes = console_object_search_attributes();
 
-    auto find_thread = new SearchThread(base, SearchScope_All, filter, search_attributes);
+    if (can_refine_last_results(base, filter, search_attributes)) {
+        refine_last_results(filter);
+
+        return;
+    }
+
+    last_results.clear();
+    last_base = base;
+    last_filter = filter;
+    last_results_complete = false;
+
+    // NOTE: new search supersedes the one in progress.
+    // Superseded thread is stopped and it's results are
+    // ignored. Busy indicator stays on until current
+    // search finishes.
+    if (find_thread != nullptr) {
+        find_thread->stop();
+    } else {
+        show_busy_indicator();
+    }
+
+    auto thread = new SearchThread(base, SearchScope_All, filter, search_attributes);
+    find_thread = thread;
 
     connect(
-        find_thread, &SearchThread::results_ready,
-        this, &FindWidget::handle_find_thread_results);
-    connect(
-        this, &QObject::destroyed,
-        find_thread, &SearchThread::stop);
+        thread, &SearchThread::results_ready,
+        this,
+        [this, thread](const QHash<QString, AdObject> &results) {
+            if (thread != find_thread) {
+                return;
+            }
+
+            for (const AdObject &object : results) {
+                last_results.insert(object.get_dn(), object);
+            }
+
+            add_results_throttled(results);
+        });
     connect(
         ui->stop_button, &QPushButton::clicked,
-        find_thread, &SearchThread::stop);
+        thread, &SearchThread::stop);
     connect(
-        find_thread, &SearchThread::finished,
+        thread, &SearchThread::finished,
         this,
-        [this, find_thread]() {
-            g_status->display_ad_messages(find_thread->get_ad_messages(), this);
-            search_thread_display_errors(find_thread, this);
+        [this, thread]() {
+            if (thread != find_thread) {
+                return;
+            }
 
-            ui->find_button->setEnabled(true);
-            ui->clear_button->setEnabled(true);
+            find_thread = nullptr;
 
-            hide_busy_indicator();
+            flush_pending_results();
 
-            find_thread->deleteLater();
-        });
+            g_status->display_ad_messages(thread->get_ad_messages(), this);
+            search_thread_display_errors(thread, this);
 
-    show_busy_indicator();
+            last_results_complete = thread->is_complete();
+            if (!last_results_complete) {
+                last_results.clear();
+            }
 
-    // NOTE: disable find and clear buttons, do not want
-    // those functions to be available while a search is in
-    // progress
-    ui->find_button->setEnabled(false);
-    ui->clear_button->setEnabled(false);
+            hide_busy_indicator();
+        });
+
+    // NOTE: not deleting thread in the slot above because
+    // widget may be destroyed before thread finishes
+    connect(
+        thread, &SearchThread::finished,
+        thread, &QObject::deleteLater);
 
     clear_results();
+    reset_row_loader();
+
+    thread->start();
+}
+
+// Updates results automatically after user stops editing
+// the filter. Only done once user has searched explicitly,
+// so that opening the dialog doesn't start a search. Also
+// only done for filters that can use server indexes, slow
+// filters need an explicit "Find".
+void FindWidget::on_auto_find_timer() {
+    const QString filter = ui->filter_widget->get_filter();
+    const QString base = ui->select_base_widget->get_base();
+
+    const bool searched_before = !last_filter.isEmpty();
+    const bool filter_is_same = (filter == last_filter && base == last_base);
+    if (!searched_before || filter.isEmpty() || filter_is_same) {
+        return;
+    }
 
-    find_thread->start();
+    FilterNode filter_node;
+    const bool parse_success = filter_parse(filter, &filter_node);
+    if (!parse_success) {
+        return;
+    }
+
+    const QList<QString> slow_reasons = filter_get_slow_reasons(filter, g_adconfig);
+    if (!slow_reasons.isEmpty()) {
+        return;
+    }
+
+    find();
 }
 
-void FindWidget::handle_find_thread_results(const QHash<QString, AdObject> &results) {
+void FindWidget::add_results(const QHash<QString, AdObject> &results) {
     const QModelIndex head_index = head_item->index();
 
+    QList<QList<QStandardItem *>> row_list;
+
+    for (const AdObject &object : results) {
+        const QList<QStandardItem *> row = ui->console->make_results_row(ItemType_Object, head_index);
+
+        row_loader->load(row, object);
+
+        row_list.append(row);
+    }
+
+    ui->console->add_rows(head_index, row_list);
+}
+
+// Adds results while search is in progress. Adding results
+// to console is expensive for big pages, so if pages arrive
+// too often, they are accumulated and added once per
+// interval.
+void FindWidget::add_results_throttled(const QHash<QString, AdObject> &results) {
     for (const AdObject &object : results) {
-        const QList<QStandardItem *> row = ui->console->add_results_item(ItemType_Object, head_index);
+        pending_results.insert(object.get_dn(), object);
+    }
+
+    if (!add_results_timer->isActive()) {
+        flush_pending_results();
+
+        add_results_timer->start();
+    }
+}
+
+void FindWidget::flush_pending_results() {
+    add_results_timer->stop();
 
-        console_object_load(row, object);
+    if (pending_results.isEmpty()) {
+        return;
+    }
+
+    add_results(pending_results);
+    pending_results.clear();
+}
+
+void FindWidget::on_add_results_timer() {
+    // NOTE: restart timer only if something was added, so
+    // that next page after a pause is added immediately
+    if (!pending_results.isEmpty()) {
+        flush_pending_results();
+
+        add_results_timer->start();
     }
 }
 
@@ -216,7 +372,70 @@ QList<QString> FindWidget::get_selected_dns() const {
     return out;
 }
 
+bool FindWidget::can_refine_last_results(const QString &base, const QString &filter, const QList<QString> &search_attributes) const {
+    if (!last_results_complete || base != last_base) {
+        return false;
+    }
+
+    // NOTE: searching again with same filter is how user
+    // refreshes results, so that always goes to server
+    if (filter == last_filter) {
+        return false;
+    }
+
+    if (!filter_is_narrowing(filter, last_filter)) {
+        return false;
+    }
+
+    FilterNode filter_node;
+    const bool parse_success = filter_parse(filter, &filter_node);
+    if (!parse_success) {
+        return false;
+    }
+
+    const bool out = filter_can_match_locally(filter_node, search_attributes, g_adconfig);
+
+    return out;
+}
+
+// Objects matching the new filter are a subset of last
+// results, so there's no need to ask the server
+void FindWidget::refine_last_results(const QString &filter) {
+    FilterNode filter_node;
+    filter_parse(filter, &filter_node);
+
+    QHash<QString, AdObject> results;
+    for (const AdObject &object : last_results) {
+        if (filter_match(filter_node, object, g_adconfig)) {
+            results.insert(object.get_dn(), object);
+        }
+    }
+
+    clear_results();
+    reset_row_loader();
+    add_results(results);
+}
+
+void FindWidget::reset_row_loader() {
+    delete row_loader;
+    row_loader = new ObjectRowLoader();
+}
+
 void FindWidget::on_clear_button() {
     ui->filter_widget->clear();
+    auto_find_timer->stop();
     clear_results();
 }
+
+// NOTE: export does it's own search instead of using
+// displayed results, so that it isn't limited by object
+// display limit and doesn't need to load all results into
+// the console
+void FindWidget::on_export_button() {
+    const QString filter = ui->filter_widget->get_filter();
+    const QString base = ui->select_base_widget->get_base();
+    const QString name = tr("Find results");
+
+    auto dialog = new ExportResultsDialog(base, SearchScope_All, filter, name, this);
+    dialog->open();
+}
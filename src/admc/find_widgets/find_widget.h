@@ -25,8 +25,13 @@
  * Provides a way for user to find objects. FilterWidget is
  * used for filter input and FindResults for displaying
  * objects. Used by FindObjectDialog and SelectObjectDialog.
+ * Search is started by "Find" button. After that, results
+ * are also updated automatically when user stops editing
+ * a filter that can use server indexes. New search
+ * supersedes search in progress.
  */
 
+#include <QHash>
 #include <QWidget>
 
 class QStandardItem;
@@ -34,6 +39,9 @@ class AdObject;
 class QMenu;
 class ObjectImpl;
 class ConsoleWidget;
+class SearchThread;
+class ObjectRowLoader;
+class QTimer;
 
 namespace Ui {
 class FindWidget;
@@ -66,9 +74,12 @@ public:
 
     void enable_filtering_all_classes();
 
+    // Shows "Export" button which writes all objects
+    // matching current filter to a file. Hidden by default.
+    void enable_export();
+
 private slots:
     void find();
-    void handle_find_thread_results(const QHash<QString, AdObject> &results);
 
 private:
     ObjectImpl *object_impl;
@@ -80,8 +91,37 @@ private:
     QAction *action_customize_columns;
     QAction *action_toggle_description_bar;
 
+    // Results of last search done on the server. If next
+    // filter is narrower, results are refined locally
+    // instead of searching again.
+    QHash<QString, AdObject> last_results;
+    QString last_base;
+    QString last_filter;
+    bool last_results_complete;
+
+    SearchThread *find_thread;
+    QTimer *auto_find_timer;
+
+    // Results received from search thread which are not
+    // yet added to console
+    QHash<QString, AdObject> pending_results;
+    QTimer *add_results_timer;
+
+    // Created at the start of each find and reused for
+    // all pages of it's results
+    ObjectRowLoader *row_loader;
+
     void on_clear_button();
+    void on_export_button();
     void clear_results();
+    void reset_row_loader();
+    void add_results(const QHash<QString, AdObject> &results);
+    void add_results_throttled(const QHash<QString, AdObject> &results);
+    void flush_pending_results();
+    void on_add_results_timer();
+    bool can_refine_last_results(const QString &base, const QString &filter, const QList<QString> &search_attributes) const;
+    void refine_last_results(const QString &filter);
+    void on_auto_find_timer();
 };
 
 #endif /* FIND_WIDGET_H */
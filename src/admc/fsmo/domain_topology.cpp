@@ -0,0 +1,281 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fsmo/domain_topology.h"
+
+#include "adldap.h"
+#include "status.h"
+#include "globals.h"
+
+DomainTopology::DomainTopology() {
+    is_valid = false;
+    for (int role_i = 0; role_i < FSMORole_COUNT; role_i++) {
+        role_master_list.append(QString());
+    }
+    domain_functionality_level = 0;
+    forest_functionality_level = 0;
+    schema_version = 0;
+}
+
+QList<FSMORole> DomainTopology::get_roles(const QString &dns_host_name) const {
+    QList<FSMORole> out;
+
+    for (int role_i = 0; role_i < FSMORole_COUNT; role_i++) {
+        const QString master = role_master_list[role_i];
+
+        if (!master.isEmpty() && master.compare(dns_host_name, Qt::CaseInsensitive) == 0) {
+            out.append((FSMORole) role_i);
+        }
+    }
+
+    return out;
+}
+
+QList<DomainTopologyServer> DomainTopology::get_site_servers(const QString &site_dn) const {
+    QList<DomainTopologyServer> out;
+
+    for (const DomainTopologyServer &server : server_list) {
+        if (server.site_dn.compare(site_dn, Qt::CaseInsensitive) == 0) {
+            out.append(server);
+        }
+    }
+
+    return out;
+}
+
+DomainTopology domain_topology_load(AdInterface &ad) {
+    DomainTopology out;
+
+    const AdObject rootDSE = ad.search_object("", {
+        ATTRIBUTE_DOMAIN_FUNCTIONALITY_LEVEL,
+        ATTRIBUTE_FOREST_FUNCTIONALITY_LEVEL,
+        ATTRIBUTE_SCHEMA_NAMING_CONTEXT,
+        ATTRIBUTE_DNS_HOST_NAME,
+        ATTRIBUTE_SERVER_NAME,
+    });
+
+    if (rootDSE.is_empty()) {
+        return out;
+    }
+
+    out.domain_functionality_level = rootDSE.get_int(ATTRIBUTE_DOMAIN_FUNCTIONALITY_LEVEL);
+    out.forest_functionality_level = rootDSE.get_int(ATTRIBUTE_FOREST_FUNCTIONALITY_LEVEL);
+    out.dc_dns_host_name = rootDSE.get_string(ATTRIBUTE_DNS_HOST_NAME);
+    out.dc_server_dn = rootDSE.get_string(ATTRIBUTE_SERVER_NAME);
+
+    // Load sites, servers and NTDS settings in one search
+    const QString sites_dn = "CN=Sites," + ad.adconfig()->configuration_dn();
+    const QString filter = filter_OR({
+        filter_CONDITION(Condition_Equals, ATTRIBUTE_OBJECT_CLASS, CLASS_SITE),
+        filter_CONDITION(Condition_Equals, ATTRIBUTE_OBJECT_CLASS, CLASS_SERVER),
+        filter_CONDITION(Condition_Equals, ATTRIBUTE_OBJECT_CLASS, CLASS_NTDS_DSA),
+    });
+    const QList<QString> attributes = {
+        ATTRIBUTE_OBJECT_CLASS,
+        ATTRIBUTE_NAME,
+        ATTRIBUTE_DNS_HOST_NAME,
+        ATTRIBUTE_SERVER_REFERENCE,
+    };
+    const QHash<QString, AdObject> results = ad.search(sites_dn, SearchScope_All, filter, attributes);
+
+    // NOTE: keys are lowercase because DN's in different
+    // attributes can differ in case
+    QHash<QString, QString> ntds_settings_map;
+    for (const AdObject &object : results) {
+        if (object.get_strings(ATTRIBUTE_OBJECT_CLASS).contains(CLASS_NTDS_DSA)) {
+            const QString server_dn = dn_get_parent(object.get_dn());
+            ntds_settings_map[server_dn.toLower()] = object.get_dn();
+        }
+    }
+
+    for (const AdObject &object : results) {
+        const QList<QString> object_classes = object.get_strings(ATTRIBUTE_OBJECT_CLASS);
+
+        if (object_classes.contains(CLASS_SITE)) {
+            DomainTopologySite site;
+            site.dn = object.get_dn();
+            site.name = object.get_string(ATTRIBUTE_NAME);
+
+            out.site_list.append(site);
+        } else if (object_classes.contains(CLASS_SERVER)) {
+            // NOTE: servers are located in
+            // "CN=Servers,CN=<site>"
+            DomainTopologyServer server;
+            server.dn = object.get_dn();
+            server.name = object.get_string(ATTRIBUTE_NAME);
+            server.dns_host_name = object.get_string(ATTRIBUTE_DNS_HOST_NAME);
+            server.site_dn = dn_get_parent(dn_get_parent(server.dn));
+            server.server_reference = object.get_string(ATTRIBUTE_SERVER_REFERENCE);
+            server.ntds_settings_dn = ntds_settings_map.value(server.dn.toLower());
+
+            out.server_list.append(server);
+        }
+    }
+
+    auto find_server = [&](const QString &server_dn) -> const DomainTopologyServer * {
+        for (const DomainTopologyServer &server : out.server_list) {
+            if (server.dn.compare(server_dn, Qt::CaseInsensitive) == 0) {
+                return &server;
+            }
+        }
+
+        return nullptr;
+    };
+
+    // Load role owners. Owner is the NTDS settings object
+    // of the master, which is resolved to it's server using
+    // topology loaded above.
+    for (int role_i = 0; role_i < FSMORole_COUNT; role_i++) {
+        const FSMORole role = (FSMORole) role_i;
+        const QString role_dn = dn_from_role(role);
+        const AdObject role_object = ad.search_object(role_dn, {ATTRIBUTE_FSMO_ROLE_OWNER});
+        const QString owner_dn = role_object.get_string(ATTRIBUTE_FSMO_ROLE_OWNER);
+
+        if (owner_dn.isEmpty()) {
+            continue;
+        }
+
+        const QString master_dn = dn_get_parent(owner_dn);
+        const DomainTopologyServer *master = find_server(master_dn);
+
+        const QString master_host = [&]() {
+            if (master != nullptr) {
+                return master->dns_host_name;
+            } else {
+                // NOTE: fall back to searching for the
+                // server if it wasn't found in the sites
+                // container for some reason
+                const AdObject master_object = ad.search_object(master_dn, {ATTRIBUTE_DNS_HOST_NAME});
+
+                return master_object.get_string(ATTRIBUTE_DNS_HOST_NAME);
+            }
+        }();
+
+        out.role_master_list[role_i] = master_host;
+    }
+
+    const QString schema_dn = rootDSE.get_string(ATTRIBUTE_SCHEMA_NAMING_CONTEXT);
+    const AdObject schema_object = ad.search_object(schema_dn, {ATTRIBUTE_OBJECT_VERSION});
+    out.schema_version = schema_object.get_int(ATTRIBUTE_OBJECT_VERSION);
+
+    const DomainTopologyServer *dc_server = find_server(out.dc_server_dn);
+    if (dc_server != nullptr && !dc_server->server_reference.isEmpty()) {
+        const AdObject host = ad.search_object(dc_server->server_reference, {ATTRIBUTE_OS, ATTRIBUTE_OS_VERSION});
+        out.dc_os = host.get_string(ATTRIBUTE_OS);
+        out.dc_os_version = host.get_string(ATTRIBUTE_OS_VERSION);
+    }
+
+    out.is_valid = true;
+
+    return out;
+}
+
+DomainTopologyThread::DomainTopologyThread() {
+}
+
+DomainTopology DomainTopologyThread::get_topology() const {
+    return topology;
+}
+
+QList<AdMessage> DomainTopologyThread::get_ad_messages() const {
+    return ad_messages;
+}
+
+void DomainTopologyThread::run() {
+    AdInterface ad;
+    if (ad.is_connected()) {
+        topology = domain_topology_load(ad);
+    }
+
+    ad_messages = ad.messages();
+}
+
+DomainTopologyService::DomainTopologyService() {
+    m_is_loaded = false;
+    thread = nullptr;
+    refresh_pending = false;
+}
+
+bool DomainTopologyService::is_loaded() const {
+    return m_is_loaded;
+}
+
+DomainTopology DomainTopologyService::get() const {
+    return topology;
+}
+
+DomainTopology DomainTopologyService::get_or_load(AdInterface &ad) {
+    if (!m_is_loaded) {
+        set_topology(domain_topology_load(ad));
+
+        emit loaded();
+    }
+
+    return topology;
+}
+
+void DomainTopologyService::refresh() {
+    if (thread != nullptr) {
+        refresh_pending = true;
+
+        return;
+    }
+
+    thread = new DomainTopologyThread();
+
+    connect(
+        thread, &DomainTopologyThread::finished,
+        this, &DomainTopologyService::on_thread_finished,
+        Qt::QueuedConnection);
+
+    thread->start();
+}
+
+void DomainTopologyService::set_role_master(const FSMORole role, const QString &dns_host_name) {
+    topology.role_master_list[role] = dns_host_name;
+}
+
+void DomainTopologyService::on_thread_finished() {
+    set_topology(thread->get_topology());
+
+    g_status->log_messages(thread->get_ad_messages());
+
+    thread->deleteLater();
+    thread = nullptr;
+
+    emit loaded();
+
+    if (refresh_pending) {
+        refresh_pending = false;
+
+        refresh();
+    }
+}
+
+// NOTE: failed load doesn't replace cached topology. If
+// nothing was loaded yet, next get_or_load() tries again.
+void DomainTopologyService::set_topology(const DomainTopology &new_topology) {
+    if (!new_topology.is_valid) {
+        return;
+    }
+
+    topology = new_topology;
+    m_is_loaded = true;
+}
@@ -0,0 +1,146 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DOMAIN_TOPOLOGY_H
+#define DOMAIN_TOPOLOGY_H
+
+/**
+ * Sites, domain controllers and FSMO role masters of the
+ * domain. Loading topology takes a fixed number of
+ * searches regardless of how many sites there are. Sites,
+ * servers and their NTDS settings are found by one subtree
+ * search of the sites container and role owners are
+ * resolved through the result. DomainTopologyService loads
+ * topology in background and caches it until it's
+ * refreshed, so that domain info and FSMO dialog share it.
+ */
+
+#include "fsmo/fsmo_utils.h"
+
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QThread>
+
+class AdInterface;
+class AdMessage;
+
+class DomainTopologySite {
+public:
+    QString dn;
+    QString name;
+};
+
+class DomainTopologyServer {
+public:
+    QString dn;
+    QString name;
+    QString dns_host_name;
+    QString site_dn;
+    QString server_reference;
+    // Empty if server is not a domain controller
+    QString ntds_settings_dn;
+};
+
+class DomainTopology {
+public:
+    DomainTopology();
+
+    bool is_valid;
+
+    QList<DomainTopologySite> site_list;
+    QList<DomainTopologyServer> server_list;
+
+    // DNS host name of master of each role, indexed by
+    // FSMORole
+    QList<QString> role_master_list;
+
+    // Domain controller that topology was loaded from
+    QString dc_dns_host_name;
+    QString dc_server_dn;
+    QString dc_os;
+    QString dc_os_version;
+
+    int domain_functionality_level;
+    int forest_functionality_level;
+    int schema_version;
+
+    QList<FSMORole> get_roles(const QString &dns_host_name) const;
+    QList<DomainTopologyServer> get_site_servers(const QString &site_dn) const;
+};
+
+DomainTopology domain_topology_load(AdInterface &ad);
+
+class DomainTopologyThread final : public QThread {
+    Q_OBJECT
+
+public:
+    DomainTopologyThread();
+
+    DomainTopology get_topology() const;
+    QList<AdMessage> get_ad_messages() const;
+
+private:
+    DomainTopology topology;
+    QList<AdMessage> ad_messages;
+
+    void run() override;
+};
+
+class DomainTopologyService final : public QObject {
+    Q_OBJECT
+
+public:
+    DomainTopologyService();
+
+    bool is_loaded() const;
+
+    // Returns cached topology, which is invalid if it
+    // wasn't loaded yet
+    DomainTopology get() const;
+
+    // Same as get() but loads topology using given
+    // interface if it wasn't loaded yet or if previous
+    // loads failed
+    DomainTopology get_or_load(AdInterface &ad);
+
+    // Reloads topology in background and emits loaded()
+    // when it's done. If called while a reload is in
+    // progress, another reload is performed after current
+    // one finishes.
+    void refresh();
+
+    // Updates cached master after role was transferred
+    void set_role_master(const FSMORole role, const QString &dns_host_name);
+
+signals:
+    void loaded();
+
+private:
+    DomainTopology topology;
+    bool m_is_loaded;
+    DomainTopologyThread *thread;
+    bool refresh_pending;
+
+    void on_thread_finished();
+    void set_topology(const DomainTopology &new_topology);
+};
+
+#endif /* DOMAIN_TOPOLOGY_H */
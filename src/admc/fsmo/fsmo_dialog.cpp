@@ -22,6 +22,7 @@
 #include "ui_fsmo_dialog.h"
 
 #include "adldap.h"
+#include "fsmo/domain_topology.h"
 #include "fsmo/fsmo_tab.h"
 #include "fsmo/fsmo_utils.h"
 #include "globals.h"
@@ -37,6 +38,10 @@ FSMODialog::FSMODialog(AdInterface &ad, QWidget *parent)
 
     setAttribute(Qt::WA_DeleteOnClose);
 
+    // NOTE: topology is usually already loaded by domain
+    // info
+    const DomainTopology topology = g_domain_topology->get_or_load(ad);
+
     for (int role_i = 0; role_i < FSMORole_COUNT; role_i++) {
         const FSMORole role = (FSMORole) role_i;
 
@@ -56,11 +61,9 @@ FSMODialog::FSMODialog(AdInterface &ad, QWidget *parent)
             return QString();
         }();
 
-        const QString role_dn = dn_from_role(role);
-
-        auto tab = new FSMOTab(title, role_dn);
+        auto tab = new FSMOTab(title, role);
         ui->tab_widget->add_tab(tab, title);
-        tab->load(ad);
+        tab->load(topology);
         connect(tab, &FSMOTab::master_changed, this, &FSMODialog::master_changed);
     }
 
@@ -25,16 +25,18 @@
 #include "globals.h"
 #include "status.h"
 #include "utils.h"
+#include "fsmo/domain_topology.h"
 #include "fsmo/fsmo_utils.h"
 
 
-FSMOTab::FSMOTab(const QString &title, const QString &role_dn_arg) {
+FSMOTab::FSMOTab(const QString &title, const FSMORole role_arg) {
     ui = new Ui::FSMOTab();
     ui->setupUi(this);
 
     ui->title_label->setText(title);
 
-    role_dn = role_dn_arg;
+    role = role_arg;
+    role_dn = dn_from_role(role);
 
     connect(
         ui->change_button, &QPushButton::clicked,
@@ -45,10 +47,10 @@ FSMOTab::~FSMOTab() {
     delete ui;
 }
 
-void FSMOTab::load(AdInterface &ad) {
-    const QString current_master = current_master_for_role_dn(ad, role_dn);
+void FSMOTab::load(const DomainTopology &topology) {
+    const QString current_master = topology.role_master_list[role];
 
-    const QString new_master = current_dc_dns_host_name(ad);
+    const QString new_master = topology.dc_dns_host_name;
 
     ui->current_edit->setText(current_master);
     ui->new_edit->setText(new_master);
@@ -76,7 +78,8 @@ void FSMOTab::change_master() {
     g_status->display_ad_messages(ad, this);
 
     if (success) {
-        load(ad);
+        g_domain_topology->set_role_master(role, new_master);
+        load(g_domain_topology->get());
         const QString new_master_dn = rootDSE.get_string(ATTRIBUTE_SERVER_NAME);
         emit master_changed(new_master_dn, fsmo_string_from_dn(role_dn));
     }
@@ -21,9 +21,11 @@
 #ifndef FSMO_TAB_H
 #define FSMO_TAB_H
 
+#include "fsmo/fsmo_utils.h"
+
 #include <QWidget>
 
-class AdInterface;
+class DomainTopology;
 
 namespace Ui {
 class FSMOTab;
@@ -35,12 +37,13 @@ class FSMOTab final : public QWidget {
 public:
     Ui::FSMOTab *ui;
 
-    FSMOTab(const QString &title, const QString &role_dn);
+    FSMOTab(const QString &title, const FSMORole role);
     ~FSMOTab();
 
-    void load(AdInterface &ad);
+    void load(const DomainTopology &topology);
 
 private:
+    FSMORole role;
     QString role_dn;
 
     void change_master();
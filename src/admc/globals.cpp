@@ -24,6 +24,7 @@
 #include "settings.h"
 #include "status.h"
 #include "icon_manager/icon_manager.h"
+#include "fsmo/domain_topology.h"
 
 #include <QLocale>
 
@@ -31,6 +32,7 @@
 AdConfig *g_adconfig = new AdConfig();
 Status *g_status = new Status();
 IconManager *g_icon_manager = new IconManager();
+DomainTopologyService *g_domain_topology = nullptr;
 
 void load_g_adconfig(AdInterface &ad) {
     const QLocale locale = settings_get_variant(SETTING_locale).toLocale();
@@ -25,12 +25,17 @@ class AdConfig;
 class AdInterface;
 class Status;
 class IconManager;
+class DomainTopologyService;
 
 extern AdConfig *g_adconfig;
 extern Status *g_status;
 
 extern IconManager *g_icon_manager;
 
+// NOTE: this is a QObject, so it is created in main()
+// after QApplication
+extern DomainTopologyService *g_domain_topology;
+
 void load_g_adconfig(AdInterface &ad);
 
 #endif /* GLOBALS_H */
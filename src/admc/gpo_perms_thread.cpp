@@ -0,0 +1,111 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gpo_perms_thread.h"
+
+#include "adldap.h"
+
+#include <QMutexLocker>
+
+GpoPermsResult::GpoPermsResult() {
+    failed_to_connect = false;
+    perms_ok = true;
+    check_ok = false;
+}
+
+GpoPermsThread::GpoPermsThread(QObject *parent)
+: QThread(parent) {
+    quit_flag = false;
+}
+
+GpoPermsThread::~GpoPermsThread() {
+    {
+        QMutexLocker locker(&mutex);
+        quit_flag = true;
+        condition.wakeAll();
+    }
+
+    wait();
+}
+
+void GpoPermsThread::check(const QString &gpo) {
+    {
+        QMutexLocker locker(&mutex);
+        pending_gpo = gpo;
+        condition.wakeAll();
+    }
+
+    if (!isRunning()) {
+        start();
+    }
+}
+
+void GpoPermsThread::run() {
+    while (true) {
+        // Wait for next request. Empty gpo means that
+        // thread should quit.
+        const QString gpo = [&]() {
+            QMutexLocker locker(&mutex);
+
+            while (pending_gpo.isEmpty() && !quit_flag) {
+                condition.wait(&mutex);
+            }
+
+            if (quit_flag) {
+                return QString();
+            }
+
+            const QString out = pending_gpo;
+            pending_gpo.clear();
+
+            return out;
+        }();
+
+        if (gpo.isEmpty()) {
+            return;
+        }
+
+        GpoPermsResult result;
+        result.gpo = gpo;
+
+        AdInterface ad;
+        if (ad.is_connected()) {
+            bool ok = true;
+            result.perms_ok = ad.gpo_check_perms(gpo, &ok);
+            result.check_ok = ok;
+            result.ad_messages = ad.messages();
+        } else {
+            result.failed_to_connect = true;
+        }
+
+        // NOTE: don't report result if another check was
+        // requested while this one was running, because
+        // the result is outdated
+        const bool result_is_outdated = [&]() {
+            QMutexLocker locker(&mutex);
+
+            return (!pending_gpo.isEmpty() || quit_flag);
+        }();
+
+        if (!result_is_outdated) {
+            emit check_finished(result);
+        }
+    }
+}
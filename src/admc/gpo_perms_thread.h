@@ -0,0 +1,80 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GPO_PERMS_THREAD_H
+#define GPO_PERMS_THREAD_H
+
+/**
+ * A thread that checks whether permissions of a GPO's GPT
+ * match permissions of it's GPC. The check reads GPT
+ * security descriptor over SMB, which can take a while, so
+ * it shouldn't be done in GUI thread. The thread lives as
+ * long as it's owner and runs checks requested through
+ * check() one at a time, so the SMB context setup for the
+ * first check is reused by all later checks. Requesting a
+ * check while another one is running replaces the request
+ * that is waiting, if there is one, and discards the
+ * result of the running check. Running check can't be
+ * interrupted, so destructor waits for it to finish.
+ */
+
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+class AdMessage;
+
+class GpoPermsResult {
+public:
+    GpoPermsResult();
+
+    QString gpo;
+    bool failed_to_connect;
+
+    // Result of the check. Only valid if check_ok is
+    // true.
+    bool perms_ok;
+    bool check_ok;
+
+    QList<AdMessage> ad_messages;
+};
+
+class GpoPermsThread final : public QThread {
+    Q_OBJECT
+
+public:
+    GpoPermsThread(QObject *parent);
+    ~GpoPermsThread();
+
+    void check(const QString &gpo);
+
+signals:
+    void check_finished(const GpoPermsResult &result);
+
+private:
+    QMutex mutex;
+    QWaitCondition condition;
+    QString pending_gpo;
+    bool quit_flag;
+
+    void run() override;
+};
+
+#endif /* GPO_PERMS_THREAD_H */
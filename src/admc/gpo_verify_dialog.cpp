@@ -0,0 +1,301 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gpo_verify_dialog.h"
+#include "ui_gpo_verify_dialog.h"
+
+#include "adldap.h"
+#include "gpo_verify_thread.h"
+#include "settings.h"
+#include "status.h"
+#include "utils.h"
+
+#include <QColor>
+#include <QSortFilterProxyModel>
+#include <QStandardItemModel>
+
+enum GpoVerifyColumn {
+    GpoVerifyColumn_Name,
+    GpoVerifyColumn_Status,
+    GpoVerifyColumn_GpcVersion,
+    GpoVerifyColumn_GptVersion,
+    GpoVerifyColumn_Details,
+
+    GpoVerifyColumn_COUNT,
+};
+
+enum GpoVerifyRole {
+    GpoVerifyRole_IsProblem = Qt::UserRole + 1,
+};
+
+QString gpo_verify_result_status(const GpoVerifyResult &result);
+QString gpo_verify_result_details(const GpoVerifyResult &result);
+
+GpoVerifyDialog::GpoVerifyDialog(QWidget *parent)
+: QDialog(parent) {
+    ui = new Ui::GpoVerifyDialog();
+    ui->setupUi(this);
+
+    setAttribute(Qt::WA_DeleteOnClose);
+
+    thread = nullptr;
+    checked_count = 0;
+    problem_count = 0;
+
+    model = new QStandardItemModel(0, GpoVerifyColumn_COUNT, this);
+    set_horizontal_header_labels_from_map(model,
+        {
+            {GpoVerifyColumn_Name, tr("Name")},
+            {GpoVerifyColumn_Status, tr("Status")},
+            {GpoVerifyColumn_GpcVersion, tr("GPC version")},
+            {GpoVerifyColumn_GptVersion, tr("GPT version")},
+            {GpoVerifyColumn_Details, tr("Details")},
+        });
+
+    proxy_model = new QSortFilterProxyModel(this);
+    proxy_model->setSourceModel(model);
+    proxy_model->setFilterKeyColumn(GpoVerifyColumn_Name);
+    proxy_model->setFilterRole(GpoVerifyRole_IsProblem);
+
+    ui->results_view->setModel(proxy_model);
+    ui->results_view->sortByColumn(GpoVerifyColumn_Status, Qt::AscendingOrder);
+
+    settings_setup_dialog_geometry(SETTING_gpo_verify_dialog_geometry, this);
+
+    connect(
+        ui->stop_button, &QPushButton::clicked,
+        this, &GpoVerifyDialog::stop);
+    connect(
+        ui->restart_button, &QPushButton::clicked,
+        this, &GpoVerifyDialog::start);
+    connect(
+        ui->only_problems_check, &QCheckBox::toggled,
+        this, &GpoVerifyDialog::on_only_problems_toggled);
+
+    start();
+}
+
+GpoVerifyDialog::~GpoVerifyDialog() {
+    // NOTE: thread deletes itself when it finishes, so
+    // only need to tell it to stop
+    stop();
+
+    delete ui;
+}
+
+void GpoVerifyDialog::start() {
+    if (thread != nullptr) {
+        return;
+    }
+
+    model->removeRows(0, model->rowCount());
+    checked_count = 0;
+    problem_count = 0;
+
+    thread = new GpoVerifyThread();
+
+    GpoVerifyThread *this_thread = thread;
+
+    connect(
+        this_thread, &GpoVerifyThread::results_ready,
+        this,
+        [this, this_thread](const QList<GpoVerifyResult> &results) {
+            if (this_thread != thread) {
+                return;
+            }
+
+            add_results(results);
+        },
+        Qt::QueuedConnection);
+    connect(
+        this_thread, &GpoVerifyThread::finished,
+        this,
+        [this, this_thread]() {
+            if (this_thread != thread) {
+                return;
+            }
+
+            on_thread_finished();
+        },
+        Qt::QueuedConnection);
+    connect(
+        this_thread, &GpoVerifyThread::finished,
+        this_thread, &QObject::deleteLater);
+
+    ui->stop_button->setEnabled(true);
+    ui->restart_button->setEnabled(false);
+
+    update_status();
+
+    thread->start();
+}
+
+void GpoVerifyDialog::stop() {
+    if (thread == nullptr) {
+        return;
+    }
+
+    // NOTE: thread stops after finishing current batch. It
+    // is detached from dialog right away so that it's
+    // results and finish are ignored.
+    thread->stop();
+    thread = nullptr;
+
+    ui->stop_button->setEnabled(false);
+    ui->restart_button->setEnabled(true);
+
+    update_status();
+}
+
+void GpoVerifyDialog::add_results(const QList<GpoVerifyResult> &results) {
+    // NOTE: disable sorting while adding a batch, otherwise
+    // proxy resorts on every appended row
+    proxy_model->setDynamicSortFilter(false);
+
+    for (const GpoVerifyResult &result : results) {
+        const QList<QStandardItem *> row = make_item_row(GpoVerifyColumn_COUNT);
+
+        const bool is_problem = !result.is_ok();
+
+        const QString name = [&]() {
+            if (result.orphaned) {
+                return result.gpt_path;
+            } else if (!result.name.isEmpty()) {
+                return result.name;
+            } else {
+                return result.dn;
+            }
+        }();
+
+        row[GpoVerifyColumn_Name]->setText(name);
+        row[GpoVerifyColumn_Name]->setToolTip(result.gpt_path);
+        row[GpoVerifyColumn_Name]->setData(is_problem, GpoVerifyRole_IsProblem);
+        row[GpoVerifyColumn_Status]->setText(gpo_verify_result_status(result));
+        row[GpoVerifyColumn_Details]->setText(gpo_verify_result_details(result));
+
+        if (result.version_checked) {
+            row[GpoVerifyColumn_GpcVersion]->setData(result.gpc_version, Qt::DisplayRole);
+            row[GpoVerifyColumn_GptVersion]->setData(result.gpt_version, Qt::DisplayRole);
+        }
+
+        if (is_problem) {
+            for (QStandardItem *item : row) {
+                item->setData(QColor(Qt::red), Qt::ForegroundRole);
+            }
+
+            problem_count++;
+        }
+
+        model->appendRow(row);
+    }
+
+    checked_count += results.size();
+
+    proxy_model->setDynamicSortFilter(true);
+    proxy_model->invalidate();
+
+    update_status();
+}
+
+void GpoVerifyDialog::on_thread_finished() {
+    GpoVerifyThread *finished_thread = thread;
+    thread = nullptr;
+
+    if (finished_thread->failed_to_connect()) {
+        g_status->add_message(tr("Failed to connect to server while verifying policies."), StatusType_Error);
+    }
+
+    g_status->display_ad_messages(finished_thread->get_ad_messages(), this);
+
+    ui->stop_button->setEnabled(false);
+    ui->restart_button->setEnabled(true);
+
+    update_status();
+}
+
+void GpoVerifyDialog::on_only_problems_toggled() {
+    const bool only_problems = ui->only_problems_check->isChecked();
+
+    if (only_problems) {
+        proxy_model->setFilterFixedString(QVariant(true).toString());
+    } else {
+        proxy_model->setFilterFixedString(QString());
+    }
+}
+
+void GpoVerifyDialog::update_status() {
+    const QString counts = tr("Checked %1 policies, found %2 problems.").arg(checked_count).arg(problem_count);
+
+    const QString text = [&]() {
+        if (thread != nullptr) {
+            return tr("Verifying...") + " " + counts;
+        } else {
+            return counts;
+        }
+    }();
+
+    ui->status_label->setText(text);
+}
+
+QString gpo_verify_result_status(const GpoVerifyResult &result) {
+    if (result.is_ok()) {
+        return QObject::tr("OK");
+    }
+
+    QList<QString> problem_list;
+
+    if (result.orphaned) {
+        problem_list.append(QObject::tr("GPT has no GPC"));
+    } else if (!result.gpt_exists) {
+        problem_list.append(QObject::tr("GPT is missing"));
+    }
+
+    if (result.version_checked && result.gpc_version != result.gpt_version) {
+        problem_list.append(QObject::tr("Version mismatch"));
+    }
+
+    if (result.perms_checked && !result.perms_match) {
+        problem_list.append(QObject::tr("Permissions mismatch"));
+    }
+
+    if (!result.error.isEmpty()) {
+        problem_list.append(QObject::tr("Check failed"));
+    }
+
+    return QStringList(problem_list).join(", ");
+}
+
+QString gpo_verify_result_details(const GpoVerifyResult &result) {
+    QList<QString> detail_list;
+
+    if (!result.error.isEmpty()) {
+        detail_list.append(result.error);
+    }
+
+    if (!result.missing_aces.isEmpty()) {
+        detail_list.append(QObject::tr("Missing in GPT: %1").arg(QStringList(result.missing_aces).join(" ")));
+    }
+
+    if (!result.extra_aces.isEmpty()) {
+        detail_list.append(QObject::tr("Extra in GPT: %1").arg(QStringList(result.extra_aces).join(" ")));
+    }
+
+    return QStringList(detail_list).join("; ");
+}
@@ -0,0 +1,67 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GPO_VERIFY_DIALOG_H
+#define GPO_VERIFY_DIALOG_H
+
+/**
+ * Verifies all policies in the domain in the background
+ * and shows results as they arrive. Checks that GPT exists,
+ * that GPT version matches GPC version, that GPT
+ * permissions match GPC permissions and finds GPT folders
+ * which have no GPC.
+ */
+
+#include <QDialog>
+
+class QStandardItemModel;
+class QSortFilterProxyModel;
+class GpoVerifyResult;
+class GpoVerifyThread;
+
+namespace Ui {
+class GpoVerifyDialog;
+}
+
+class GpoVerifyDialog final : public QDialog {
+    Q_OBJECT
+
+public:
+    Ui::GpoVerifyDialog *ui;
+
+    GpoVerifyDialog(QWidget *parent);
+    ~GpoVerifyDialog();
+
+private:
+    QStandardItemModel *model;
+    QSortFilterProxyModel *proxy_model;
+    GpoVerifyThread *thread;
+    int checked_count;
+    int problem_count;
+
+    void start();
+    void stop();
+    void add_results(const QList<GpoVerifyResult> &results);
+    void on_thread_finished();
+    void on_only_problems_toggled();
+    void update_status();
+};
+
+#endif /* GPO_VERIFY_DIALOG_H */
@@ -0,0 +1,57 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gpo_verify_thread.h"
+
+#include "adldap.h"
+
+GpoVerifyThread::GpoVerifyThread() {
+    stop_flag = false;
+    m_failed_to_connect = false;
+}
+
+void GpoVerifyThread::stop() {
+    stop_flag = true;
+}
+
+bool GpoVerifyThread::failed_to_connect() const {
+    return m_failed_to_connect;
+}
+
+QList<AdMessage> GpoVerifyThread::get_ad_messages() const {
+    return ad_messages;
+}
+
+void GpoVerifyThread::run() {
+    AdInterface ad;
+    if (!ad.is_connected()) {
+        m_failed_to_connect = true;
+
+        return;
+    }
+
+    const GpoVerifyCallback callback = [this](const QList<GpoVerifyResult> &results) {
+        emit results_ready(results);
+    };
+
+    ad.gpo_verify_all(callback, &stop_flag);
+
+    ad_messages = ad.messages();
+}
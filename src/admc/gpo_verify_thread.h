@@ -0,0 +1,60 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GPO_VERIFY_THREAD_H
+#define GPO_VERIFY_THREAD_H
+
+/**
+ * A thread that verifies consistency of all GPO's in the
+ * domain. results_ready() signal is emitted multiple times
+ * with batches of results as they become available. Use
+ * stop() to stop verification, it stops once current batch
+ * is done. Note that creator of thread should call thread's
+ * deleteLater() in the finished() slot.
+ */
+
+#include <QThread>
+
+class AdMessage;
+class GpoVerifyResult;
+
+class GpoVerifyThread final : public QThread {
+    Q_OBJECT
+
+public:
+    GpoVerifyThread();
+
+    void stop();
+    bool failed_to_connect() const;
+
+    QList<AdMessage> get_ad_messages() const;
+
+signals:
+    void results_ready(const QList<GpoVerifyResult> &results);
+
+private:
+    bool stop_flag;
+    bool m_failed_to_connect;
+    QList<AdMessage> ad_messages;
+
+    void run() override;
+};
+
+#endif /* GPO_VERIFY_THREAD_H */
@@ -144,11 +144,9 @@ void IconManager::update_action_icons() {
 
 void IconManager::update_icons_array() {
     type_index_icons_array[ItemIconType_Policy_Clean] = get_object_icon(OBJECT_CATEGORY_GP_CONTAINER);
-    type_index_icons_array[ItemIconType_Policy_Link] = overlay_scope_item_icon(type_index_icons_array[ItemIconType_Policy_Clean], get_indicator_icon(link_indicator),
-                                                                  QSize(16, 16), QSize(12, 12), QPoint(-2, 6));
+    type_index_icons_array[ItemIconType_Policy_Link] = get_object_icon(OBJECT_CATEGORY_GP_CONTAINER, IconOverlay_Link);
     type_index_icons_array[ItemIconType_Policy_Link_Disabled] = type_index_icons_array[ItemIconType_Policy_Link].pixmap(16, 16, QIcon::Disabled);
-    type_index_icons_array[ItemIconType_Policy_Enforced] = overlay_scope_item_icon(type_index_icons_array[ItemIconType_Policy_Link], get_indicator_icon(enforced_indicator),
-                                                                                   QSize(16, 16), QSize(8, 8), QPoint(8, 8));
+    type_index_icons_array[ItemIconType_Policy_Enforced] = get_object_icon(OBJECT_CATEGORY_GP_CONTAINER, IconOverlay_Enforced);
     type_index_icons_array[ItemIconType_Policy_Enforced_Disabled] = type_index_icons_array[ItemIconType_Policy_Enforced].pixmap(16, 16, QIcon::Disabled);
     type_index_icons_array[ItemIconType_OU_Clean] = get_object_icon(OBJECT_CATEGORY_OU);
     type_index_icons_array[ItemIconType_OU_InheritanceBlocked] = overlay_scope_item_icon(type_index_icons_array[ItemIconType_OU_Clean], get_indicator_icon(inheritance_indicator),
@@ -158,16 +156,10 @@ void IconManager::update_icons_array() {
                                                                                 get_indicator_icon(inheritance_indicator),
                                                                                 QSize(16, 16), QSize(10, 10), QPoint(6, 6));
     type_index_icons_array[ItemIconType_Person_Clean] = get_object_icon(OBJECT_CATEGORY_PERSON).pixmap(max_icon_size);
-    type_index_icons_array[ItemIconType_Person_Blocked] = overlay_scope_item_icon(type_index_icons_array[ItemIconType_Person_Clean],
-                                                                                  get_indicator_icon(block_indicator), max_icon_size,
-                                                                                  QSize(max_icon_size.width()/2, max_icon_size.height()/2),
-                                                                                  QPoint(max_icon_size.width()/2, max_icon_size.width()/2));
+    type_index_icons_array[ItemIconType_Person_Blocked] = get_object_icon(OBJECT_CATEGORY_PERSON, IconOverlay_Blocked);
     type_index_icons_array[ItemIconType_Site_Clean] = get_object_icon(OBJECT_CATEGORY_SITE);
     type_index_icons_array[ItemIconType_Computer_Clean] = get_object_icon(OBJECT_CATEGORY_COMPUTER).pixmap(max_icon_size);
-    type_index_icons_array[ItemIconType_Computer_Blocked] = overlay_scope_item_icon(type_index_icons_array[ItemIconType_Computer_Clean],
-                                                                                    get_indicator_icon(block_indicator), max_icon_size,
-                                                                                    QSize(max_icon_size.width()/2, max_icon_size.height()/2),
-                                                                                    QPoint(max_icon_size.width()/2, max_icon_size.width()/2));
+    type_index_icons_array[ItemIconType_Computer_Blocked] = get_object_icon(OBJECT_CATEGORY_COMPUTER, IconOverlay_Blocked);
     type_index_icons_array[ItemIconType_Group_Clean] = get_object_icon(OBJECT_CATEGORY_GROUP).pixmap(max_icon_size);
 }
 
@@ -193,6 +185,36 @@ QIcon IconManager::get_object_icon(const AdObject &object) const
 
 QIcon IconManager::get_object_icon(const QString &object_category) const
 {
+    return get_object_icon(object_category, IconOverlay_None);
+}
+
+QIcon IconManager::get_object_icon(const QString &object_category, const IconOverlay overlay) const {
+    QHash<QString, QIcon> &cache = object_icon_cache[overlay];
+
+    auto it = cache.constFind(object_category);
+    if (it != cache.constEnd()) {
+        return it.value();
+    }
+
+    const QIcon icon = render_object_icon(object_category, overlay);
+    cache.insert(object_category, icon);
+
+    return icon;
+}
+
+QIcon IconManager::get_indicator_icon(const QString &indicator_icon_name) const {
+    auto it = indicator_icon_cache.constFind(indicator_icon_name);
+    if (it != indicator_icon_cache.constEnd()) {
+        return it.value();
+    }
+
+    const QIcon icon = find_indicator_icon(indicator_icon_name);
+    indicator_icon_cache.insert(indicator_icon_name, icon);
+
+    return icon;
+}
+
+QIcon IconManager::find_object_icon(const QString &object_category) const {
     const QString icon_name = [&]() -> QString {
         const QList<QString> fallback_icon_list = {
             fallback_icon_name,
@@ -218,7 +240,7 @@ QIcon IconManager::get_object_icon(const QString &object_category) const
     return icon;
 }
 
-QIcon IconManager::get_indicator_icon(const QString &indicator_icon_name) const {
+QIcon IconManager::find_indicator_icon(const QString &indicator_icon_name) const {
     if (indicator_icon_name.isEmpty()) {
         return QIcon::fromTheme(error_icon);
     }
@@ -239,6 +261,42 @@ QIcon IconManager::get_indicator_icon(const QString &indicator_icon_name) const
     return icon;
 }
 
+QIcon IconManager::render_object_icon(const QString &object_category, const IconOverlay overlay) const {
+    switch (overlay) {
+        case IconOverlay_None: return find_object_icon(object_category);
+        case IconOverlay_Blocked: {
+            const QIcon clean_icon = get_object_icon(object_category).pixmap(max_icon_size);
+            const QSize overlay_size = QSize(max_icon_size.width() / 2, max_icon_size.height() / 2);
+            const QPoint overlay_pos = QPoint(max_icon_size.width() / 2, max_icon_size.width() / 2);
+
+            return overlay_scope_item_icon(clean_icon, get_indicator_icon(block_indicator), max_icon_size, overlay_size, overlay_pos);
+        }
+        case IconOverlay_Link: {
+            const QIcon clean_icon = get_object_icon(object_category);
+
+            return overlay_scope_item_icon(clean_icon, get_indicator_icon(link_indicator), QSize(16, 16), QSize(12, 12), QPoint(-2, 6));
+        }
+        case IconOverlay_Enforced: {
+            // NOTE: enforced indicator is drawn on top of
+            // link variant
+            const QIcon link_icon = get_object_icon(object_category, IconOverlay_Link);
+
+            return overlay_scope_item_icon(link_icon, get_indicator_icon(enforced_indicator), QSize(16, 16), QSize(8, 8), QPoint(8, 8));
+        }
+        case IconOverlay_LAST: break;
+    }
+
+    return find_object_icon(object_category);
+}
+
+void IconManager::clear_icon_cache() {
+    for (int i = 0; i < IconOverlay_LAST; i++) {
+        object_icon_cache[i].clear();
+    }
+
+    indicator_icon_cache.clear();
+}
+
 void IconManager::set_theme(const QString &icons_theme) {
     if (theme == icons_theme && !icons_theme.isEmpty()) {
         return;
@@ -248,6 +306,7 @@ void IconManager::set_theme(const QString &icons_theme) {
 
     QIcon::setThemeName(icons_theme);
     settings_set_variant(SETTING_current_icon_theme, icons_theme);
+    clear_icon_cache();
     update_action_icons();
     update_icons_array();
 }
@@ -5,6 +5,7 @@
 
 #include <QObject>
 #include <QIcon>
+#include <QHash>
 #include <QMap>
 #include <QSize>
 #include <QLocale>
@@ -33,6 +34,17 @@ enum ItemIconType {
     ItemIconType_LAST
 };
 
+// Variants of object icons that are rendered once per
+// category and theme, then reused for all items
+enum IconOverlay {
+    IconOverlay_None,
+    IconOverlay_Blocked,
+    IconOverlay_Link,
+    IconOverlay_Enforced,
+
+    IconOverlay_LAST
+};
+
 class AdObject;
 class QAction;
 template <typename T, typename U>
@@ -57,6 +69,7 @@ public:
     const QIcon& get_icon_for_type(ItemIconType icon_type) const;
     QIcon get_object_icon(const AdObject &object) const;
     QIcon get_object_icon(const QString& object_category) const;
+    QIcon get_object_icon(const QString &object_category, const IconOverlay overlay) const;
     QIcon get_indicator_icon(const QString &indicator_icon_name) const;
     void set_theme(const QString &icons_theme);
 
@@ -74,6 +87,13 @@ private:
     QMap<QString, QList<QString>> indicator_map;
     QMap<QString, QAction*> category_action_map;
 
+    // NOTE: theme lookups are expensive, so resolved
+    // icons are cached by category and indicator name.
+    // Caches are only valid for current theme and are
+    // cleared when theme changes.
+    mutable QHash<QString, QIcon> object_icon_cache[IconOverlay_LAST];
+    mutable QHash<QString, QIcon> indicator_icon_cache;
+
     QString error_icon;
     const QString fallback_icon_name = "fallback";
 
@@ -97,6 +117,10 @@ private:
                                          IconOverlayPosition position = IconOverlayPosition_BottomRight) const;
     QIcon overlay_scope_item_icon(const QIcon &clean_icon, const QIcon &overlay_icon, const QSize &clean_icon_size,
                                          const QSize &overlay_icon_size, const QPoint &pos) const;
+    QIcon find_object_icon(const QString &object_category) const;
+    QIcon find_indicator_icon(const QString &indicator_icon_name) const;
+    QIcon render_object_icon(const QString &object_category, const IconOverlay overlay) const;
+    void clear_icon_cache();
     void update_icons_array();
     void update_action_icons();
 };
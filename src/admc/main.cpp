@@ -22,6 +22,7 @@
 #include "config.h"
 #include "connection_options_dialog.h"
 #include "globals.h"
+#include "gpo_perms_thread.h"
 #include "main_window.h"
 #include "main_window_connection_error.h"
 #include "settings.h"
@@ -30,6 +31,7 @@
 #include "connection_options_dialog.h"
 #include "locale.h"
 #include "icon_manager/icon_manager.h"
+#include "fsmo/domain_topology.h"
 
 #include <QApplication>
 #include <QDebug>
@@ -45,6 +47,12 @@ int main(int argc, char **argv) {
     // error.
     qRegisterMetaType<QHash<QString, AdObject>>("QHash<QString, AdObject>");
 
+    // NOTE: same for results of gpo_verify_thread.cpp
+    qRegisterMetaType<QList<GpoVerifyResult>>("QList<GpoVerifyResult>");
+
+    // NOTE: same for results of gpo_perms_thread.cpp
+    qRegisterMetaType<GpoPermsResult>("GpoPermsResult");
+
     QApplication app(argc, argv);
     app.setApplicationDisplayName(ADMC_APPLICATION_DISPLAY_NAME);
     app.setApplicationName(ADMC_APPLICATION_NAME);
@@ -53,6 +61,8 @@ int main(int argc, char **argv) {
     app.setOrganizationDomain(ADMC_ORGANIZATION_DOMAIN);
     app.setWindowIcon(QIcon(":/admc/admc.ico"));
 
+    g_domain_topology = new DomainTopologyService();
+
     const QLocale saved_locale = settings_get_variant(SETTING_locale).toLocale();
     const QString locale_dot_UTF8 = saved_locale.name() + ".UTF-8";
     const char* locale_for_c = std::setlocale(LC_ALL, locale_dot_UTF8.toLocal8Bit().data());
@@ -36,9 +36,11 @@
 #include "console_impls/query_folder_impl.h"
 #include "console_impls/query_item_impl.h"
 #include "console_widget/console_widget.h"
+#include "diagnostics_dialog.h"
 #include "fsmo/fsmo_dialog.h"
 #include "globals.h"
 #include "main_window_connection_error.h"
+#include "message_log_widget.h"
 #include "settings.h"
 #include "status.h"
 #include "utils.h"
@@ -57,7 +59,7 @@ MainWindow::MainWindow(AdInterface &ad, QWidget *parent)
 
     country_combo_load_data();
 
-    g_status->init(ui->statusbar, ui->message_log_edit);
+    g_status->init(ui->statusbar, ui->message_log_widget->get_model());
 
     const QMap<QString, QAction*> category_action_map = {
         {OBJECT_CATEGORY_OU, ui->action_create_ou},
@@ -293,6 +295,9 @@ MainWindow::MainWindow(AdInterface &ad, QWidget *parent)
     connect(
         ui->action_about, &QAction::triggered,
         this, &MainWindow::open_about);
+    connect(
+        ui->action_diagnostics, &QAction::triggered,
+        this, &MainWindow::open_diagnostics);
     connect(
         ui->action_filter_objects, &QAction::triggered,
         object_impl, &ObjectImpl::open_console_filter_dialog);
@@ -368,6 +373,9 @@ MainWindow::MainWindow(AdInterface &ad, QWidget *parent)
         ui->action_show_login, &QAction::triggered,
         this, &MainWindow::on_show_login_changed);
     on_show_login_changed();
+    connect(
+        ui->action_timestamps, &QAction::toggled,
+        ui->message_log_widget, &MessageLogWidget::set_show_timestamps);
 
     if (!current_dc_is_master_for_role(ad, FSMORole_PDCEmulation)) {
             g_status->add_message(tr("You are connected to DC without PDC-Emulator role"), StatusType_Success);
@@ -428,6 +436,11 @@ void MainWindow::open_about() {
     about_dialog->open();
 }
 
+void MainWindow::open_diagnostics() {
+    auto diagnostics_dialog = new DiagnosticsDialog(this);
+    diagnostics_dialog->open();
+}
+
 void MainWindow::edit_fsmo_roles() {
     AdInterface ad;
     if (ad_failed(ad, this)) {
@@ -51,6 +51,7 @@ private:
     void open_connection_options();
     void open_changelog();
     void open_about();
+    void open_diagnostics();
     void edit_fsmo_roles();
     void reload_console_tree();
 };
@@ -0,0 +1,179 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "message_log_model.h"
+
+#include <QColor>
+#include <QTimer>
+
+// Interval at which pending messages are inserted into the
+// model, in milliseconds. Roughly one frame.
+#define FLUSH_INTERVAL 16
+
+MessageLogModel::MessageLogModel(const int capacity, QObject *parent)
+: QAbstractListModel(parent) {
+    ring.resize(qMax(1, capacity));
+    ring_start = 0;
+    ring_size = 0;
+    show_timestamps = true;
+
+    flush_timer = new QTimer(this);
+    flush_timer->setSingleShot(true);
+    flush_timer->setInterval(FLUSH_INTERVAL);
+
+    connect(
+        flush_timer, &QTimer::timeout,
+        this, &MessageLogModel::flush);
+}
+
+void MessageLogModel::add_message(const QString &text, const StatusType type) {
+    MessageLogRecord record;
+    record.time = QDateTime::currentDateTime();
+    record.text = text;
+    record.type = type;
+
+    pending.append(record);
+
+    // NOTE: messages which would be dropped on flush
+    // anyway are dropped right away, so that pending list
+    // doesn't grow past capacity
+    if (pending.size() > capacity()) {
+        pending.removeFirst();
+    }
+
+    if (!flush_timer->isActive()) {
+        flush_timer->start();
+    }
+}
+
+void MessageLogModel::flush() {
+    flush_timer->stop();
+
+    if (pending.isEmpty()) {
+        return;
+    }
+
+    const int add_count = pending.size();
+
+    // Drop oldest records to make room for new ones
+    const int drop_count = qMax(0, ring_size + add_count - capacity());
+    if (drop_count > 0) {
+        beginRemoveRows(QModelIndex(), 0, drop_count - 1);
+        ring_start = (ring_start + drop_count) % capacity();
+        ring_size -= drop_count;
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), ring_size, ring_size + add_count - 1);
+    for (const MessageLogRecord &record : pending) {
+        const int ring_index = (ring_start + ring_size) % capacity();
+        ring[ring_index] = record;
+        ring_size++;
+    }
+    endInsertRows();
+
+    pending.clear();
+
+    emit flushed();
+}
+
+void MessageLogModel::clear() {
+    flush_timer->stop();
+    pending.clear();
+
+    beginResetModel();
+    ring_start = 0;
+    ring_size = 0;
+    endResetModel();
+}
+
+void MessageLogModel::set_show_timestamps(const bool show) {
+    if (show_timestamps == show) {
+        return;
+    }
+
+    show_timestamps = show;
+
+    if (ring_size > 0) {
+        emit dataChanged(index(0, 0), index(ring_size - 1, 0), {Qt::DisplayRole});
+    }
+}
+
+int MessageLogModel::capacity() const {
+    return ring.size();
+}
+
+int MessageLogModel::pending_count() const {
+    return pending.size();
+}
+
+MessageLogRecord MessageLogModel::get_record(const int row) const {
+    return record_at(row);
+}
+
+int MessageLogModel::rowCount(const QModelIndex &parent) const {
+    if (parent.isValid()) {
+        return 0;
+    }
+
+    return ring_size;
+}
+
+QVariant MessageLogModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= ring_size) {
+        return QVariant();
+    }
+
+    const MessageLogRecord &record = record_at(index.row());
+
+    switch (role) {
+        case Qt::DisplayRole: {
+            if (show_timestamps) {
+                const QString timestamp = record.time.toString("hh:mm:ss");
+
+                return QString("%1 %2").arg(timestamp, record.text);
+            } else {
+                return record.text;
+            }
+        }
+        case Qt::ToolTipRole: {
+            return record.time.toString(Qt::ISODate);
+        }
+        case Qt::ForegroundRole: {
+            switch (record.type) {
+                case StatusType_Success: return QColor(Qt::darkGreen);
+                case StatusType_Error: return QColor(Qt::red);
+            }
+
+            return QVariant();
+        }
+        case MessageLogRole_Type: {
+            return (int) record.type;
+        }
+    }
+
+    return QVariant();
+}
+
+const MessageLogRecord &MessageLogModel::record_at(const int row) const {
+    const int ring_index = (ring_start + row) % capacity();
+
+    return ring[ring_index];
+}
@@ -0,0 +1,90 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MESSAGE_LOG_MODEL_H
+#define MESSAGE_LOG_MODEL_H
+
+/**
+ * Model for the message log. Stores a fixed number of
+ * most recent messages in a ring buffer, oldest messages
+ * are dropped once capacity is reached. Added messages are
+ * first collected into a pending list and then inserted
+ * into the model together, once per frame, so adding a
+ * message is cheap even if thousands of them are added at
+ * once.
+ */
+
+#include <QAbstractListModel>
+#include <QDateTime>
+#include <QList>
+#include <QVector>
+
+#include "status.h"
+
+class QTimer;
+
+enum MessageLogRole {
+    MessageLogRole_Type = Qt::UserRole + 1,
+};
+
+class MessageLogRecord {
+public:
+    QDateTime time;
+    QString text;
+    StatusType type;
+};
+
+class MessageLogModel final : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    MessageLogModel(const int capacity, QObject *parent);
+
+    // Adds message to pending list. Pending messages are
+    // inserted into the model by flush(), which is called
+    // automatically by a timer.
+    void add_message(const QString &text, const StatusType type);
+    void flush();
+    void clear();
+
+    void set_show_timestamps(const bool show);
+
+    int capacity() const;
+    int pending_count() const;
+    MessageLogRecord get_record(const int row) const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+signals:
+    void flushed();
+
+private:
+    QVector<MessageLogRecord> ring;
+    int ring_start;
+    int ring_size;
+    QList<MessageLogRecord> pending;
+    QTimer *flush_timer;
+    bool show_timestamps;
+
+    const MessageLogRecord &record_at(const int row) const;
+};
+
+#endif /* MESSAGE_LOG_MODEL_H */
@@ -0,0 +1,93 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "message_log_widget.h"
+#include "ui_message_log_widget.h"
+
+#include "message_log_model.h"
+#include "settings.h"
+
+#include <QSortFilterProxyModel>
+
+// NOTE: log is displayed by a list view which only renders
+// visible rows, so capacity can be much bigger than when
+// it was a text edit
+#define MAX_MESSAGES_IN_LOG 1000
+
+// NOTE: -1 type means all types
+#define TYPE_ALL -1
+
+MessageLogWidget::MessageLogWidget(QWidget *parent)
+: QWidget(parent) {
+    ui = new Ui::MessageLogWidget();
+    ui->setupUi(this);
+
+    model = new MessageLogModel(MAX_MESSAGES_IN_LOG, this);
+
+    const bool show_timestamps = settings_get_variant(SETTING_timestamp_log).toBool();
+    model->set_show_timestamps(show_timestamps);
+
+    proxy_model = new QSortFilterProxyModel(this);
+    proxy_model->setSourceModel(model);
+    proxy_model->setFilterRole(MessageLogRole_Type);
+
+    ui->view->setModel(proxy_model);
+
+    ui->type_combo->addItem(tr("All messages"), TYPE_ALL);
+    ui->type_combo->addItem(tr("Errors"), StatusType_Error);
+    ui->type_combo->addItem(tr("Successes"), StatusType_Success);
+
+    connect(
+        ui->type_combo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+        this, &MessageLogWidget::on_type_combo_changed);
+    connect(
+        ui->clear_button, &QPushButton::clicked,
+        model, &MessageLogModel::clear);
+    connect(
+        model, &MessageLogModel::flushed,
+        this, &MessageLogWidget::on_model_flushed);
+}
+
+MessageLogWidget::~MessageLogWidget() {
+    delete ui;
+}
+
+MessageLogModel *MessageLogWidget::get_model() const {
+    return model;
+}
+
+void MessageLogWidget::set_show_timestamps(const bool show) {
+    model->set_show_timestamps(show);
+}
+
+void MessageLogWidget::on_type_combo_changed() {
+    const int type = ui->type_combo->currentData().toInt();
+
+    if (type == TYPE_ALL) {
+        proxy_model->setFilterFixedString(QString());
+    } else {
+        proxy_model->setFilterFixedString(QString::number(type));
+    }
+}
+
+void MessageLogWidget::on_model_flushed() {
+    // Move to newest message
+    ui->view->scrollToBottom();
+}
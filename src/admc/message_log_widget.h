@@ -0,0 +1,60 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MESSAGE_LOG_WIDGET_H
+#define MESSAGE_LOG_WIDGET_H
+
+/**
+ * Displays messages from message log model in a list view
+ * which can be filtered by message type. View scrolls to
+ * newest message when new messages are added.
+ */
+
+#include <QWidget>
+
+class MessageLogModel;
+class QSortFilterProxyModel;
+
+namespace Ui {
+class MessageLogWidget;
+}
+
+class MessageLogWidget final : public QWidget {
+    Q_OBJECT
+
+public:
+    Ui::MessageLogWidget *ui;
+
+    MessageLogWidget(QWidget *parent);
+    ~MessageLogWidget();
+
+    MessageLogModel *get_model() const;
+
+    void set_show_timestamps(const bool show);
+
+private:
+    MessageLogModel *model;
+    QSortFilterProxyModel *proxy_model;
+
+    void on_type_combo_changed();
+    void on_model_flushed();
+};
+
+#endif /* MESSAGE_LOG_WIDGET_H */
@@ -0,0 +1,188 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "multi_modify_thread.h"
+
+#include "adldap.h"
+
+#include <QAtomicInt>
+
+// Max number of connections used at the same time
+#define CONNECTION_COUNT 4
+
+// Interval at which progress is reported, in milliseconds
+#define PROGRESS_INTERVAL 100
+
+// Worker which modifies targets using it's own connection.
+// Workers take next target index from a shared counter
+// until all targets are processed.
+class MultiModifyWorker final : public QThread {
+public:
+    const QList<QString> *target_list;
+    const QList<AttributeEditModFunction> *function_list;
+    const QList<QString> *attribute_list;
+    const bool *stop_flag;
+    QAtomicInt *next_index;
+    QAtomicInt *done_count;
+
+    bool failed_to_connect;
+    QList<QString> failures;
+    QList<AdMessage> ad_messages;
+
+    void run() override;
+};
+
+MultiModifyThread::MultiModifyThread(const QList<QString> &target_list_arg, const QList<AttributeEditModFunction> &function_list_arg, const QList<QString> &attribute_list_arg) {
+    target_list = target_list_arg;
+    function_list = function_list_arg;
+    attribute_list = attribute_list_arg;
+    stop_flag = false;
+    m_failed_to_connect = false;
+}
+
+void MultiModifyThread::stop() {
+    stop_flag = true;
+}
+
+bool MultiModifyThread::is_stopped() const {
+    return stop_flag;
+}
+
+bool MultiModifyThread::failed_to_connect() const {
+    return m_failed_to_connect;
+}
+
+QList<QString> MultiModifyThread::get_failures() const {
+    return failures;
+}
+
+QList<AdMessage> MultiModifyThread::get_ad_messages() const {
+    return ad_messages;
+}
+
+void MultiModifyThread::run() {
+    QAtomicInt next_index(0);
+    QAtomicInt done_count(0);
+
+    const int worker_count = qMin(CONNECTION_COUNT, target_list.size());
+
+    QList<MultiModifyWorker *> worker_list;
+    for (int i = 0; i < worker_count; i++) {
+        auto worker = new MultiModifyWorker();
+        worker->target_list = &target_list;
+        worker->function_list = &function_list;
+        worker->attribute_list = &attribute_list;
+        worker->stop_flag = &stop_flag;
+        worker->next_index = &next_index;
+        worker->done_count = &done_count;
+        worker->failed_to_connect = false;
+
+        worker_list.append(worker);
+        worker->start();
+    }
+
+    int reported_count = 0;
+    auto report_progress = [&]() {
+        const int current_count = done_count.load();
+
+        if (current_count != reported_count) {
+            reported_count = current_count;
+
+            emit progress(current_count);
+        }
+    };
+
+    for (MultiModifyWorker *worker : worker_list) {
+        while (!worker->wait(PROGRESS_INTERVAL)) {
+            report_progress();
+        }
+    }
+
+    report_progress();
+
+    // NOTE: if some workers failed to connect, their share
+    // of targets was processed by other workers, so only
+    // a failure if all of them failed
+    m_failed_to_connect = !worker_list.isEmpty();
+
+    for (MultiModifyWorker *worker : worker_list) {
+        m_failed_to_connect = (m_failed_to_connect && worker->failed_to_connect);
+        failures.append(worker->failures);
+        ad_messages.append(worker->ad_messages);
+
+        delete worker;
+    }
+}
+
+void MultiModifyWorker::run() {
+    AdInterface ad;
+    if (!ad.is_connected()) {
+        failed_to_connect = true;
+
+        return;
+    }
+
+    while (!*stop_flag) {
+        const int index = next_index->fetchAndAddOrdered(1);
+        if (index >= target_list->size()) {
+            break;
+        }
+
+        const QString &target = target_list->at(index);
+
+        const AdObject object = [&]() {
+            if (attribute_list->isEmpty()) {
+                return AdObject();
+            } else {
+                return ad.search_object(target, *attribute_list);
+            }
+        }();
+
+        if (!attribute_list->isEmpty() && object.is_empty()) {
+            const QString name = dn_get_name(target);
+            failures.append(QString(QObject::tr("Failed to load object %1.")).arg(name));
+        } else {
+            QList<AdBackendMod> mod_list;
+            for (const AttributeEditModFunction &function : *function_list) {
+                function(object, &mod_list);
+            }
+
+            const bool success = ad.attribute_modify(target, mod_list);
+
+            if (!success) {
+                const QList<AdMessage> message_list = ad.messages();
+
+                const QString failure = [&]() {
+                    if (!message_list.isEmpty()) {
+                        return message_list.last().text();
+                    } else {
+                        return QString(QObject::tr("Failed to modify object %1.")).arg(dn_get_name(target));
+                    }
+                }();
+
+                failures.append(failure);
+            }
+        }
+
+        done_count->ref();
+    }
+
+    ad_messages = ad.messages();
+}
@@ -0,0 +1,75 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MULTI_MODIFY_THREAD_H
+#define MULTI_MODIFY_THREAD_H
+
+/**
+ * A thread that applies attribute edits to many objects.
+ * Edits are compiled into one modification request per
+ * object. Requests are performed by a small pool of
+ * workers, each with it's own connection. progress() signal
+ * is emitted periodically with number of processed
+ * objects. Use stop() to cancel, objects that were already
+ * modified stay modified. Note that creator of thread
+ * should call thread's deleteLater() in the finished()
+ * slot.
+ */
+
+#include "attribute_edits/attribute_edit.h"
+
+#include <QThread>
+
+class AdMessage;
+
+class MultiModifyThread final : public QThread {
+    Q_OBJECT
+
+public:
+    // Attributes in "attribute_list" are loaded for each
+    // target and passed to mod f-ns. If list is empty,
+    // targets aren't loaded.
+    MultiModifyThread(const QList<QString> &target_list, const QList<AttributeEditModFunction> &function_list, const QList<QString> &attribute_list);
+
+    void stop();
+    bool is_stopped() const;
+    bool failed_to_connect() const;
+
+    // Returns one error message for each target which
+    // failed to be modified
+    QList<QString> get_failures() const;
+    QList<AdMessage> get_ad_messages() const;
+
+signals:
+    void progress(const int done_count);
+
+private:
+    QList<QString> target_list;
+    QList<AttributeEditModFunction> function_list;
+    QList<QString> attribute_list;
+    bool stop_flag;
+    bool m_failed_to_connect;
+    QList<QString> failures;
+    QList<AdMessage> ad_messages;
+
+    void run() override;
+};
+
+#endif /* MULTI_MODIFY_THREAD_H */
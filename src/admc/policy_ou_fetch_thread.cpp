@@ -0,0 +1,139 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "policy_ou_fetch_thread.h"
+
+#include "adldap.h"
+#include "console_impls/object_impl.h"
+#include "console_impls/policy_impl.h"
+#include "globals.h"
+#include "gplink.h"
+
+#include <QHash>
+
+PolicyOUFetchThread::PolicyOUFetchThread(const QString &ou_dn_arg) {
+    stop_flag = false;
+    ou_dn = ou_dn_arg;
+    m_failed_to_connect = false;
+
+    static int id_max = 0;
+    id = id_max;
+    id_max++;
+}
+
+void PolicyOUFetchThread::stop() {
+    stop_flag = true;
+}
+
+int PolicyOUFetchThread::get_id() const {
+    return id;
+}
+
+bool PolicyOUFetchThread::failed_to_connect() const {
+    return m_failed_to_connect;
+}
+
+QList<AdMessage> PolicyOUFetchThread::get_ad_messages() const {
+    return ad_messages;
+}
+
+void PolicyOUFetchThread::run() {
+    AdInterface ad;
+    if (!ad.is_connected()) {
+        m_failed_to_connect = true;
+
+        return;
+    }
+
+    // Load child OU's
+    {
+        const QString filter = filter_CONDITION(Condition_Equals, ATTRIBUTE_OBJECT_CLASS, CLASS_OU);
+        const QList<QString> attributes = console_object_search_attributes();
+
+        AdCookie cookie;
+
+        while (true) {
+            QHash<QString, AdObject> results;
+
+            const bool success = ad.search_paged(ou_dn, SearchScope_Children, filter, attributes, &results, &cookie);
+
+            ad_messages = ad.messages();
+
+            emit ous_ready(results);
+
+            const bool search_interrupted = (!success || stop_flag);
+            if (search_interrupted) {
+                return;
+            }
+
+            if (!cookie.more_pages()) {
+                break;
+            }
+        }
+    }
+
+    // Load policies linked to this OU
+    const AdObject ou_object = ad.search_object_cached(ou_dn, {ATTRIBUTE_GPLINK});
+    const QString gplink_string = ou_object.get_string(ATTRIBUTE_GPLINK);
+    const QList<QString> gpo_list = Gplink(gplink_string).get_gpo_list();
+
+    if (stop_flag) {
+        return;
+    }
+
+    const QList<QString> attributes = console_policy_search_attributes();
+
+    QHash<QString, AdObject> policy_results;
+    QList<QString> uncached_gpo_list;
+
+    // NOTE: policies are usually already cached by
+    // "All policies" folder
+    for (const QString &gpo : gpo_list) {
+        AdObject cached_object;
+        QList<QString> missing;
+        const bool cache_hit = AdInterface::object_cache()->get(gpo, attributes, CacheMaxAge_Default, &cached_object, &missing);
+
+        if (cache_hit) {
+            policy_results[gpo] = cached_object;
+        } else {
+            uncached_gpo_list.append(gpo);
+        }
+    }
+
+    if (!uncached_gpo_list.isEmpty()) {
+        // NOTE: links may point to policies outside of
+        // policies container, so search whole domain.
+        // Policies that don't exist anymore are simply
+        // missing from results.
+        const QString base = g_adconfig->domain_dn();
+        const QString filter = filter_dn_list(uncached_gpo_list);
+        const QHash<QString, AdObject> search_results = ad.search(base, SearchScope_All, filter, attributes);
+
+        // NOTE: server returns DN's in their own case, while
+        // gpo list from gplink is lowercase
+        for (const QString &dn : search_results.keys()) {
+            policy_results[dn.toLower()] = search_results[dn];
+        }
+    }
+
+    ad_messages = ad.messages();
+
+    emit policies_ready(gplink_string, policy_results);
+}
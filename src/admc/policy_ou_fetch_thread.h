@@ -0,0 +1,70 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POLICY_OU_FETCH_THREAD_H
+#define POLICY_OU_FETCH_THREAD_H
+
+/**
+ * Thread that loads children of an OU in the policy tree:
+ * child OU's and policies linked to the OU. Child OU's are
+ * emitted page by page, same as SearchThread. Linked
+ * policies are emitted once after that, together with the
+ * OU's gPLink, because the gPLink has to be read first to
+ * know which policies to load. Policies that are already
+ * in object cache are not loaded again and the rest are
+ * loaded by one search instead of a search per policy.
+ * Policy results are keyed by lowercase DN, same as DN's
+ * returned by Gplink::get_gpo_list().
+ * Ids work the same way as SearchThread's ids. Note that
+ * creator of thread should call thread's deleteLater() in
+ * the finished() slot.
+ */
+
+#include <QThread>
+
+class AdObject;
+class AdMessage;
+
+class PolicyOUFetchThread final : public QThread {
+    Q_OBJECT
+
+public:
+    PolicyOUFetchThread(const QString &ou_dn);
+
+    void stop();
+    int get_id() const;
+    bool failed_to_connect() const;
+    QList<AdMessage> get_ad_messages() const;
+
+signals:
+    void ous_ready(const QHash<QString, AdObject> &results);
+    void policies_ready(const QString &gplink_string, const QHash<QString, AdObject> &results);
+
+private:
+    bool stop_flag;
+    QString ou_dn;
+    int id;
+    bool m_failed_to_connect;
+    QList<AdMessage> ad_messages;
+
+    void run() override;
+};
+
+#endif /* POLICY_OU_FETCH_THREAD_H */
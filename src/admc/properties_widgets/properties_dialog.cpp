@@ -139,7 +139,7 @@ PropertiesDialog::PropertiesDialog(AdInterface &ad, const QString &target_arg, C
     }();
     setWindowTitle(title);
 
-    const AdObject object = ad.search_object(target);
+    const AdObject object = ad.search_object_cached(target);
 
     const bool is_person = (object.is_class(CLASS_USER) || object.is_class(CLASS_INET_ORG_PERSON));
 
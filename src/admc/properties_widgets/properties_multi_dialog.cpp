@@ -24,6 +24,7 @@
 #include "adldap.h"
 #include "attribute_edits/attribute_edit.h"
 #include "globals.h"
+#include "multi_modify_thread.h"
 #include "multi_tabs/account_multi_tab.h"
 #include "multi_tabs/address_multi_tab.h"
 #include "multi_tabs/general_other_multi_tab.h"
@@ -38,6 +39,7 @@
 #include <QAction>
 #include <QCheckBox>
 #include <QDialogButtonBox>
+#include <QProgressDialog>
 #include <QPushButton>
 
 PropertiesMultiDialog::PropertiesMultiDialog(AdInterface &ad, const QList<QString> &target_list_arg, const QList<QString> &class_list)
@@ -48,6 +50,8 @@ PropertiesMultiDialog::PropertiesMultiDialog(AdInterface &ad, const QList<QStrin
     setAttribute(Qt::WA_DeleteOnClose);
 
     target_list = target_list_arg;
+    apply_thread = nullptr;
+    progress_dialog = nullptr;
 
     apply_button = ui->button_box->button(QDialogButtonBox::Apply);
 
@@ -96,63 +100,179 @@ PropertiesMultiDialog::PropertiesMultiDialog(AdInterface &ad, const QList<QStrin
 }
 
 PropertiesMultiDialog::~PropertiesMultiDialog() {
+    // NOTE: thread deletes itself when it finishes, so
+    // only need to tell it to stop
+    if (apply_thread != nullptr) {
+        apply_thread->stop();
+    }
+
     delete ui;
 }
 
 void PropertiesMultiDialog::accept() {
-    const bool success = apply();
+    start_apply(true);
+}
 
-    if (success) {
-        QDialog::accept();
-    }
+void PropertiesMultiDialog::apply() {
+    start_apply(false);
 }
 
-bool PropertiesMultiDialog::apply() {
-    AdInterface ad;
-    if (ad_failed(ad, this)) {
-        return false;
+void PropertiesMultiDialog::start_apply(const bool accept_when_done) {
+    if (apply_thread != nullptr) {
+        return;
     }
 
-    show_busy_indicator();
-
-    const bool apply_success = [&]() {
-        bool out = true;
+    const QList<AttributeEdit *> applied_edit_list = [&]() {
+        QList<AttributeEdit *> out;
 
         for (AttributeEdit *edit : edit_list) {
             QCheckBox *apply_check = check_map[edit];
             const bool need_to_apply = apply_check->isChecked();
 
             if (need_to_apply) {
-                const bool success = [&]() {
-                    bool success_out = true;
+                out.append(edit);
+            }
+        }
 
-                    for (const QString &target : target_list) {
-                        const bool this_success = edit->apply(ad, target);
+        return out;
+    }();
+
+    // Compile edits into mod f-ns. Edits which can't be
+    // compiled are applied the slow way.
+    QList<AttributeEditModFunction> function_list;
+    QList<QString> attribute_list;
+    QList<AttributeEdit *> fallback_edit_list;
 
-                        success_out = (success_out && this_success);
-                    }
+    for (AttributeEdit *edit : applied_edit_list) {
+        const AttributeEditModFunction function = edit->get_mod_function();
 
-                    return success_out;
-                }();
+        if (function) {
+            function_list.append(function);
 
-                if (success) {
-                    apply_check->setChecked(false);
+            for (const QString &attribute : edit->get_mod_attributes()) {
+                if (!attribute_list.contains(attribute)) {
+                    attribute_list.append(attribute);
                 }
+            }
+        } else {
+            fallback_edit_list.append(edit);
+        }
+    }
+
+    const bool fallback_success = apply_fallback(fallback_edit_list);
 
-                out = (out && success);
+    if (function_list.isEmpty()) {
+        if (fallback_success) {
+            for (AttributeEdit *edit : applied_edit_list) {
+                check_map[edit]->setChecked(false);
             }
         }
 
-        return out;
-    }();
+        emit applied();
 
-    g_status->display_ad_messages(ad, this);
+        if (fallback_success && accept_when_done) {
+            QDialog::accept();
+        }
 
-    hide_busy_indicator();
+        return;
+    }
+
+    apply_thread = new MultiModifyThread(target_list, function_list, attribute_list);
+
+    progress_dialog = new QProgressDialog(tr("Applying changes..."), tr("Cancel"), 0, target_list.size(), this);
+    progress_dialog->setWindowModality(Qt::WindowModal);
+
+    // NOTE: don't flash progress dialog for quick applies
+    progress_dialog->setMinimumDuration(500);
+
+    MultiModifyThread *thread = apply_thread;
+
+    connect(
+        progress_dialog, &QProgressDialog::canceled,
+        this,
+        [thread]() {
+            thread->stop();
+        });
+    connect(
+        thread, &MultiModifyThread::progress,
+        progress_dialog, &QProgressDialog::setValue,
+        Qt::QueuedConnection);
+    connect(
+        thread, &MultiModifyThread::finished,
+        this,
+        [this, thread, applied_edit_list, fallback_success, accept_when_done]() {
+            on_apply_finished(thread, applied_edit_list, fallback_success, accept_when_done);
+        },
+        Qt::QueuedConnection);
+    connect(
+        thread, &MultiModifyThread::finished,
+        thread, &QObject::deleteLater);
+
+    ui->button_box->setEnabled(false);
+
+    thread->start();
+}
+
+void PropertiesMultiDialog::on_apply_finished(MultiModifyThread *thread, const QList<AttributeEdit *> &applied_edit_list, const bool fallback_success, const bool accept_when_done) {
+    apply_thread = nullptr;
+
+    progress_dialog->reset();
+    progress_dialog->deleteLater();
+    progress_dialog = nullptr;
+
+    ui->button_box->setEnabled(true);
+
+    if (thread->failed_to_connect()) {
+        g_status->add_message(tr("Failed to connect to server while applying changes."), StatusType_Error);
+    }
+
+    g_status->log_messages(thread->get_ad_messages());
+
+    const QList<QString> failures = thread->get_failures();
+    error_log(failures, this);
+
+    const bool success = (fallback_success && failures.isEmpty() && !thread->is_stopped() && !thread->failed_to_connect());
+
+    if (success) {
+        for (AttributeEdit *edit : applied_edit_list) {
+            check_map[edit]->setChecked(false);
+        }
+    }
 
     emit applied();
 
-    return apply_success;
+    if (success && accept_when_done) {
+        QDialog::accept();
+    }
+}
+
+bool PropertiesMultiDialog::apply_fallback(const QList<AttributeEdit *> &fallback_edit_list) {
+    if (fallback_edit_list.isEmpty()) {
+        return true;
+    }
+
+    AdInterface ad;
+    if (ad_failed(ad, this)) {
+        return false;
+    }
+
+    show_busy_indicator();
+
+    bool success = true;
+
+    for (AttributeEdit *edit : fallback_edit_list) {
+        for (const QString &target : target_list) {
+            const bool this_success = edit->apply(ad, target);
+
+            success = (success && this_success);
+        }
+    }
+
+    g_status->display_ad_messages(ad, this);
+
+    hide_busy_indicator();
+
+    return success;
 }
 
 void PropertiesMultiDialog::on_edited() {
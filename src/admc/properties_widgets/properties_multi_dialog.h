@@ -26,13 +26,17 @@
  * objects at the same time. Only editing, attribute values
  * aren't displayed. For most objects the only attribute is
  * description. Only users have many tabs/attributes.
+ * Changes are applied in the background, with one
+ * modification request per object.
  */
 
 #include <QDialog>
 
 class AttributeEdit;
 class AdInterface;
+class MultiModifyThread;
 class QCheckBox;
+class QProgressDialog;
 
 namespace Ui {
 class PropertiesMultiDialog;
@@ -59,8 +63,13 @@ private:
     QList<AttributeEdit *> edit_list;
     QHash<AttributeEdit *, QCheckBox *> check_map;
     QPushButton *apply_button;
+    MultiModifyThread *apply_thread;
+    QProgressDialog *progress_dialog;
 
-    bool apply();
+    void apply();
+    void start_apply(const bool accept_when_done);
+    void on_apply_finished(MultiModifyThread *thread, const QList<AttributeEdit *> &applied_edit_list, const bool fallback_success, const bool accept_when_done);
+    bool apply_fallback(const QList<AttributeEdit *> &fallback_edit_list);
 };
 
 #endif /* PROPERTIES_MULTI_DIALOG_H */
@@ -0,0 +1,125 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "query_cache_thread.h"
+
+#include "adldap.h"
+#include "settings.h"
+#include "status.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+QueryCacheThread::QueryCacheThread(const AdQueryCache &cache_arg, const QString &file_path_arg) {
+    cache = cache_arg;
+    file_path = file_path_arg;
+    m_failed_to_connect = false;
+    m_hit_object_display_limit = false;
+    m_is_complete = false;
+
+    // NOTE: id's are shared with search threads through
+    // the search thread id role of console items. Search
+    // thread id's count up from 0, so count down from -1
+    // here so that they never match.
+    static int id_min = -1;
+    id = id_min;
+    id_min--;
+}
+
+void QueryCacheThread::run() {
+    AdInterface ad;
+    if (!ad.is_connected()) {
+        m_failed_to_connect = true;
+
+        return;
+    }
+
+    const bool success = cache.refresh(ad, &changed, &removed);
+
+    ad_messages = ad.messages();
+
+    if (!success) {
+        return;
+    }
+
+    const int object_display_limit = settings_get_variant(SETTING_object_display_limit).toInt();
+    if (cache.get_objects().size() > object_display_limit) {
+        m_hit_object_display_limit = true;
+
+        return;
+    }
+
+    m_is_complete = true;
+
+    // NOTE: failing to save is not an error, results will
+    // be loaded from server again next time
+    QDir().mkpath(QFileInfo(file_path).absolutePath());
+
+    QFile file(file_path);
+    const bool open_success = file.open(QIODevice::WriteOnly);
+    if (open_success) {
+        // NOTE: results contain directory data, so only
+        // current user should be able to read them
+        file.setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner);
+        file.write(cache.save());
+    }
+}
+
+int QueryCacheThread::get_id() const {
+    return id;
+}
+
+bool QueryCacheThread::failed_to_connect() const {
+    return m_failed_to_connect;
+}
+
+bool QueryCacheThread::hit_object_display_limit() const {
+    return m_hit_object_display_limit;
+}
+
+bool QueryCacheThread::is_complete() const {
+    return m_is_complete;
+}
+
+AdQueryCache QueryCacheThread::get_cache() const {
+    return cache;
+}
+
+QList<AdObject> QueryCacheThread::get_changed() const {
+    return changed;
+}
+
+QList<QString> QueryCacheThread::get_removed() const {
+    return removed;
+}
+
+QList<AdMessage> QueryCacheThread::get_ad_messages() const {
+    return ad_messages;
+}
+
+void query_cache_thread_display_errors(QueryCacheThread *thread, QWidget *parent) {
+    if (thread->failed_to_connect()) {
+        error_log({QCoreApplication::translate("query_cache_thread.cpp", "Failed to connect to server while updating query results.")}, parent);
+    } else if (thread->hit_object_display_limit()) {
+        error_log({QCoreApplication::translate("object_impl.cpp", "Could not load all objects. Increase object display limit in Filter Options or reduce number of objects by applying a filter. Filter Options is accessible from main window's menubar via the \"View\" menu.")}, parent);
+    }
+}
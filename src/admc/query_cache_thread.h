@@ -0,0 +1,77 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUERY_CACHE_THREAD_H
+#define QUERY_CACHE_THREAD_H
+
+/**
+ * A thread that brings kept results of a query item up to
+ * date and then saves them to file. Works on a copy of
+ * results, get_cache() returns updated results once the
+ * thread is finished. get_changed() and get_removed()
+ * return the difference from the results the thread was
+ * started with, so that only rows of changed objects need
+ * to be updated in the console. Note that creator of
+ * thread should call thread's deleteLater() in the
+ * finished() slot.
+ */
+
+#include <QThread>
+
+#include "ad_query_cache.h"
+
+class AdMessage;
+
+class QueryCacheThread final : public QThread {
+    Q_OBJECT
+
+public:
+    QueryCacheThread(const AdQueryCache &cache, const QString &file_path);
+
+    int get_id() const;
+    bool failed_to_connect() const;
+    bool hit_object_display_limit() const;
+
+    // Returns true if refresh succeeded and results are
+    // within object display limit
+    bool is_complete() const;
+
+    AdQueryCache get_cache() const;
+    QList<AdObject> get_changed() const;
+    QList<QString> get_removed() const;
+    QList<AdMessage> get_ad_messages() const;
+
+private:
+    AdQueryCache cache;
+    QString file_path;
+    int id;
+    bool m_failed_to_connect;
+    bool m_hit_object_display_limit;
+    bool m_is_complete;
+    QList<AdObject> changed;
+    QList<QString> removed;
+    QList<AdMessage> ad_messages;
+
+    void run() override;
+};
+
+void query_cache_thread_display_errors(QueryCacheThread *thread, QWidget *parent);
+
+#endif /* QUERY_CACHE_THREAD_H */
@@ -56,7 +56,7 @@ RenameObjectHelper::RenameObjectHelper(AdInterface &ad, const QString &target_ar
 
     limit_edit(name_edit, ATTRIBUTE_CN);
 
-    const AdObject object = ad.search_object(target);
+    const AdObject object = ad.search_object_cached(target);
     AttributeEdit::load(edits, ad, object);
 
     if (!required_list.isEmpty() && ok_button != nullptr) {
@@ -28,6 +28,7 @@
 #include "globals.h"
 #include "ad_config.h"
 #include "status.h"
+#include "fsmo/domain_topology.h"
 #include "fsmo/fsmo_utils.h"
 #include "icon_manager/icon_manager.h"
 #include "utils.h"
@@ -44,7 +45,12 @@ DomainInfoResultsWidget::DomainInfoResultsWidget(ConsoleWidget *console_arg) :
     ui->tree->setHeaderHidden(true);
 
     connect(console, &ConsoleWidget::fsmo_master_changed, this, &DomainInfoResultsWidget::update_fsmo_roles);
-    update();
+    connect(
+        g_domain_topology, &DomainTopologyService::loaded,
+        this, &DomainInfoResultsWidget::on_topology_loaded);
+    connect(
+        ui->refresh_button, &QPushButton::clicked,
+        this, &DomainInfoResultsWidget::refresh);
 }
 
 DomainInfoResultsWidget::~DomainInfoResultsWidget() {
@@ -52,10 +58,27 @@ DomainInfoResultsWidget::~DomainInfoResultsWidget() {
 }
 
 void DomainInfoResultsWidget::update() {
+    if (g_domain_topology->is_loaded()) {
+        load(g_domain_topology->get());
+    } else {
+        refresh();
+    }
+}
+
+void DomainInfoResultsWidget::refresh() {
     update_defaults();
 
-    DomainInfo_SearchResults results = search_results();
-    populate_widgets(results);
+    // NOTE: button is enabled back once topology is
+    // loaded
+    ui->refresh_button->setEnabled(false);
+
+    g_domain_topology->refresh();
+}
+
+void DomainInfoResultsWidget::on_topology_loaded() {
+    ui->refresh_button->setEnabled(true);
+
+    load(g_domain_topology->get());
 }
 
 void DomainInfoResultsWidget::update_fsmo_roles(const QString &new_master_dn, const QString &fsmo_role_string) {
@@ -95,24 +118,19 @@ void DomainInfoResultsWidget::update_defaults() {
     }
 }
 
-QList<QStandardItem *> DomainInfoResultsWidget::get_tree_items(AdInterface &ad) {
-    const QString sites_container_dn = "CN=Sites,CN=Configuration," + g_adconfig->domain_dn();
-    const QString filter = filter_CONDITION(Condition_Equals, ATTRIBUTE_OBJECT_CLASS, CLASS_SITE);
-    const QHash<QString, AdObject> site_objects = ad.search(sites_container_dn, SearchScope_Children,
-                                                            filter, {ATTRIBUTE_DN, ATTRIBUTE_NAME/*, ATTRIBUTE_GPLINK*/});
-
+QList<QStandardItem *> DomainInfoResultsWidget::get_tree_items(const DomainTopology &topology) {
     QList<QStandardItem *> site_items;
-    if (site_objects.isEmpty()) {
+    if (topology.site_list.isEmpty()) {
         g_status->add_message("Failed to find domain sites.", StatusType_Error);
         return site_items;
     }
 
-    for (const AdObject &site_object : site_objects.values()) {
-        QStandardItem *site_item = add_tree_item(site_object.get_string(ATTRIBUTE_NAME), g_icon_manager->get_icon_for_type(ItemIconType_Site_Clean),
+    for (const DomainTopologySite &site : topology.site_list) {
+        QStandardItem *site_item = add_tree_item(site.name, g_icon_manager->get_icon_for_type(ItemIconType_Site_Clean),
                                                  DomainInfoTreeItemType_Site, nullptr);
-        site_item->setData(site_object.get_dn(), DomainInfoTreeItemRole_DN);
+        site_item->setData(site.dn, DomainInfoTreeItemRole_DN);
 
-        add_host_items(site_item, site_object, ad);
+        add_host_items(site_item, site.dn, topology);
 
         site_items.append(site_item);
     }
@@ -120,52 +138,15 @@ QList<QStandardItem *> DomainInfoResultsWidget::get_tree_items(AdInterface &ad)
     return site_items;
 }
 
-DomainInfo_SearchResults DomainInfoResultsWidget::search_results() {
-    DomainInfo_SearchResults results;
+void DomainInfoResultsWidget::load(const DomainTopology &topology) {
+    update_defaults();
 
-    AdInterface ad;
-    if (!ad.is_connected()) {
-        return results;
+    if (!topology.is_valid) {
+        return;
     }
 
-    results.tree_items = get_tree_items(ad);
-
-    const QStringList root_dse_attributes = {
-        ATTRIBUTE_DOMAIN_FUNCTIONALITY_LEVEL,
-        ATTRIBUTE_FOREST_FUNCTIONALITY_LEVEL,
-        ATTRIBUTE_SCHEMA_NAMING_CONTEXT,
-        ATTRIBUTE_DNS_HOST_NAME,
-        ATTRIBUTE_SERVER_NAME
-    };
-
-    const AdObject rootDSE = ad.search_object("", root_dse_attributes);
-
-    const QString server_name = rootDSE.get_string(ATTRIBUTE_SERVER_NAME);
-    const AdObject server_object = ad.search_object(server_name, {ATTRIBUTE_SERVER_REFERENCE});
-    const AdObject host = ad.search_object(server_object.get_string(ATTRIBUTE_SERVER_REFERENCE), {ATTRIBUTE_OS, ATTRIBUTE_OS_VERSION});
-    const QString dc_version = host.get_string(ATTRIBUTE_OS).isEmpty() ? QString() : host.get_string(ATTRIBUTE_OS) +
-                                                                                    QString(" (%1)").arg(host.get_string(ATTRIBUTE_OS_VERSION));
-    results.domain_controller_version = dc_version;
-
-    const int forest_level = rootDSE.get_int(ATTRIBUTE_FOREST_FUNCTIONALITY_LEVEL);
-    const QString forest_level_string = QString::number(forest_level) + " " + functionality_level_to_string(forest_level);
-    results.forest_functional_level = forest_level_string;
-
-    const int domain_level = rootDSE.get_int(ATTRIBUTE_DOMAIN_FUNCTIONALITY_LEVEL);
-    const QString domain_level_string = QString::number(domain_level) + " " + functionality_level_to_string(domain_level);
-    results.domain_functional_level = domain_level_string;
-
-    const QString schema_dn = rootDSE.get_string(ATTRIBUTE_SCHEMA_NAMING_CONTEXT);
-    const AdObject schema_object = ad.search_object(schema_dn, {ATTRIBUTE_OBJECT_VERSION});
-    const int domain_schema_version = schema_object.get_int(ATTRIBUTE_OBJECT_VERSION);
-    const QString domain_schema_version_string = QString::number(domain_schema_version) + " " + schema_version_to_string(domain_schema_version);
-    results.domain_schema_version = domain_schema_version_string;
-
-    return results;
-}
-
-void DomainInfoResultsWidget::populate_widgets(DomainInfo_SearchResults results) {
-    for (auto item : results.tree_items) {
+    const QList<QStandardItem *> tree_items = get_tree_items(topology);
+    for (auto item : tree_items) {
         model->appendRow(item);
     }
     model->sort(0);
@@ -188,12 +169,23 @@ void DomainInfoResultsWidget::populate_widgets(DomainInfo_SearchResults results)
         type_label_hash[type]->setText(QString::number(count));
     }
 
+    const QString dc_version = topology.dc_os.isEmpty() ? QString() : topology.dc_os + QString(" (%1)").arg(topology.dc_os_version);
+
+    const int forest_level = topology.forest_functionality_level;
+    const QString forest_level_string = QString::number(forest_level) + " " + functionality_level_to_string(forest_level);
+
+    const int domain_level = topology.domain_functionality_level;
+    const QString domain_level_string = QString::number(domain_level) + " " + functionality_level_to_string(domain_level);
+
+    const int schema_version = topology.schema_version;
+    const QString schema_version_string = QString::number(schema_version) + " " + schema_version_to_string(schema_version);
+
     // Populate labels. Widgets are keys because levels can match
     const QHash<QLabel*, QString> label_results_hash {
-        {ui->domain_functionality_value, results.domain_functional_level},
-        {ui->forest_functionality_value, results.forest_functional_level},
-        {ui->domain_schema_value, results.domain_schema_version},
-        {ui->dc_version_value, results.domain_controller_version}
+        {ui->domain_functionality_value, domain_level_string},
+        {ui->forest_functionality_value, forest_level_string},
+        {ui->domain_schema_value, schema_version_string},
+        {ui->dc_version_value, dc_version}
     };
     for (QLabel *label : label_results_hash.keys()) {
         if (label_results_hash[label].isEmpty()) {
@@ -205,32 +197,21 @@ void DomainInfoResultsWidget::populate_widgets(DomainInfo_SearchResults results)
     }
 }
 
-void DomainInfoResultsWidget::add_host_items(QStandardItem *site_item, const AdObject &site_object, AdInterface &ad) {
-    const QString servers_container_dn = "CN=Servers," + site_object.get_dn();
-    const QString filter = filter_CONDITION(Condition_Equals, ATTRIBUTE_OBJECT_CLASS, CLASS_SERVER);
-    const QHash<QString, AdObject> host_objects = ad.search(servers_container_dn, SearchScope_Children,
-                                                            filter, {ATTRIBUTE_DN, ATTRIBUTE_NAME, ATTRIBUTE_DNS_HOST_NAME});
+void DomainInfoResultsWidget::add_host_items(QStandardItem *site_item, const QString &site_dn, const DomainTopology &topology) {
+    const QList<DomainTopologyServer> server_list = topology.get_site_servers(site_dn);
 
-    QHash<QString, QStringList> host_fsmo_map;
-    for (int role = 0; role < FSMORole_COUNT; ++role) {
-        const QString host = current_master_for_role(ad, FSMORole(role));
-        host_fsmo_map[host].append(string_fsmo_role(FSMORole(role)));
-    }
-    QString host;
-    for (const AdObject &host_object : host_objects.values()) {
-        QStandardItem *host_item = add_tree_item(host_object.get_string(ATTRIBUTE_DNS_HOST_NAME), g_icon_manager->get_icon_for_type(ItemIconType_Domain_Clean),
+    for (const DomainTopologyServer &server : server_list) {
+        QStandardItem *host_item = add_tree_item(server.dns_host_name, g_icon_manager->get_icon_for_type(ItemIconType_Domain_Clean),
                                                  DomainInfoTreeItemType_Host, site_item);
-        host_item->setData(host_object.get_dn(), DomainInfoTreeItemRole_DN);
-        host = host_object.get_string(ATTRIBUTE_DNS_HOST_NAME);
+        host_item->setData(server.dn, DomainInfoTreeItemRole_DN);
 
         QStandardItem *fsmo_roles_container_item = add_tree_item(tr("FSMO roles"), g_icon_manager->get_object_icon(ADMC_CATEGORY_FSMO_ROLE_CONTAINER),
                                                                  DomainInfoTreeItemType_FSMO_Container, host_item);
 
-        if (host_fsmo_map.keys().contains(host_item->text())) {
-            for (const QString &fsmo_role : host_fsmo_map[host_item->text()]) {
-                add_tree_item(fsmo_role, g_icon_manager->get_object_icon(ADMC_CATEGORY_FSMO_ROLE),
-                              DomainInfoTreeItemType_FSMO_Role,fsmo_roles_container_item);
-            }
+        const QList<FSMORole> role_list = topology.get_roles(server.dns_host_name);
+        for (const FSMORole role : role_list) {
+            add_tree_item(string_fsmo_role(role), g_icon_manager->get_object_icon(ADMC_CATEGORY_FSMO_ROLE),
+                          DomainInfoTreeItemType_FSMO_Role, fsmo_roles_container_item);
         }
     }
 }
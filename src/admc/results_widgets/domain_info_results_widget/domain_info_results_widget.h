@@ -27,22 +27,10 @@ class DomainInfoResultsWidget;
 }
 
 class ConsoleWidget;
-class AdInterface;
 class QStandardItemModel;
-class AdObject;
 class QStandardItem;
-class QSpinBox;
-template <typename T, typename U>
-class QHash;
 class QLabel;
-
-struct DomainInfo_SearchResults {
-    QList<QStandardItem*> tree_items;
-    QString domain_functional_level;
-    QString forest_functional_level;
-    QString domain_schema_version;
-    QString domain_controller_version;
-};
+class DomainTopology;
 
 class DomainInfoResultsWidget : public QWidget
 {
@@ -77,8 +65,13 @@ public:
     explicit DomainInfoResultsWidget(ConsoleWidget *console_arg);
     ~DomainInfoResultsWidget();
 
+    // Displays cached topology, loads it in background if
+    // it wasn't loaded yet
     void update();
 
+    // Reloads topology in background
+    void refresh();
+
 public slots:
     void  update_fsmo_roles(const QString &new_master_dn, const QString &fsmo_role_string);
 
@@ -89,10 +82,10 @@ private:
     QStandardItemModel *model;
 
     void update_defaults();
-    QList<QStandardItem*> get_tree_items(AdInterface &ad);
-    DomainInfo_SearchResults search_results();
-    void populate_widgets(DomainInfo_SearchResults results);
-    void add_host_items(QStandardItem *site_item, const AdObject &site_object, AdInterface &ad);
+    void load(const DomainTopology &topology);
+    void on_topology_loaded();
+    QList<QStandardItem*> get_tree_items(const DomainTopology &topology);
+    void add_host_items(QStandardItem *site_item, const QString &site_dn, const DomainTopology &topology);
     void set_label_failed(QLabel *label, bool failed);
     QStandardItem *add_tree_item(const QString &text, const QIcon &icon, DomainInfoTreeItemType type, QStandardItem *parent_item = nullptr);
 
@@ -340,7 +340,7 @@ QList<AdObject> LinkedPoliciesWidget::gpo_object_list(AdInterface &ad) {
     const QString base = g_adconfig->policies_dn();
     const SearchScope scope = SearchScope_Children;
     const QString filter = filter_dn_list(gpo_dn_list);
-    const QList<QString> attributes = QList<QString>();
+    const QList<QString> attributes = console_policy_search_attributes();
 
     const QHash<QString, AdObject> search_results = ad.search(base, scope, filter, attributes);
 
@@ -27,6 +27,7 @@
 #include "console_widget/console_widget.h"
 #include "console_widget/results_view.h"
 #include "globals.h"
+#include "search_thread.h"
 #include "settings.h"
 #include "status.h"
 #include "utils.h"
@@ -71,6 +72,8 @@ PolicyResultsWidget::PolicyResultsWidget(QWidget *parent)
     ui = new Ui::PolicyResultsWidget();
     ui->setupUi(this);
 
+    current_search_id = -1;
+
     auto delete_link_action = new QAction(tr("Delete link"), this);
 
     context_menu = new QMenu(this);
@@ -133,20 +136,93 @@ void PolicyResultsWidget::update(const QModelIndex &index) {
 void PolicyResultsWidget::update(const QString &new_gpo) {
     gpo = new_gpo;
 
+    // NOTE: discard results of background lookup if one
+    // is in progress
+    current_search_id = -1;
+
     AdInterface ad;
     if (ad_failed(ad, this)) {
         return;
     }
 
-    model->removeRows(0, model->rowCount());
-
     const QString base = g_adconfig->domain_dn();
     const SearchScope scope = SearchScope_All;
     const QList<QString> attributes = {ATTRIBUTE_NAME, ATTRIBUTE_GPLINK, ATTRIBUTE_OBJECT_CATEGORY};
     const QString filter = filter_CONDITION(Condition_Contains, ATTRIBUTE_GPLINK, gpo);
     const QHash<QString, AdObject> results = ad.search(base, scope, filter, attributes);
 
-    for (const AdObject &object : results.values()) {
+    link_cache[gpo] = results.values();
+    load_links(results.values());
+}
+
+void PolicyResultsWidget::load_cached(const QString &new_gpo) {
+    gpo = new_gpo;
+    current_search_id = -1;
+
+    load_links(link_cache.value(gpo));
+}
+
+void PolicyResultsWidget::update_in_background(const QString &new_gpo) {
+    gpo = new_gpo;
+
+    const QString base = g_adconfig->domain_dn();
+    const SearchScope scope = SearchScope_All;
+    const QList<QString> attributes = {ATTRIBUTE_NAME, ATTRIBUTE_GPLINK, ATTRIBUTE_OBJECT_CATEGORY};
+    const QString filter = filter_CONDITION(Condition_Contains, ATTRIBUTE_GPLINK, gpo);
+
+    auto search_thread = new SearchThread(base, scope, filter, attributes);
+
+    current_search_id = search_thread->get_id();
+    pending_results.clear();
+
+    // NOTE: results of all pages are loaded at once when
+    // search finishes, so that links that are already
+    // displayed from cache don't flicker
+    connect(
+        search_thread, &SearchThread::results_ready,
+        this,
+        [=](const QHash<QString, AdObject> &results) {
+            if (search_thread->get_id() != current_search_id) {
+                search_thread->stop();
+
+                return;
+            }
+
+            pending_results.unite(results);
+        },
+        Qt::QueuedConnection);
+    connect(
+        search_thread, &SearchThread::finished,
+        this,
+        [=]() {
+            search_thread->deleteLater();
+
+            if (search_thread->get_id() != current_search_id) {
+                return;
+            }
+
+            current_search_id = -1;
+
+            g_status->log_messages(search_thread->get_ad_messages());
+
+            if (search_thread->failed_to_connect()) {
+                return;
+            }
+
+            link_cache[gpo] = pending_results.values();
+            load_links(pending_results.values());
+
+            pending_results.clear();
+        },
+        Qt::QueuedConnection);
+
+    search_thread->start();
+}
+
+void PolicyResultsWidget::load_links(const QList<AdObject> &object_list) {
+    model->removeRows(0, model->rowCount());
+
+    for (const AdObject &object : object_list) {
         const QList<QStandardItem *> row = make_item_row(PolicyResultsColumn_COUNT);
 
         const QString dn = object.get_dn();
@@ -235,6 +311,7 @@ void PolicyResultsWidget::on_item_changed(QStandardItem *item) {
 
     if (success) {
         model->setData(index, updated_gplink_string, PolicyResultsRole_GplinkString);
+        link_cache.remove(gpo);
         emit ou_gplink_changed(ou_dn, gplink, gpo, option);
 
     } else {
@@ -300,6 +377,10 @@ void PolicyResultsWidget::delete_link() {
         model->removeRow(index.row());
     }
 
+    if (!removed_indexes.isEmpty()) {
+        link_cache.remove(gpo);
+    }
+
     g_status->display_ad_messages(ad, this);
 
     hide_busy_indicator();
@@ -25,12 +25,14 @@
  * Displays OU's linked to currently selected policy.
  */
 
+#include <QHash>
 #include <QWidget>
 #include "gplink.h"
 
 class QStandardItemModel;
 class QStandardItem;
 class QMenu;
+class AdObject;
 class ResultsView;
 class ADMCTestPolicyResultsWidget;
 
@@ -53,6 +55,17 @@ public:
 
     void update(const QString &gpo);
 
+    // Loads links for this policy from results of last
+    // lookup, without contacting the server. If there were
+    // no lookups for this policy yet, view is cleared.
+    void load_cached(const QString &gpo);
+
+    // Looks up links in a background thread, then replaces
+    // displayed links with results. Results are discarded
+    // if another update is started before this one
+    // finishes.
+    void update_in_background(const QString &gpo);
+
     ResultsView *get_view() const;
 
     QString get_current_gpo() const;
@@ -64,6 +77,11 @@ private:
     QStandardItemModel *model;
     QString gpo;
     QMenu *context_menu;
+    QHash<QString, QList<AdObject>> link_cache;
+    QHash<QString, AdObject> pending_results;
+    int current_search_id;
+
+    void load_links(const QList<AdObject> &object_list);
 
     void on_item_changed(QStandardItem *item);
     void open_context_menu(const QPoint &pos);
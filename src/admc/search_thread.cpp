@@ -35,12 +35,19 @@ SearchThread::SearchThread(const QString base_arg, const SearchScope scope_arg,
     attributes = attributes_arg;
     m_failed_to_connect = false;
     m_hit_object_display_limit = false;
+    m_is_complete = false;
+    size_limit = 0;
+    m_hit_size_limit = false;
 
     static int id_max = 0;
     id = id_max;
     id_max++;
 }
 
+void SearchThread::set_size_limit(const int size_limit_arg) {
+    size_limit = size_limit_arg;
+}
+
 void SearchThread::stop() {
     stop_flag = true;
 }
@@ -74,6 +81,24 @@ void SearchThread::run() {
 
         ad_messages = ad.messages();
 
+        // NOTE: server returns whole pages, so drop
+        // results that are over the limit
+        const bool over_size_limit = (size_limit > 0 && (total_results_count > size_limit || (total_results_count == size_limit && cookie.more_pages())));
+        if (over_size_limit) {
+            const int extra_count = total_results_count - size_limit;
+            const QList<QString> extra_dn_list = results.keys().mid(0, extra_count);
+
+            for (const QString &dn : extra_dn_list) {
+                results.remove(dn);
+            }
+
+            m_hit_size_limit = true;
+
+            emit results_ready(results);
+
+            break;
+        }
+
         emit results_ready(results);
 
         const bool search_interrupted = (!success || stop_flag);
@@ -82,6 +107,8 @@ void SearchThread::run() {
         }
 
         if (!cookie.more_pages()) {
+            m_is_complete = true;
+
             break;
         }
     }
@@ -99,6 +126,14 @@ bool SearchThread::hit_object_display_limit() const {
     return m_hit_object_display_limit;
 }
 
+bool SearchThread::is_complete() const {
+    return m_is_complete;
+}
+
+bool SearchThread::hit_size_limit() const {
+    return m_hit_size_limit;
+}
+
 QList<AdMessage> SearchThread::get_ad_messages() const {
     return ad_messages;
 }
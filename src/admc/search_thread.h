@@ -46,10 +46,21 @@ class SearchThread final : public QThread {
 public:
     SearchThread(const QString base, const SearchScope scope, const QString &filter, const QList<QString> attributes);
 
+    // Stops search once this many results were received.
+    // 0 means no limit, which is the default.
+    void set_size_limit(const int size_limit);
+
     void stop();
     int get_id() const;
     bool failed_to_connect() const;
     bool hit_object_display_limit() const;
+
+    // Returns true if all pages were received, which means
+    // search was not stopped, didn't fail and didn't hit
+    // the object display limit
+    bool is_complete() const;
+    bool hit_size_limit() const;
+
     QList<AdMessage> get_ad_messages() const;
 
 signals:
@@ -65,6 +76,9 @@ private:
     int id;
     bool m_failed_to_connect;
     bool m_hit_object_display_limit;
+    bool m_is_complete;
+    int size_limit;
+    bool m_hit_size_limit;
     QList<AdMessage> ad_messages;
 
     void run() override;
@@ -22,6 +22,10 @@
 #include "ui_select_container_dialog.h"
 
 #include "adldap.h"
+#include "console_impls/item_type.h"
+#include "console_impls/object_impl.h"
+#include "console_widget/console_widget.h"
+#include "container_fetch_thread.h"
 #include "globals.h"
 #include "settings.h"
 #include "status.h"
@@ -31,14 +35,21 @@
 #include <QDialogButtonBox>
 #include <QHeaderView>
 #include <QPushButton>
+#include <QSet>
 #include <QSortFilterProxyModel>
 #include <QStandardItemModel>
 #include <QTreeView>
 #include <QVBoxLayout>
 
+// NOTE: limit prefetch so that expanding a container with
+// a lot of children doesn't start a long chain of searches
+const int PREFETCH_MAX = 20;
+
 QStandardItem *make_container_node(const AdObject &object);
+QList<QString> container_node_attributes();
+void remove_placeholder_node(QStandardItem *parent);
 
-SelectContainerDialog::SelectContainerDialog(AdInterface &ad, QWidget *parent)
+SelectContainerDialog::SelectContainerDialog(AdInterface &ad, QWidget *parent, ConsoleWidget *console_arg)
 : QDialog(parent) {
     ui = new Ui::SelectContainerDialog();
     ui->setupUi(this);
@@ -47,6 +58,8 @@ SelectContainerDialog::SelectContainerDialog(AdInterface &ad, QWidget *parent)
 
     ui->view->sortByColumn(0, Qt::AscendingOrder);
 
+    console = console_arg;
+
     model = new QStandardItemModel(this);
 
     proxy_model = new QSortFilterProxyModel(this);
@@ -67,9 +80,10 @@ SelectContainerDialog::SelectContainerDialog(AdInterface &ad, QWidget *parent)
 
     // Load head object
     const QString head_dn = g_adconfig->domain_dn();
-    const AdObject head_object = ad.search_object(head_dn);
+    const AdObject head_object = ad.search_object_cached(head_dn, container_node_attributes());
     QStandardItem *item = make_container_node(head_object);
     model->appendRow(item);
+    dn_to_index_map[head_dn] = item->index();
 
     // NOTE: geometry is shared with the subclass
     // MoveObjectDialog but that is intended.
@@ -78,9 +92,18 @@ SelectContainerDialog::SelectContainerDialog(AdInterface &ad, QWidget *parent)
     connect(
         ui->view, &QTreeView::expanded,
         this, &SelectContainerDialog::on_item_expanded);
+
+    // Start loading head's children right away so that
+    // first expansion is instant
+    fetch_nodes({item->index()});
 }
 
 SelectContainerDialog::~SelectContainerDialog() {
+    // NOTE: threads delete themselves when they finish
+    for (ContainerFetchThread *thread : thread_set) {
+        thread->stop();
+    }
+
     delete ui;
 }
 
@@ -91,20 +114,33 @@ QString SelectContainerDialog::get_selected() const {
     return dn;
 }
 
-void SelectContainerDialog::fetch_node(const QModelIndex &proxy_index) {
-    const QModelIndex index = proxy_model->mapToSource(proxy_index);
+// NOTE: nodes are fetched by one thread, one after another
+void SelectContainerDialog::fetch_nodes(const QList<QModelIndex> &index_list) {
+    QList<QString> base_list;
 
-    AdInterface ad;
-    if (ad_failed(ad, this)) {
-        return;
-    }
+    for (const QModelIndex &index : index_list) {
+        // NOTE: nodes that are being fetched by another
+        // thread will be loaded by that thread
+        const bool fetched = index.data(ContainerRole_Fetched).toBool();
+        const bool fetching = index.data(ContainerRole_Fetching).toBool();
+        if (fetched || fetching) {
+            continue;
+        }
 
-    show_busy_indicator();
+        const bool loaded_from_console = load_node_from_console(index);
+        if (loaded_from_console) {
+            continue;
+        }
 
-    model->removeRows(0, model->rowCount(index), index);
+        model->setData(index, true, ContainerRole_Fetching);
 
-    const QString base = index.data(ContainerRole_DN).toString();
-    const SearchScope scope = SearchScope_Children;
+        const QString dn = index.data(ContainerRole_DN).toString();
+        base_list.append(dn);
+    }
+
+    if (base_list.isEmpty()) {
+        return;
+    }
 
     const QString filter = [=]() {
         QString out;
@@ -115,27 +151,207 @@ void SelectContainerDialog::fetch_node(const QModelIndex &proxy_index) {
         return out;
     }();
 
-    const QList<QString> attributes = QList<QString>();
+    const QList<QString> attributes = container_node_attributes();
+
+    auto thread = new ContainerFetchThread(base_list, filter, attributes);
+    thread_set.insert(thread);
+
+    connect(
+        thread, &ContainerFetchThread::results_ready,
+        this,
+        [this](const QString &base, const QHash<QString, AdObject> &results) {
+            const QModelIndex index = dn_to_index_map.value(base);
+            if (!index.isValid()) {
+                return;
+            }
+
+            add_nodes(index, results.values());
+        },
+        Qt::QueuedConnection);
+    connect(
+        thread, &ContainerFetchThread::base_fetched,
+        this,
+        [this](const QString &base) {
+            const QModelIndex index = dn_to_index_map.value(base);
+            if (!index.isValid()) {
+                return;
+            }
+
+            on_node_fetched(index);
+        },
+        Qt::QueuedConnection);
+    connect(
+        thread, &ContainerFetchThread::finished,
+        this,
+        [this, thread, base_list]() {
+            thread_set.remove(thread);
+
+            g_status->display_ad_messages(thread->get_ad_messages(), this);
+
+            if (thread->failed_to_connect()) {
+                error_log({tr("Failed to connect to server while searching for objects.")}, this);
+            }
+
+            // NOTE: reset nodes that failed to load so that
+            // they are fetched again when expanded
+            for (const QString &base : base_list) {
+                const QModelIndex index = dn_to_index_map.value(base);
+                if (!index.isValid()) {
+                    continue;
+                }
+
+                const bool fetched = index.data(ContainerRole_Fetched).toBool();
+                if (!fetched) {
+                    model->setData(index, false, ContainerRole_Fetching);
+                }
+            }
+        },
+        Qt::QueuedConnection);
+
+    // NOTE: not deleting thread in the slot above because
+    // dialog may be closed before thread finishes
+    connect(
+        thread, &ContainerFetchThread::finished,
+        thread, &QObject::deleteLater);
+
+    thread->start();
+}
+
+// Prefetch children of given node, so that they don't
+// need to be loaded when they are expanded
+void SelectContainerDialog::prefetch_children(const QModelIndex &index) {
+    QList<QModelIndex> child_list;
+
+    for (int row = 0; row < model->rowCount(index); row++) {
+        if (child_list.size() >= PREFETCH_MAX) {
+            break;
+        }
+
+        const QModelIndex child = model->index(row, 0, index);
+
+        const QString dn = child.data(ContainerRole_DN).toString();
+        const bool fetched = child.data(ContainerRole_Fetched).toBool();
+        const bool should_prefetch = (!dn.isEmpty() && !fetched);
+
+        if (should_prefetch) {
+            child_list.append(child);
+        }
+    }
+
+    fetch_nodes(child_list);
+}
+
+// Copies children from console's object tree, if console
+// has already fetched this container. Returns true if
+// children were copied.
+bool SelectContainerDialog::load_node_from_console(const QModelIndex &index) {
+    if (console == nullptr) {
+        return false;
+    }
+
+    const QModelIndex console_root = get_object_tree_root(console);
+    if (!console_root.isValid()) {
+        return false;
+    }
+
+    const QString dn = index.data(ContainerRole_DN).toString();
+    const QModelIndex console_index = console->search_item(console_root, ObjectRole_DN, dn, {ItemType_Object});
+    if (!console_index.isValid()) {
+        return false;
+    }
+
+    const bool console_fetched = console_item_get_was_fetched(console_index);
+    const bool console_fetching = console_index.data(ObjectRole_Fetching).toBool();
+    if (!console_fetched || console_fetching) {
+        return false;
+    }
+
+    const QList<QString> filter_containers = g_adconfig->get_filter_containers();
+    const QSet<QString> container_class_set = QSet<QString>(filter_containers.begin(), filter_containers.end());
+
+    const QList<AdObject> object_list = [&]() {
+        QList<AdObject> out;
+
+        QStandardItem *console_item = console->get_item(console_index);
+
+        for (int row = 0; row < console_item->rowCount(); row++) {
+            QStandardItem *child = console_item->child(row, 0);
+
+            const int child_type = child->data(ConsoleRole_Type).toInt();
+            if (child_type != ItemType_Object) {
+                continue;
+            }
+
+            // NOTE: console tree may also contain
+            // non-containers, depending on settings
+            const QList<QString> object_classes = child->data(ObjectRole_ObjectClasses).toStringList();
+            const bool is_container = (!object_classes.isEmpty() && container_class_set.contains(object_classes.last()));
+            if (!is_container) {
+                continue;
+            }
+
+            const QString child_dn = child->data(ObjectRole_DN).toString();
+            const QString object_category = child->data(ObjectRole_ObjectCategory).toString();
+
+            AdObject object;
+            object.load(child_dn, {
+                {ATTRIBUTE_OBJECT_CATEGORY, {object_category.toUtf8()}},
+                {ATTRIBUTE_NAME, {child->text().toUtf8()}},
+            });
+
+            out.append(object);
+        }
+
+        return out;
+    }();
+
+    add_nodes(index, object_list);
+    on_node_fetched(index);
 
-    QHash<QString, AdObject> results = ad.search(base, scope, filter, attributes);
+    return true;
+}
 
-    dev_mode_search_results(results, ad, base);
+void SelectContainerDialog::add_nodes(const QModelIndex &parent_index, const QList<AdObject> &object_list) {
+    QStandardItem *parent = model->itemFromIndex(parent_index);
+
+    remove_placeholder_node(parent);
+
+    for (const AdObject &object : object_list) {
+        // NOTE: node may have been loaded already if it
+        // was fetched by both prefetch and expansion
+        const QString dn = object.get_dn();
+        if (dn_to_index_map.value(dn).isValid()) {
+            continue;
+        }
 
-    QStandardItem *parent = model->itemFromIndex(index);
-    for (const AdObject &object : results.values()) {
         auto item = make_container_node(object);
         parent->appendRow(item);
+        dn_to_index_map[dn] = item->index();
     }
+}
+
+void SelectContainerDialog::on_node_fetched(const QModelIndex &index) {
+    model->setData(index, true, ContainerRole_Fetched);
+    model->setData(index, false, ContainerRole_Fetching);
 
-    parent->setData(true, ContainerRole_Fetched);
+    QStandardItem *item = model->itemFromIndex(index);
+    remove_placeholder_node(item);
 
-    hide_busy_indicator();
+    const QModelIndex proxy_index = proxy_model->mapFromSource(index);
+    const bool is_expanded = ui->view->isExpanded(proxy_index);
+    if (is_expanded) {
+        prefetch_children(index);
+    }
 }
 
-void SelectContainerDialog::on_item_expanded(const QModelIndex &index) {
+void SelectContainerDialog::on_item_expanded(const QModelIndex &proxy_index) {
+    const QModelIndex index = proxy_model->mapToSource(proxy_index);
+
     const bool fetched = index.data(ContainerRole_Fetched).toBool();
-    if (!fetched) {
-        fetch_node(index);
+    if (fetched) {
+        prefetch_children(index);
+    } else {
+        fetch_nodes({index});
     }
 }
 
@@ -149,7 +365,15 @@ QStandardItem *make_container_node(const AdObject &object) {
     const QString dn = object.get_dn();
     item->setData(dn, ContainerRole_DN);
 
-    const QString name = dn_get_name(dn);
+    const QString name = [&]() {
+        const QString name_attribute = object.get_string(ATTRIBUTE_NAME);
+
+        if (!name_attribute.isEmpty()) {
+            return name_attribute;
+        } else {
+            return dn_get_name(dn);
+        }
+    }();
     item->setText(name);
 
     const QIcon icon = g_icon_manager->get_object_icon(object);
@@ -157,3 +381,27 @@ QStandardItem *make_container_node(const AdObject &object) {
 
     return item;
 }
+
+// Attributes needed to create container nodes
+QList<QString> container_node_attributes() {
+    // NOTE: object category is needed for icon
+    const QList<QString> out = {
+        ATTRIBUTE_OBJECT_CATEGORY,
+        ATTRIBUTE_NAME,
+    };
+
+    return out;
+}
+
+// NOTE: placeholder is the fake child added to nodes which
+// haven't been fetched yet
+void remove_placeholder_node(QStandardItem *parent) {
+    for (int row = parent->rowCount() - 1; row >= 0; row--) {
+        QStandardItem *child = parent->child(row, 0);
+        const QString dn = child->data(ContainerRole_DN).toString();
+
+        if (dn.isEmpty()) {
+            parent->removeRow(row);
+        }
+    }
+}
@@ -24,14 +24,26 @@
 /**
  * Displays a tree of container objects, similarly to
  * Containers widget. User can selected a container.
+ * Containers are loaded in background. When a container is
+ * expanded, containers below it's children are prefetched
+ * so that expanding them is instant. If console is given,
+ * containers which were already fetched in the console's
+ * object tree are copied from there instead of being
+ * loaded again.
  */
 
 #include <QDialog>
+#include <QHash>
+#include <QPersistentModelIndex>
+#include <QSet>
 
 class QTreeView;
 class QStandardItemModel;
 class QSortFilterProxyModel;
 class AdInterface;
+class AdObject;
+class ConsoleWidget;
+class ContainerFetchThread;
 
 namespace Ui {
 class SelectContainerDialog;
@@ -40,6 +52,7 @@ class SelectContainerDialog;
 enum ContainerRole {
     ContainerRole_DN = Qt::UserRole + 1,
     ContainerRole_Fetched = Qt::UserRole + 2,
+    ContainerRole_Fetching = Qt::UserRole + 3,
 };
 
 class SelectContainerDialog : public QDialog {
@@ -48,7 +61,7 @@ class SelectContainerDialog : public QDialog {
 public:
     Ui::SelectContainerDialog *ui;
 
-    SelectContainerDialog(AdInterface &ad, QWidget *parent);
+    SelectContainerDialog(AdInterface &ad, QWidget *parent, ConsoleWidget *console = nullptr);
     ~SelectContainerDialog();
 
     QString get_selected() const;
@@ -56,9 +69,16 @@ public:
 private:
     QStandardItemModel *model;
     QSortFilterProxyModel *proxy_model;
+    ConsoleWidget *console;
+    QHash<QString, QPersistentModelIndex> dn_to_index_map;
+    QSet<ContainerFetchThread *> thread_set;
 
-    void fetch_node(const QModelIndex &proxy_index);
-    void on_item_expanded(const QModelIndex &index);
+    void fetch_nodes(const QList<QModelIndex> &index_list);
+    void prefetch_children(const QModelIndex &index);
+    bool load_node_from_console(const QModelIndex &index);
+    void add_nodes(const QModelIndex &parent_index, const QList<AdObject> &object_list);
+    void on_node_fetched(const QModelIndex &index);
+    void on_item_expanded(const QModelIndex &proxy_index);
 };
 
 #endif /* SELECT_CONTAINER_DIALOG_H */
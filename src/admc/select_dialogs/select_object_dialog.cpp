@@ -24,12 +24,24 @@
 #include "adldap.h"
 #include "console_impls/object_impl.h"
 #include "globals.h"
+#include "search_thread.h"
 #include "select_object_advanced_dialog.h"
 #include "select_object_match_dialog.h"
 #include "settings.h"
 #include "utils.h"
 
+#include <QAbstractItemView>
+#include <QCompleter>
 #include <QStandardItemModel>
+#include <QTimer>
+
+// Delay between last edit of name and search for
+// completions, in milliseconds
+#define NAME_SEARCH_DELAY 300
+#define NAME_SEARCH_SIZE_LIMIT 50
+
+QString select_object_name_filter(const QString &name, const QString &classes_filter);
+QList<QString> select_object_search_attributes();
 
 enum SelectColumn {
     SelectColumn_Name,
@@ -72,9 +84,37 @@ SelectObjectDialog::SelectObjectDialog(const QList<QString> class_list_arg, cons
     connect(
         ui->advanced_button, &QPushButton::clicked,
         this, &SelectObjectDialog::open_advanced_dialog);
+
+    name_search_thread = nullptr;
+
+    name_search_timer = new QTimer(this);
+    name_search_timer->setSingleShot(true);
+    name_search_timer->setInterval(NAME_SEARCH_DELAY);
+
+    completer_model = new QStandardItemModel(this);
+
+    // NOTE: completions are already filtered by the
+    // search, and ANR matches may not start with the
+    // entered text, so completer shouldn't filter them
+    completer = new QCompleter(completer_model, this);
+    completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    ui->name_edit->setCompleter(completer);
+
+    connect(
+        ui->name_edit, &QLineEdit::textChanged,
+        this, &SelectObjectDialog::on_name_edited);
+    connect(
+        name_search_timer, &QTimer::timeout,
+        this, &SelectObjectDialog::start_name_search);
+    connect(
+        completer, QOverload<const QModelIndex &>::of(&QCompleter::activated),
+        this, &SelectObjectDialog::on_completion_activated);
 }
 
 SelectObjectDialog::~SelectObjectDialog() {
+    // NOTE: thread deletes itself when it finishes
+    cancel_name_search();
+
     settings_save_header_state(SETTING_select_object_header_state, ui->view->header());
 
     delete ui;
@@ -136,42 +176,38 @@ void SelectObjectDialog::accept() {
 }
 
 void SelectObjectDialog::on_add_button() {
-    if (ui->name_edit->text().isEmpty()) {
+    const QString entered_name = ui->name_edit->text();
+    if (entered_name.isEmpty()) {
         return;
     }
 
-    AdInterface ad;
-    if (ad_failed(ad, this)) {
-        return;
-    }
+    cancel_name_search();
+    completer->popup()->hide();
 
     const QString base = ui->select_base_widget->get_base();
+    const QString classes_filter = ui->select_classes_widget->get_filter();
 
-    const QString filter = [&]() {
-        const QString entered_name = ui->name_edit->text();
-
-        const QString name_filter = filter_OR({
-            filter_CONDITION(Condition_StartsWith, ATTRIBUTE_NAME, entered_name),
-            filter_CONDITION(Condition_StartsWith, ATTRIBUTE_CN, entered_name),
-            filter_CONDITION(Condition_StartsWith, ATTRIBUTE_SAM_ACCOUNT_NAME, entered_name),
-            filter_CONDITION(Condition_StartsWith, ATTRIBUTE_USER_PRINCIPAL_NAME, entered_name),
-        });
+    QHash<QString, AdObject> search_results;
+    const bool got_local_results = get_local_results(entered_name, base, classes_filter, &search_results);
 
-        const QString classes_filter = ui->select_classes_widget->get_filter();
-
-        const QString out = filter_AND({
-            name_filter,
-            classes_filter,
-        });
+    if (!got_local_results) {
+        AdInterface ad;
+        if (ad_failed(ad, this)) {
+            return;
+        }
 
-        return out;
-    }();
+        const QString filter = select_object_name_filter(entered_name, classes_filter);
+        search_results = ad.search(base, SearchScope_All, filter, select_object_search_attributes());
 
-    const QHash<QString, AdObject> search_results = ad.search(base, SearchScope_All, filter, console_object_search_attributes());
+        // NOTE: results of failed search may be
+        // incomplete, so can't be reused
+        if (!ad.any_error_messages()) {
+            save_results(entered_name, base, classes_filter, search_results);
+        }
+    }
 
     if (search_results.size() == 1) {
-        const QString dn = search_results.keys()[0];
-        add_objects_to_list({dn}, ad);
+        add_objects_to_list(search_results.values());
     } else if (search_results.size() > 1) {
         // Open dialog where you can select one of the matches
         auto dialog = new SelectObjectMatchDialog(search_results, this);
@@ -180,10 +216,15 @@ void SelectObjectDialog::on_add_button() {
         connect(
             dialog, &QDialog::accepted,
             this,
-            [this, dialog]() {
+            [this, dialog, search_results]() {
                 const QList<QString> selected_matches = dialog->get_selected();
 
-                add_objects_to_list(selected_matches);
+                QList<AdObject> object_list;
+                for (const QString &dn : selected_matches) {
+                    object_list.append(search_results[dn]);
+                }
+
+                add_objects_to_list(object_list);
             });
     } else if (search_results.size() == 0) {
         // Warn about failing to find any matches
@@ -191,6 +232,184 @@ void SelectObjectDialog::on_add_button() {
     }
 }
 
+void SelectObjectDialog::on_name_edited() {
+    const QString name = ui->name_edit->text();
+
+    if (name.trimmed().isEmpty()) {
+        cancel_name_search();
+        load_completions(QHash<QString, AdObject>());
+    } else {
+        name_search_timer->start();
+    }
+}
+
+// Searches for objects matching entered name in the
+// background, to show them as completions. Search is
+// limited to a small number of objects, because only the
+// first few completions are useful.
+void SelectObjectDialog::start_name_search() {
+    cancel_name_search();
+
+    const QString name = ui->name_edit->text();
+    const QString base = ui->select_base_widget->get_base();
+    const QString classes_filter = ui->select_classes_widget->get_filter();
+
+    QHash<QString, AdObject> local_results;
+    const bool got_local_results = get_local_results(name, base, classes_filter, &local_results);
+    if (got_local_results) {
+        load_completions(local_results);
+
+        return;
+    }
+
+    const QString filter = select_object_name_filter(name, classes_filter);
+    auto thread = new SearchThread(base, SearchScope_All, filter, select_object_search_attributes());
+    thread->set_size_limit(NAME_SEARCH_SIZE_LIMIT);
+
+    name_search_thread = thread;
+    name_search_results.clear();
+
+    // NOTE: results of superseded searches are ignored
+    connect(
+        thread, &SearchThread::results_ready,
+        this,
+        [this, thread](const QHash<QString, AdObject> &results) {
+            if (thread != name_search_thread) {
+                return;
+            }
+
+            for (const AdObject &object : results) {
+                name_search_results.insert(object.get_dn(), object);
+            }
+        });
+    connect(
+        thread, &SearchThread::finished,
+        this,
+        [this, thread, name, base, classes_filter]() {
+            if (thread != name_search_thread) {
+                return;
+            }
+
+            name_search_thread = nullptr;
+
+            // NOTE: results that hit the size limit are
+            // shown but can't be reused
+            if (thread->is_complete()) {
+                save_results(name, base, classes_filter, name_search_results);
+            }
+
+            load_completions(name_search_results);
+        });
+
+    // NOTE: not deleting thread in the slot above because
+    // dialog may be closed before thread finishes
+    connect(
+        thread, &SearchThread::finished,
+        thread, &QObject::deleteLater);
+
+    thread->start();
+}
+
+void SelectObjectDialog::cancel_name_search() {
+    name_search_timer->stop();
+
+    if (name_search_thread != nullptr) {
+        name_search_thread->stop();
+        name_search_thread = nullptr;
+    }
+}
+
+void SelectObjectDialog::load_completions(const QHash<QString, AdObject> &results) {
+    completer_results = results;
+    completer_model->clear();
+
+    for (const AdObject &object : results) {
+        auto item = new QStandardItem();
+        console_object_item_data_load(item, object);
+
+        const QString dn = object.get_dn();
+        const QString name = dn_get_name(dn);
+        const QString folder = dn_get_parent_canonical(dn);
+        const QString text = QString("%1 (%2)").arg(name, folder);
+        item->setText(text);
+
+        completer_model->appendRow(item);
+    }
+
+    completer_model->sort(0);
+
+    if (!results.isEmpty() && ui->name_edit->hasFocus()) {
+        completer->complete();
+    }
+}
+
+void SelectObjectDialog::on_completion_activated(const QModelIndex &index) {
+    const QString dn = index.data(ObjectRole_DN).toString();
+    if (!completer_results.contains(dn)) {
+        return;
+    }
+
+    const AdObject object = completer_results[dn];
+
+    // NOTE: line edit sets text of completion after this
+    // signal, so add object later. Otherwise that text
+    // would replace the clearing of line edit done by
+    // add_objects_to_list().
+    QTimer::singleShot(0, this,
+        [this, object]() {
+            add_objects_to_list({object});
+        });
+}
+
+// Gets results for name from results of last search, if
+// possible. Objects found by ANR for a name are a subset
+// of objects found for a prefix of that name, so if last
+// search was for a prefix, it's enough to filter its
+// results.
+bool SelectObjectDialog::get_local_results(const QString &name, const QString &base, const QString &classes_filter, QHash<QString, AdObject> *out) const {
+    const bool same_search = (!last_name.isEmpty() && base == last_base && classes_filter == last_classes_filter);
+    if (!same_search) {
+        return false;
+    }
+
+    if (name == last_name) {
+        *out = last_results;
+
+        return true;
+    }
+
+    // NOTE: names that start with "=" request an exact
+    // match, which can't be refined
+    const bool name_is_longer = (name.startsWith(last_name, Qt::CaseInsensitive) && !last_name.startsWith('='));
+    if (!name_is_longer) {
+        return false;
+    }
+
+    const QString filter = select_object_name_filter(name, classes_filter);
+
+    FilterNode filter_node;
+    const bool parse_success = filter_parse(filter, &filter_node);
+    if (!parse_success || !filter_can_match_locally(filter_node, select_object_search_attributes(), g_adconfig)) {
+        return false;
+    }
+
+    out->clear();
+    for (const AdObject &object : last_results) {
+        if (filter_match(filter_node, object, g_adconfig)) {
+            out->insert(object.get_dn(), object);
+        }
+    }
+
+    return true;
+}
+
+void SelectObjectDialog::save_results(const QString &name, const QString &base, const QString &classes_filter, const QHash<QString, AdObject> &results) {
+    last_results = results;
+    last_name = name;
+    last_base = base;
+    last_classes_filter = classes_filter;
+}
+
 void SelectObjectDialog::on_remove_button() {
     const QList<QPersistentModelIndex> selected = persistent_index_list(ui->view->selectionModel()->selectedRows());
 
@@ -213,39 +432,38 @@ void SelectObjectDialog::open_advanced_dialog() {
         });
 }
 
+// NOTE: advanced dialog returns only DN's, so objects are
+// loaded again
 void SelectObjectDialog::add_objects_to_list(const QList<QString> &dn_list) {
     AdInterface ad;
     if (ad_failed(ad, this)) {
         return;
     }
 
-    add_objects_to_list(dn_list, ad);
+    QList<AdObject> object_list;
+    for (const QString &dn : dn_list) {
+        const AdObject object = ad.search_object_cached(dn);
+        object_list.append(object);
+    }
+
+    add_objects_to_list(object_list);
 }
 
 // Adds objects to the list of selected objects. If list
 // contains objects that are already in list, they won't be
 // added and a message box will open warning user about
 // that.
-// NOTE: this is slightly inefficient because we search for
-// objects again, when they already were searched for by
-// callers of this f-n, in other words we don't reuse search
-// results. For majority of cases this is fine. For rare
-// cases where user is selecting truly huge amounts of
-// objects, they can wait. The alternative of caching
-// objects everywhere adds too much complexity.
-void SelectObjectDialog::add_objects_to_list(const QList<QString> &dn_list, AdInterface &ad) {
+void SelectObjectDialog::add_objects_to_list(const QList<AdObject> &object_list) {
     const QList<QString> current_selected_list = get_selected();
 
     bool any_duplicates = false;
 
-    for (const QString &dn : dn_list) {
-        const bool is_duplicate = current_selected_list.contains(dn);
+    for (const AdObject &object : object_list) {
+        const bool is_duplicate = current_selected_list.contains(object.get_dn());
 
         if (is_duplicate) {
             any_duplicates = true;
         } else {
-            const AdObject object = ad.search_object(dn);
-
             add_select_object_to_model(model, object);
         }
     }
@@ -274,3 +492,25 @@ void add_select_object_to_model(QStandardItemModel *model, const AdObject &objec
 
     model->appendRow(row);
 }
+
+// NOTE: names are resolved using ambiguous name
+// resolution, which matches name, display name, logon name,
+// first and last name and some other attributes
+QString select_object_name_filter(const QString &name, const QString &classes_filter) {
+    const QString out = filter_AND({
+        filter_CONDITION(Condition_Equals, ATTRIBUTE_ANR, name),
+        classes_filter,
+    });
+
+    return out;
+}
+
+// NOTE: also load attributes used by ANR, so that results
+// can be refined locally
+QList<QString> select_object_search_attributes() {
+    QList<QString> out = console_object_search_attributes();
+    out += filter_get_anr_attributes(g_adconfig);
+    out.removeDuplicates();
+
+    return out;
+}
@@ -22,10 +22,14 @@
 #define SELECT_OBJECT_DIALOG_H
 
 #include <QDialog>
+#include <QHash>
 
 class QStandardItemModel;
+class QCompleter;
+class QTimer;
+class QModelIndex;
 class AdObject;
-class AdInterface;
+class SearchThread;
 
 namespace Ui {
 class SelectObjectDialog;
@@ -63,10 +67,36 @@ private:
     QList<QString> class_list;
     SelectObjectDialogMultiSelection multi_selection;
 
+    // Results of last complete search done on the server.
+    // If user enters same name or a longer name with same
+    // prefix, results are reused or refined locally
+    // instead of searching again.
+    QHash<QString, AdObject> last_results;
+    QString last_name;
+    QString last_base;
+    QString last_classes_filter;
+
+    // Search for completions which is started when user
+    // stops typing
+    QTimer *name_search_timer;
+    SearchThread *name_search_thread;
+    QHash<QString, AdObject> name_search_results;
+
+    QCompleter *completer;
+    QStandardItemModel *completer_model;
+    QHash<QString, AdObject> completer_results;
+
     void on_add_button();
     void on_remove_button();
+    void on_name_edited();
+    void start_name_search();
+    void cancel_name_search();
+    void load_completions(const QHash<QString, AdObject> &results);
+    void on_completion_activated(const QModelIndex &index);
+    bool get_local_results(const QString &name, const QString &base, const QString &classes_filter, QHash<QString, AdObject> *out) const;
+    void save_results(const QString &name, const QString &base, const QString &classes_filter, const QHash<QString, AdObject> &results);
     void add_objects_to_list(const QList<QString> &dn_list);
-    void add_objects_to_list(const QList<QString> &dn_list, AdInterface &ad);
+    void add_objects_to_list(const QList<AdObject> &object_list);
     void open_advanced_dialog();
 };
 
@@ -49,7 +49,7 @@ SelectPolicyDialog::SelectPolicyDialog(AdInterface &ad, QWidget *parent)
     const QString base = g_adconfig->domain_dn();
     const SearchScope scope = SearchScope_All;
     const QString filter = filter_CONDITION(Condition_Equals, ATTRIBUTE_OBJECT_CLASS, CLASS_GP_CONTAINER);
-    const QList<QString> attributes = QList<QString>();
+    const QList<QString> attributes = console_policy_search_attributes();
 
     const QHash<QString, AdObject> results = ad.search(base, scope, filter, attributes);
 
@@ -65,6 +65,9 @@ DEFINE_SETTING(SETTING_object_multi_dialog_geometry);
 DEFINE_SETTING(SETTING_connection_options_dialog_geometry);
 DEFINE_SETTING(SETTING_changelog_dialog_geometry);
 DEFINE_SETTING(SETTING_error_log_dialog_geometry);
+DEFINE_SETTING(SETTING_diagnostics_dialog_geometry);
+DEFINE_SETTING(SETTING_gpo_verify_dialog_geometry);
+DEFINE_SETTING(SETTING_export_results_dialog_geometry);
 DEFINE_SETTING(SETTING_select_well_known_trustee_dialog_geometry);
 DEFINE_SETTING(SETTING_select_object_match_dialog_geometry);
 DEFINE_SETTING(SETTING_edit_query_item_dialog_geometry);
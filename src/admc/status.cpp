@@ -23,21 +23,19 @@
 #include "adldap.h"
 #include "error_log_dialog.h"
 #include "globals.h"
-#include "settings.h"
+#include "message_log_model.h"
 
 #include <QCoreApplication>
-#include <QDateTime>
 #include <QDebug>
 #include <QDialog>
 #include <QDialogButtonBox>
 #include <QPlainTextEdit>
 #include <QStatusBar>
-#include <QTextEdit>
 #include <QVBoxLayout>
 
-#define MAX_MESSAGES_IN_LOG 200
+StatusType ad_message_type_to_status_type(const AdMessageType type);
 
-void Status::init(QStatusBar *statusbar, QTextEdit *message_log) {
+void Status::init(QStatusBar *statusbar, MessageLogModel *message_log) {
     m_status_bar = statusbar;
     m_message_log = message_log;
 }
@@ -49,48 +47,7 @@ void Status::add_message(const QString &msg, const StatusType &type) {
 
     m_status_bar->showMessage(msg);
 
-    const QString timestamp = []() {
-        const QDateTime current_datetime = QDateTime::currentDateTime();
-        return current_datetime.toString("hh:mm:ss");
-    }();
-
-    const QString timestamped_msg = QString("%1 %2").arg(timestamp, msg);
-
-    const bool timestamps_ON = settings_get_variant(SETTING_timestamp_log).toBool();
-
-    const QColor color = [type]() {
-        switch (type) {
-            case StatusType_Success: return Qt::darkGreen;
-            case StatusType_Error: return Qt::red;
-        }
-        return Qt::black;
-    }();
-
-    const QColor original_color = m_message_log->textColor();
-    m_message_log->setTextColor(color);
-    if (timestamps_ON) {
-        m_message_log->append(timestamped_msg);
-    } else {
-        m_message_log->append(msg);
-    }
-    m_message_log->setTextColor(original_color);
-
-    // Limit number of messages in log by deleting old ones
-    // once over limit
-    QTextCursor cursor = m_message_log->textCursor();
-    const int message_count = cursor.blockNumber();
-    if (message_count > MAX_MESSAGES_IN_LOG) {
-        cursor.movePosition(QTextCursor::Start);
-        cursor.movePosition(QTextCursor::Down, QTextCursor::MoveAnchor, 0);
-        cursor.select(QTextCursor::LineUnderCursor);
-        cursor.removeSelectedText();
-        cursor.deleteChar();
-    }
-
-    // Move cursor to newest message
-    QTextCursor end_cursor = m_message_log->textCursor();
-    end_cursor.movePosition(QTextCursor::End);
-    m_message_log->setTextCursor(end_cursor);
+    m_message_log->add_message(msg, type);
 }
 
 void Status::display_ad_messages(const QList<AdMessage> &messages, QWidget *parent) {
@@ -111,17 +68,19 @@ void Status::log_messages(const QList<AdMessage> &messages) {
         return;
     }
 
+    if (messages.isEmpty()) {
+        return;
+    }
+
     for (const AdMessage &message : messages) {
-        const StatusType status_type = [message]() {
-            switch (message.type()) {
-                case AdMessageType_Success: return StatusType_Success;
-                case AdMessageType_Error: return StatusType_Error;
-            }
-            return StatusType_Success;
-        }();
+        const StatusType status_type = ad_message_type_to_status_type(message.type());
 
-        add_message(message.text(), status_type);
+        m_message_log->add_message(message.text(), status_type);
     }
+
+    // NOTE: only the last message is shown in status bar,
+    // showing each one would be wasted work
+    m_status_bar->showMessage(messages.last().text());
 }
 
 void Status::log_messages(const AdInterface &ad) {
@@ -163,3 +122,11 @@ void error_log(const QList<QString> error_list, QWidget *parent) {
     error_log_dialog->set_text(errors_text);
     error_log_dialog->open();
 }
+
+StatusType ad_message_type_to_status_type(const AdMessageType type) {
+    switch (type) {
+        case AdMessageType_Success: return StatusType_Success;
+        case AdMessageType_Error: return StatusType_Error;
+    }
+    return StatusType_Success;
+}
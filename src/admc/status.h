@@ -27,7 +27,7 @@
  * error messages in a dialog.
  */
 
-class QTextEdit;
+class MessageLogModel;
 class QStatusBar;
 class QString;
 class QWidget;
@@ -44,7 +44,7 @@ enum StatusType {
 class Status {
 
 public:
-    void init(QStatusBar *statusbar, QTextEdit *message_log);
+    void init(QStatusBar *statusbar, MessageLogModel *message_log);
 
     void add_message(const QString &msg, const StatusType &type);
 
@@ -57,7 +57,7 @@ public:
 
 private:
     QStatusBar *m_status_bar;
-    QTextEdit *m_message_log;
+    MessageLogModel *m_message_log;
 };
 
 // Opens a dialog containing ad error messages in a
@@ -112,7 +112,7 @@ void ManagedByTabEdit::load_manager_edits(AdInterface &ad) {
     const QString manager = manager_edit->get_manager();
 
     if (!manager.isEmpty()) {
-        const AdObject manager_object = ad.search_object(manager);
+        const AdObject manager_object = ad.search_object_cached(manager);
         AttributeEdit::load(manager_edits, ad, manager_object);
     } else {
         AdObject empty_object;
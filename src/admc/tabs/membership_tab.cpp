@@ -134,7 +134,7 @@ void MembershipTabEdit::load(AdInterface &ad, const AdObject &object) {
             const QString base = g_adconfig->domain_dn();
             const SearchScope scope = SearchScope_All;
             const QString filter = filter_CONDITION(Condition_Equals, ATTRIBUTE_PRIMARY_GROUP_ID, group_rid);
-            const QList<QString> attributes = QList<QString>();
+            const QList<QString> attributes = {ATTRIBUTE_DN};
             const QHash<QString, AdObject> results = ad.search(base, scope, filter, attributes);
 
             for (const QString &user : results.keys()) {
@@ -161,7 +161,7 @@ void MembershipTabEdit::load(AdInterface &ad, const AdObject &object) {
             const QString base = g_adconfig->domain_dn();
             const SearchScope scope = SearchScope_All;
             const QString filter = filter_CONDITION(Condition_Equals, ATTRIBUTE_OBJECT_SID, group_sid);
-            const QList<QString> attributes = QList<QString>();
+            const QList<QString> attributes = {ATTRIBUTE_DN};
             const QHash<QString, AdObject> results = ad.search(base, scope, filter, attributes);
 
             if (!results.isEmpty()) {
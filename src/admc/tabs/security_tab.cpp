@@ -489,7 +489,7 @@ void SecurityTabEdit::on_add_trustee_button() {
 
                 const QList<QString> selected_list = dialog->get_selected();
                 for (const QString &dn : selected_list) {
-                    const AdObject object = ad.search_object(dn, {ATTRIBUTE_OBJECT_SID});
+                    const AdObject object = ad.search_object_cached(dn, {ATTRIBUTE_OBJECT_SID});
                     const QByteArray sid = object.get_value(ATTRIBUTE_OBJECT_SID);
 
                     out.append(sid);
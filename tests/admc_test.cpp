@@ -53,6 +53,31 @@
 #define PRINT_FOCUS_WIDGET_BEFORE_TAB false
 #define PRINT_FOCUS_WIDGET_AFTER_TAB false
 
+// NOTE: if ADMC_TEST_DATASET is set to a path of an LDIF
+// file, tests run against an in-memory directory seeded
+// from that file instead of a live domain. Backend has to
+// be installed before the test object and it's
+// AdInterface are created, so this is done during static
+// initialization.
+AdMemoryBackend *test_backend = []() -> AdMemoryBackend * {
+    const QString dataset_path = QString::fromLocal8Bit(qgetenv("ADMC_TEST_DATASET"));
+    if (dataset_path.isEmpty()) {
+        return nullptr;
+    }
+
+    AdMemoryBackend *out = new AdMemoryBackend("DOMAIN.ALT", "dc0.domain.alt", "administrator@domain.alt");
+
+    QString error;
+    const bool load_success = out->load_ldif(dataset_path, &error);
+    if (!load_success) {
+        qFatal("Failed to load test dataset: %s", qPrintable(error));
+    }
+
+    AdInterface::set_backend(out);
+
+    return out;
+}();
+
 void ADMCTest::initTestCase() {
     qRegisterMetaType<QHash<QString, AdObject>>("QHash<QString, AdObject>");
 
@@ -165,6 +190,22 @@ void navigate_until_object(QTreeView *view, const QString &target_dn, const int
         const bool is_parent_of_object = (target_dn.contains(dn));
         if (is_parent_of_object) {
             view->expand(index);
+
+            // NOTE: some models load children in background
+            // and show an empty placeholder child until
+            // children are loaded, wait for that
+            int timer = 0;
+            auto children_are_loading = [&]() {
+                const QModelIndex first_child = model->index(0, 0, index);
+                const bool out = (first_child.isValid() && first_child.data(dn_role).toString().isEmpty());
+
+                return out;
+            };
+            while (index.isValid() && children_are_loading()) {
+                QTest::qWait(1);
+                timer++;
+                QVERIFY2((timer < 1000), "Children failed to load, took too long");
+            }
         }
 
         const bool found_object = (dn == target_dn);
@@ -302,3 +343,26 @@ void test_lineedit_autofill(QLineEdit *src_edit, QLineEdit *dest_edit) {
     const QString actual_dest_text = dest_edit->text();
     QCOMPARE(actual_dest_text, expected_dest_text);
 }
+
+AdMemoryBackend *test_memory_backend_new() {
+    AdMemoryBackend *out = new AdMemoryBackend("TEST.COM", "dc.test.com", "user@test.com");
+
+    out->add_entry(ROOT_DSE, {
+        {ATTRIBUTE_ROOT_DOMAIN_NAMING_CONTEXT, {TEST_MEMORY_DOMAIN_DN}},
+    });
+    out->add_entry(TEST_MEMORY_DOMAIN_DN, {
+        {"objectClass", {"top", "domain", "domainDNS"}},
+    });
+
+    AdInterface::set_backend(out);
+
+    return out;
+}
+
+void test_memory_backend_free(AdMemoryBackend *backend) {
+    // NOTE: restore the dataset backend, if tests run
+    // offline
+    AdInterface::set_backend(test_backend);
+
+    delete backend;
+}
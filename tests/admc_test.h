@@ -47,6 +47,10 @@ class AttributeEdit;
 #define TEST_COMPUTER "ADMCTEST-pc"
 #define TEST_OBJECT "ADMCTEST-object"
 
+// Domain of the in-memory directory created by
+// test_memory_backend_new()
+#define TEST_MEMORY_DOMAIN_DN "DC=test,DC=com"
+
 class ADMCTest : public QObject {
     Q_OBJECT
 
@@ -121,4 +125,15 @@ private:
 void navigate_until_object(QTreeView *view, const QString &target_dn, const int dn_role);
 void test_lineedit_autofill(QLineEdit *src_edit, QLineEdit *dest_edit);
 
+// Creates an in-memory directory that contains only the
+// rootDSE and the domain object and installs it as the
+// backend of AdInterface. Used by tests that don't need a
+// live domain, add the rest of the test data with
+// add_entry(). Free with test_memory_backend_free().
+AdMemoryBackend *test_memory_backend_new();
+
+// Uninstalls and deletes a backend created by
+// test_memory_backend_new()
+void test_memory_backend_free(AdMemoryBackend *backend);
+
 #endif /* ADMC_TEST_H */
@@ -0,0 +1,190 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "admc_test_ad_export.h"
+
+#include "ad_csv.h"
+#include "ad_export.h"
+#include "ad_ldif.h"
+#include "ad_object.h"
+
+#include <QBuffer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+const QString test_dn = "CN=test,DC=test,DC=com";
+
+AdObject make_test_object();
+QByteArray write_test_object(const AdExportFormat format, const AdExportValues values, const QList<QString> &attributes);
+
+// NOTE: adconfig is not loaded in these tests, so display
+// values are same as raw values
+void ADMCTestAdExport::csv() {
+    const QByteArray data = write_test_object(AdExportFormat_Csv, AdExportValues_Display, {"cn", "description", "missing"});
+
+    const QByteArray expected = "dn,cn,description,missing\r\n"
+                                "\"CN=test,DC=test,DC=com\",test,\"say \"\"hi\"\", bye\";second,\r\n";
+
+    QCOMPARE(data, expected);
+}
+
+void ADMCTestAdExport::csv_raw() {
+    const QByteArray data = write_test_object(AdExportFormat_Csv, AdExportValues_Raw, {"cn"});
+
+    const QByteArray expected = "dn,cn\r\n"
+                                "\"CN=test,DC=test,DC=com\",dGVzdA==\r\n";
+
+    QCOMPARE(data, expected);
+}
+
+void ADMCTestAdExport::json_lines() {
+    const QByteArray data = write_test_object(AdExportFormat_JsonLines, AdExportValues_Display, {"cn", "description", "missing"});
+
+    QVERIFY(data.endsWith('\n'));
+    QCOMPARE(data.count('\n'), 1);
+
+    const QJsonObject json_object = QJsonDocument::fromJson(data).object();
+    QCOMPARE(json_object["dn"].toString(), test_dn);
+    QCOMPARE(json_object["cn"].toArray(), QJsonArray({"test"}));
+    QCOMPARE(json_object["description"].toArray(), QJsonArray({"say \"hi\", bye", "second"}));
+    QVERIFY(!json_object.contains("missing"));
+}
+
+void ADMCTestAdExport::ldif() {
+    const QByteArray data = write_test_object(AdExportFormat_Ldif, AdExportValues_Raw, {"cn", "objectSid"});
+
+    QList<LdifEntry> entry_list;
+    QString error;
+    const bool success = ldif_parse(data, &entry_list, &error);
+
+    QVERIFY(success);
+    QCOMPARE(entry_list.size(), 1);
+    QCOMPARE(entry_list[0].dn, test_dn);
+    QCOMPARE(entry_list[0].attributes["cn"], QList<QByteArray>({"test"}));
+    QCOMPARE(entry_list[0].attributes["objectSid"], QList<QByteArray>({QByteArray("\x01\x00\x02", 3)}));
+}
+
+void ADMCTestAdExport::ldif_write_round_trip() {
+    LdifEntry entry;
+    entry.dn = test_dn;
+    entry.attributes["plain"] = {"value"};
+    entry.attributes["leading_space"] = {" value"};
+    entry.attributes["trailing_space"] = {"value "};
+    entry.attributes["colon"] = {":value"};
+    entry.attributes["utf8"] = {QString::fromUtf8("\xd0\xb8\xd0\xbc\xd1\x8f").toUtf8()};
+    entry.attributes["long"] = {QByteArray(200, 'a')};
+    entry.attributes["multi"] = {"first", "second"};
+
+    const QByteArray data = ldif_write_entry(entry);
+
+    // Lines are folded
+    for (const QByteArray &line : data.split('\n')) {
+        QVERIFY(line.size() <= 76);
+    }
+
+    QVERIFY(data.contains("plain: value\n"));
+
+    QList<LdifEntry> entry_list;
+    QString error;
+    const bool success = ldif_parse(data, &entry_list, &error);
+
+    QVERIFY(success);
+    QCOMPARE(entry_list.size(), 1);
+    QCOMPARE(entry_list[0].dn, entry.dn);
+    QCOMPARE(entry_list[0].attributes, entry.attributes);
+}
+
+// Empty attributes list means all attributes
+void ADMCTestAdExport::json_lines_all_attributes() {
+    const QByteArray data = write_test_object(AdExportFormat_JsonLines, AdExportValues_Raw, {});
+
+    const QJsonObject json_object = QJsonDocument::fromJson(data).object();
+    QCOMPARE(json_object.keys(), QStringList({"cn", "description", "dn", "objectSid"}));
+}
+
+void ADMCTestAdExport::csv_parse() {
+    const QByteArray data = "dn,description\r\n"
+                            "\"CN=a,DC=test,DC=com\",\"multi\nline, \"\"quoted\"\"\"\r\n"
+                            "CN=b,\n"
+                            "CN=c,last";
+
+    QList<QList<QString>> row_list;
+    QString error;
+    const bool success = ::csv_parse(data, &row_list, &error);
+
+    QVERIFY(success);
+    QCOMPARE(row_list.size(), 4);
+    QCOMPARE(row_list[0], QList<QString>({"dn", "description"}));
+    QCOMPARE(row_list[1], QList<QString>({"CN=a,DC=test,DC=com", "multi\nline, \"quoted\""}));
+    QCOMPARE(row_list[2], QList<QString>({"CN=b", ""}));
+    QCOMPARE(row_list[3], QList<QString>({"CN=c", "last"}));
+
+    // Output of export writer can be read back
+    const QByteArray exported = write_test_object(AdExportFormat_Csv, AdExportValues_Display, {"description"});
+
+    QList<QList<QString>> exported_row_list;
+    const bool exported_success = ::csv_parse(exported, &exported_row_list, &error);
+
+    QVERIFY(exported_success);
+    QCOMPARE(exported_row_list.size(), 2);
+    QCOMPARE(exported_row_list[1], QList<QString>({test_dn, "say \"hi\", bye;second"}));
+}
+
+void ADMCTestAdExport::csv_parse_malformed() {
+    const QList<QByteArray> malformed_list = {
+        "a,\"unclosed\n",
+        "a,b\"c\n",
+        "a,\"quoted\"extra\n",
+    };
+
+    for (const QByteArray &data : malformed_list) {
+        QList<QList<QString>> row_list;
+        QString error;
+        const bool success = ::csv_parse(data, &row_list, &error);
+
+        QVERIFY(!success);
+        QVERIFY(!error.isEmpty());
+    }
+}
+
+AdObject make_test_object() {
+    AdObject object;
+    object.load(test_dn, {
+        {"cn", {"test"}},
+        {"description", {"say \"hi\", bye", "second"}},
+        {"objectSid", {QByteArray("\x01\x00\x02", 3)}},
+    });
+
+    return object;
+}
+
+QByteArray write_test_object(const AdExportFormat format, const AdExportValues values, const QList<QString> &attributes) {
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+
+    AdExportWriter writer(&buffer, format, values, attributes, nullptr);
+    writer.write_header();
+    writer.write_object(make_test_object());
+
+    return buffer.data();
+}
+
+QTEST_MAIN(ADMCTestAdExport)
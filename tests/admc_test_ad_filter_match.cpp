@@ -0,0 +1,203 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "admc_test_ad_filter_match.h"
+
+#include "ad_config.h"
+#include "ad_filter_match.h"
+#include "ad_filter_tree.h"
+#include "ad_interface.h"
+#include "ad_object.h"
+#include "admc_test.h"
+
+#include <algorithm>
+
+const QString object_dn = "CN=Test User,CN=Users,DC=test,DC=com";
+
+void ADMCTestAdFilterMatch::match_data() {
+    QTest::addColumn<QString>("filter");
+    QTest::addColumn<bool>("expected");
+
+    QTest::newRow("equal") << "(sAMAccountName=testuser)" << true;
+    QTest::newRow("equal case insensitive") << "(samaccountname=TESTUSER)" << true;
+    QTest::newRow("not equal") << "(sAMAccountName=other)" << false;
+    QTest::newRow("multi-valued") << "(objectClass=user)" << true;
+    QTest::newRow("present") << "(description=*)" << true;
+    QTest::newRow("not present") << "(mail=*)" << false;
+    QTest::newRow("starts with") << "(name=test*)" << true;
+    QTest::newRow("ends with") << "(name=*user)" << true;
+    QTest::newRow("contains") << "(name=*t u*)" << true;
+    QTest::newRow("substring mismatch") << "(name=*x*)" << false;
+    QTest::newRow("escaped value") << "(description=a\\2ab)" << true;
+    QTest::newRow("greater number") << "(logonCount>=9)" << true;
+    QTest::newRow("less number") << "(logonCount<=9)" << false;
+    QTest::newRow("bit and") << "(userAccountControl:1.2.840.113556.1.4.803:=514)" << true;
+    QTest::newRow("bit and mismatch") << "(userAccountControl:1.2.840.113556.1.4.803:=16)" << false;
+    QTest::newRow("bit or") << "(userAccountControl:1.2.840.113556.1.4.804:=18)" << true;
+    QTest::newRow("bit and signed") << "(groupType:1.2.840.113556.1.4.803:=2147483648)" << true;
+    QTest::newRow("dn") << "(distinguishedName=cn=test user,cn=users,dc=test,dc=com)" << true;
+    QTest::newRow("short category") << "(objectCategory=person)" << true;
+    QTest::newRow("and") << "(&(objectClass=user)(name=test*))" << true;
+    QTest::newRow("and mismatch") << "(&(objectClass=user)(name=x*))" << false;
+    QTest::newRow("or") << "(|(objectClass=group)(name=test*))" << true;
+    QTest::newRow("not") << "(!(objectClass=computer))" << true;
+    QTest::newRow("anr prefix") << "(anr=TESTU)" << true;
+    QTest::newRow("anr mismatch") << "(anr=user)" << false;
+    QTest::newRow("anr first last") << "(anr=john sm)" << true;
+    QTest::newRow("anr last first") << "(anr=smith j)" << true;
+    QTest::newRow("anr exact") << "(anr==testuser)" << true;
+    QTest::newRow("anr exact mismatch") << "(anr==test)" << false;
+}
+
+void ADMCTestAdFilterMatch::match() {
+    QFETCH(QString, filter);
+    QFETCH(bool, expected);
+
+    AdObject object;
+    object.load(object_dn, {
+        {"objectClass", {"top", "person", "organizationalPerson", "user"}},
+        {"objectCategory", {"CN=Person,CN=Schema,CN=Configuration,DC=test,DC=com"}},
+        {"name", {"Test User"}},
+        {"sAMAccountName", {"testuser"}},
+        {"givenName", {"John"}},
+        {"sn", {"Smith"}},
+        {"description", {"a*b"}},
+        {"logonCount", {"10"}},
+        {"userAccountControl", {"514"}},
+        {"groupType", {"-2147483646"}},
+    });
+
+    FilterNode filter_node;
+    const bool parse_success = filter_parse(filter, &filter_node);
+    QVERIFY(parse_success);
+
+    const bool match = filter_match(filter_node, object, nullptr);
+    QCOMPARE(match, expected);
+}
+
+void ADMCTestAdFilterMatch::can_match_locally_data() {
+    QTest::addColumn<QString>("filter");
+    QTest::addColumn<bool>("expected");
+
+    QTest::newRow("loaded") << "(&(name=x)(objectClass=user))" << true;
+    QTest::newRow("loaded case insensitive") << "(NAME=x)" << true;
+    QTest::newRow("dn") << "(distinguishedName=x)" << true;
+    QTest::newRow("not loaded") << "(&(name=x)(description=y))" << false;
+    QTest::newRow("bit rule") << "(objectClass:1.2.840.113556.1.4.803:=2)" << true;
+    QTest::newRow("in chain") << "(memberOf:1.2.840.113556.1.4.1941:=CN=x)" << false;
+    QTest::newRow("dn attributes") << "(name:dn:=x)" << false;
+    QTest::newRow("anr") << "(anr=x)" << false;
+}
+
+void ADMCTestAdFilterMatch::can_match_locally() {
+    QFETCH(QString, filter);
+    QFETCH(bool, expected);
+
+    FilterNode filter_node;
+    const bool parse_success = filter_parse(filter, &filter_node);
+    QVERIFY(parse_success);
+
+    const bool can_match = filter_can_match_locally(filter_node, {"name", "objectClass"}, nullptr);
+    QCOMPARE(can_match, expected);
+}
+
+void ADMCTestAdFilterMatch::is_narrowing_data() {
+    QTest::addColumn<QString>("narrow");
+    QTest::addColumn<QString>("wide");
+    QTest::addColumn<bool>("expected");
+
+    QTest::newRow("same") << "(name=x)" << "(name=x)" << true;
+    QTest::newRow("extra term") << "(&(name=x)(cn=y))" << "(name=x)" << true;
+    QTest::newRow("nested") << "(&(&(a=1)(b=2))(c=3))" << "(&(b=2)(a=1))" << true;
+    QTest::newRow("missing term") << "(&(a=1)(c=3))" << "(&(a=1)(b=2))" << false;
+    QTest::newRow("or is not narrower") << "(|(a=1)(b=2))" << "(a=1)" << false;
+    QTest::newRow("malformed") << "(a=1" << "(a=1)" << false;
+}
+
+void ADMCTestAdFilterMatch::is_narrowing() {
+    QFETCH(QString, narrow);
+    QFETCH(QString, wide);
+    QFETCH(bool, expected);
+
+    QCOMPARE(filter_is_narrowing(narrow, wide), expected);
+}
+
+// NOTE: ANR attributes come from schema, which can have
+// more of them than the default set
+void ADMCTestAdFilterMatch::anr_schema() {
+    const QString configuration_dn = QString("CN=Configuration,%1").arg(TEST_MEMORY_DOMAIN_DN);
+    const QString schema_dn = QString("CN=Schema,%1").arg(configuration_dn);
+
+    AdMemoryBackend *backend = test_memory_backend_new();
+
+    backend->add_entry("", {
+        {"rootDomainNamingContext", {TEST_MEMORY_DOMAIN_DN}},
+        {"configurationNamingContext", {configuration_dn.toUtf8()}},
+        {"schemaNamingContext", {schema_dn.toUtf8()}},
+    });
+    // NOTE: adconfig loads domain sid
+    backend->add_entry(TEST_MEMORY_DOMAIN_DN, {
+        {"objectClass", {"top", "domain", "domainDNS"}},
+        {"objectSid", {QByteArray::fromBase64("AQQAAAAAAAUVAAAA6AMAANAHAAC4CwAA")}},
+    });
+    backend->add_entry(configuration_dn, {
+        {"objectClass", {"top", "configuration"}},
+    });
+    backend->add_entry(schema_dn, {
+        {"objectClass", {"top", "dMD"}},
+    });
+
+    auto add_attribute = [&](const QString &name, const QString &search_flags) {
+        backend->add_entry(QString("CN=%1,%2").arg(name, schema_dn), {
+            {"objectClass", {"top", "attributeSchema"}},
+            {"lDAPDisplayName", {name.toUtf8()}},
+            {"searchFlags", {search_flags.toUtf8()}},
+        });
+    };
+
+    add_attribute("displayName", "5");
+    add_attribute("msDS-PhoneticDisplayName", "5");
+    add_attribute("description", "1");
+
+    AdInterface ad;
+    AdConfig adconfig;
+    adconfig.load(ad, QLocale(QLocale::English));
+
+    test_memory_backend_free(backend);
+
+    QList<QString> anr_attributes = filter_get_anr_attributes(&adconfig);
+    std::sort(anr_attributes.begin(), anr_attributes.end());
+    QCOMPARE(anr_attributes, QList<QString>({"displayName", "msDS-PhoneticDisplayName"}));
+
+    FilterNode filter_node;
+    filter_parse("(anr=smi)", &filter_node);
+
+    AdObject object;
+    object.load(object_dn, {
+        {"msDS-PhoneticDisplayName", {"smith"}},
+    });
+    QVERIFY(filter_match(filter_node, object, &adconfig));
+    QVERIFY(!filter_match(filter_node, object, nullptr));
+
+    QVERIFY(!filter_can_match_locally(filter_node, {"displayName"}, &adconfig));
+    QVERIFY(filter_can_match_locally(filter_node, anr_attributes, &adconfig));
+}
+
+QTEST_MAIN(ADMCTestAdFilterMatch)
@@ -0,0 +1,206 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "admc_test_ad_filter_tree.h"
+
+#include "ad_config.h"
+#include "ad_filter.h"
+#include "ad_filter_tree.h"
+#include "ad_interface.h"
+#include "admc_test.h"
+
+const QString configuration_dn = QString("CN=Configuration,%1").arg(TEST_MEMORY_DOMAIN_DN);
+const QString schema_dn = QString("CN=Schema,%1").arg(configuration_dn);
+
+void ADMCTestAdFilterTree::escape() {
+    const QString escaped = filter_escape("a*b(c)\\d");
+    QCOMPARE(escaped, QString("a\\2ab\\28c\\29\\5cd"));
+
+    // NOTE: non-ASCII text is left as is
+    const QString unicode = QString::fromUtf8("тест");
+    QCOMPARE(filter_escape(unicode), unicode);
+
+    QCOMPARE(filter_unescape(escaped), QByteArray("a*b(c)\\d"));
+}
+
+void ADMCTestAdFilterTree::escape_bytes() {
+    const QByteArray value = QByteArray::fromHex("01ff2a41");
+    const QString escaped = filter_escape_bytes(value);
+    QCOMPARE(escaped, QString("\\01\\ff\\2aA"));
+    QCOMPARE(filter_unescape(escaped), value);
+}
+
+void ADMCTestAdFilterTree::condition_escape() {
+    QCOMPARE(filter_CONDITION(Condition_Equals, "name", "a*b"), QString("(name=a\\2ab)"));
+    QCOMPARE(filter_CONDITION(Condition_Contains, "name", "(x)"), QString("(name=*\\28x\\29*)"));
+    QCOMPARE(filter_CONDITION(Condition_StartsWith, "name", "x"), QString("(name=x*)"));
+    QCOMPARE(filter_CONDITION(Condition_EndsWith, "name", "x"), QString("(name=*x)"));
+    QCOMPARE(filter_CONDITION(Condition_NotEquals, "name", "x"), QString("(!(name=x))"));
+    QCOMPARE(filter_CONDITION(Condition_Set, "name"), QString("(name=*)"));
+    QCOMPARE(filter_CONDITION(Condition_Unset, "name"), QString("(!(name=*))"));
+}
+
+void ADMCTestAdFilterTree::parse_serialize_data() {
+    QTest::addColumn<QString>("filter");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("equal") << "(name=x)" << "(name=x)";
+    QTest::newRow("no parentheses") << "name=x" << "(name=x)";
+    QTest::newRow("whitespace") << "  (name=x) " << "(name=x)";
+    QTest::newRow("approx") << "(name~=x)" << "(name~=x)";
+    QTest::newRow("greater") << "(uSNChanged>=100)" << "(uSNChanged>=100)";
+    QTest::newRow("less") << "(uSNChanged<=100)" << "(uSNChanged<=100)";
+    QTest::newRow("present") << "(name=*)" << "(name=*)";
+    QTest::newRow("substring") << "(name=a*b*c)" << "(name=a*b*c)";
+    QTest::newRow("escaped") << "(name=a\\28b\\29\\2a)" << "(name=a\\28b\\29\\2a)";
+    QTest::newRow("extensible") << "(userAccountControl:1.2.840.113556.1.4.803:=2)" << "(userAccountControl:1.2.840.113556.1.4.803:=2)";
+    QTest::newRow("extensible dn") << "(ou:dn:=x)" << "(ou:dn:=x)";
+    QTest::newRow("nested") << "(&(name=x)(|(cn=a*)(cn=*b))(!(sn=*)))" << "(&(name=x)(|(cn=a*)(cn=*b))(!(sn=*)))";
+}
+
+void ADMCTestAdFilterTree::parse_serialize() {
+    QFETCH(QString, filter);
+    QFETCH(QString, expected);
+
+    FilterNode node;
+    const bool parse_success = filter_parse(filter, &node);
+    QVERIFY(parse_success);
+
+    const QString serialized = filter_serialize(node);
+    QCOMPARE(serialized, expected);
+}
+
+void ADMCTestAdFilterTree::parse_malformed_data() {
+    QTest::addColumn<QString>("filter");
+
+    QTest::newRow("empty") << "";
+    QTest::newRow("open") << "(";
+    QTest::newRow("unclosed") << "(name=x";
+    QTest::newRow("unclosed and") << "(&(name=x)";
+    QTest::newRow("extra closing") << "(name=x))";
+    QTest::newRow("no attribute") << "(=x)";
+    QTest::newRow("no equals") << "(name)";
+    QTest::newRow("not with two terms") << "(!(a=1)(b=2))";
+}
+
+void ADMCTestAdFilterTree::parse_malformed() {
+    QFETCH(QString, filter);
+
+    FilterNode node;
+    const bool parse_success = filter_parse(filter, &node);
+    QVERIFY(!parse_success);
+}
+
+void ADMCTestAdFilterTree::parse_extensible() {
+    FilterNode node;
+    const bool parse_success = filter_parse("(memberOf:1.2.840.113556.1.4.1941:=CN=x\\2cDC=a)", &node);
+    QVERIFY(parse_success);
+    QCOMPARE(node.type, FilterNodeType_Extensible);
+    QCOMPARE(node.attribute, QString("memberOf"));
+    QCOMPARE(node.rule, QString("1.2.840.113556.1.4.1941"));
+    QCOMPARE(node.dn_attributes, false);
+    QCOMPARE(node.value, QByteArray("CN=x,DC=a"));
+}
+
+void ADMCTestAdFilterTree::optimize_data() {
+    QTest::addColumn<QString>("filter");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("flatten and") << "(&(&(a=1)(b=2))(c=3))" << "(&(a=1)(b=2)(c=3))";
+    QTest::newRow("flatten or") << "(|(a=1)(|(b=2)(c=3)))" << "(|(a=1)(b=2)(c=3))";
+    QTest::newRow("remove duplicates") << "(&(a=1)(b=2)(a=1))" << "(&(a=1)(b=2))";
+    QTest::newRow("unwrap single term") << "(|(a=1)(a=1))" << "(a=1)";
+    QTest::newRow("double negation") << "(!(!(a=1)))" << "(a=1)";
+    QTest::newRow("negation last") << "(&(!(a=1))(b=2))" << "(&(b=2)(!(a=1)))";
+    QTest::newRow("indexed first") << "(&(a=1)(distinguishedName=x))" << "(&(distinguishedName=x)(a=1))";
+    QTest::newRow("malformed") << "(a=1" << "(a=1";
+}
+
+void ADMCTestAdFilterTree::optimize() {
+    QFETCH(QString, filter);
+    QFETCH(QString, expected);
+
+    const QString optimized = filter_optimize(filter, nullptr);
+    QCOMPARE(optimized, expected);
+}
+
+void ADMCTestAdFilterTree::optimize_category_data() {
+    QTest::addColumn<QString>("filter");
+    QTest::addColumn<QString>("expected");
+
+    const QString user_category = QString("CN=Person,%1").arg(schema_dn);
+
+    QTest::newRow("structural") << "(objectClass=user)" << QString("(objectCategory=%1)").arg(user_category);
+    QTest::newRow("auxiliary") << "(objectClass=posixAccount)" << "(objectClass=posixAccount)";
+    QTest::newRow("abstract") << "(objectClass=top)" << "(objectClass=top)";
+}
+
+// NOTE: objects with auxiliary classes have the category of
+// their structural class, so only structural classes can
+// be searched by category
+void ADMCTestAdFilterTree::optimize_category() {
+    QFETCH(QString, filter);
+    QFETCH(QString, expected);
+
+    AdMemoryBackend *backend = test_memory_backend_new();
+
+    backend->add_entry("", {
+        {"rootDomainNamingContext", {TEST_MEMORY_DOMAIN_DN}},
+        {"configurationNamingContext", {configuration_dn.toUtf8()}},
+        {"schemaNamingContext", {schema_dn.toUtf8()}},
+    });
+    // NOTE: adconfig loads domain sid
+    backend->add_entry(TEST_MEMORY_DOMAIN_DN, {
+        {"objectClass", {"top", "domain", "domainDNS"}},
+        {"objectSid", {QByteArray::fromBase64("AQQAAAAAAAUVAAAA6AMAANAHAAC4CwAA")}},
+    });
+    backend->add_entry(configuration_dn, {
+        {"objectClass", {"top", "configuration"}},
+    });
+    backend->add_entry(schema_dn, {
+        {"objectClass", {"top", "dMD"}},
+    });
+
+    auto add_class = [&](const QString &name, const QString &ldap_name, const QString &category, const QString &class_category) {
+        backend->add_entry(QString("CN=%1,%2").arg(name, schema_dn), {
+            {"objectClass", {"top", "classSchema"}},
+            {"lDAPDisplayName", {ldap_name.toUtf8()}},
+            {"subClassOf", {"top"}},
+            {"defaultObjectCategory", {QString("CN=%1,%2").arg(category, schema_dn).toUtf8()}},
+            {"objectClassCategory", {class_category.toUtf8()}},
+        });
+    };
+
+    add_class("Top", "top", "Top", "2");
+    add_class("User", "user", "Person", "1");
+    add_class("posixAccount", "posixAccount", "posixAccount", "3");
+
+    AdInterface ad;
+    AdConfig adconfig;
+    adconfig.load(ad, QLocale(QLocale::English));
+
+    const QString optimized = filter_optimize(filter, &adconfig);
+
+    test_memory_backend_free(backend);
+
+    QCOMPARE(optimized, expected);
+}
+
+QTEST_MAIN(ADMCTestAdFilterTree)
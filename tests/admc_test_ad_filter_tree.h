@@ -0,0 +1,45 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ADMC_TEST_AD_FILTER_TREE_H
+#define ADMC_TEST_AD_FILTER_TREE_H
+
+#include <QObject>
+#include <QTest>
+
+class ADMCTestAdFilterTree : public QObject {
+    Q_OBJECT
+
+private slots:
+    void escape();
+    void escape_bytes();
+    void condition_escape();
+    void parse_serialize_data();
+    void parse_serialize();
+    void parse_malformed_data();
+    void parse_malformed();
+    void parse_extensible();
+    void optimize_data();
+    void optimize();
+    void optimize_category_data();
+    void optimize_category();
+};
+
+#endif /* ADMC_TEST_AD_FILTER_TREE_H */
@@ -0,0 +1,248 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "admc_test_ad_import.h"
+
+#include "ad_import.h"
+#include "ad_interface.h"
+#include "ad_object.h"
+#include "admc_test.h"
+
+const QString domain_dn = TEST_MEMORY_DOMAIN_DN;
+const QString ou_dn = "OU=school,DC=test,DC=com";
+const QString class_ou_dn = "OU=class1,OU=school,DC=test,DC=com";
+const QString user1_dn = "CN=user1,OU=class1,OU=school,DC=test,DC=com";
+const QString user2_dn = "CN=user2,OU=class1,OU=school,DC=test,DC=com";
+const QString existing_dn = "CN=existing,DC=test,DC=com";
+
+LdifEntry make_entry(const QString &dn, const QByteArray &object_class, const QHash<QString, QList<QByteArray>> &attributes = QHash<QString, QList<QByteArray>>());
+QList<QString> get_dn_list(const QList<LdifEntry> &entry_list);
+
+void ADMCTestAdImport::init() {
+    backend = test_memory_backend_new();
+    backend->add_entry(existing_dn, {
+        {"objectClass", {"top", "person", "organizationalPerson", "user"}},
+        {"description", {"old"}},
+    });
+}
+
+void ADMCTestAdImport::cleanup() {
+    test_memory_backend_free(backend);
+    backend = nullptr;
+}
+
+void ADMCTestAdImport::dn_parent() {
+    QCOMPARE(ad_import_dn_parent(user1_dn), class_ou_dn);
+    QCOMPARE(ad_import_dn_parent("CN=Doe\\, John,DC=test,DC=com"), domain_dn);
+    QCOMPARE(ad_import_dn_parent("DC=com"), QString());
+}
+
+void ADMCTestAdImport::sort_entries() {
+    const QList<LdifEntry> entry_list = {
+        make_entry(user1_dn, "user"),
+        make_entry(class_ou_dn, "organizationalUnit"),
+        make_entry(user2_dn, "user"),
+        make_entry(ou_dn, "organizationalUnit"),
+    };
+
+    const QList<LdifEntry> sorted_list = ad_import_sort_entries(entry_list);
+
+    // Parents are first, siblings keep their order
+    QCOMPARE(get_dn_list(sorted_list), QList<QString>({ou_dn, class_ou_dn, user1_dn, user2_dn}));
+}
+
+void ADMCTestAdImport::entries_from_csv() {
+    const QByteArray data = "dn,objectClass,description\n"
+                            "\"CN=user1,OU=class1,OU=school,DC=test,DC=com\",top;user,\n"
+                            "\"CN=user2,OU=class1,OU=school,DC=test,DC=com\",user,desc\n";
+
+    QList<LdifEntry> entry_list;
+    QString error;
+    const bool success = ad_import_entries_from_csv(data, &entry_list, &error);
+
+    QVERIFY(success);
+    QCOMPARE(get_dn_list(entry_list), QList<QString>({user1_dn, user2_dn}));
+    QCOMPARE(entry_list[0].attributes["objectClass"], QList<QByteArray>({"top", "user"}));
+    QVERIFY(!entry_list[0].attributes.contains("description"));
+    QCOMPARE(entry_list[1].attributes["description"], QList<QByteArray>({"desc"}));
+
+    QList<LdifEntry> keep_empty_list;
+    const bool keep_empty_success = ad_import_entries_from_csv(data, &keep_empty_list, &error, true);
+    QVERIFY(keep_empty_success);
+    QVERIFY(keep_empty_list[0].attributes.contains("description"));
+    QVERIFY(keep_empty_list[0].attributes["description"].isEmpty());
+
+    const bool no_dn_success = ad_import_entries_from_csv("cn,description\na,b\n", &entry_list, &error);
+    QVERIFY(!no_dn_success);
+}
+
+void ADMCTestAdImport::import_entries() {
+    // NOTE: children are before parents, import has to
+    // reorder them
+    const QList<LdifEntry> entry_list = {
+        make_entry(user1_dn, "user", {{"description", {"first"}}}),
+        make_entry(user2_dn, "user"),
+        make_entry(class_ou_dn, "organizationalUnit"),
+        make_entry(ou_dn, "organizationalUnit"),
+    };
+
+    AdImportOptions options;
+    options.window_size = 2;
+
+    int last_done_count = 0;
+    const AdImportProgressCallback progress = [&](const int done_count, const int total_count) {
+        QCOMPARE(total_count, entry_list.size());
+        QVERIFY(done_count >= last_done_count);
+
+        last_done_count = done_count;
+    };
+
+    AdInterface ad;
+    const AdImportReport report = ad.import_entries(entry_list, options, progress, nullptr);
+
+    QVERIFY(report.is_ok());
+    QCOMPARE(report.total_count, 4);
+    QCOMPARE(report.added_count, 4);
+    QCOMPARE(last_done_count, 4);
+
+    const AdObject user1 = ad.search_object(user1_dn);
+    QCOMPARE(user1.get_string("description"), QString("first"));
+}
+
+void ADMCTestAdImport::import_parent_failed() {
+    // NOTE: OU without object class fails, so it's
+    // children can't be created
+    const QList<LdifEntry> entry_list = {
+        LdifEntry{ou_dn, {}},
+        make_entry(class_ou_dn, "organizationalUnit"),
+        make_entry(user1_dn, "user"),
+        make_entry("CN=other,DC=test,DC=com", "user"),
+    };
+
+    AdInterface ad;
+    const AdImportReport report = ad.import_entries(entry_list, AdImportOptions(), AdImportProgressCallback(), nullptr);
+
+    QVERIFY(!report.is_ok());
+    QCOMPARE(report.added_count, 1);
+    QCOMPARE(report.failures.size(), 3);
+    QCOMPARE(report.skipped_count, 0);
+    QCOMPARE(report.failures[0].dn, ou_dn);
+    QCOMPARE(report.failures[0].attempts, 1);
+    QVERIFY(report.failures_text().contains(user1_dn));
+
+    QVERIFY(ad.search_object(class_ou_dn).is_empty());
+}
+
+void ADMCTestAdImport::import_existing() {
+    const QList<LdifEntry> entry_list = {
+        make_entry(existing_dn, "user", {{"description", {"new"}}}),
+    };
+
+    AdInterface ad;
+    const AdImportReport report = ad.import_entries(entry_list, AdImportOptions(), AdImportProgressCallback(), nullptr);
+
+    QCOMPARE(report.failures.size(), 1);
+    QCOMPARE(ad.search_object(existing_dn).get_string("description"), QString("old"));
+}
+
+void ADMCTestAdImport::import_existing_children() {
+    backend->add_entry(ou_dn, {
+        {"objectClass", {"top", "organizationalUnit"}},
+    });
+
+    const QList<LdifEntry> entry_list = {
+        make_entry(ou_dn, "organizationalUnit"),
+        make_entry(class_ou_dn, "organizationalUnit"),
+        make_entry(user1_dn, "user"),
+    };
+
+    AdInterface ad;
+    const AdImportReport report = ad.import_entries(entry_list, AdImportOptions(), AdImportProgressCallback(), nullptr);
+
+    // NOTE: existing parent fails, but it's children are
+    // still created
+    QCOMPARE(report.failures.size(), 1);
+    QCOMPARE(report.failures[0].dn, ou_dn);
+    QCOMPARE(report.added_count, 2);
+    QCOMPARE(report.skipped_count, 0);
+    QVERIFY(!ad.search_object(user1_dn).is_empty());
+}
+
+void ADMCTestAdImport::import_update_existing() {
+    const QList<LdifEntry> entry_list = {
+        make_entry(existing_dn, "user", {{"description", {"new"}}}),
+    };
+
+    AdImportOptions options;
+    options.update_existing = true;
+
+    AdInterface ad;
+    const AdImportReport report = ad.import_entries(entry_list, options, AdImportProgressCallback(), nullptr);
+
+    QVERIFY(report.is_ok());
+    QCOMPARE(report.added_count, 0);
+    QCOMPARE(report.updated_count, 1);
+    QCOMPARE(ad.search_object(existing_dn).get_string("description"), QString("new"));
+}
+
+void ADMCTestAdImport::import_stop() {
+    const QList<LdifEntry> entry_list = {
+        make_entry(ou_dn, "organizationalUnit"),
+        make_entry(class_ou_dn, "organizationalUnit"),
+        make_entry(user1_dn, "user"),
+    };
+
+    bool stop_flag = false;
+    const AdImportProgressCallback progress = [&](const int, const int) {
+        stop_flag = true;
+    };
+
+    AdImportOptions options;
+    options.window_size = 1;
+
+    AdInterface ad;
+    const AdImportReport report = ad.import_entries(entry_list, options, progress, &stop_flag);
+
+    QVERIFY(!report.is_ok());
+    QCOMPARE(report.added_count, 1);
+    QCOMPARE(report.skipped_count, 2);
+    QVERIFY(report.failures.isEmpty());
+}
+
+LdifEntry make_entry(const QString &dn, const QByteArray &object_class, const QHash<QString, QList<QByteArray>> &attributes) {
+    LdifEntry out;
+    out.dn = dn;
+    out.attributes = attributes;
+    out.attributes["objectClass"] = {"top", object_class};
+
+    return out;
+}
+
+QList<QString> get_dn_list(const QList<LdifEntry> &entry_list) {
+    QList<QString> out;
+
+    for (const LdifEntry &entry : entry_list) {
+        out.append(entry.dn);
+    }
+
+    return out;
+}
+
+QTEST_MAIN(ADMCTestAdImport)
@@ -257,4 +257,39 @@ void ADMCTestAdInterface::user_set_account_option() {
     }
 }
 
+void ADMCTestAdInterface::attribute_modify() {
+    const QString user_dn = test_object_dn(TEST_USER, CLASS_USER);
+    const bool add_user_success = ad.object_add(user_dn, CLASS_USER);
+    QVERIFY(add_user_success);
+
+    const bool set_office_success = ad.attribute_replace_string(user_dn, ATTRIBUTE_OFFICE, "office");
+    QVERIFY(set_office_success);
+
+    // Change one attribute, add another and delete third
+    // one with one request
+    const QList<AdBackendMod> mod_list = {
+        {AdBackendModOp_Replace, ATTRIBUTE_DESCRIPTION, {"description"}},
+        {AdBackendModOp_Replace, ATTRIBUTE_DEPARTMENT, {"department"}},
+        {AdBackendModOp_Replace, ATTRIBUTE_OFFICE, {}},
+    };
+    const bool modify_success = ad.attribute_modify(user_dn, mod_list);
+    QVERIFY(modify_success);
+
+    const AdObject object = ad.search_object(user_dn);
+    QCOMPARE(object.get_string(ATTRIBUTE_DESCRIPTION), QString("description"));
+    QCOMPARE(object.get_string(ATTRIBUTE_DEPARTMENT), QString("department"));
+    QVERIFY(!object.contains(ATTRIBUTE_OFFICE));
+
+    // Failed modification changes nothing
+    const QList<AdBackendMod> bad_mod_list = {
+        {AdBackendModOp_Replace, ATTRIBUTE_DESCRIPTION, {"changed"}},
+        {AdBackendModOp_Delete, ATTRIBUTE_OFFICE, {"doesn't exist"}},
+    };
+    const bool bad_modify_success = ad.attribute_modify(user_dn, bad_mod_list);
+    QVERIFY(!bad_modify_success);
+
+    const AdObject object_after_fail = ad.search_object(user_dn);
+    QCOMPARE(object_after_fail.get_string(ATTRIBUTE_DESCRIPTION), QString("description"));
+}
+
 QTEST_MAIN(ADMCTestAdInterface)
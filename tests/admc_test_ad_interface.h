@@ -37,6 +37,8 @@ private slots:
     void object_move();
     void object_rename();
 
+    void attribute_modify();
+
     void group_add_member();
     void group_remove_member();
     void group_set_scope();
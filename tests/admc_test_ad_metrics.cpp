@@ -0,0 +1,206 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "admc_test_ad_metrics.h"
+
+#include "ad_interface.h"
+#include "ad_metrics.h"
+#include "ad_object.h"
+#include "admc_test.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+const QString domain_dn = TEST_MEMORY_DOMAIN_DN;
+
+void ADMCTestAdMetrics::initTestCase() {
+    backend = test_memory_backend_new();
+    backend->set_page_size(2);
+    for (int i = 0; i < 5; i++) {
+        const QString dn = QString("CN=user%1,%2").arg(i).arg(domain_dn);
+
+        backend->add_entry(dn, {
+            {"objectClass", {"top", "person", "organizationalPerson", "user"}},
+            {"sAMAccountName", {QString("user%1").arg(i).toUtf8()}},
+        });
+    }
+}
+
+void ADMCTestAdMetrics::cleanupTestCase() {
+    test_memory_backend_free(backend);
+}
+
+void ADMCTestAdMetrics::init() {
+    ad_metrics_clear();
+}
+
+void ADMCTestAdMetrics::cleanup() {
+}
+
+void ADMCTestAdMetrics::histogram_data() {
+    QTest::addColumn<qint64>("duration");
+    QTest::addColumn<int>("bucket");
+
+    // NOTE: durations are in microseconds
+    QTest::newRow("zero") << (qint64) 0 << 0;
+    QTest::newRow("below 1ms") << (qint64) 999 << 0;
+    QTest::newRow("1ms") << (qint64) 1000 << 1;
+    QTest::newRow("3ms") << (qint64) 3000 << 2;
+    QTest::newRow("4ms") << (qint64) 4000 << 3;
+    QTest::newRow("huge") << (qint64) 1000000000 << 15;
+}
+
+void ADMCTestAdMetrics::histogram() {
+    QFETCH(qint64, duration);
+    QFETCH(int, bucket);
+
+    AdHistogram histogram;
+    histogram.add(duration);
+
+    QCOMPARE(histogram.count(), 1);
+    QCOMPARE(histogram.get_bucket(bucket), 1);
+}
+
+void ADMCTestAdMetrics::percentile() {
+    AdHistogram histogram;
+
+    QCOMPARE(histogram.percentile(0.5), (qint64) 0);
+
+    for (int i = 0; i < 9; i++) {
+        histogram.add(500);
+    }
+    histogram.add(100000);
+
+    QCOMPARE(histogram.percentile(0.5), (qint64) 1);
+    QCOMPARE(histogram.percentile(0.9), (qint64) 1);
+    QCOMPARE(histogram.percentile(1.0), (qint64) 128);
+}
+
+void ADMCTestAdMetrics::stats() {
+    AdOperationRecord record_1;
+    record_1.type = AdOperationType_Modify;
+    record_1.total_time = 2000;
+
+    AdOperationRecord record_2;
+    record_2.type = AdOperationType_Modify;
+    record_2.total_time = 6000;
+    record_2.result = 32;
+
+    ad_metrics_record(record_1);
+    ad_metrics_record(record_2);
+
+    const AdOperationStats stats = ad_metrics_get_stats(AdOperationType_Modify);
+    QCOMPARE(stats.count, 2);
+    QCOMPARE(stats.error_count, 1);
+    QCOMPARE(stats.total_time, (qint64) 8000);
+    QCOMPARE(stats.max_time, (qint64) 6000);
+    QCOMPARE(stats.total_histogram.count(), 2);
+
+    const AdOperationStats search_stats = ad_metrics_get_stats(AdOperationType_Search);
+    QCOMPARE(search_stats.count, 0);
+}
+
+// Only recent records are kept, but stats include all
+void ADMCTestAdMetrics::records_limit() {
+    const int count = 1500;
+
+    for (int i = 0; i < count; i++) {
+        AdOperationRecord record;
+        record.type = AdOperationType_Add;
+        record.total_time = i;
+
+        ad_metrics_record(record);
+    }
+
+    const QList<AdOperationRecord> record_list = ad_metrics_get_records();
+    QVERIFY(record_list.size() < count);
+    QCOMPARE(record_list.last().total_time, (qint64) (count - 1));
+
+    const AdOperationStats stats = ad_metrics_get_stats(AdOperationType_Add);
+    QCOMPARE(stats.count, count);
+}
+
+// All pages of a search should be recorded as one
+// operation
+void ADMCTestAdMetrics::search() {
+    AdInterface ad;
+    QVERIFY(ad.is_connected());
+
+    const QString filter = "(objectClass=user)";
+    const QHash<QString, AdObject> results = ad.search(domain_dn, SearchScope_Children, filter, {"sAMAccountName"});
+    QCOMPARE(results.size(), 5);
+
+    const QList<AdOperationRecord> record_list = ad_metrics_get_records();
+    QCOMPARE(record_list.size(), 1);
+
+    const AdOperationRecord record = record_list[0];
+    QCOMPARE(record.type, AdOperationType_Search);
+    QCOMPARE(record.base, domain_dn);
+    QCOMPARE(record.scope, SearchScope_Children);
+    QCOMPARE(record.filter_hash, qHash(filter));
+    QCOMPARE(record.pages, 3);
+    QCOMPARE(record.entries, 5);
+    QCOMPARE(record.result, 0);
+    QVERIFY(record.first_entry_time >= 0);
+    QVERIFY(record.first_entry_time <= record.total_time);
+}
+
+void ADMCTestAdMetrics::rename() {
+    AdInterface ad;
+    QVERIFY(ad.is_connected());
+
+    const QString dn = QString("CN=user0,%1").arg(domain_dn);
+    const bool rename_success = ad.object_rename(dn, "user0-renamed");
+    QVERIFY(rename_success);
+
+    const QList<AdOperationRecord> record_list = ad_metrics_get_records();
+    QCOMPARE(record_list.size(), 1);
+
+    const AdOperationRecord record = record_list[0];
+    QCOMPARE(record.type, AdOperationType_Rename);
+    QCOMPARE(record.base, dn);
+    QCOMPARE(record.result, 0);
+}
+
+void ADMCTestAdMetrics::to_json() {
+    AdOperationRecord record;
+    record.type = AdOperationType_Search;
+    record.base = domain_dn;
+    record.entries = 10;
+    ad_metrics_record(record);
+
+    const QJsonDocument document = QJsonDocument::fromJson(ad_metrics_to_json());
+    QVERIFY(document.isObject());
+
+    const QJsonObject json = document.object();
+    const QJsonArray operations = json["operations"].toArray();
+    QCOMPARE(operations.size(), 1);
+
+    const QJsonObject operation = operations[0].toObject();
+    QCOMPARE(operation["type"].toString(), QString("search"));
+    QCOMPARE(operation["base"].toString(), domain_dn);
+    QCOMPARE(operation["entries"].toInt(), 10);
+
+    const QJsonObject search_stats = json["stats"].toObject()["search"].toObject();
+    QCOMPARE(search_stats["count"].toInt(), 1);
+}
+
+QTEST_MAIN(ADMCTestAdMetrics)
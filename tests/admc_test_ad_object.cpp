@@ -0,0 +1,127 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "admc_test_ad_object.h"
+
+#include "ad_defines.h"
+#include "ad_object.h"
+#include "ad_utils.h"
+
+const QString test_dn = "CN=test,DC=test,DC=com";
+
+void ADMCTestAdObject::single_values() {
+    AdObject object;
+    object.load(test_dn, {
+        {ATTRIBUTE_DESCRIPTION, {"first", "second"}},
+        {ATTRIBUTE_MAX_PWD_AGE, {"42", "7"}},
+        {ATTRIBUTE_SHOW_IN_ADVANCED_VIEW_ONLY, {"TRUE"}},
+    });
+
+    QCOMPARE(object.get_value(ATTRIBUTE_DESCRIPTION), QByteArray("first"));
+    QCOMPARE(object.get_string(ATTRIBUTE_DESCRIPTION), QString("first"));
+    QCOMPARE(object.get_int(ATTRIBUTE_MAX_PWD_AGE), 42);
+    QCOMPARE(object.get_bool(ATTRIBUTE_SHOW_IN_ADVANCED_VIEW_ONLY), true);
+
+    // List getters still return all values
+    QCOMPARE(object.get_strings(ATTRIBUTE_DESCRIPTION), QList<QString>({"first", "second"}));
+    QCOMPARE(object.get_ints(ATTRIBUTE_MAX_PWD_AGE), QList<int>({42, 7}));
+}
+
+void ADMCTestAdObject::missing_values() {
+    AdObject object;
+    object.load(test_dn, {
+        {ATTRIBUTE_DESCRIPTION, {}},
+    });
+
+    QCOMPARE(object.get_value(ATTRIBUTE_DESCRIPTION), QByteArray());
+    QCOMPARE(object.get_string(ATTRIBUTE_NAME), QString());
+    QCOMPARE(object.get_int(ATTRIBUTE_MAX_PWD_AGE), 0);
+    QCOMPARE(object.get_bool(ATTRIBUTE_SHOW_IN_ADVANCED_VIEW_ONLY), false);
+    QCOMPARE(object.get_user_account_control(), 0);
+    QCOMPARE(object.get_system_flags(), 0);
+    QCOMPARE(object.get_most_derived_class(), QString());
+    QVERIFY(!object.get_system_flag(SystemFlagsBit_CannotDelete));
+    QVERIFY(!object.get_account_option(AccountOption_Disabled, nullptr));
+}
+
+void ADMCTestAdObject::most_derived_class() {
+    AdObject object;
+    object.load(test_dn, {
+        {ATTRIBUTE_OBJECT_CLASS, {"top", "person", "organizationalPerson", "user", "computer"}},
+    });
+
+    QCOMPARE(object.get_most_derived_class(), QString(CLASS_COMPUTER));
+    QCOMPARE(object.get_string(ATTRIBUTE_OBJECT_CLASS), QString(CLASS_COMPUTER));
+    QVERIFY(object.is_class(CLASS_COMPUTER));
+    QVERIFY(!object.is_class(CLASS_USER));
+}
+
+void ADMCTestAdObject::cached_ints() {
+    const int uac = (UAC_ACCOUNTDISABLE | UAC_NORMAL_ACCOUNT);
+    const int system_flags = (SystemFlagsBit_CannotDelete | SystemFlagsBit_DomainCannotRename);
+    const int group_type = (GROUP_TYPE_BIT_SECURITY | group_scope_bit(GroupScope_Universal));
+
+    AdObject object;
+    object.load(test_dn, {
+        {ATTRIBUTE_USER_ACCOUNT_CONTROL, {QByteArray::number(uac)}},
+        {ATTRIBUTE_SYSTEM_FLAGS, {QByteArray::number(system_flags)}},
+        {ATTRIBUTE_GROUP_TYPE, {QByteArray::number(group_type)}},
+    });
+
+    // NOTE: call twice to go through both uncached and
+    // cached paths
+    for (int i = 0; i < 2; i++) {
+        QCOMPARE(object.get_user_account_control(), uac);
+        QCOMPARE(object.get_system_flags(), system_flags);
+        QCOMPARE(object.get_group_type_bits(), group_type);
+
+        QVERIFY(object.get_account_option(AccountOption_Disabled, nullptr));
+        QVERIFY(!object.get_account_option(AccountOption_SmartcardRequired, nullptr));
+        QVERIFY(object.get_system_flag(SystemFlagsBit_CannotDelete));
+        QVERIFY(object.get_system_flag(SystemFlagsBit_DomainCannotRename));
+        QVERIFY(!object.get_system_flag(SystemFlagsBit_DomainCannotMove));
+        QCOMPARE(object.get_group_type(), GroupType_Security);
+        QCOMPARE(object.get_group_scope(), GroupScope_Universal);
+    }
+
+    // Copies keep correct values
+    const AdObject copy = object;
+    QCOMPARE(copy.get_user_account_control(), uac);
+}
+
+void ADMCTestAdObject::load_resets_cache() {
+    AdObject object;
+    object.load(test_dn, {
+        {ATTRIBUTE_OBJECT_CLASS, {"top", "user"}},
+        {ATTRIBUTE_USER_ACCOUNT_CONTROL, {"2"}},
+    });
+
+    QCOMPARE(object.get_most_derived_class(), QString(CLASS_USER));
+    QCOMPARE(object.get_user_account_control(), 2);
+
+    object.load(test_dn, {
+        {ATTRIBUTE_OBJECT_CLASS, {"top", "group"}},
+    });
+
+    QCOMPARE(object.get_most_derived_class(), QString(CLASS_GROUP));
+    QCOMPARE(object.get_user_account_control(), 0);
+}
+
+QTEST_MAIN(ADMCTestAdObject)
@@ -0,0 +1,319 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "admc_test_ad_object_cache.h"
+
+#include "ad_interface.h"
+#include "ad_metrics.h"
+#include "ad_object.h"
+#include "ad_object_cache.h"
+#include "admc_test.h"
+
+const QString domain_dn = TEST_MEMORY_DOMAIN_DN;
+const QString user_dn = "CN=user,DC=test,DC=com";
+const QString group_dn = "CN=group,DC=test,DC=com";
+
+AdObject make_object(const QString &dn, const QHash<QString, QList<QByteArray>> &attributes_data);
+int search_count();
+
+void ADMCTestAdObjectCache::initTestCase() {
+    backend = test_memory_backend_new();
+    backend->add_entry(user_dn, {
+        {"objectClass", {"top", "person", "organizationalPerson", "user"}},
+        {"sAMAccountName", {"user"}},
+        {"description", {"user description"}},
+    });
+    backend->add_entry(group_dn, {
+        {"objectClass", {"top", "group"}},
+        {"sAMAccountName", {"group"}},
+        {"member", {user_dn.toUtf8()}},
+    });
+}
+
+void ADMCTestAdObjectCache::cleanupTestCase() {
+    test_memory_backend_free(backend);
+}
+
+void ADMCTestAdObjectCache::init() {
+    AdInterface::object_cache()->clear();
+    ad_metrics_clear();
+}
+
+void ADMCTestAdObjectCache::cleanup() {
+}
+
+void ADMCTestAdObjectCache::get_partial() {
+    AdObjectCache cache;
+    cache.insert(make_object(user_dn, {{"a", {"1"}}}), {"a"});
+
+    AdObject object;
+    QList<QString> missing;
+
+    const bool hit = cache.get(user_dn, {"a"}, CacheMaxAge_Any, &object, &missing);
+    QVERIFY(hit);
+    QVERIFY(missing.isEmpty());
+    QCOMPARE(object.get_dn(), user_dn);
+    QCOMPARE(object.get_value("a"), QByteArray("1"));
+
+    const bool hit_more = cache.get(user_dn, {"a", "b"}, CacheMaxAge_Any, &object, &missing);
+    QVERIFY(!hit_more);
+    QCOMPARE(missing, QList<QString>({"b"}));
+    QCOMPARE(object.get_value("a"), QByteArray("1"));
+
+    const bool hit_other = cache.get(group_dn, {"a"}, CacheMaxAge_Any, &object, &missing);
+    QVERIFY(!hit_other);
+    QCOMPARE(missing, QList<QString>({"a"}));
+    QVERIFY(object.is_empty());
+}
+
+void ADMCTestAdObjectCache::merge() {
+    AdObjectCache cache;
+    cache.insert(make_object(user_dn, {{"a", {"1"}}}), {"a"});
+    cache.insert(make_object(user_dn, {{"b", {"2"}}}), {"b"});
+    cache.insert(make_object(user_dn, {{"a", {"3"}}}), {"a"});
+
+    AdObject object;
+    QList<QString> missing;
+    const bool hit = cache.get(user_dn, {"a", "b"}, CacheMaxAge_Any, &object, &missing);
+    QVERIFY(hit);
+    QCOMPARE(object.get_value("a"), QByteArray("3"));
+    QCOMPARE(object.get_value("b"), QByteArray("2"));
+    QCOMPARE(cache.size(), 1);
+}
+
+void ADMCTestAdObjectCache::missing_attribute() {
+    AdObjectCache cache;
+    cache.insert(make_object(user_dn, {{"a", {"1"}}}), {"a", "b"});
+
+    AdObject object;
+    QList<QString> missing;
+    const bool hit = cache.get(user_dn, {"b"}, CacheMaxAge_Any, &object, &missing);
+    QVERIFY(hit);
+    QVERIFY(!object.contains("b"));
+
+    // Attribute that became empty is removed
+    cache.insert(make_object(user_dn, {}), {"a"});
+    cache.get(user_dn, {"a"}, CacheMaxAge_Any, &object, &missing);
+    QVERIFY(!object.contains("a"));
+}
+
+void ADMCTestAdObjectCache::complete() {
+    AdObjectCache cache;
+
+    AdObject object;
+    QList<QString> missing;
+
+    cache.insert(make_object(user_dn, {{"a", {"1"}}}), {"a"});
+    const bool partial_hit = cache.get(user_dn, QList<QString>(), CacheMaxAge_Any, &object, &missing);
+    QVERIFY(!partial_hit);
+    QVERIFY(missing.isEmpty());
+
+    cache.insert(make_object(user_dn, {{"a", {"1"}}, {"b", {"2"}}}), QList<QString>());
+    const bool complete_hit = cache.get(user_dn, QList<QString>(), CacheMaxAge_Any, &object, &missing);
+    QVERIFY(complete_hit);
+    QCOMPARE(object.attributes().size(), 2);
+
+    // Complete load also covers attributes that object
+    // doesn't have
+    const bool absent_hit = cache.get(user_dn, {"c"}, CacheMaxAge_Any, &object, &missing);
+    QVERIFY(absent_hit);
+    QVERIFY(!object.contains("c"));
+}
+
+void ADMCTestAdObjectCache::case_insensitive() {
+    AdObjectCache cache;
+    cache.insert(make_object(user_dn, {{"sAMAccountName", {"user"}}}), {"sAMAccountName"});
+
+    AdObject object;
+    QList<QString> missing;
+    const bool hit = cache.get(user_dn.toUpper(), {"samaccountname"}, CacheMaxAge_Any, &object, &missing);
+    QVERIFY(hit);
+    QCOMPARE(object.get_dn(), user_dn);
+    QCOMPARE(object.get_value("sAMAccountName"), QByteArray("user"));
+}
+
+void ADMCTestAdObjectCache::max_age() {
+    AdObjectCache cache;
+    cache.insert(make_object(user_dn, {{"a", {"1"}}}), {"a"});
+
+    AdObject object;
+    QList<QString> missing;
+
+    QVERIFY(!cache.get(user_dn, {"a"}, CacheMaxAge_None, &object, &missing));
+    QCOMPARE(missing, QList<QString>({"a"}));
+
+    QTest::qWait(50);
+
+    QVERIFY(!cache.get(user_dn, {"a"}, 10, &object, &missing));
+    QVERIFY(cache.get(user_dn, {"a"}, 10000, &object, &missing));
+    QVERIFY(cache.get(user_dn, {"a"}, CacheMaxAge_Any, &object, &missing));
+}
+
+void ADMCTestAdObjectCache::invalidate_subtree() {
+    const QString ou_dn = "OU=ou,DC=test,DC=com";
+    const QString child_dn = "CN=child,OU=ou,DC=test,DC=com";
+    const QString other_dn = "CN=other,DC=test,DC=com";
+
+    AdObjectCache cache;
+    cache.insert(make_object(ou_dn, {{"a", {"1"}}}), {"a"});
+    cache.insert(make_object(child_dn, {{"a", {"1"}}}), {"a"});
+    cache.insert(make_object(other_dn, {{"a", {"1"}}}), {"a"});
+
+    cache.invalidate_subtree(ou_dn.toUpper());
+
+    AdObject object;
+    QList<QString> missing;
+    QVERIFY(!cache.get(ou_dn, {"a"}, CacheMaxAge_Any, &object, &missing));
+    QVERIFY(!cache.get(child_dn, {"a"}, CacheMaxAge_Any, &object, &missing));
+    QVERIFY(cache.get(other_dn, {"a"}, CacheMaxAge_Any, &object, &missing));
+}
+
+void ADMCTestAdObjectCache::invalidate_references() {
+    AdObjectCache cache;
+    cache.insert(make_object(group_dn, {{"member", {user_dn.toUtf8()}}}), {"member"});
+    cache.insert(make_object(domain_dn, {{"a", {"1"}}}), {"a"});
+
+    cache.invalidate_references(user_dn);
+
+    AdObject object;
+    QList<QString> missing;
+    QVERIFY(!cache.get(group_dn, {"member"}, CacheMaxAge_Any, &object, &missing));
+    QVERIFY(cache.get(domain_dn, {"a"}, CacheMaxAge_Any, &object, &missing));
+}
+
+void ADMCTestAdObjectCache::invalidate_references_updated() {
+    const QString child_dn = "CN=child," + user_dn;
+
+    AdObjectCache cache;
+    cache.insert(make_object(group_dn, {{"member", {child_dn.toUpper().toUtf8()}}}), {"member"});
+
+    // Reference to a descendant is matched regardless of
+    // case
+    cache.invalidate_references(user_dn);
+
+    AdObject object;
+    QList<QString> missing;
+    QVERIFY(!cache.get(group_dn, {"member"}, CacheMaxAge_Any, &object, &missing));
+
+    // Reference that was replaced by a later load is no
+    // longer matched
+    cache.insert(make_object(group_dn, {{"member", {user_dn.toUtf8()}}}), {"member"});
+    cache.insert(make_object(group_dn, {{"member", {}}}), {"member"});
+    cache.invalidate_references(user_dn);
+
+    QVERIFY(cache.get(group_dn, {"member"}, CacheMaxAge_Any, &object, &missing));
+}
+
+void ADMCTestAdObjectCache::search_object_cached() {
+    AdInterface ad;
+    QVERIFY(ad.is_connected());
+
+    // Listing loads some attributes into cache
+    ad.search(domain_dn, SearchScope_Children, QString(), {"sAMAccountName"});
+    const int count_after_list = search_count();
+
+    const AdObject listed = ad.search_object_cached(user_dn, {"sAMAccountName"});
+    QCOMPARE(listed.get_string("sAMAccountName"), QString("user"));
+    QCOMPARE(search_count(), count_after_list);
+
+    // Only missing attribute is loaded
+    const AdObject delta = ad.search_object_cached(user_dn, {"sAMAccountName", "description"});
+    QCOMPARE(delta.get_string("sAMAccountName"), QString("user"));
+    QCOMPARE(delta.get_string("description"), QString("user description"));
+    QCOMPARE(search_count(), count_after_list + 1);
+
+    const AdObject again = ad.search_object_cached(user_dn, {"description"});
+    QCOMPARE(again.get_string("description"), QString("user description"));
+    QCOMPARE(search_count(), count_after_list + 1);
+
+    // Cache is bypassed
+    ad.search_object_cached(user_dn, {"description"}, CacheMaxAge_None);
+    QCOMPARE(search_count(), count_after_list + 2);
+}
+
+void ADMCTestAdObjectCache::search_object_cached_all() {
+    AdInterface ad;
+    QVERIFY(ad.is_connected());
+
+    const AdObject first = ad.search_object_cached(group_dn);
+    QVERIFY(first.contains("member"));
+    QCOMPARE(search_count(), 1);
+
+    const AdObject second = ad.search_object_cached(group_dn);
+    QCOMPARE(second.get_attributes_data(), first.get_attributes_data());
+    QCOMPARE(search_count(), 1);
+
+    const AdObject not_found = ad.search_object_cached("CN=doesnt-exist,DC=test,DC=com");
+    QVERIFY(not_found.is_empty());
+}
+
+void ADMCTestAdObjectCache::rename() {
+    AdInterface ad;
+    QVERIFY(ad.is_connected());
+
+    ad.search_object_cached(user_dn);
+    ad.search_object_cached(group_dn);
+    QCOMPARE(AdInterface::object_cache()->size(), 2);
+
+    const bool rename_success = ad.object_rename(user_dn, "user-renamed");
+    QVERIFY(rename_success);
+
+    // Renamed object and objects that refer to it are
+    // invalidated
+    QCOMPARE(AdInterface::object_cache()->size(), 0);
+
+    const AdObject old_object = ad.search_object_cached(user_dn);
+    QVERIFY(old_object.is_empty());
+
+    const QString renamed_dn = "CN=user-renamed,DC=test,DC=com";
+    const AdObject renamed_object = ad.search_object_cached(renamed_dn);
+    QCOMPARE(renamed_object.get_string("sAMAccountName"), QString("user"));
+
+    ad.object_rename(renamed_dn, "user");
+}
+
+// Objects loaded in a burst share the same load time, half
+// of them should still be evicted when cache is full
+void ADMCTestAdObjectCache::evict() {
+    AdObjectCache cache;
+
+    for (int i = 0; i <= CACHE_SIZE_MAX; i++) {
+        const QString dn = QString("CN=user%1,DC=test,DC=com").arg(i);
+        cache.insert(make_object(dn, {{"a", {"1"}}}), {"a"});
+    }
+
+    QVERIFY(cache.size() <= CACHE_SIZE_MAX / 2 + 1);
+    QVERIFY(cache.size() > 0);
+}
+
+AdObject make_object(const QString &dn, const QHash<QString, QList<QByteArray>> &attributes_data) {
+    AdObject out;
+    out.load(dn, attributes_data);
+
+    return out;
+}
+
+int search_count() {
+    const AdOperationStats stats = ad_metrics_get_stats(AdOperationType_Search);
+
+    return stats.count;
+}
+
+QTEST_MAIN(ADMCTestAdObjectCache)
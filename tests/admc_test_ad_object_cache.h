@@ -0,0 +1,57 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ADMC_TEST_AD_OBJECT_CACHE_H
+#define ADMC_TEST_AD_OBJECT_CACHE_H
+
+#include <QObject>
+#include <QTest>
+
+class AdMemoryBackend;
+
+class ADMCTestAdObjectCache : public QObject {
+    Q_OBJECT
+
+public slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+private slots:
+    void get_partial();
+    void merge();
+    void missing_attribute();
+    void complete();
+    void case_insensitive();
+    void max_age();
+    void invalidate_subtree();
+    void invalidate_references();
+    void invalidate_references_updated();
+    void search_object_cached();
+    void search_object_cached_all();
+    void rename();
+    void evict();
+
+private:
+    AdMemoryBackend *backend;
+};
+
+#endif /* ADMC_TEST_AD_OBJECT_CACHE_H */
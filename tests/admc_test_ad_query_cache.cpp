@@ -0,0 +1,263 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "admc_test_ad_query_cache.h"
+
+#include "ad_config.h"
+#include "ad_interface.h"
+#include "ad_object.h"
+#include "ad_query_cache.h"
+#include "admc_test.h"
+
+#include <algorithm>
+
+const QString domain_dn = TEST_MEMORY_DOMAIN_DN;
+const QString user1_dn = "CN=user1,DC=test,DC=com";
+const QString user2_dn = "CN=user2,DC=test,DC=com";
+const QString user3_dn = "CN=user3,DC=test,DC=com";
+const QString user4_dn = "CN=user4,DC=test,DC=com";
+const QString filter = "(description=keep*)";
+
+AdQueryCache make_cache();
+QList<QString> get_dn_list(const QList<AdObject> &object_list);
+
+void ADMCTestAdQueryCache::init() {
+    backend = test_memory_backend_new();
+    backend->add_entry(user1_dn, {
+        {"objectClass", {"top", "person", "organizationalPerson", "user"}},
+        {"description", {"keep 1"}},
+        {"uSNChanged", {"2"}},
+    });
+    backend->add_entry(user2_dn, {
+        {"objectClass", {"top", "person", "organizationalPerson", "user"}},
+        {"description", {"keep 2"}},
+        {"uSNChanged", {"3"}},
+    });
+    backend->add_entry(user3_dn, {
+        {"objectClass", {"top", "person", "organizationalPerson", "user"}},
+        {"description", {"keep 3"}},
+        {"uSNChanged", {"4"}},
+    });
+}
+
+void ADMCTestAdQueryCache::cleanup() {
+    test_memory_backend_free(backend);
+    backend = nullptr;
+}
+
+void ADMCTestAdQueryCache::refresh_full() {
+    AdInterface ad;
+    AdQueryCache cache = make_cache();
+    QVERIFY(cache.is_empty());
+
+    QList<AdObject> changed;
+    QList<QString> removed;
+    const bool success = cache.refresh(ad, &changed, &removed);
+
+    QVERIFY(success);
+    QVERIFY(!cache.is_empty());
+    QCOMPARE(get_dn_list(changed), QList<QString>({user1_dn, user2_dn, user3_dn}));
+    QVERIFY(removed.isEmpty());
+    QCOMPARE(cache.get_highest_usn(), qint64(4));
+}
+
+// NOTE: highest usn is the server's usn at the time of
+// refresh, even if it's higher than usn's of results
+void ADMCTestAdQueryCache::refresh_server_usn() {
+    backend->add_entry("CN=other,DC=test,DC=com", {
+        {"objectClass", {"top", "person", "organizationalPerson", "user"}},
+        {"description", {"other"}},
+        {"uSNChanged", {"10"}},
+    });
+
+    AdInterface ad;
+    AdQueryCache cache = make_cache();
+    const bool success = cache.refresh(ad, nullptr, nullptr);
+
+    QVERIFY(success);
+    QCOMPARE(cache.get_objects().size(), 3);
+    QCOMPARE(cache.get_highest_usn(), qint64(10));
+}
+
+void ADMCTestAdQueryCache::refresh_incremental() {
+    AdInterface ad;
+    AdQueryCache cache = make_cache();
+    cache.refresh(ad, nullptr, nullptr);
+
+    // Changed, stops matching, deleted and added
+    ad.attribute_replace_string(user1_dn, "description", "keep changed");
+    ad.attribute_replace_string(user2_dn, "description", "drop");
+    ad.object_delete(user3_dn);
+    ad.object_add(user4_dn, {
+        {"objectClass", {"user"}},
+        {"description", {"keep 4"}},
+    });
+
+    QList<AdObject> changed;
+    QList<QString> removed;
+    const bool success = cache.refresh(ad, &changed, &removed);
+
+    QVERIFY(success);
+    QCOMPARE(get_dn_list(changed), QList<QString>({user1_dn, user4_dn}));
+
+    std::sort(removed.begin(), removed.end());
+    QCOMPARE(removed, QList<QString>({user2_dn, user3_dn}));
+
+    QCOMPARE(get_dn_list(cache.get_objects()), QList<QString>({user1_dn, user4_dn}));
+
+    for (const AdObject &object : changed) {
+        if (object.get_dn() == user1_dn) {
+            QCOMPARE(object.get_string("description"), QString("keep changed"));
+        }
+    }
+}
+
+void ADMCTestAdQueryCache::refresh_no_changes() {
+    AdInterface ad;
+    AdQueryCache cache = make_cache();
+    cache.refresh(ad, nullptr, nullptr);
+
+    QList<AdObject> changed;
+    QList<QString> removed;
+    const bool success = cache.refresh(ad, &changed, &removed);
+
+    QVERIFY(success);
+    QVERIFY(changed.isEmpty());
+    QVERIFY(removed.isEmpty());
+    QCOMPARE(cache.get_objects().size(), 3);
+}
+
+// Adding user to a group changes user's memberOf but not
+// it's uSNChanged, so refresh has to be full when memberOf
+// is requested
+void ADMCTestAdQueryCache::refresh_backlink() {
+    const QString configuration_dn = QString("CN=Configuration,%1").arg(domain_dn);
+    const QString schema_dn = QString("CN=Schema,%1").arg(configuration_dn);
+    const QString group_dn = "CN=group,DC=test,DC=com";
+
+    backend->add_entry("", {
+        {"rootDomainNamingContext", {domain_dn.toUtf8()}},
+        {"configurationNamingContext", {configuration_dn.toUtf8()}},
+        {"schemaNamingContext", {schema_dn.toUtf8()}},
+    });
+    // NOTE: adconfig loads domain sid
+    backend->add_entry(domain_dn, {
+        {"objectClass", {"top", "domain", "domainDNS"}},
+        {"objectSid", {QByteArray::fromBase64("AQQAAAAAAAUVAAAA6AMAANAHAAC4CwAA")}},
+    });
+    backend->add_entry(configuration_dn, {
+        {"objectClass", {"top", "configuration"}},
+    });
+    backend->add_entry(schema_dn, {
+        {"objectClass", {"top", "dMD"}},
+    });
+    backend->add_entry(QString("CN=Is-Member-Of-DL,%1").arg(schema_dn), {
+        {"objectClass", {"top", "attributeSchema"}},
+        {"lDAPDisplayName", {"memberOf"}},
+        {"linkID", {"3"}},
+    });
+
+    AdInterface ad;
+    AdConfig adconfig;
+    adconfig.load(ad, QLocale(QLocale::English));
+    AdInterface::set_config(&adconfig);
+
+    AdQueryCache cache(domain_dn, SearchScope_All, filter, {"description", "memberOf"});
+    cache.refresh(ad, nullptr, nullptr);
+
+    ad.object_add(group_dn, {
+        {"objectClass", {"group"}},
+        {"member", {user1_dn}},
+    });
+
+    QList<AdObject> changed;
+    const bool success = cache.refresh(ad, &changed, nullptr);
+
+    AdInterface::set_config(nullptr);
+
+    QVERIFY(success);
+
+    const AdObject user1 = [&]() {
+        for (const AdObject &object : changed) {
+            if (object.get_dn() == user1_dn) {
+                return object;
+            }
+        }
+
+        return AdObject();
+    }();
+    QCOMPARE(user1.get_strings("memberOf"), QList<QString>({group_dn}));
+}
+
+void ADMCTestAdQueryCache::save_load() {
+    AdInterface ad;
+    AdQueryCache cache = make_cache();
+    cache.refresh(ad, nullptr, nullptr);
+
+    const QByteArray data = cache.save();
+
+    AdQueryCache loaded = make_cache();
+    QVERIFY(loaded.load(data));
+    QCOMPARE(loaded.get_highest_usn(), cache.get_highest_usn());
+    QCOMPARE(get_dn_list(loaded.get_objects()), get_dn_list(cache.get_objects()));
+
+    // Loaded results can be refreshed incrementally
+    ad.attribute_replace_string(user1_dn, "description", "keep changed");
+
+    QList<AdObject> changed;
+    loaded.refresh(ad, &changed, nullptr);
+    QCOMPARE(get_dn_list(changed), QList<QString>({user1_dn}));
+
+    AdQueryCache other(domain_dn, SearchScope_All, "(description=other)", {"description"});
+    QVERIFY(!other.load(data));
+    QVERIFY(other.is_empty());
+
+    AdQueryCache garbage = make_cache();
+    QVERIFY(!garbage.load("garbage"));
+    QVERIFY(garbage.is_empty());
+}
+
+void ADMCTestAdQueryCache::key() {
+    const AdQueryCache cache = make_cache();
+    const AdQueryCache reordered(domain_dn, SearchScope_All, filter, {"name", "description"});
+    const AdQueryCache other_base(user1_dn, SearchScope_All, filter, {"description", "name"});
+
+    QCOMPARE(cache.get_key(), reordered.get_key());
+    QVERIFY(cache.get_key() != other_base.get_key());
+}
+
+AdQueryCache make_cache() {
+    return AdQueryCache(domain_dn, SearchScope_All, filter, {"description", "name"});
+}
+
+// Returns sorted list of dn's
+QList<QString> get_dn_list(const QList<AdObject> &object_list) {
+    QList<QString> out;
+
+    for (const AdObject &object : object_list) {
+        out.append(object.get_dn());
+    }
+
+    std::sort(out.begin(), out.end());
+
+    return out;
+}
+
+QTEST_MAIN(ADMCTestAdQueryCache)
@@ -357,6 +357,62 @@ void ADMCTestAdSecurity::add_to_unset_opposite_superior() {
     check_state(test_trustee, SEC_ADS_GENERIC_ALL, QByteArray(), expected_full_control);
 }
 
+void ADMCTestAdSecurity::sd_string_compare_data() {
+    QTest::addColumn<QString>("expected");
+    QTest::addColumn<QString>("actual");
+    QTest::addColumn<bool>("expected_ok");
+    QTest::addColumn<bool>("expected_match");
+    QTest::addColumn<int>("expected_missing");
+    QTest::addColumn<int>("expected_extra");
+
+    const QString header = "REVISION:1,OWNER:S-1-5-32-544,GROUP:S-1-5-32-544";
+    const QString ace_1 = "ACL:S-1-5-11:0/3/0x001200a9";
+    const QString ace_2 = "ACL:S-1-5-18:0/3/0x001f01ff";
+    const QString ace_1_decimal = "ACL:S-1-5-11:0/3/1179817";
+    const QString ace_3 = "ACL:S-1-1-0:0/3/0x001f01ff";
+
+    auto sd = [&](const QList<QString> &ace_list) {
+        const QString acl = QStringList(ace_list).join(",");
+
+        return QString("%1,%2").arg(header, acl);
+    };
+
+    QTest::newRow("same") << sd({ace_1, ace_2}) << sd({ace_1, ace_2}) << true << true << 0 << 0;
+    QTest::newRow("different order") << sd({ace_1, ace_2}) << sd({ace_2, ace_1}) << true << true << 0 << 0;
+    QTest::newRow("decimal mask") << sd({ace_1}) << sd({ace_1_decimal}) << true << true << 0 << 0;
+    QTest::newRow("lower case trustee") << sd({ace_1}) << sd({"ACL:s-1-5-11:0/3/0x001200a9"}) << true << true << 0 << 0;
+    QTest::newRow("same duplicates") << sd({ace_1, ace_2, ace_2}) << sd({ace_2, ace_1, ace_2}) << true << true << 0 << 0;
+    QTest::newRow("extra duplicate") << sd({ace_1, ace_2}) << sd({ace_1, ace_2, ace_2}) << true << false << 0 << 1;
+    QTest::newRow("missing duplicate") << sd({ace_1, ace_1, ace_2}) << sd({ace_1, ace_2}) << true << false << 1 << 0;
+    QTest::newRow("missing") << sd({ace_1, ace_2}) << sd({ace_1}) << true << false << 1 << 0;
+    QTest::newRow("extra") << sd({ace_1}) << sd({ace_1, ace_3}) << true << false << 0 << 1;
+    QTest::newRow("missing and extra") << sd({ace_1, ace_2}) << sd({ace_1, ace_3}) << true << false << 1 << 1;
+    QTest::newRow("different owner") << sd({ace_1}) << QString(sd({ace_1})).replace("OWNER:S-1-5-32-544", "OWNER:S-1-5-18") << true << false << 0 << 0;
+    QTest::newRow("malformed ace") << sd({ace_1}) << sd({"ACL:S-1-5-11:0/3"}) << false << false << 0 << 0;
+    QTest::newRow("empty") << sd({ace_1}) << QString() << false << false << 0 << 0;
+}
+
+void ADMCTestAdSecurity::sd_string_compare() {
+    QFETCH(QString, expected);
+    QFETCH(QString, actual);
+    QFETCH(bool, expected_ok);
+    QFETCH(bool, expected_match);
+    QFETCH(int, expected_missing);
+    QFETCH(int, expected_extra);
+
+    bool ok;
+    const SdStringDiff diff = ::sd_string_compare(expected, actual, &ok);
+
+    QCOMPARE(ok, expected_ok);
+    if (!ok) {
+        return;
+    }
+
+    QCOMPARE(diff.is_match(), expected_match);
+    QCOMPARE(diff.missing_aces.size(), expected_missing);
+    QCOMPARE(diff.extra_aces.size(), expected_extra);
+}
+
 void ADMCTestAdSecurity::check_state(const QByteArray &trustee, const uint32_t access_mask, const QByteArray &object_type, const TestAdSecurityType type) const {
     const SecurityRightState state = security_descriptor_get_right(sd, trustee, access_mask, object_type);
 
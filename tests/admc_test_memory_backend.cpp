@@ -0,0 +1,297 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "admc_test_memory_backend.h"
+
+#include "ad_ldif.h"
+#include "ad_object.h"
+#include "admc_test.h"
+
+#include <ldap.h>
+
+#include <algorithm>
+
+Q_DECLARE_METATYPE(SearchScope)
+
+const QString domain_dn = TEST_MEMORY_DOMAIN_DN;
+const QString ou_dn = "OU=ou1,DC=test,DC=com";
+const QString user1_dn = "CN=user1,OU=ou1,DC=test,DC=com";
+const QString user2_dn = "CN=user2,OU=ou1,DC=test,DC=com";
+const QString group1_dn = "CN=group1,OU=ou1,DC=test,DC=com";
+const QString group2_dn = "CN=group2,DC=test,DC=com";
+
+void ADMCTestMemoryBackend::initTestCase() {
+}
+
+void ADMCTestMemoryBackend::cleanupTestCase() {
+}
+
+void ADMCTestMemoryBackend::init() {
+    backend = test_memory_backend_new();
+    backend->add_entry(ou_dn, {
+        {"objectClass", {"top", "organizationalUnit"}},
+    });
+    backend->add_entry(user1_dn, {
+        {"objectClass", {"top", "person", "organizationalPerson", "user"}},
+        {"sAMAccountName", {"user1"}},
+        {"userAccountControl", {"514"}},
+        {"objectCategory", {"CN=Person,CN=Schema,CN=Configuration,DC=test,DC=com"}},
+    });
+    backend->add_entry(user2_dn, {
+        {"objectClass", {"top", "person", "organizationalPerson", "user"}},
+        {"sAMAccountName", {"user2"}},
+        {"userAccountControl", {"512"}},
+        {"objectCategory", {"CN=Person,CN=Schema,CN=Configuration,DC=test,DC=com"}},
+    });
+    backend->add_entry(group1_dn, {
+        {"objectClass", {"top", "group"}},
+        {"member", {user1_dn.toUtf8()}},
+    });
+    backend->add_entry(group2_dn, {
+        {"objectClass", {"top", "group"}},
+        {"member", {group1_dn.toUtf8()}},
+    });
+}
+
+void ADMCTestMemoryBackend::cleanup() {
+    test_memory_backend_free(backend);
+    backend = nullptr;
+}
+
+void ADMCTestMemoryBackend::search_scope_data() {
+    QTest::addColumn<QString>("base");
+    QTest::addColumn<SearchScope>("scope");
+    QTest::addColumn<QList<QString>>("expected");
+
+    QTest::newRow("object") << ou_dn << SearchScope_Object << QList<QString>({ou_dn});
+    QTest::newRow("children") << domain_dn << SearchScope_Children << QList<QString>({group2_dn, ou_dn});
+    QTest::newRow("all") << ou_dn << SearchScope_All << QList<QString>({group1_dn, user1_dn, user2_dn, ou_dn});
+    QTest::newRow("descendants") << ou_dn << SearchScope_Descendants << QList<QString>({group1_dn, user1_dn, user2_dn});
+}
+
+void ADMCTestMemoryBackend::search_scope() {
+    QFETCH(QString, base);
+    QFETCH(SearchScope, scope);
+    QFETCH(QList<QString>, expected);
+
+    const QList<QString> actual = search_dn_list(base, scope, QString());
+
+    QCOMPARE(actual, expected);
+}
+
+void ADMCTestMemoryBackend::search_filter_data() {
+    QTest::addColumn<QString>("filter");
+    QTest::addColumn<QList<QString>>("expected");
+
+    QTest::newRow("equals") << "(sAMAccountName=USER1)" << QList<QString>({user1_dn});
+    QTest::newRow("present") << "(member=*)" << QList<QString>({group1_dn, group2_dn});
+    QTest::newRow("substring") << "(sAMAccountName=us*2)" << QList<QString>({user2_dn});
+    QTest::newRow("and") << "(&(objectClass=user)(!(sAMAccountName=user1)))" << QList<QString>({user2_dn});
+    QTest::newRow("or") << "(|(cn=nothing)(sAMAccountName=user2))" << QList<QString>({user2_dn});
+    QTest::newRow("greater") << "(userAccountControl>=513)" << QList<QString>({user1_dn});
+    QTest::newRow("category short form") << "(objectCategory=person)" << QList<QString>({user1_dn, user2_dn});
+    QTest::newRow("bit and") << "(userAccountControl:1.2.840.113556.1.4.803:=2)" << QList<QString>({user1_dn});
+    QTest::newRow("in chain") << QString("(memberOf:1.2.840.113556.1.4.1941:=%1)").arg(group2_dn) << QList<QString>({group1_dn, user1_dn});
+    QTest::newRow("escaped") << "(sAMAccountName=user\\31)" << QList<QString>({user1_dn});
+}
+
+void ADMCTestMemoryBackend::search_filter() {
+    QFETCH(QString, filter);
+    QFETCH(QList<QString>, expected);
+
+    const QList<QString> actual = search_dn_list(domain_dn, SearchScope_All, filter);
+
+    QCOMPARE(actual, expected);
+}
+
+void ADMCTestMemoryBackend::search_paged() {
+    backend->set_page_size(2);
+
+    QHash<QString, AdObject> results;
+    int cookie = 0;
+    int page_count = 0;
+
+    do {
+        const int result = backend->search(domain_dn, SearchScope_All, QString(), {"name"}, &results, &cookie);
+        QCOMPARE(result, LDAP_SUCCESS);
+
+        page_count++;
+    } while (cookie != 0);
+
+    QCOMPARE(results.size(), 6);
+    QCOMPARE(page_count, 3);
+}
+
+// NOTE: entries matched on first page are returned on later
+// pages, except ones that were deleted in between
+void ADMCTestMemoryBackend::search_paged_delete() {
+    backend->set_page_size(2);
+
+    QHash<QString, AdObject> results;
+    int cookie = 0;
+
+    const int first_result = backend->search(domain_dn, SearchScope_All, QString(), {"name"}, &results, &cookie);
+    QCOMPARE(first_result, LDAP_SUCCESS);
+    QVERIFY(cookie != 0);
+
+    const QString deleted_dn = [&]() {
+        for (const QString &dn : QList<QString>({user1_dn, user2_dn, group1_dn, group2_dn})) {
+            if (!results.contains(dn)) {
+                return dn;
+            }
+        }
+
+        return QString();
+    }();
+    QCOMPARE(backend->remove(deleted_dn, false), LDAP_SUCCESS);
+
+    while (cookie != 0) {
+        const int result = backend->search(domain_dn, SearchScope_All, QString(), {"name"}, &results, &cookie);
+        QCOMPARE(result, LDAP_SUCCESS);
+    }
+
+    QCOMPARE(results.size(), 5);
+    QVERIFY(!results.contains(deleted_dn));
+
+    int bad_cookie = 12345;
+    const int bad_result = backend->search(domain_dn, SearchScope_All, QString(), {"name"}, &results, &bad_cookie);
+    QCOMPARE(bad_result, LDAP_UNWILLING_TO_PERFORM);
+    QCOMPARE(bad_cookie, 0);
+}
+
+void ADMCTestMemoryBackend::search_no_such_object() {
+    QHash<QString, AdObject> results;
+    int cookie = 0;
+    const int result = backend->search("OU=missing,DC=test,DC=com", SearchScope_Object, QString(), {}, &results, &cookie);
+
+    QCOMPARE(result, LDAP_NO_SUCH_OBJECT);
+    QVERIFY(results.isEmpty());
+}
+
+void ADMCTestMemoryBackend::add() {
+    const QString dn = "CN=new,OU=ou1,DC=test,DC=com";
+
+    QCOMPARE(backend->add(dn, {{"objectClass", {"user"}}}), LDAP_SUCCESS);
+    QCOMPARE(backend->add(dn, {{"objectClass", {"user"}}}), LDAP_ALREADY_EXISTS);
+    QCOMPARE(backend->add("CN=new,OU=missing,DC=test,DC=com", {{"objectClass", {"user"}}}), LDAP_NO_SUCH_OBJECT);
+
+    QHash<QString, AdObject> results;
+    int cookie = 0;
+    backend->search(dn, SearchScope_Object, QString(), {}, &results, &cookie);
+    const AdObject object = results.value(dn);
+
+    QCOMPARE(object.get_string("cn"), QString("new"));
+    QCOMPARE(object.get_string("name"), QString("new"));
+    QCOMPARE(object.get_string("distinguishedName"), dn);
+    QVERIFY(object.contains("uSNChanged"));
+}
+
+void ADMCTestMemoryBackend::modify() {
+    const AdBackendMod replace_mod = {AdBackendModOp_Replace, "description", {"hello"}};
+    QCOMPARE(backend->modify(user1_dn, {replace_mod}), LDAP_SUCCESS);
+
+    const AdBackendMod add_existing_mod = {AdBackendModOp_Add, "description", {"hello"}};
+    QCOMPARE(backend->modify(user1_dn, {add_existing_mod}), LDAP_TYPE_OR_VALUE_EXISTS);
+
+    const AdBackendMod delete_missing_mod = {AdBackendModOp_Delete, "description", {"bye"}};
+    QCOMPARE(backend->modify(user1_dn, {delete_missing_mod}), LDAP_NO_SUCH_ATTRIBUTE);
+
+    QCOMPARE(search_dn_list(domain_dn, SearchScope_All, "(description=hello)"), QList<QString>({user1_dn}));
+
+    const AdBackendMod clear_mod = {AdBackendModOp_Replace, "description", {}};
+    QCOMPARE(backend->modify(user1_dn, {clear_mod}), LDAP_SUCCESS);
+
+    QVERIFY(search_dn_list(domain_dn, SearchScope_All, "(description=*)").isEmpty());
+}
+
+void ADMCTestMemoryBackend::remove() {
+    QCOMPARE(backend->remove(ou_dn, false), LDAP_NOT_ALLOWED_ON_NONLEAF);
+    QCOMPARE(backend->remove(ou_dn, true), LDAP_SUCCESS);
+
+    QCOMPARE(search_dn_list(domain_dn, SearchScope_All, QString()), QList<QString>({group2_dn, domain_dn}));
+
+    // Link to deleted group should be removed
+    QVERIFY(search_dn_list(domain_dn, SearchScope_All, "(member=*)").isEmpty());
+}
+
+void ADMCTestMemoryBackend::rename() {
+    const QString new_ou_dn = "OU=ou2,DC=test,DC=com";
+    const QString new_user1_dn = "CN=user1,OU=ou2,DC=test,DC=com";
+    const QString new_group1_dn = "CN=group1,OU=ou2,DC=test,DC=com";
+
+    QCOMPARE(backend->rename(ou_dn, "OU=ou2", QString()), LDAP_SUCCESS);
+
+    QCOMPARE(search_dn_list(new_ou_dn, SearchScope_Children, QString()).size(), 3);
+    QVERIFY(search_dn_list(domain_dn, SearchScope_All, "(ou=ou1)").isEmpty());
+
+    // Links to moved objects should be updated
+    const QString member_filter = QString("(member=%1)").arg(new_user1_dn);
+    QCOMPARE(search_dn_list(domain_dn, SearchScope_All, member_filter), QList<QString>({new_group1_dn}));
+
+    QCOMPARE(backend->rename(new_user1_dn, "CN=user1", domain_dn), LDAP_SUCCESS);
+    QCOMPARE(search_dn_list(domain_dn, SearchScope_Children, "(cn=user1)"), QList<QString>({"CN=user1,DC=test,DC=com"}));
+}
+
+void ADMCTestMemoryBackend::member_of() {
+    QHash<QString, AdObject> results;
+    int cookie = 0;
+    backend->search(user1_dn, SearchScope_Object, QString(), {"memberOf"}, &results, &cookie);
+
+    QCOMPARE(results.value(user1_dn).get_strings("memberOf"), QList<QString>({group1_dn}));
+}
+
+void ADMCTestMemoryBackend::ldif_parse() {
+    const QByteArray data = "version: 1\n"
+                            "\n"
+                            "# comment\n"
+                            "dn: CN=a,DC=test,DC=com\n"
+                            "description: long\n"
+                            "  value\n"
+                            "objectSid:: AQIDBA==\n"
+                            "\n"
+                            "dn: CN=b,DC=test,DC=com\n"
+                            "cn: b\n";
+
+    QList<LdifEntry> entry_list;
+    QString error;
+    const bool success = ::ldif_parse(data, &entry_list, &error);
+
+    QVERIFY(success);
+    QCOMPARE(entry_list.size(), 2);
+    QCOMPARE(entry_list[0].dn, QString("CN=a,DC=test,DC=com"));
+    QCOMPARE(entry_list[0].attributes["description"], QList<QByteArray>({"long value"}));
+    QCOMPARE(entry_list[0].attributes["objectSid"], QList<QByteArray>({QByteArray("\x01\x02\x03\x04")}));
+    QCOMPARE(entry_list[1].attributes["cn"], QList<QByteArray>({"b"}));
+}
+
+QList<QString> ADMCTestMemoryBackend::search_dn_list(const QString &base, const SearchScope scope, const QString &filter) {
+    QHash<QString, AdObject> results;
+    int cookie = 0;
+    backend->search(base, scope, filter, {}, &results, &cookie);
+
+    QList<QString> out = results.keys();
+    std::sort(out.begin(), out.end(), [](const QString &a, const QString &b) {
+        return (a.toLower() < b.toLower());
+    });
+
+    return out;
+}
+
+QTEST_MAIN(ADMCTestMemoryBackend)
@@ -0,0 +1,61 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ADMC_TEST_MEMORY_BACKEND_H
+#define ADMC_TEST_MEMORY_BACKEND_H
+
+#include "ad_defines.h"
+
+#include <QObject>
+#include <QTest>
+
+class AdMemoryBackend;
+
+class ADMCTestMemoryBackend : public QObject {
+    Q_OBJECT
+
+public slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+private slots:
+    void search_scope_data();
+    void search_scope();
+    void search_filter_data();
+    void search_filter();
+    void search_paged();
+    void search_paged_delete();
+    void search_no_such_object();
+    void add();
+    void modify();
+    void remove();
+    void rename();
+    void member_of();
+    void ldif_parse();
+
+private:
+    AdMemoryBackend *backend;
+
+    QList<QString> search_dn_list(const QString &base, const SearchScope scope, const QString &filter);
+};
+
+#endif /* ADMC_TEST_MEMORY_BACKEND_H */
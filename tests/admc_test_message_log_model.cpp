@@ -0,0 +1,126 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "admc_test_message_log_model.h"
+
+#include "message_log_model.h"
+
+#include <QSignalSpy>
+
+#define TEST_CAPACITY 5
+
+void ADMCTestMessageLogModel::init() {
+    model = new MessageLogModel(TEST_CAPACITY, this);
+}
+
+void ADMCTestMessageLogModel::cleanup() {
+    delete model;
+}
+
+// Added messages are not visible until flush
+void ADMCTestMessageLogModel::add_is_pending() {
+    model->add_message("first", StatusType_Success);
+
+    QCOMPARE(model->rowCount(), 0);
+    QCOMPARE(model->pending_count(), 1);
+
+    // Flush timer should insert it eventually
+    QTRY_COMPARE(model->rowCount(), 1);
+    QCOMPARE(model->pending_count(), 0);
+}
+
+// All pending messages are inserted with one insert
+void ADMCTestMessageLogModel::flush_inserts_batch() {
+    QSignalSpy insert_spy(model, &QAbstractItemModel::rowsInserted);
+
+    model->add_message("1", StatusType_Success);
+    model->add_message("2", StatusType_Error);
+    model->add_message("3", StatusType_Success);
+    model->flush();
+
+    QCOMPARE(insert_spy.count(), 1);
+    QCOMPARE(model->rowCount(), 3);
+    QCOMPARE(model->get_record(0).text, QString("1"));
+    QCOMPARE(model->get_record(1).type, StatusType_Error);
+    QCOMPARE(model->get_record(2).text, QString("3"));
+    QCOMPARE(model->index(1, 0).data(MessageLogRole_Type).toInt(), (int) StatusType_Error);
+}
+
+void ADMCTestMessageLogModel::capacity_drops_oldest() {
+    for (int i = 0; i < 4; i++) {
+        model->add_message(QString::number(i), StatusType_Success);
+    }
+    model->flush();
+
+    QSignalSpy remove_spy(model, &QAbstractItemModel::rowsRemoved);
+
+    for (int i = 4; i < 7; i++) {
+        model->add_message(QString::number(i), StatusType_Success);
+    }
+    model->flush();
+
+    QCOMPARE(remove_spy.count(), 1);
+    QCOMPARE(model->rowCount(), TEST_CAPACITY);
+    for (int row = 0; row < TEST_CAPACITY; row++) {
+        QCOMPARE(model->get_record(row).text, QString::number(row + 2));
+    }
+}
+
+// Pending list shouldn't grow past capacity
+void ADMCTestMessageLogModel::pending_over_capacity() {
+    for (int i = 0; i < 100; i++) {
+        model->add_message(QString::number(i), StatusType_Success);
+    }
+
+    QCOMPARE(model->pending_count(), TEST_CAPACITY);
+
+    model->flush();
+
+    QCOMPARE(model->rowCount(), TEST_CAPACITY);
+    QCOMPARE(model->get_record(0).text, QString("95"));
+    QCOMPARE(model->get_record(TEST_CAPACITY - 1).text, QString("99"));
+}
+
+void ADMCTestMessageLogModel::timestamps() {
+    model->add_message("text", StatusType_Success);
+    model->flush();
+
+    const QModelIndex index = model->index(0, 0);
+
+    model->set_show_timestamps(false);
+    QCOMPARE(index.data().toString(), QString("text"));
+
+    model->set_show_timestamps(true);
+    const QString timestamp = model->get_record(0).time.toString("hh:mm:ss");
+    QCOMPARE(index.data().toString(), QString("%1 text").arg(timestamp));
+}
+
+void ADMCTestMessageLogModel::clear() {
+    model->add_message("1", StatusType_Success);
+    model->flush();
+    model->add_message("2", StatusType_Success);
+
+    model->clear();
+
+    QCOMPARE(model->rowCount(), 0);
+    QCOMPARE(model->pending_count(), 0);
+}
+
+QTEST_MAIN(ADMCTestMessageLogModel)
@@ -0,0 +1,48 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ADMC_TEST_MESSAGE_LOG_MODEL_H
+#define ADMC_TEST_MESSAGE_LOG_MODEL_H
+
+#include <QObject>
+#include <QTest>
+
+class MessageLogModel;
+
+class ADMCTestMessageLogModel : public QObject {
+    Q_OBJECT
+
+public slots:
+    void init();
+    void cleanup();
+
+private slots:
+    void add_is_pending();
+    void flush_inserts_batch();
+    void capacity_drops_oldest();
+    void pending_over_capacity();
+    void timestamps();
+    void clear();
+
+private:
+    MessageLogModel *model;
+};
+
+#endif /* ADMC_TEST_MESSAGE_LOG_MODEL_H */
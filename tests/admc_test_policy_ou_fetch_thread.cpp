@@ -0,0 +1,62 @@
+/*
+ * ADMC - AD Management Center
+ *
+ * Copyright (C) 2020-2022 BaseALT Ltd.
+ * Copyright (C) 2020-2022 Dmitry Degtyarev
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "admc_test_policy_ou_fetch_thread.h"
+
+#include "policy_ou_fetch_thread.h"
+
+// NOTE: gplink's written by other tools contain DN's in
+// upper case, while server returns policy DN's in their
+// own case. Linked policy has to be found anyway.
+void ADMCTestPolicyOUFetchThread::linked_policy_not_cached() {
+    const QString container_dn = test_object_dn("policies", CLASS_CONTAINER);
+    QVERIFY(ad.object_add(container_dn, CLASS_CONTAINER));
+
+    const QString gpo_dn = QString("CN={6AC1786C-016F-11D2-945F-00C04FB984F9},%1").arg(container_dn);
+    QVERIFY(ad.object_add(gpo_dn, CLASS_GP_CONTAINER));
+
+    Gplink gplink;
+    gplink.add(gpo_dn.toUpper());
+    const QString gplink_string = gplink.to_string();
+    QVERIFY(ad.attribute_replace_string(test_arena_dn(), ATTRIBUTE_GPLINK, gplink_string));
+
+    AdInterface::object_cache()->clear();
+
+    PolicyOUFetchThread thread(test_arena_dn());
+
+    QHash<QString, AdObject> policy_results;
+    connect(
+        &thread, &PolicyOUFetchThread::policies_ready,
+        this,
+        [&](const QString &, const QHash<QString, AdObject> &results) {
+            policy_results = results;
+        },
+        Qt::DirectConnection);
+
+    thread.start();
+    QVERIFY(thread.wait(10000));
+
+    const QList<QString> gpo_list = Gplink(gplink_string).get_gpo_list();
+    QCOMPARE(gpo_list.size(), 1);
+    QVERIFY(policy_results.contains(gpo_list[0]));
+    QCOMPARE(policy_results[gpo_list[0]].get_dn().toLower(), gpo_dn.toLower());
+}
+
+QTEST_MAIN(ADMCTestPolicyOUFetchThread)